@@ -0,0 +1,150 @@
+#ifndef BACKLIGHT_HANDLER_M5STICK_ADAPTER_H
+#define BACKLIGHT_HANDLER_M5STICK_ADAPTER_H
+
+#include <M5Unified.h>
+#include <Arduino.h>
+#include "../ports/backlight_handler_port.h"
+#include "../ports/battery_handler_port.h"
+#include "../settings_manager.h"
+
+// Governs the LCD backlight: user level x page level, dimmed after
+// inactivity and capped on low battery. Level changes are faded by stepping
+// the PWM duty from update(); M5GFX owns the LEDC channel, so the fade goes
+// through M5.Display.setBrightness instead of the LEDC fade unit.
+class BacklightHandlerM5StickAdapter final : public IBacklightHandler {
+public:
+    static const uint32_t FADE_MS            = 300;
+    static const uint32_t DIM_AFTER_MS       = 8000;
+    static const uint8_t  DIM_PERCENT        = 25;
+    static const int32_t  SAVER_BATTERY_PCT  = 20;
+    static const uint8_t  SAVER_MAX_LEVEL    = 64;
+
+    BacklightHandlerM5StickAdapter(BatteryHandlerT* battery)
+        : _battery(battery), _settings(nullptr), _pagePercent(100),
+          _level(0), _fadeFrom(0), _target(0), _fadeStart(0),
+          _lastAccounting(0), _dimmed(false) {
+        memset(_buckets, 0, sizeof(_buckets));
+    }
+
+    void begin() override {
+        _settings = SettingsManager::getInstance();
+        _target = computeTarget();
+        _level = _fadeFrom = _target;
+        M5.Display.setBrightness(_level);
+        _lastAccounting = millis();
+    }
+
+    void update() override {
+        unsigned long now = millis();
+        account(now);
+
+        uint8_t target = computeTarget();
+        if (target != _target) {
+            _fadeFrom  = _level;
+            _target    = target;
+            _fadeStart = now;
+        }
+        if (_level == _target) return;
+
+        uint32_t elapsed = now - _fadeStart;
+        uint8_t  next = _target;
+        if (elapsed < FADE_MS) {
+            next = _fadeFrom + ((int32_t)_target - _fadeFrom) * (int32_t)elapsed / (int32_t)FADE_MS;
+        }
+        if (next != _level) {
+            _level = next;
+            M5.Display.setBrightness(_level);
+        }
+    }
+
+    void setBrightness(uint8_t level) override { _settings->setBrightness(level); }
+    uint8_t getBrightness() override           { return _settings->getBrightness(); }
+
+    void setPageLevel(uint8_t percent) override {
+        _pagePercent = percent > 100 ? 100 : percent;
+    }
+
+    uint8_t getCurrentLevel() override { return _level; }
+    bool    isDimmed() override        { return _dimmed; }
+    bool    isOn() override            { return _level > 0; }
+
+    const BacklightEnergyBucket* getEnergyBuckets() override { return _buckets; }
+
+    // Backlight cost of a bucket = its average draw minus the draw of the
+    // darkest bucket observed, i.e. mA, which is also mAh per hour.
+    void printEnergyReport() override {
+        double baseline = -1;
+        for (int i = 0; i < BACKLIGHT_ENERGY_BUCKETS; i++) {
+            if (_buckets[i].activeMs > 0) { baseline = averageMa(i); break; }
+        }
+
+        Serial.println("=== Backlight energy ===");
+        Serial.println("level    time_s  avg_mA  backlight_mAh/h");
+        for (int i = 0; i < BACKLIGHT_ENERGY_BUCKETS; i++) {
+            if (_buckets[i].activeMs == 0) continue;
+            double avg = averageMa(i);
+            Serial.printf("%-7s %7lu %7.1f %8.1f\n", bucketLabel(i),
+                          (unsigned long)(_buckets[i].activeMs / 1000), avg, avg - baseline);
+        }
+        Serial.println("========================");
+    }
+
+private:
+    BatteryHandlerT*      _battery;
+    SettingsManager*      _settings;
+    uint8_t               _pagePercent;
+    uint8_t               _level;
+    uint8_t               _fadeFrom;
+    uint8_t               _target;
+    unsigned long         _fadeStart;
+    unsigned long         _lastAccounting;
+    bool                  _dimmed;
+    BacklightEnergyBucket _buckets[BACKLIGHT_ENERGY_BUCKETS];
+
+    uint8_t computeTarget() {
+        uint32_t level = (uint32_t)_settings->getBrightness() * _pagePercent / 100;
+
+        _dimmed = _settings->getInactiveMs() >= DIM_AFTER_MS;
+        if (_dimmed) level = level * DIM_PERCENT / 100;
+
+        if (!_battery->isCharging() && _battery->getLevel() > 0 &&
+            _battery->getLevel() < SAVER_BATTERY_PCT && level > SAVER_MAX_LEVEL) {
+            level = SAVER_MAX_LEVEL;
+        }
+        return (uint8_t)level;
+    }
+
+    // Buckets: off, then quarters of the 0-255 range
+    static int bucketFor(uint8_t level) {
+        if (level == 0) return 0;
+        return 1 + (level - 1) / 64;
+    }
+
+    static const char* bucketLabel(int bucket) {
+        switch (bucket) {
+            case 0:  return "off";
+            case 1:  return "1-25%";
+            case 2:  return "26-50%";
+            case 3:  return "51-75%";
+            default: return "76-100%";
+        }
+    }
+
+    double averageMa(int bucket) {
+        return _buckets[bucket].chargeMaMs / _buckets[bucket].activeMs;
+    }
+
+    // getCurrent() is negative while discharging; charging time is skipped
+    void account(unsigned long now) {
+        uint32_t dt = now - _lastAccounting;
+        _lastAccounting = now;
+        int32_t current = _battery->getCurrent();
+        if (_battery->isCharging() || current >= 0) return;
+
+        BacklightEnergyBucket& b = _buckets[bucketFor(_level)];
+        b.activeMs   += dt;
+        b.chargeMaMs += (double)(-current) * dt;
+    }
+};
+
+#endif
@@ -8,13 +8,14 @@
 #include <driver/gpio.h>
 #include "../ports/battery_handler_port.h"
 #include "../ports/display_handler_port.h"
+#include "../metrics.h"
 
 #define BUTTON_A_GPIO GPIO_NUM_37
 #define WAKEUP_BUTTON_MASK (1ULL << BUTTON_A_GPIO)
 
-class BatteryHandlerM5StickAdapter : public IBatteryHandler {
+class BatteryHandlerM5StickAdapter final : public IBatteryHandler {
 public:
-    BatteryHandlerM5StickAdapter(IDisplayHandler* display, uint32_t intervalMs = 5000)
+    BatteryHandlerM5StickAdapter(DisplayHandlerT* display, uint32_t intervalMs = 5000)
         : _display(display), _bc(0), _bl(0), _bv(0),
           _ic(m5::Power_Class::is_charging_t::is_discharging),
           _lastUpdate(0), _updateInterval(intervalMs) {}
@@ -29,6 +30,9 @@ public:
         _bl = M5.Power.getBatteryLevel();
         _bv = M5.Power.getBatteryVoltage();
         _ic = M5.Power.isCharging();
+        Metrics::batterySamples.inc();
+        Metrics::batteryLevel.set(_bl);
+        Metrics::batteryMv.set(_bv);
     }
 
     void displayInfo() override {
@@ -47,6 +51,14 @@ public:
         esp_deep_sleep_start();
     }
 
+    // The task blocks, so the idle task gets the CPU (and automatic light
+    // sleep when power management is on); the sub-ms rest is a busy wait
+    // to land on the frame time
+    void idle(uint32_t microseconds) override {
+        if (microseconds >= 1000) delay(microseconds / 1000);
+        if (microseconds % 1000)  delayMicroseconds(microseconds % 1000);
+    }
+
     void cutAllNonCore() override {
         esp_wifi_stop();
         btStop();
@@ -62,7 +74,7 @@ public:
     }
 
 private:
-    IDisplayHandler*              _display;
+    DisplayHandlerT*              _display;
     int32_t                       _bc, _bl;
     int16_t                       _bv;
     m5::Power_Class::is_charging_t _ic;
@@ -5,7 +5,7 @@
 #include <Arduino.h>
 #include "../ports/button_handler_port.h"
 
-class ButtonHandlerM5StickAdapter : public IButtonHandler {
+class ButtonHandlerM5StickAdapter final : public IButtonHandler {
 public:
     ButtonHandlerM5StickAdapter(int btnType = 1, uint32_t doubleClickMs = 400)
         : _lastPressTime(0), _waitingSecondPress(false),
@@ -4,18 +4,29 @@
 #include <M5Unified.h>
 #include <Arduino.h>
 #include <Preferences.h>
+#include <esp_timer.h>
+#include <esp_attr.h>
 #include "../ports/clock_handler_port.h"
 #include "../ports/display_handler_port.h"
 #include "../ports/battery_handler_port.h"
 #include "../ports/rtc_utils_port.h"
+#include "../core/second_ticker.h"
+
+// Optional: a GPIO wired to a 1 Hz RTC output rising with the seconds
+// change. The StickC Plus2 does not route one, so by default the edge is
+// found by polling the seconds register around the expected time.
+#ifdef RTC_SECOND_GPIO
+static volatile int64_t rtcSecondEdgeUs = 0;
+static void IRAM_ATTR onRtcSecondEdge() { rtcSecondEdgeUs = esp_timer_get_time(); }
+#endif
 
-class ClockHandlerM5StickAdapter : public IClockHandler {
+class ClockHandlerM5StickAdapter final : public IClockHandler {
 public:
-    static const int POMODORO_MINUTES = 25;
     static const int CLOCK_REFRESH_MS = 1000;
 
-    ClockHandlerM5StickAdapter(IDisplayHandler* display, IBatteryHandler* battery, IRtcUtils* rtc)
-        : _display(display), _battery(battery), _rtc(rtc) {
+    ClockHandlerM5StickAdapter(DisplayHandlerT* display, BatteryHandlerT* battery, RtcUtilsT* rtc)
+        : _display(display), _battery(battery), _rtc(rtc), _tickPhase(TICK_SEARCH), _lastSecond(0xFF),
+          _windowUs(0) {
         memset(_timeBuffer, 0, sizeof(_timeBuffer));
         memset(_dateBuffer, 0, sizeof(_dateBuffer));
     }
@@ -46,37 +57,90 @@ public:
         return _dateBuffer;
     }
 
-    void drawClock(uint32_t remainSec = 0) override {
-        static uint32_t lastRemain = 9999;
-        static uint8_t  lastSec    = 99;
+    void drawClock(uint32_t remainSec = 0, const char* label = "Timer") override {
+        static uint32_t    lastRemain = 9999;
+        static uint8_t     lastSec    = 99;
+        static const char* lastLabel  = nullptr;
         updateDateTime();
-        if (_dt.time.seconds != lastSec || remainSec != lastRemain) {
+        if (_dt.time.seconds != lastSec || remainSec != lastRemain || label != lastLabel) {
             _display->clearScreen();
             _display->displayMainTitle(getCurrentFullTime());
             _display->displaySubtitle(getCurrentFullDateFR());
             if (remainSec > 0) {
-                char pomoText[32];
-                sprintf(pomoText, "Pomo: %02u:%02u", remainSec / 60, remainSec % 60);
-                _display->displayInfoMessage(pomoText);
+                char countdown[32];
+                snprintf(countdown, sizeof(countdown), "%s: %02u:%02u", label, remainSec / 60, remainSec % 60);
+                _display->displayInfoMessage(countdown);
             }
             lastSec    = _dt.time.seconds;
             lastRemain = remainSec;
+            lastLabel  = label;
         }
     }
 
-    void armPomodoroAndSleep() override {
-        _display->clearScreen();
-        _display->displayMainTitle("Pomodoro", MSG_SUCCESS);
-        delay(1500);
-        armTimerAndSleep(POMODORO_MINUTES);
-    }
-
     void armTimerAndSleep(uint32_t minutes) override {
         uint32_t target = _rtc->epochNow() + minutes * 60;
         writeTarget(target);
         _battery->deepSleep((uint64_t)minutes * 60ULL * 1000000ULL);
     }
 
+    bool secondTick() override {
+        int64_t now = esp_timer_get_time();
+        switch (_tickPhase) {
+            case TICK_SEARCH: {
+                // Loop-rate polling, only good to a loop period: the next
+                // edge is then observed closely
+                uint8_t s = _rtc->getSeconds();
+                bool changed = _lastSecond != 0xFF && s != _lastSecond;
+                _lastSecond = s;
+                if (!changed) return false;
+                _tickPhase = TICK_FINE;
+                _windowUs  = now + 1000000 - SECOND_EDGE_LEAD_US;
+                return true;
+            }
+            case TICK_FINE:
+                if (now < _windowUs) return false;
+                return observeEdge();
+            case TICK_LOCKED: {
+                if (!_ticker.due(now)) return false;
+                uint8_t s = _rtc->getSeconds();
+                _ticker.onTick(now, s != _lastSecond);
+                _lastSecond = s;
+                if (_ticker.calibrationDue()) {
+                    _tickPhase = TICK_FINE;
+                    _windowUs  = _ticker.nextEdgeUs() - SECOND_EDGE_LEAD_US;
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int64_t nextTickDueUs() override {
+        switch (_tickPhase) {
+            case TICK_LOCKED: return _ticker.nextTickUs();
+            case TICK_FINE:   return esp_timer_get_time() < _windowUs ? _windowUs : 0;
+            default:          return 0;
+        }
+    }
+
+    void resyncTick() override {
+        _tickPhase  = TICK_SEARCH;
+        _lastSecond = 0xFF;
+        _ticker.resync();
+    }
+
+    void printTickStats() override {
+        const SecondTickStats& s = _ticker.stats();
+        Serial.printf("tick: %s, rtc second %+ld ppm vs esp_timer\n",
+                      _tickPhase == TICK_LOCKED ? "locked" : "searching", (long)_ticker.periodPpm());
+        Serial.printf("ticks %lu  slips %lu  skipped %lu  calibrations %lu\n", (unsigned long)s.ticks,
+                      (unsigned long)s.slips, (unsigned long)s.skipped, (unsigned long)s.calibrations);
+        Serial.printf("after the edge: min %.2f  mean %.2f  max %.2f  jitter %.2f ms\n", s.minLateUs / 1000.0,
+                      s.meanLateUs() / 1000.0, s.maxLateUs / 1000.0, s.jitterUs() / 1000.0);
+    }
+
+    void resetTickStats() override { _ticker.resetStats(); }
+
     void writeTarget(uint32_t epoch) override {
         _prefs.begin("clock", false);
         _prefs.putUInt("target", epoch);
@@ -101,13 +165,55 @@ public:
     int getWeekDay() override { updateDateTime(); return _dt.date.weekDay; }
 
 private:
-    IDisplayHandler*   _display;
-    IBatteryHandler*   _battery;
-    IRtcUtils*         _rtc;
+    enum TickPhase : uint8_t { TICK_SEARCH, TICK_FINE, TICK_LOCKED };
+
+    DisplayHandlerT*   _display;
+    BatteryHandlerT*   _battery;
+    RtcUtilsT*         _rtc;
     m5::rtc_datetime_t _dt;
     char               _timeBuffer[16];
     char               _dateBuffer[16];
     Preferences        _prefs;
+    SecondTicker       _ticker;
+    TickPhase          _tickPhase;
+    uint8_t            _lastSecond;
+    int64_t            _windowUs;
+
+    // Waits for the seconds to change, at most SECOND_EDGE_TIMEOUT_US from
+    // the start of the window. Blocks up to ~25 ms, once per calibration.
+    // A window reached too late (stall, page hidden) gives no edge.
+    bool observeEdge() {
+#ifdef RTC_SECOND_GPIO
+        static bool attached = false;
+        if (!attached) {
+            pinMode(RTC_SECOND_GPIO, INPUT);
+            attachInterrupt(digitalPinToInterrupt(RTC_SECOND_GPIO), onRtcSecondEdge, RISING);
+            attached = true;
+        }
+        if (rtcSecondEdgeUs > _windowUs) {
+            _ticker.calibrate(rtcSecondEdgeUs);
+            _lastSecond = _rtc->getSeconds();
+            _tickPhase  = TICK_LOCKED;
+            return true;
+        }
+        if (esp_timer_get_time() - _windowUs < SECOND_EDGE_TIMEOUT_US) return false;
+#else
+        uint8_t s = _lastSecond;
+        int64_t edge = observeSecondEdge(_windowUs, _lastSecond,
+                                         [this]() { return (uint8_t)_rtc->getSeconds(); },
+                                         []() { return esp_timer_get_time(); }, &s);
+        if (edge >= 0) {
+            _ticker.calibrate(edge);
+            _lastSecond = s;
+            _tickPhase  = TICK_LOCKED;
+            return true;
+        }
+#endif
+        // No edge where expected (RTC set meanwhile, window reached late): start over
+        _tickPhase  = TICK_SEARCH;
+        _lastSecond = _rtc->getSeconds();
+        return false;
+    }
 };
 
 #endif
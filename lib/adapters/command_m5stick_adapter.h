@@ -0,0 +1,86 @@
+#ifndef COMMAND_M5STICK_ADAPTER_H
+#define COMMAND_M5STICK_ADAPTER_H
+
+#include <Arduino.h>
+#include "../ports/command_port.h"
+#include "../ports/mqtt_helper_port.h"
+#include "../core/command_dispatcher.h"
+#include "../deferred_log.h"
+
+#define COMMAND_TOPIC_MAX  64
+#define COMMAND_REPLY_MAX  160
+
+// Reply: {"id":"42","action":"set_config","status":"ok","detail":""}
+class CommandM5StickAdapter final : public ICommandService {
+public:
+    CommandM5StickAdapter(MQTTHelperT* mqtt, const CommandSpec* table, size_t count)
+        : _mqtt(mqtt), _table(table), _count(count) {
+        _cmdTopic[0]   = '\0';
+        _replyTopic[0] = '\0';
+    }
+
+    bool begin(const char* topicBase = nullptr) override {
+        if (!_dispatcher.begin(_table, _count)) {
+            DLOG_E(CMD, CMD_TABLE_REJECTED, (unsigned)_count);
+            return false;
+        }
+        if (topicBase) {
+            snprintf(_cmdTopic, sizeof(_cmdTopic), "%s/cmd", topicBase);
+            snprintf(_replyTopic, sizeof(_replyTopic), "%s/reply", topicBase);
+        } else {
+            snprintf(_cmdTopic, sizeof(_cmdTopic), "device/%s/cmd", _mqtt->getDeviceId());
+            snprintf(_replyTopic, sizeof(_replyTopic), "device/%s/reply", _mqtt->getDeviceId());
+        }
+
+        // MQTT task: parse and queue only
+        _mqtt->subscribe(_cmdTopic, [this](const MqttMessageView& msg) {
+            _dispatcher.submit((const uint8_t*)msg.payload, msg.length, micros());
+        }, 1);
+        return true;
+    }
+
+    void update() override { _dispatcher.runPending(sendReply, this, nowUs); }
+
+    CommandStatus submit(const uint8_t* payload, size_t length) override {
+        return _dispatcher.submit(payload, length, micros());
+    }
+
+    const CommandStats& getStats() override { return _dispatcher.stats(); }
+
+    void printReport() override {
+        const CommandStats&       s = _dispatcher.stats();
+        const FixedPoolAllocator& p = _dispatcher.pool();
+        Serial.println("=== Commands ===");
+        Serial.printf("Topic: %s (%u commands)\n", _cmdTopic, (unsigned)_count);
+        Serial.printf("Received: %u, executed: %u, failed: %u\n", (unsigned)s.received, (unsigned)s.executed,
+                      (unsigned)s.failed);
+        Serial.printf("Rejected: %u unknown, %u bad args, %u bad payload, %u dropped\n", (unsigned)s.unknown,
+                      (unsigned)s.badArgs, (unsigned)s.parseErrors, (unsigned)s.dropped);
+        Serial.printf("Latency: avg %u us, max %u us, queue peak %u\n", (unsigned)s.averageLatencyUs(),
+                      (unsigned)s.maxLatencyUs, (unsigned)s.maxQueued);
+        Serial.printf("Parse pool: %u/%u bytes peak, %u failures\n", (unsigned)p.highWater(),
+                      (unsigned)p.capacity(), (unsigned)p.failures());
+        Serial.println("================");
+    }
+
+private:
+    MQTTHelperT*          _mqtt;
+    const CommandSpec*    _table;
+    size_t                _count;
+    CommandDispatcher<>   _dispatcher;
+    char                  _cmdTopic[COMMAND_TOPIC_MAX];
+    char                  _replyTopic[COMMAND_TOPIC_MAX];
+
+    static uint32_t nowUs() { return micros(); }
+
+    static void sendReply(void* ctx, const CommandJob& job, const CommandSpec* spec, const CommandResult& result) {
+        CommandM5StickAdapter* self = (CommandM5StickAdapter*)ctx;
+        char payload[COMMAND_REPLY_MAX];
+        snprintf(payload, sizeof(payload), "{\"id\":\"%s\",\"action\":\"%s\",\"status\":\"%s\",\"detail\":\"%s\"}",
+                 job.id, spec ? spec->name : "", commandStatusName(result.status),
+                 result.detail ? result.detail : "");
+        self->_mqtt->publishText(self->_replyTopic, payload, 1);
+    }
+};
+
+#endif
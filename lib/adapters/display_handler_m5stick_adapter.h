@@ -5,7 +5,7 @@
 #include <Arduino.h>
 #include "../ports/display_handler_port.h"
 
-class DisplayHandlerM5StickAdapter : public IDisplayHandler {
+class DisplayHandlerM5StickAdapter final : public IDisplayHandler {
 public:
     DisplayHandlerM5StickAdapter() {}
 
@@ -66,6 +66,15 @@ public:
         M5.Display.print(text);
     }
 
+    void overwriteTextAt(const char* text, int x, int y, int textSize = 2, MessageType type = MSG_NORMAL) override {
+        M5.Display.setTextSize(textSize);
+        M5.Display.setTextColor(colorFor(type), BACKGROUND_COLOR);
+        M5.Display.setCursor(x, y);
+        M5.Display.print(text);
+    }
+
+    int charWidth(int textSize = 2) override { return 6 * textSize; }
+
     void drawCenteredText(const char* text, int y, uint16_t color, int textSize = 2) override {
         M5.Display.setTextSize(textSize);
         M5.Display.setTextColor(color);
@@ -0,0 +1,176 @@
+#ifndef ENERGY_PROFILER_M5STICK_ADAPTER_H
+#define ENERGY_PROFILER_M5STICK_ADAPTER_H
+
+#include <M5Unified.h>
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <esp_sleep.h>
+#include "../ports/energy_profiler_port.h"
+#include "../ports/battery_handler_port.h"
+#include "../ports/page_manager_port.h"
+#include "../ports/backlight_handler_port.h"
+#include "../ports/rtc_utils_port.h"
+#include "../core/energy_accountant.h"
+
+#define ENERGY_RTC_MAGIC         0x454E5247
+#define ENERGY_SLEEP_CURRENT_MA  0.6f
+
+// Counters survive deep sleep in RTC slow memory
+struct EnergyRtcState {
+    uint32_t         magic;
+    uint32_t         sleepStartEpoch;
+    EnergyAccountant accountant;
+};
+
+RTC_DATA_ATTR static EnergyRtcState energyRtc;
+
+class EnergyProfilerM5StickAdapter final : public IEnergyProfiler {
+public:
+    EnergyProfilerM5StickAdapter(BatteryHandlerT* battery, PageManagerT* pages,
+                                 BacklightHandlerT* backlight, RtcUtilsT* rtc,
+                                 uint32_t sampleIntervalMs = 1000)
+        : _battery(battery), _pages(pages), _backlight(backlight), _rtc(rtc),
+          _lastSample(0), _sampleInterval(sampleIntervalMs), _radioOn(false) {}
+
+    void begin() override {
+        EnergyAccountant& acc = energyRtc.accountant;
+        if (energyRtc.magic != ENERGY_RTC_MAGIC) {
+            memset(&energyRtc, 0, sizeof(energyRtc));
+            acc.reset();
+            energyRtc.magic = ENERGY_RTC_MAGIC;
+        }
+
+        if (energyRtc.sleepStartEpoch &&
+            esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_UNDEFINED) {
+            uint32_t now = _rtc->epochNow();
+            if (now > energyRtc.sleepStartEpoch) {
+                acc.addSleep((now - energyRtc.sleepStartEpoch) * 1000UL, ENERGY_SLEEP_CURRENT_MA);
+            }
+        }
+        energyRtc.sleepStartEpoch = 0;
+
+        unsigned long now = millis();
+        acc.resume(now);
+        acc.setContext(now, currentContext());
+        sample(now);
+    }
+
+    void update() override {
+        EnergyAccountant& acc = energyRtc.accountant;
+        unsigned long now = millis();
+
+        EnergyContext ctx = currentContext();
+        if (energyContextKey(ctx) != energyContextKey(acc.context)) {
+            acc.setContext(now, ctx);
+        }
+        if (now - _lastSample >= _sampleInterval) sample(now);
+    }
+
+    bool beginSpan(const char* name) override { return energyRtc.accountant.beginSpan(name); }
+    void endSpan(const char* name) override   { energyRtc.accountant.endSpan(name); }
+    void pauseSpan(const char* name) override { energyRtc.accountant.pauseSpan(name); }
+    void resumeSpan(const char* name) override { energyRtc.accountant.resumeSpan(name); }
+
+    void notifySleep() override {
+        energyRtc.accountant.addSample(millis(), 0);
+        energyRtc.sleepStartEpoch = _rtc->epochNow();
+    }
+
+    void setRadioOn(bool on) override { _radioOn = on; }
+
+    void reset() override {
+        energyRtc.accountant.reset();
+        unsigned long now = millis();
+        energyRtc.accountant.resume(now);
+        energyRtc.accountant.setContext(now, currentContext());
+    }
+
+    const EnergyAccountant& getAccountant() override { return energyRtc.accountant; }
+
+    void printReport() override {
+        const EnergyAccountant& acc = energyRtc.accountant;
+        Serial.println("=== Energy report ===");
+        Serial.println("context                          time_s  avg_mA      mAh");
+        char label[40];
+        for (uint8_t i = 0; i < acc.slotCount; i++) {
+            const EnergyContext& c = acc.slots[i].context;
+            snprintf(label, sizeof(label), "page %d bl %s%s%s", c.page,
+                     BACKLIGHT_LABELS[energyBacklightBucket(c.backlight)],
+                     c.speaker ? " spk" : "", c.radio ? " radio" : "");
+            printLine(label, acc.slots[i].counter);
+        }
+
+        Serial.println("--- by subsystem ---");
+        for (int page = 0; page < _pages->getPageCount(); page++) {
+            snprintf(label, sizeof(label), "page %d", page);
+            printLine(label, acc.sum(PageIs(page)));
+        }
+        printLine("display on",  acc.sum(DisplayOn()));
+        printLine("display off", acc.sum(DisplayOff()));
+        printLine("speaker",     acc.sum(SpeakerOn()));
+        printLine("radio",       acc.sum(RadioOn()));
+        printLine("deep sleep",  acc.sleep);
+
+        for (int i = 0; i < ENERGY_MAX_SPANS; i++) {
+            const EnergySpan& s = acc.spans[i];
+            if (s.name[0] == '\0') continue;
+            snprintf(label, sizeof(label), "span %s x%lu%s", s.name,
+                     (unsigned long)s.runs, s.open ? (s.paused ? " (paused)" : " (open)") : "");
+            printLine(label, s.counter);
+            if (s.runs > 0) {
+                Serial.printf("  %.3f mAh per run\n", s.counter.mAh() / s.runs);
+            }
+        }
+
+        printLine("total", acc.total);
+        if (acc.droppedMs) Serial.printf("unattributed: %lu ms\n", (unsigned long)acc.droppedMs);
+        Serial.println("=====================");
+    }
+
+private:
+    BatteryHandlerT*   _battery;
+    PageManagerT*      _pages;
+    BacklightHandlerT* _backlight;
+    RtcUtilsT*         _rtc;
+    unsigned long      _lastSample;
+    uint32_t           _sampleInterval;
+    bool               _radioOn;
+
+    struct PageIs {
+        int page;
+        explicit PageIs(int p) : page(p) {}
+        bool operator()(const EnergyContext& c) const { return c.page == page; }
+    };
+    struct DisplayOn  { bool operator()(const EnergyContext& c) const { return c.backlight > 0; } };
+    struct DisplayOff { bool operator()(const EnergyContext& c) const { return c.backlight == 0; } };
+    struct SpeakerOn  { bool operator()(const EnergyContext& c) const { return c.speaker; } };
+    struct RadioOn    { bool operator()(const EnergyContext& c) const { return c.radio; } };
+
+    EnergyContext currentContext() {
+        EnergyContext ctx;
+        ctx.page      = (int8_t)_pages->getCurrentPageIndex();
+        ctx.backlight = _backlight->getCurrentLevel();
+        ctx.speaker   = M5.Speaker.isPlaying();
+        ctx.radio     = _radioOn;
+        return ctx;
+    }
+
+    // getCurrent() is negative while discharging, charging counts as 0 draw
+    void sample(unsigned long now) {
+        _lastSample = now;
+        int32_t current = _battery->getCurrent();
+        energyRtc.accountant.addSample(now, current < 0 ? (float)-current : 0.0f);
+    }
+
+    void printLine(const char* label, const EnergyCounter& c) {
+        Serial.printf("%-30s %8.1f %7.1f %8.3f\n", label, c.ms / 1000.0, c.averageMa(), c.mAh());
+    }
+
+    static const char* const BACKLIGHT_LABELS[5];
+};
+
+const char* const EnergyProfilerM5StickAdapter::BACKLIGHT_LABELS[5] = {
+    "off", "1-25%", "26-50%", "51-75%", "76-100%"
+};
+
+#endif
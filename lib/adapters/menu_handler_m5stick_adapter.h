@@ -7,6 +7,7 @@
 #include "../ports/menu_handler_port.h"
 #include "../ports/display_handler_port.h"
 #include "../settings_manager.h"
+#include "../metrics.h"
 
 #define MAX_MENU_ITEMS 10
 
@@ -19,9 +20,9 @@ struct MenuItem {
     MenuItem(const char* lbl, std::function<void()> cb) : label(lbl), callback(cb), enabled(true) {}
 };
 
-class MenuHandlerM5StickAdapter : public IMenuHandler {
+class MenuHandlerM5StickAdapter final : public IMenuHandler {
 public:
-    MenuHandlerM5StickAdapter(IDisplayHandler* disp, const char* menuTitle = "Menu")
+    MenuHandlerM5StickAdapter(DisplayHandlerT* disp, const char* menuTitle = "Menu")
         : _display(disp), _title(menuTitle),
           _itemCount(0), _selectedIndex(0), _scrollOffset(0), _maxVisibleItems(4) {}
 
@@ -76,6 +77,7 @@ public:
     }
 
     void draw() override {
+        uint32_t start = micros();
         _display->clearScreen();
         _display->displayTextAt(_title, 10, 5, 1, MSG_INFO);
 
@@ -104,6 +106,9 @@ public:
         char counter[16];
         sprintf(counter, "%d/%d", _selectedIndex + 1, _itemCount);
         _display->displayTextAt(counter, 180, 5, 1, MSG_NORMAL);
+
+        Metrics::menuDraws.inc();
+        Metrics::menuDrawUs.observe(micros() - start);
     }
 
     void setItemEnabled(int index, bool enabled) override {
@@ -128,7 +133,7 @@ public:
     }
 
 private:
-    IDisplayHandler* _display;
+    DisplayHandlerT* _display;
     const char*     _title;
     MenuItem        _items[MAX_MENU_ITEMS];
     int             _itemCount;
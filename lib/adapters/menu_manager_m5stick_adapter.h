@@ -6,9 +6,9 @@
 
 #define MAX_MENU_STACK 5
 
-class MenuManagerM5StickAdapter : public IMenuManager {
+class MenuManagerM5StickAdapter final : public IMenuManager {
 public:
-    MenuManagerM5StickAdapter(IDisplayHandler* disp)
+    MenuManagerM5StickAdapter(DisplayHandlerT* disp)
         : _display(disp), _stackSize(0), _isActive(false) {}
 
     ~MenuManagerM5StickAdapter() {
@@ -64,7 +64,7 @@ public:
     }
 
 private:
-    IDisplayHandler* _display;
+    DisplayHandlerT* _display;
     IMenuHandler*    _menuStack[MAX_MENU_STACK];
     int              _stackSize;
     bool             _isActive;
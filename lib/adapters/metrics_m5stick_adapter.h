@@ -0,0 +1,91 @@
+#ifndef METRICS_M5STICK_ADAPTER_H
+#define METRICS_M5STICK_ADAPTER_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "../ports/metrics_port.h"
+#include "../ports/mqtt_helper_port.h"
+#include "../metrics.h"
+
+#define METRICS_TOPIC_MAX  64
+
+// Payload, histograms as [count, sum, max, bucket0 .. overflow]:
+// {"up":3600,"c":{"page_switches":12},"g":{"battery_pct":87},"h":{"wifi_connect_ms":[5,4060,1900,0,1,3,1,0,0,0,0]}}
+// Sent with publishJson(), so it goes through the outbox and the encoding
+// set for the topic.
+class MetricsM5StickAdapter final : public IMetricsExporter {
+public:
+    explicit MetricsM5StickAdapter(MQTTHelperT* mqtt) : _mqtt(mqtt), _periodMs(0), _lastPublish(0) {
+        _topic[0] = '\0';
+    }
+
+    void begin(const char* topic = nullptr, uint32_t periodMs = 60000) override {
+        if (topic) snprintf(_topic, sizeof(_topic), "%s", topic);
+        else if (_mqtt) snprintf(_topic, sizeof(_topic), "device/%s/metrics", _mqtt->getDeviceId());
+        _periodMs    = periodMs;
+        _lastPublish = millis();
+    }
+
+    void update() override {
+        if (!_mqtt || !_periodMs || millis() - _lastPublish < _periodMs) return;
+        _lastPublish = millis();
+        publishNow();
+    }
+
+    uint16_t publishNow() override {
+        if (!_mqtt || !_topic[0]) return 0;
+        refreshGauges();
+
+        JsonDocument doc;
+        doc["up"] = millis() / 1000;
+        JsonObject c = doc["c"].to<JsonObject>();
+        JsonObject g = doc["g"].to<JsonObject>();
+        JsonObject h = doc["h"].to<JsonObject>();
+        for (const Metric* m = Metric::first(); m; m = m->next()) {
+            switch (m->type()) {
+                case METRIC_COUNTER:
+                    c[m->name()] = ((const MetricCounter*)m)->value();
+                    break;
+                case METRIC_GAUGE:
+                    g[m->name()] = ((const MetricGauge*)m)->value();
+                    break;
+                case METRIC_HISTOGRAM: {
+                    const MetricHistogram* hist = (const MetricHistogram*)m;
+                    JsonArray a = h[m->name()].to<JsonArray>();
+                    a.add(hist->count());
+                    a.add(hist->sum());
+                    a.add(hist->max());
+                    for (uint8_t b = 0; b <= hist->boundCount(); b++) a.add(hist->bucket(b));
+                    break;
+                }
+            }
+        }
+        return _mqtt->publishJson(_topic, doc);
+    }
+
+    void printTable() override {
+        refreshGauges();
+        char row[160];
+        Serial.printf("=== Metrics (%u) ===\n", (unsigned)Metric::count());
+        for (const Metric* m = Metric::first(); m; m = m->next()) {
+            metricsFormatRow(*m, row, sizeof(row));
+            Serial.println(row);
+        }
+        Serial.println("====================");
+    }
+
+    void reset() override { metricsReset(); }
+
+private:
+    MQTTHelperT*  _mqtt;
+    char          _topic[METRICS_TOPIC_MAX];
+    uint32_t      _periodMs;
+    unsigned long _lastPublish;
+
+    void refreshGauges() {
+        Metrics::heapFree.set((int32_t)ESP.getFreeHeap());
+        Metrics::heapMinFree.set((int32_t)ESP.getMinFreeHeap());
+    }
+};
+
+#endif
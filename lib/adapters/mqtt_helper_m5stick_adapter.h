@@ -7,12 +7,109 @@
 #include <Arduino.h>
 #include <functional>
 #include "../ports/mqtt_helper_port.h"
+#include "../core/mqtt_reassembler.h"
+#include "../core/mqtt_topic_router.h"
+#include "../core/mqtt_outbox.h"
+#include "../core/payload_codec.h"
+#include "../core/backoff.h"
+#include "../deferred_log.h"
+#include "../metrics.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/timers.h>
+#ifdef MQTT_OUTBOX_SPILL
+#include <LittleFS.h>
+#include <esp_attr.h>
+#endif
+
+// Receive pool: split payloads up to MQTT_RX_SLOT_SIZE bytes are reassembled,
+// MQTT_RX_SLOTS of them can be in flight at the same time
+#ifndef MQTT_RX_SLOTS
+#define MQTT_RX_SLOTS 2
+#endif
+#ifndef MQTT_RX_SLOT_SIZE
+#define MQTT_RX_SLOT_SIZE 2048
+#endif
+#ifndef MQTT_RX_TOPIC_MAX
+#define MQTT_RX_TOPIC_MAX 128
+#endif
+
+// Subscription router capacity (MQTT_ROUTER_NODES must be a power of two)
+#ifndef MQTT_ROUTER_FILTERS
+#define MQTT_ROUTER_FILTERS 16
+#endif
+#ifndef MQTT_ROUTER_NODES
+#define MQTT_ROUTER_NODES 64
+#endif
+#ifndef MQTT_ROUTER_POOL
+#define MQTT_ROUTER_POOL 1024
+#endif
+
+// Largest encoded publishJson payload, whatever the encoding
+#ifndef MQTT_PAYLOAD_MAX
+#define MQTT_PAYLOAD_MAX 4096
+#endif
+
+// Reconnect backoff: equal jitter between half and all of base * 2^n, capped
+#ifndef MQTT_RECONNECT_BASE_MS
+#define MQTT_RECONNECT_BASE_MS 1000
+#endif
+#ifndef MQTT_RECONNECT_CAP_MS
+#define MQTT_RECONNECT_CAP_MS 60000
+#endif
+
+// Per-topic payload encodings for publishJson
+#ifndef MQTT_ENCODING_RULES
+#define MQTT_ENCODING_RULES 8
+#endif
+#define MQTT_ENCODING_FILTER_MAX 64
+
+// Outbox for publishes made while offline: MQTT_OUTBOX_SIZE bytes in PSRAM,
+// or the static fallback when there is none. Replayed MQTT_OUTBOX_BURST
+// messages every MQTT_OUTBOX_PACE_MS once connected.
+#ifndef MQTT_OUTBOX_SIZE
+#define MQTT_OUTBOX_SIZE 16384
+#endif
+#ifndef MQTT_OUTBOX_FALLBACK_SIZE
+#define MQTT_OUTBOX_FALLBACK_SIZE 2048
+#endif
+#ifndef MQTT_OUTBOX_PACE_MS
+#define MQTT_OUTBOX_PACE_MS 20
+#endif
+#ifndef MQTT_OUTBOX_BURST
+#define MQTT_OUTBOX_BURST 4
+#endif
+
+static uint8_t mqttOutboxFallback[MQTT_OUTBOX_FALLBACK_SIZE];
+
+// Optional flash spill (-DMQTT_OUTBOX_SPILL): evicted records and the whole
+// outbox before deep sleep go to a LittleFS file replayed ahead of RAM.
+#ifdef MQTT_OUTBOX_SPILL
+#define MQTT_OUTBOX_SPILL_FILE "/mqtt_outbox.bin"
+#ifndef MQTT_OUTBOX_SPILL_MAX
+#define MQTT_OUTBOX_SPILL_MAX  65536
+#endif
+
+// Replay position survives deep sleep so spilled records are not sent twice
+RTC_DATA_ATTR static uint32_t mqttSpillReadPos = 0;
+
+struct MqttSpillHeader {
+    uint8_t  qos;
+    uint8_t  retain;
+    uint16_t topicLen;
+    uint16_t payloadLen;
+};
+#endif
 
-class MQTTHelperM5StickAdapter : public IMQTTHelper {
+class MQTTHelperM5StickAdapter final : public IMQTTHelper {
 public:
     MQTTHelperM5StickAdapter()
         : _host(nullptr), _port(1883), _username(nullptr),
-          _password(nullptr), _autoReconnect(true) {
+          _password(nullptr), _autoReconnect(true), _outboxBuffer(nullptr),
+          _lastReplay(0), _spillCount(0), _encodeErrors(0), _encodingRuleCount(0),
+          _reconnectTimer(nullptr), _userDisconnect(false), _lost(false), _lostAt(0) {
+        _backoff.configure(MQTT_RECONNECT_BASE_MS, MQTT_RECONNECT_CAP_MS);
+        memset(&_reconnect, 0, sizeof(_reconnect));
+        _deviceId[0] = '\0';
         setupDefaultCallbacks();
     }
 
@@ -24,47 +121,153 @@ public:
         _password = pass;
         _client.setServer(_host, _port);
         if (_username && _password) _client.setCredentials(_username, _password);
-        Serial.println("MQTT configured");
+        beginOutbox();
+        if (!_reconnectTimer) {
+            _reconnectTimer = xTimerCreate("mqttReconnect", pdMS_TO_TICKS(MQTT_RECONNECT_BASE_MS),
+                                           pdFALSE, this, reconnectTimerCallback);
+        }
+        DLOG_I(MQTT, MQTT_CONFIGURED, _host, (unsigned)_port);
     }
 
     void connect() override {
+        _userDisconnect = false;
         if (WiFi.status() != WL_CONNECTED) {
-            Serial.println("WiFi not connected. Cannot connect to MQTT.");
+            DLOG_W(MQTT, MQTT_NO_WIFI);
+            scheduleReconnect();
             return;
         }
-        Serial.print("Connecting to MQTT broker: ");
-        Serial.println(_host);
+        DLOG_I(MQTT, MQTT_CONNECTING, _host);
         _client.connect();
     }
 
     void disconnect() override {
+        _userDisconnect = true;
+        if (_reconnectTimer) xTimerStop(_reconnectTimer, 0);
         _client.disconnect();
-        Serial.println("MQTT disconnected");
+        DLOG_I(MQTT, MQTT_DISCONNECTED);
     }
 
     bool isConnected() override { return _client.connected(); }
 
+    // Returns 0 when the message was queued in the outbox instead of sent
     uint16_t publishText(const char* topic, const char* payload,
                          uint8_t qos = 0, bool retain = false) override {
-        if (!isConnected()) { Serial.println("Not connected to MQTT"); return 0; }
-        return _client.publish(topic, qos, retain, payload);
+        return publishRaw(topic, (const uint8_t*)payload, strlen(payload), qos, retain);
     }
 
+    // Encoded as set for the topic (JSON by default). Small documents use the
+    // stack, larger ones up to MQTT_PAYLOAD_MAX a heap buffer sized beforehand;
+    // anything bigger is refused and counted
     uint16_t publishJson(const char* topic, JsonDocument& doc,
                          uint8_t qos = 0, bool retain = false) override {
-        char buffer[512];
-        size_t len = serializeJson(doc, buffer, sizeof(buffer));
-        if (len == 0) { Serial.println("JSON serialization failed"); return 0; }
-        return _client.publish(topic, qos, retain, buffer, len);
+        PayloadEncoding enc    = getEncoding(topic);
+        size_t          needed = measurePayload(doc, enc);
+        if (needed == 0 || needed > MQTT_PAYLOAD_MAX) {
+            _encodeErrors++;
+            Metrics::mqttEncodeErrors.inc();
+            DLOG_E(MQTT, MQTT_PAYLOAD_TOO_LARGE, payloadEncodingName(enc), topic, (unsigned)needed,
+                   (unsigned)MQTT_PAYLOAD_MAX);
+            return 0;
+        }
+
+        uint8_t  stackBuffer[512];
+        uint8_t* buffer = needed < sizeof(stackBuffer) ? stackBuffer : (uint8_t*)malloc(needed + 1);
+        if (!buffer) { _encodeErrors++; Metrics::mqttEncodeErrors.inc(); return 0; }
+        size_t   len = encodePayload(doc, enc, buffer, needed + 1);
+        uint16_t id  = len ? publishRaw(topic, buffer, len, qos, retain) : 0;
+        if (!len) {
+            _encodeErrors++;
+            Metrics::mqttEncodeErrors.inc();
+        }
+        if (buffer != stackBuffer) free(buffer);
+        return id;
+    }
+
+    // Later rules take precedence, e.g. "#" -> CBOR then "status/#" -> JSON
+    void setEncoding(const char* topicFilter, PayloadEncoding encoding) override {
+        if (!mqttFilterIsValid(topicFilter) || strlen(topicFilter) >= MQTT_ENCODING_FILTER_MAX) return;
+        for (uint8_t i = 0; i < _encodingRuleCount; i++) {
+            if (strcmp(_encodingRules[i].filter, topicFilter) == 0) {
+                _encodingRules[i].encoding = encoding;
+                return;
+            }
+        }
+        if (_encodingRuleCount >= MQTT_ENCODING_RULES) return;
+        strcpy(_encodingRules[_encodingRuleCount].filter, topicFilter);
+        _encodingRules[_encodingRuleCount].encoding = encoding;
+        _encodingRuleCount++;
     }
 
+    PayloadEncoding getEncoding(const char* topic) override {
+        for (int i = _encodingRuleCount - 1; i >= 0; i--) {
+            if (mqttTopicMatches(_encodingRules[i].filter, topic)) return _encodingRules[i].encoding;
+        }
+        return PAYLOAD_JSON;
+    }
+
+    uint32_t getEncodeErrors() override { return _encodeErrors; }
+
+    // Paced replay of the outbox, call from loop()
+    void update() override {
+        if (!isConnected()) return;
+        unsigned long now = millis();
+        if (now - _lastReplay < MQTT_OUTBOX_PACE_MS) return;
+        _lastReplay = now;
+
+        for (int i = 0; i < MQTT_OUTBOX_BURST; i++) {
+#ifdef MQTT_OUTBOX_SPILL
+            if (_spillCount > 0) {
+                if (!replaySpilled()) return;
+                continue;
+            }
+#endif
+            MqttOutboxRecord r;
+            if (!_outbox.peek(r)) return;
+            if (!send(r.topic, r.payload, r.length, r.qos, r.retain)) return;  // client busy, next tick
+            _outbox.pop();
+        }
+    }
+
+    void setOutboxPolicy(MqttOutboxPolicy policy) override { _outbox.setPolicy(policy); }
+
+    MqttOutboxStats getOutboxStats() override {
+        MqttOutboxStats s = _outbox.stats(millis());
+        s.spillDepth = _spillCount;
+        return s;
+    }
+
+    // Moves everything queued in RAM to flash, call before deep sleep
+    void persistOutbox() override {
+#ifdef MQTT_OUTBOX_SPILL
+        MqttOutboxRecord r;
+        while (_outbox.peek(r)) {
+            spill(r);
+            _outbox.pop();
+        }
+#endif
+    }
+
+    // Remembered by the router so it is restored on reconnect; messages go
+    // to the onMessage callback only
     uint16_t subscribe(const char* topic, uint8_t qos = 0) override {
-        if (!isConnected()) { Serial.println("Not connected to MQTT"); return 0; }
-        Serial.print("Subscribing to "); Serial.println(topic);
+        _router.subscribe(topic, qos, nullptr);
+        if (!isConnected()) { DLOG_W(MQTT, MQTT_NOT_CONNECTED, topic); return 0; }
+        DLOG_D(MQTT, MQTT_SUBSCRIBING, topic);
         return _client.subscribe(topic, qos);
     }
 
+    bool subscribe(const char* topicFilter, MqttMessageHandler handler, uint8_t qos = 0) override {
+        if (!_router.subscribe(topicFilter, qos, handler)) {
+            DLOG_E(MQTT, MQTT_CANNOT_ROUTE, topicFilter);
+            return false;
+        }
+        if (isConnected()) _client.subscribe(topicFilter, qos);
+        return true;
+    }
+
     uint16_t unsubscribe(const char* topic) override {
+        _router.unsubscribe(topic);
+        if (!isConnected()) return 0;
         return _client.unsubscribe(topic);
     }
 
@@ -72,7 +275,9 @@ public:
         _onConnectCallback = callback;
     }
 
-    void onMessage(std::function<void(char*, char*, size_t)> callback) override {
+    // The view is only valid during the callback and its payload is not
+    // NUL-terminated; copy what must outlive it.
+    void onMessage(std::function<void(const MqttMessageView&)> callback) override {
         _onMessageCallback = callback;
     }
 
@@ -80,8 +285,29 @@ public:
         _onDisconnectCallback = callback;
     }
 
-    void   setAutoReconnect(bool enable) override { _autoReconnect = enable; }
-    String getDeviceId() override { return WiFi.macAddress(); }
+    void setAutoReconnect(bool enable) override {
+        _autoReconnect = enable;
+        if (!enable && _reconnectTimer) xTimerStop(_reconnectTimer, 0);
+    }
+
+    void setReconnectBackoff(uint32_t baseMs, uint32_t capMs) override {
+        portENTER_CRITICAL(&_backoffLock);
+        _backoff.configure(baseMs, capMs);
+        portEXIT_CRITICAL(&_backoffLock);
+    }
+    const ReconnectStats& getReconnectStats() override { return _reconnect; }
+
+    const char* getDeviceId() override {
+        if (!_deviceId[0]) {
+            uint8_t mac[6];
+            WiFi.macAddress(mac);
+            snprintf(_deviceId, sizeof(_deviceId), "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3],
+                     mac[4], mac[5]);
+        }
+        return _deviceId;
+    }
+
+    const MqttRxStats& getRxStats() override { return _rx.stats(); }
 
 private:
     AsyncMqttClient _client;
@@ -90,39 +316,218 @@ private:
     const char*     _username;
     const char*     _password;
     bool            _autoReconnect;
+    char            _deviceId[18];
 
     std::function<void(bool)>                  _onConnectCallback;
-    std::function<void(char*, char*, size_t)>  _onMessageCallback;
+    std::function<void(const MqttMessageView&)> _onMessageCallback;
     std::function<void()>                      _onDisconnectCallback;
 
+    MqttReassembler<MQTT_RX_SLOTS, MQTT_RX_SLOT_SIZE, MQTT_RX_TOPIC_MAX> _rx;
+    MqttTopicRouter<MQTT_ROUTER_FILTERS, MQTT_ROUTER_NODES, MQTT_ROUTER_POOL> _router;
+    MqttOutbox      _outbox;
+    uint8_t*        _outboxBuffer;
+    unsigned long   _lastReplay;
+    uint32_t        _spillCount;
+    uint32_t        _encodeErrors;
+
+    struct EncodingRule {
+        char            filter[MQTT_ENCODING_FILTER_MAX];
+        PayloadEncoding encoding;
+    };
+    EncodingRule    _encodingRules[MQTT_ENCODING_RULES];
+    uint8_t         _encodingRuleCount;
+
+    // Reconnect state machine: a lost connection arms a one-shot timer with
+    // the next backoff delay; the timer callback checks Wi-Fi and calls
+    // connect(); a failed attempt comes back through onDisconnect and re-arms
+    // it. Nothing here blocks the async TCP task. The backoff is stepped from
+    // the timer task, the async TCP task and the loop: always under
+    // _backoffLock, FreeRTOS calls outside of it.
+    TimerHandle_t      _reconnectTimer;
+    ExponentialBackoff _backoff;
+    portMUX_TYPE       _backoffLock = portMUX_INITIALIZER_UNLOCKED;
+    ReconnectStats     _reconnect;
+    volatile bool      _userDisconnect;
+    volatile bool      _lost;
+    unsigned long      _lostAt;
+
+    static void reconnectTimerCallback(TimerHandle_t timer) {
+        static_cast<MQTTHelperM5StickAdapter*>(pvTimerGetTimerID(timer))->attemptReconnect();
+    }
+
+    void scheduleReconnect() {
+        if (!_autoReconnect || _userDisconnect || !_reconnectTimer) return;
+        uint32_t random = esp_random();
+        portENTER_CRITICAL(&_backoffLock);
+        uint32_t delayMs = _backoff.next(random);
+        _reconnect.nextRetryMs = delayMs;
+        portEXIT_CRITICAL(&_backoffLock);
+        xTimerChangePeriod(_reconnectTimer, pdMS_TO_TICKS(delayMs), 0);  // (re)starts the timer
+    }
+
+    // Runs on the timer service task
+    void attemptReconnect() {
+        if (_client.connected() || _userDisconnect) return;
+        if (WiFi.status() != WL_CONNECTED) {  // no point opening a socket yet
+            scheduleReconnect();
+            return;
+        }
+        _reconnect.attempts++;
+        _client.connect();
+    }
+
+    void beginOutbox() {
+        if (_outboxBuffer) return;
+        size_t size   = MQTT_OUTBOX_SIZE;
+        _outboxBuffer = psramFound() ? (uint8_t*)ps_malloc(size) : nullptr;
+        if (!_outboxBuffer) {
+            _outboxBuffer = mqttOutboxFallback;
+            size          = sizeof(mqttOutboxFallback);
+        }
+        _outbox.begin(_outboxBuffer, size, _outbox.policy());
+#ifdef MQTT_OUTBOX_SPILL
+        if (LittleFS.begin(true)) {
+            _spillCount = countSpilled();
+            _outbox.setEvictHandler([this](const MqttOutboxRecord& r) { return spill(r); });
+        }
+#endif
+    }
+
+    // Sends directly only when nothing older is waiting, to keep ordering
+    uint16_t publishRaw(const char* topic, const uint8_t* data, size_t len, uint8_t qos, bool retain) {
+        if (isConnected() && _outbox.empty() && _spillCount == 0) {
+            uint16_t id = send(topic, data, len, qos, retain);
+            if (id) return id;
+        }
+        uint32_t dropped = _outbox.stats(millis()).dropped;
+        _outbox.push(topic, data, len, qos, retain, millis());
+        Metrics::mqttQueued.inc();
+        Metrics::mqttDropped.add(_outbox.stats(millis()).dropped - dropped);
+        return 0;
+    }
+
+    uint16_t send(const char* topic, const uint8_t* data, size_t len, uint8_t qos, bool retain) {
+        // The client falls back to strlen() for a zero length
+        const char* payload = len ? (const char*)data : "";
+        uint16_t    id      = _client.publish(topic, qos, retain, payload, len);
+        if (id) Metrics::mqttPublished.inc();
+        return id;
+    }
+
+#ifdef MQTT_OUTBOX_SPILL
+    bool spill(const MqttOutboxRecord& r) {
+        File f = LittleFS.open(MQTT_OUTBOX_SPILL_FILE, FILE_APPEND, true);
+        if (!f) return false;
+        size_t topicLen = strlen(r.topic);
+        if (f.size() + sizeof(MqttSpillHeader) + topicLen + r.length > MQTT_OUTBOX_SPILL_MAX) {
+            f.close();
+            return false;
+        }
+        MqttSpillHeader h = { r.qos, (uint8_t)r.retain, (uint16_t)topicLen, (uint16_t)r.length };
+        f.write((const uint8_t*)&h, sizeof(h));
+        f.write((const uint8_t*)r.topic, topicLen);
+        f.write(r.payload, r.length);
+        f.close();
+        _spillCount++;
+        return true;
+    }
+
+    uint32_t countSpilled() {
+        File f = LittleFS.open(MQTT_OUTBOX_SPILL_FILE, FILE_READ);
+        if (!f) { mqttSpillReadPos = 0; return 0; }
+        uint32_t count = 0;
+        uint32_t pos   = mqttSpillReadPos;
+        MqttSpillHeader h;
+        while (f.seek(pos) && f.read((uint8_t*)&h, sizeof(h)) == sizeof(h)) {
+            pos += sizeof(h) + h.topicLen + h.payloadLen;
+            if (pos > f.size()) break;
+            count++;
+        }
+        f.close();
+        return count;
+    }
+
+    // Sends the oldest spilled record, the file is removed once fully replayed
+    bool replaySpilled() {
+        File f = LittleFS.open(MQTT_OUTBOX_SPILL_FILE, FILE_READ);
+        MqttSpillHeader h;
+        if (!f || !f.seek(mqttSpillReadPos) || f.read((uint8_t*)&h, sizeof(h)) != sizeof(h)) {
+            if (f) f.close();
+            dropSpill();
+            return true;
+        }
+        uint8_t* record = (uint8_t*)malloc(h.topicLen + 1 + h.payloadLen);
+        if (!record) { f.close(); return false; }
+        size_t body = h.topicLen + h.payloadLen;
+        bool   ok   = f.read(record, h.topicLen) == h.topicLen &&
+                      f.read(record + h.topicLen + 1, h.payloadLen) == h.payloadLen;
+        f.close();
+        record[h.topicLen] = '\0';
+
+        bool sent = ok && send((const char*)record, record + h.topicLen + 1, h.payloadLen, h.qos, h.retain);
+        free(record);
+        if (!ok) { dropSpill(); return true; }
+        if (!sent) return false;
+
+        mqttSpillReadPos += sizeof(h) + body;
+        if (--_spillCount == 0) dropSpill();
+        return true;
+    }
+
+    void dropSpill() {
+        LittleFS.remove(MQTT_OUTBOX_SPILL_FILE);
+        mqttSpillReadPos = 0;
+        _spillCount      = 0;
+    }
+#endif
+
+    // Routed handlers first, then the catch-all callback
+    void deliver(const MqttMessageView& view) {
+        _router.dispatch(view);
+        if (_onMessageCallback) _onMessageCallback(view);
+    }
+
+    void restoreSubscriptions() {
+        _router.forEachFilter([this](const char* filter, uint8_t qos) {
+            _client.subscribe(filter, qos);
+        });
+    }
+
     void setupDefaultCallbacks() {
         _client.onConnect([this](bool sessionPresent) {
-            Serial.println("Connected to MQTT broker");
-            Serial.print(" Session present: ");
-            Serial.println(sessionPresent ? "Yes" : "No");
+            DLOG_I(MQTT, MQTT_CONNECTED, (unsigned)sessionPresent);
+            portENTER_CRITICAL(&_backoffLock);
+            if (_lost) {
+                _lost = false;
+                _reconnect.recordReconnect(millis() - _lostAt);
+            }
+            _backoff.reset();
+            portEXIT_CRITICAL(&_backoffLock);
+            if (!sessionPresent) restoreSubscriptions();
+            _lastReplay = millis() - MQTT_OUTBOX_PACE_MS;  // outbox drains on the next update()
             if (_onConnectCallback) _onConnectCallback(sessionPresent);
         });
 
+        // Also called when a connect attempt fails
         _client.onDisconnect([this](AsyncMqttClientDisconnectReason reason) {
-            Serial.print("Disconnected from MQTT. Reason: ");
-            Serial.println((int)reason);
-            if (_onDisconnectCallback) _onDisconnectCallback();
-            if (_autoReconnect && WiFi.status() == WL_CONNECTED) {
-                Serial.println("Auto-reconnecting in 5 seconds...");
+            _rx.reset();
+            if (!_userDisconnect && !_lost) {
+                _lost   = true;
+                _lostAt = millis();
+                _reconnect.disconnects++;
+                DLOG_W(MQTT, MQTT_LOST, (int)reason);
             }
+            if (_onDisconnectCallback) _onDisconnectCallback();
+            scheduleReconnect();
         });
 
+        // Hot path: runs on the async TCP task, no heap and no Serial here
         _client.onMessage([this](char* topic, char* payload,
                                  AsyncMqttClientMessageProperties props,
                                  size_t len, size_t index, size_t total) {
-            Serial.print("Message received on ");
-            Serial.print(topic); Serial.print(": ");
-            char* message = new char[len + 1];
-            memcpy(message, payload, len);
-            message[len] = '\0';
-            Serial.println(message);
-            if (_onMessageCallback) _onMessageCallback(topic, message, len);
-            delete[] message;
+            MqttMessageProperties p = { props.qos, props.retain, props.dup };
+            auto sink = [this](const MqttMessageView& view) { deliver(view); };
+            _rx.feed(topic, payload, len, index, total, p, millis(), sink);
         });
     }
 };
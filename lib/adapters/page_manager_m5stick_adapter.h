@@ -3,19 +3,24 @@
 
 #include <M5Unified.h>
 #include <Arduino.h>
+#include <esp_timer.h>
 #include "../ports/page_manager_port.h"
 #include "../pages/page_base.h"
+#include "../metrics.h"
 
 #define MAX_PAGES 4
+#define PAGE_INPUT_POLL_US 10000   // longest idle between main loop passes, buttons are polled at that rate
 
-class PageManagerM5StickAdapter : public IPageManager {
+class PageManagerM5StickAdapter final : public IPageManager {
 public:
     PageManagerM5StickAdapter()
         : _pageCount(0), _currentPageIndex(-1), _currentPage(nullptr),
-          _transitionInProgress(false), _lastBtnPWRState(false), _lastBtnBState(false) {}
+          _transitionInProgress(false), _lastBtnPWRState(false), _lastBtnBState(false), _activeSinceUs(0) {}
 
     bool addPage(PageBase* page) override {
         if (_pageCount >= MAX_PAGES) return false;
+        _frameStats[_pageCount].clear();
+        page->setFrameStats(&_frameStats[_pageCount]);
         _pages[_pageCount++] = page;
         return true;
     }
@@ -30,9 +35,11 @@ public:
 
         _transitionInProgress = true;
 
+        int64_t now = esp_timer_get_time();
         if (_currentPage) {
             _currentPage->cleanup();
             _currentPage->setInitialized(false);
+            _frameStats[_currentPageIndex].activeUs += now - _activeSinceUs;
         }
 
         _currentPageIndex = index;
@@ -40,7 +47,14 @@ public:
         _currentPage->setup();
         _currentPage->setInitialized(true);
 
+        // The new page's pacing, first frame right away
+        _activeSinceUs = now;
+        _pacer.setRate(_currentPage->getTargetFps(), now);
+        _pacer.setDeadline(_currentPage->getNextFrameUs());
+        Metrics::frameBudgetUs.set(_pacer.periodUs());
+
         _transitionInProgress = false;
+        Metrics::pageSwitches.inc();
     }
 
     void nextPage() override {
@@ -52,9 +66,28 @@ public:
     }
 
     void update() override {
-        if (_currentPage && !_transitionInProgress) {
-            _currentPage->loop();
+        if (!_currentPage || _transitionInProgress) return;
+        int64_t now = esp_timer_get_time();
+        if (!_pacer.due(now)) return;
+
+        PageFrameStats& stats = _frameStats[_currentPageIndex];
+        uint32_t late = stats.late, dropped = stats.dropped;
+        _currentPage->loop(_pacer.beginFrame(now, stats));
+        Metrics::framesLate.add(stats.late - late);
+        Metrics::framesDropped.add(stats.dropped - dropped);
+
+        // The page may change its rate or ask for a time from one frame to the next
+        uint16_t fps = _currentPage->getTargetFps();
+        if (fps != _pacer.fps()) {
+            _pacer.setRate(fps, now + (fps ? 1000000 / fps : 0));
+            Metrics::frameBudgetUs.set(_pacer.periodUs());
         }
+        _pacer.setDeadline(_currentPage->getNextFrameUs());
+    }
+
+    uint32_t getIdleUs() override {
+        if (!_currentPage || _transitionInProgress) return PAGE_INPUT_POLL_US;
+        return _pacer.idleUs(esp_timer_get_time(), PAGE_INPUT_POLL_US);
     }
 
     void handleInput() override {
@@ -90,6 +123,23 @@ public:
         return _currentPage ? _currentPage->getName() : "None";
     }
 
+    void printFrameStats() override {
+        int64_t now = esp_timer_get_time();
+        char line[80];
+        Serial.println("page       target   fps   frames   late dropped maxlate(ms)");
+        for (int i = 0; i < _pageCount; i++) {
+            int64_t active = _frameStats[i].activeUs + (i == _currentPageIndex ? now - _activeSinceUs : 0);
+            formatFrameStatsRow(_pages[i]->getName(), _pages[i]->getTargetFps(), _frameStats[i], active,
+                                line, sizeof(line));
+            Serial.println(line);
+        }
+    }
+
+    void resetFrameStats() override {
+        for (int i = 0; i < _pageCount; i++) _frameStats[i].clear();
+        _activeSinceUs = esp_timer_get_time();
+    }
+
 private:
     PageBase* _pages[MAX_PAGES];
     int       _pageCount;
@@ -98,6 +148,10 @@ private:
     bool      _transitionInProgress;
     bool      _lastBtnPWRState;
     bool      _lastBtnBState;
+
+    FramePacer     _pacer;          // of the current page
+    PageFrameStats _frameStats[MAX_PAGES];
+    int64_t        _activeSinceUs;  // current page in front since
 };
 
 #endif
@@ -0,0 +1,131 @@
+#ifndef POMODORO_M5STICK_ADAPTER_H
+#define POMODORO_M5STICK_ADAPTER_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <esp_attr.h>
+#include "../ports/pomodoro_port.h"
+#include "../ports/battery_handler_port.h"
+#include "../ports/rtc_utils_port.h"
+#include "../core/pomodoro.h"
+#include "../metrics.h"
+
+#define POMODORO_RTC_MAGIC  0x504F4D4F
+
+// The running cycle lives in RTC slow memory. NVS only holds the config,
+// read on cold boot, and the lifetime stats, written in batches.
+struct PomodoroRtcState {
+    uint32_t      magic;
+    PomodoroCycle cycle;
+};
+
+RTC_DATA_ATTR static PomodoroRtcState pomodoroRtc;
+
+class PomodoroM5StickAdapter final : public IPomodoro {
+public:
+    PomodoroM5StickAdapter(BatteryHandlerT* battery, RtcUtilsT* rtc)
+        : _battery(battery), _rtc(rtc) {}
+
+    void begin() override {
+        if (pomodoroRtc.magic != POMODORO_RTC_MAGIC) {
+            PomodoroConfig config = POMODORO_DEFAULT_CONFIG;
+            _prefs.begin("pomodoro", true);
+            _prefs.getBytes("config", &config, sizeof(config));
+            _prefs.end();
+            pomodoroRtc.cycle.reset(config);
+            pomodoroRtc.magic = POMODORO_RTC_MAGIC;
+        }
+        update();
+    }
+
+    uint16_t update() override {
+        PomodoroCycle& c = pomodoroRtc.cycle;
+        if (!c.active()) return 0;
+        uint16_t ended = c.advance(_rtc->epochNow());
+        if (c.statsDue()) flushStats();
+        return ended;
+    }
+
+    void start() override {
+        pomodoroRtc.cycle.start(_rtc->epochNow());
+    }
+
+    void stop() override {
+        pomodoroRtc.cycle.stop(_rtc->epochNow());
+        flushStats();
+    }
+
+    bool isActive() override { return pomodoroRtc.cycle.active(); }
+    uint8_t getPhase() override { return pomodoroRtc.cycle.phase; }
+    uint32_t getRemaining() override { return pomodoroRtc.cycle.remaining(_rtc->epochNow()); }
+    const PomodoroCycle& getCycle() override { return pomodoroRtc.cycle; }
+
+    void setConfig(const PomodoroConfig& config) override {
+        pomodoroRtc.cycle.configure(config);
+        _prefs.begin("pomodoro", false);
+        _prefs.putBytes("config", &pomodoroRtc.cycle.config, sizeof(PomodoroConfig));
+        _prefs.end();
+        Metrics::nvsCommits.inc();
+    }
+
+    const PomodoroConfig& getConfig() override { return pomodoroRtc.cycle.config; }
+
+    void sleepUntilPhaseEnd() override {
+        sleepUntilPhaseEnd(_rtc->epochNow());
+    }
+
+    void sleepUntilPhaseEnd(uint32_t now) override {
+        PomodoroCycle& c = pomodoroRtc.cycle;
+        if (c.active()) c.advance(now);
+        if (c.statsDue()) flushStats();
+        uint32_t remain = c.remaining(now);
+        if (!remain) remain = 1;
+        _battery->deepSleep((uint64_t)remain * 1000000ULL);
+    }
+
+    void flushStats() override {
+        PomodoroStats& pending = pomodoroRtc.cycle.pending;
+        if (!pending.workSessions && !pending.workMinutes && !pending.interrupted) return;
+        PomodoroStats total = readStats();
+        total.add(pending);
+        _prefs.begin("pomodoro", false);
+        _prefs.putBytes("stats", &total, sizeof(total));
+        _prefs.end();
+        Metrics::nvsCommits.inc();
+        pending.clear();
+    }
+
+    void printStats() override {
+        const PomodoroCycle& c = pomodoroRtc.cycle;
+        PomodoroStats total = readStats();
+        total.add(c.pending);
+        Serial.printf("pomodoro: %s", pomodoroPhaseName(c.phase));
+        if (c.active()) {
+            uint32_t remain = getRemaining();
+            Serial.printf(" %u/%u, %02u:%02u left", c.session(), c.config.cycles,
+                          (unsigned)(remain / 60), (unsigned)(remain % 60));
+        }
+        Serial.printf("\nconfig: %u/%u/%u min, long break every %u\n", c.config.workMin,
+                      c.config.shortBreakMin, c.config.longBreakMin, c.config.cycles);
+        Serial.printf("lifetime: %lu sessions, %lu min, %lu long breaks, %lu interrupted (%lu not flushed)\n",
+                      (unsigned long)total.workSessions, (unsigned long)total.workMinutes,
+                      (unsigned long)total.longBreaks, (unsigned long)total.interrupted,
+                      (unsigned long)c.pending.workSessions);
+    }
+
+private:
+    BatteryHandlerT* _battery;
+    RtcUtilsT*       _rtc;
+    Preferences      _prefs;
+
+    PomodoroStats readStats() {
+        PomodoroStats s;
+        s.clear();
+        _prefs.begin("pomodoro", true);
+        _prefs.getBytes("stats", &s, sizeof(s));
+        _prefs.end();
+        return s;
+    }
+};
+
+#endif
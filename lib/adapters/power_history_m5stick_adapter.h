@@ -0,0 +1,204 @@
+#ifndef POWER_HISTORY_M5STICK_ADAPTER_H
+#define POWER_HISTORY_M5STICK_ADAPTER_H
+
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <esp_sleep.h>
+#include <esp_partition.h>
+#include "../ports/power_history_port.h"
+#include "../ports/battery_handler_port.h"
+#include "../ports/rtc_utils_port.h"
+#include "../core/power_history_codec.h"
+
+// Dedicated data partition declared in partitions.csv
+#define POWER_HISTORY_PARTITION   "powerlog"
+#define POWER_HISTORY_SECTOR_SIZE 4096
+#define POWER_HISTORY_RTC_MAGIC   0x50484C47
+
+// Staged page + delta state. Lives in RTC slow memory so samples taken
+// between deep sleeps accumulate without touching flash until a page is full.
+struct PowerHistoryRtcState {
+    uint32_t            magic;
+    PowerHistoryEncoder encoder;
+};
+
+RTC_DATA_ATTR static PowerHistoryRtcState powerHistoryRtc;
+
+class PowerHistoryM5StickAdapter final : public IPowerHistory {
+public:
+    PowerHistoryM5StickAdapter(BatteryHandlerT* battery, RtcUtilsT* rtc, uint32_t sampleIntervalMs = 60000)
+        : _battery(battery), _rtc(rtc), _partition(nullptr), _pageCount(0),
+          _lastSample(0), _sampleInterval(sampleIntervalMs), _lastCharging(false) {}
+
+    // Call after the battery handler begin() so the first sample is valid
+    void begin() override {
+        if (!attach()) return;
+
+        esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+        recordEvent(cause == ESP_SLEEP_WAKEUP_UNDEFINED ? POWER_EVENT_BOOT : POWER_EVENT_WAKE, (uint8_t)cause);
+
+        _lastCharging = _battery->isCharging();
+        sample();
+    }
+
+    void update() override {
+        if (!_partition) return;
+
+        bool charging = _battery->isCharging();
+        if (charging != _lastCharging) {
+            _lastCharging = charging;
+            recordEvent(charging ? POWER_EVENT_CHARGE_START : POWER_EVENT_CHARGE_STOP);
+        }
+
+        if (millis() - _lastSample >= _sampleInterval) sample();
+    }
+
+    void recordEvent(uint8_t event, uint8_t arg = 0) override {
+        if (!_partition) return;
+        recordEventAt(_rtc->epochNow(), event, arg);
+    }
+
+    void recordEventAt(uint32_t epoch, uint8_t event, uint8_t arg = 0) override {
+        if (!attach()) return;
+        PowerHistoryEncoder& enc = powerHistoryRtc.encoder;
+        if (!enc.appendEvent(epoch, event, arg)) {
+            writePage();
+            enc.appendEvent(epoch, event, arg);
+        }
+    }
+
+    void clear() override {
+        if (!_partition) return;
+        esp_partition_erase_range(_partition, 0, _partition->size);
+        powerHistoryRtc.encoder.startPage(0);
+    }
+
+    void exportCsv() override {
+        if (!_partition) { Serial.println("No powerlog partition"); return; }
+        Serial.println(POWER_HISTORY_CSV_HEADER);
+
+        uint8_t page[POWER_HISTORY_PAGE_SIZE];
+        char    line[96];
+        uint32_t next = powerHistoryRtc.encoder.sequence();
+        for (uint32_t seq = firstSequence(); seq <= next; seq++) {
+            const uint8_t* src = powerHistoryRtc.encoder.page;
+            if (seq < next) {
+                if (!readPage(seq, page)) continue;
+                src = page;
+            }
+            PowerHistoryDecoder dec(src, POWER_HISTORY_PAGE_SIZE);
+            PowerHistoryEntry e;
+            while (dec.next(e)) {
+                if (formatPowerHistoryCsv(e, line, sizeof(line)) > 0) Serial.println(line);
+            }
+        }
+    }
+
+    // Raw pages framed by a text header, decoded host-side with the same codec
+    void exportBinary() override {
+        if (!_partition) { Serial.println("No powerlog partition"); return; }
+
+        uint8_t page[POWER_HISTORY_PAGE_SIZE];
+        uint32_t next  = powerHistoryRtc.encoder.sequence();
+        uint32_t first = firstSequence();
+        uint32_t count = 0;
+        for (uint32_t seq = first; seq < next; seq++) {
+            if (readPage(seq, page)) count++;
+        }
+
+        Serial.printf("PHBIN %u %u\n", (unsigned)(count + 1), (unsigned)POWER_HISTORY_PAGE_SIZE);
+        for (uint32_t seq = first; seq < next; seq++) {
+            if (readPage(seq, page)) Serial.write(page, POWER_HISTORY_PAGE_SIZE);
+        }
+        Serial.write(powerHistoryRtc.encoder.page, POWER_HISTORY_PAGE_SIZE);
+        Serial.println("PHEND");
+    }
+
+    uint32_t getStoredPages() override {
+        uint32_t next = powerHistoryRtc.encoder.sequence();
+        return next - firstSequence();
+    }
+
+    uint32_t getCapacityPages() override { return _pageCount; }
+
+private:
+    BatteryHandlerT*       _battery;
+    RtcUtilsT*             _rtc;
+    const esp_partition_t* _partition;
+    uint32_t               _pageCount;
+    unsigned long          _lastSample;
+    uint32_t               _sampleInterval;
+    bool                   _lastCharging;
+
+    // Partition and staged page only, no battery or RTC access
+    bool attach() {
+        if (_partition) return true;
+        _partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY,
+                                              POWER_HISTORY_PARTITION);
+        if (!_partition) return false;
+        _pageCount = _partition->size / POWER_HISTORY_PAGE_SIZE;
+
+        if (powerHistoryRtc.magic != POWER_HISTORY_RTC_MAGIC) {
+            // Cold boot: RTC memory is gone, resume after the newest flashed page
+            memset(&powerHistoryRtc, 0, sizeof(powerHistoryRtc));
+            powerHistoryRtc.encoder.startPage(findNextSequence());
+            powerHistoryRtc.magic = POWER_HISTORY_RTC_MAGIC;
+        }
+        return true;
+    }
+
+    void sample() {
+        _lastSample = millis();
+        PowerHistoryEncoder& enc = powerHistoryRtc.encoder;
+        uint32_t now     = _rtc->epochNow();
+        int32_t  level   = _battery->getLevel();
+        int32_t  voltage = _battery->getVoltage();
+        int32_t  current = _battery->getCurrent();
+        bool     charge  = _battery->isCharging();
+        if (!enc.appendSample(now, level, voltage, current, charge)) {
+            writePage();
+            enc.appendSample(now, level, voltage, current, charge);
+        }
+    }
+
+    // Only place that writes flash: one full page at a time, erasing the
+    // sector ahead when the ring enters it.
+    void writePage() {
+        PowerHistoryEncoder& enc = powerHistoryRtc.encoder;
+        uint32_t seq    = enc.sequence();
+        uint32_t offset = (seq % _pageCount) * POWER_HISTORY_PAGE_SIZE;
+        if (offset % POWER_HISTORY_SECTOR_SIZE == 0) {
+            esp_partition_erase_range(_partition, offset, POWER_HISTORY_SECTOR_SIZE);
+        }
+        esp_partition_write(_partition, offset, enc.page, POWER_HISTORY_PAGE_SIZE);
+        enc.startPage(seq + 1);
+    }
+
+    bool readPage(uint32_t seq, uint8_t* page) {
+        uint32_t offset = (seq % _pageCount) * POWER_HISTORY_PAGE_SIZE;
+        if (esp_partition_read(_partition, offset, page, POWER_HISTORY_PAGE_SIZE) != ESP_OK) return false;
+        PowerHistoryDecoder dec(page, POWER_HISTORY_PAGE_SIZE);
+        return dec.isValid() && dec.sequence() == seq;
+    }
+
+    uint32_t firstSequence() {
+        uint32_t next = powerHistoryRtc.encoder.sequence();
+        return next > _pageCount ? next - _pageCount : 0;
+    }
+
+    // Scans page headers only (8 bytes each) to find where the ring resumes
+    uint32_t findNextSequence() {
+        uint32_t next = 0;
+        uint8_t  header[POWER_HISTORY_HEADER_SIZE];
+        for (uint32_t slot = 0; slot < _pageCount; slot++) {
+            if (esp_partition_read(_partition, slot * POWER_HISTORY_PAGE_SIZE,
+                                   header, sizeof(header)) != ESP_OK) continue;
+            if (power_codec::getU16(header) != POWER_HISTORY_MAGIC) continue;
+            uint32_t seq = power_codec::getU32(header + 2);
+            if (seq % _pageCount == slot && seq + 1 > next) next = seq + 1;
+        }
+        return next;
+    }
+};
+
+#endif
@@ -5,7 +5,7 @@
 #include <Arduino.h>
 #include "../ports/rtc_utils_port.h"
 
-class RtcUtilsM5StickAdapter : public IRtcUtils {
+class RtcUtilsM5StickAdapter final : public IRtcUtils {
 public:
     uint32_t epochNow() override {
         m5::rtc_datetime_t dt;
@@ -0,0 +1,97 @@
+#ifndef TELEMETRY_M5STICK_ADAPTER_H
+#define TELEMETRY_M5STICK_ADAPTER_H
+
+#include <Arduino.h>
+#include "../ports/telemetry_port.h"
+#include "../ports/mqtt_helper_port.h"
+#include "../ports/rtc_utils_port.h"
+#include "../core/telemetry_batch.h"
+
+// Upper bound of one batch payload
+#ifndef TELEMETRY_BATCH_SIZE
+#define TELEMETRY_BATCH_SIZE 1024
+#endif
+
+// Collects samples for one flush window and publishes them as a single MQTT
+// message. The payload goes through the MQTT outbox, so a batch flushed while
+// offline is sent on the next connection.
+class TelemetryM5StickAdapter final : public ITelemetry {
+public:
+    TelemetryM5StickAdapter(MQTTHelperT* mqtt, RtcUtilsT* rtc, const char* topic,
+                            uint32_t windowMs = 60000, uint8_t qos = 0)
+        : _mqtt(mqtt), _rtc(rtc), _topic(topic), _window(windowMs), _qos(qos) {
+        memset(&_stats, 0, sizeof(_stats));
+    }
+
+    void begin() override {
+        _batch.reset();
+    }
+
+    // Age trigger: the window starts with the first sample of the batch
+    void update() override {
+        if (!_batch.empty() && millis() - _batch.firstMs() >= _window) {
+            publish(TELEMETRY_FLUSH_AGE);
+        }
+    }
+
+    bool add(const char* key, float value) override {
+        unsigned long now = millis();
+        TelemetryAddResult r = _batch.add(now, _rtc->epochNow(), key, value);
+        if (r == TELEMETRY_FULL) {
+            publish(TELEMETRY_FLUSH_SIZE);
+            r = _batch.add(now, _rtc->epochNow(), key, value);
+        }
+        if (r != TELEMETRY_ADDED) {
+            _stats.dropped++;
+            return false;
+        }
+        _stats.samples++;
+        return true;
+    }
+
+    bool flush() override { return publish(TELEMETRY_FLUSH_MANUAL); }
+
+    // Last chance before deep sleep: PSRAM is lost, so also persist the outbox
+    void flushBeforeSleep() override {
+        publish(TELEMETRY_FLUSH_SLEEP);
+        _mqtt->persistOutbox();
+    }
+
+    TelemetryStats getStats() override { return _stats; }
+
+    void printReport() override {
+        Serial.println("=== Telemetry ===");
+        Serial.printf("Samples: %u (dropped %u), pending %u\n", (unsigned)_stats.samples,
+                      (unsigned)_stats.dropped, (unsigned)_batch.samples());
+        Serial.printf("Packets: %u, saved %u\n", (unsigned)_stats.packets, (unsigned)_stats.packetsSaved());
+        Serial.printf("Bytes: %u, %.1f bytes/sample\n", (unsigned)_stats.bytes, _stats.bytesPerSample());
+        Serial.printf("Flushes size/age/sleep/manual: %u/%u/%u/%u\n",
+                      (unsigned)_stats.flushes[TELEMETRY_FLUSH_SIZE], (unsigned)_stats.flushes[TELEMETRY_FLUSH_AGE],
+                      (unsigned)_stats.flushes[TELEMETRY_FLUSH_SLEEP], (unsigned)_stats.flushes[TELEMETRY_FLUSH_MANUAL]);
+        Serial.println("=================");
+    }
+
+private:
+    MQTTHelperT*    _mqtt;
+    RtcUtilsT*      _rtc;
+    const char*     _topic;
+    uint32_t        _window;
+    uint8_t         _qos;
+    TelemetryStats  _stats;
+    TelemetryBatch<TELEMETRY_BATCH_SIZE> _batch;
+
+    bool publish(TelemetryFlushReason reason) {
+        size_t      len;
+        const char* payload = _batch.finish(&len);
+        if (!payload) return false;
+
+        _mqtt->publishText(_topic, payload, _qos, false);
+        _stats.packets++;
+        _stats.bytes += len;
+        _stats.flushes[reason]++;
+        _batch.reset();
+        return true;
+    }
+};
+
+#endif
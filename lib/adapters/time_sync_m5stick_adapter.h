@@ -0,0 +1,284 @@
+#ifndef TIME_SYNC_M5STICK_ADAPTER_H
+#define TIME_SYNC_M5STICK_ADAPTER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include <Preferences.h>
+#include <esp_attr.h>
+#include <time.h>
+#include "../ports/time_sync_port.h"
+#include "../ports/rtc_utils_port.h"
+#include "../core/sntp.h"
+#include "../core/rtc_drift.h"
+#include "../deferred_log.h"
+#include "../metrics.h"
+
+#define TIME_SYNC_RTC_MAGIC        0x54535943
+#define NTP_SAMPLES                4      // best (lowest delay) of N exchanges
+#define NTP_REPLY_TIMEOUT_MS       1000
+#define NTP_LOCAL_PORT             2390
+#define TIME_SYNC_EDGE_TIMEOUT_MS  1500
+#define TIME_SYNC_STEP_CHECK_MS    10000
+#define TIME_SYNC_RETRY_S          300
+
+// Drift estimate and schedule survive deep sleep, the ppm also goes to NVS
+struct TimeSyncRtcState {
+    uint32_t          magic;
+    RtcDriftEstimator drift;
+    TimeSyncStats     stats;
+};
+
+RTC_DATA_ATTR static TimeSyncRtcState timeSyncRtc;
+
+// The BM8563 only counts whole seconds. Sub-second accuracy comes from
+// timing everything against a seconds edge: the RTC is polled until its
+// seconds change, the edge is stamped with millis(), and the RTC reading at
+// any later millis() is edge + elapsed. The RTC is then written right on the
+// next true second boundary.
+class TimeSyncM5StickAdapter final : public ITimeSync {
+public:
+    TimeSyncM5StickAdapter(RtcUtilsT* rtc, const char* server = "pool.ntp.org")
+        : _rtc(rtc), _server(server), _port(123), _utcOffset(0), _maxErrorMs(500),
+          _phase(TS_IDLE), _forStep(false), _requested(false), _lastStepCheck(0) {}
+
+    void begin() override {
+        if (timeSyncRtc.magic == TIME_SYNC_RTC_MAGIC) return;
+        memset(&timeSyncRtc, 0, sizeof(timeSyncRtc));
+        timeSyncRtc.magic = TIME_SYNC_RTC_MAGIC;
+        timeSyncRtc.drift.reset();
+
+        // Cold boot: the crystal did not change, its drift is still a good prior
+        _prefs.begin("timesync", true);
+        if (_prefs.isKey("ppm")) {
+            timeSyncRtc.drift.ppm       = _prefs.getFloat("ppm", 0);
+            timeSyncRtc.drift.spreadPpm = _prefs.getFloat("spread", 2.0f);
+            timeSyncRtc.drift.samples   = 1;
+        }
+        _prefs.end();
+    }
+
+    void update() override {
+        switch (_phase) {
+            case TS_IDLE:
+                if (WiFi.status() == WL_CONNECTED && (_requested || isSyncDue())) {
+                    _requested = false;
+                    startEdge(false);
+                } else if (millis() - _lastStepCheck >= TIME_SYNC_STEP_CHECK_MS) {
+                    _lastStepCheck = millis();
+                    if (timeSyncRtc.drift.dueStepMs(utcNowMs()) != 0) startEdge(true);
+                }
+                break;
+            case TS_EDGE:
+                pollEdge();
+                break;
+            case TS_QUERY:
+                pollQuery();
+                break;
+            case TS_ALIGN:
+                if ((int32_t)(millis() - _alignAt) >= 0) {
+                    setRtcUtc(_alignSecond);
+                    finishSync();
+                }
+                break;
+        }
+    }
+
+    void setServer(const char* host, uint16_t port = 123) override {
+        _server = host;
+        _port   = port;
+    }
+
+    void setUtcOffset(int32_t seconds) override { _utcOffset = seconds; }
+    void setMaxErrorMs(uint32_t ms) override { _maxErrorMs = ms; }
+
+    void onRtcSet(std::function<void()> callback) override { _onRtcSet = callback; }
+
+    void requestSync() override { _requested = true; }
+
+    bool isSyncDue() override {
+        return (uint32_t)(utcNowMs() / 1000) >= timeSyncRtc.stats.nextSyncEpoch;
+    }
+
+    bool isSyncing() override { return _phase != TS_IDLE && !_forStep; }
+
+    const TimeSyncStats&     getStats() override { return timeSyncRtc.stats; }
+    const RtcDriftEstimator& getDrift() override { return timeSyncRtc.drift; }
+
+    void printReport() override {
+        const TimeSyncStats&     s = timeSyncRtc.stats;
+        const RtcDriftEstimator& d = timeSyncRtc.drift;
+        int32_t nextIn = (int32_t)(s.nextSyncEpoch - (uint32_t)(utcNowMs() / 1000));
+        Serial.println("=== Time sync ===");
+        Serial.printf("Server: %s:%u\n", _server, (unsigned)_port);
+        Serial.printf("Syncs: %u (failed %u), drift steps: %u\n", (unsigned)s.syncs, (unsigned)s.failures,
+                      (unsigned)s.corrections);
+        Serial.printf("Last: offset %d ms, delay %u ms\n", (int)s.lastOffsetMs, (unsigned)s.lastDelayMs);
+        Serial.printf("Drift: %.2f ppm (+-%.2f, %u samples), predicted error now %d ms\n", d.ppm, d.spreadPpm,
+                      (unsigned)d.samples, (int)d.predictedErrorMs(utcNowMs()));
+        Serial.printf("Next sync in %d s\n", (int)(nextIn > 0 ? nextIn : 0));
+        Serial.println("=================");
+    }
+
+private:
+    enum Phase { TS_IDLE, TS_EDGE, TS_QUERY, TS_ALIGN };
+
+    RtcUtilsT*    _rtc;
+    const char*   _server;
+    uint16_t      _port;
+    int32_t       _utcOffset;
+    uint32_t      _maxErrorMs;
+    Phase         _phase;
+    bool          _forStep;      // edge wanted for a drift step, not a sync
+    bool          _requested;
+    unsigned long _lastStepCheck;
+    unsigned long _phaseStart;
+    Preferences   _prefs;
+    WiFiUDP       _udp;
+    std::function<void()> _onRtcSet;
+
+    // Seconds edge: RTC read exactly _edgeUtc at millis() == _edgeMillis
+    uint8_t       _edgeSecond;
+    uint32_t      _edgeMillis;
+    uint32_t      _edgeUtc;
+
+    uint8_t       _request[NTP_PACKET_SIZE];
+    int64_t       _t1;
+    uint32_t      _sentAt;
+    uint8_t       _sent;
+    bool          _gotSample;
+    NtpSample     _best;
+
+    int64_t       _syncTrueMs;
+    uint32_t      _alignSecond;
+    uint32_t      _alignAt;
+
+    int64_t utcNowMs() { return ((int64_t)_rtc->epochNow() - _utcOffset) * 1000; }
+
+    int64_t rtcMsAt(uint32_t ms) const { return (int64_t)_edgeUtc * 1000 + (int32_t)(ms - _edgeMillis); }
+
+    void setRtcUtc(uint32_t utc) {
+        time_t    t = (time_t)utc + _utcOffset;
+        struct tm tmv;
+        gmtime_r(&t, &tmv);
+        _rtc->setDateTime(tmv.tm_hour, tmv.tm_min, tmv.tm_sec, tmv.tm_year + 1900, tmv.tm_mon + 1, tmv.tm_mday,
+                          tmv.tm_wday);
+        if (_onRtcSet) _onRtcSet();
+    }
+
+    void startEdge(bool forStep) {
+        _forStep    = forStep;
+        _edgeSecond = _rtc->getSeconds();
+        _phaseStart = millis();
+        _phase      = TS_EDGE;
+    }
+
+    void pollEdge() {
+        if (_rtc->getSeconds() == _edgeSecond) {
+            if (millis() - _phaseStart <= TIME_SYNC_EDGE_TIMEOUT_MS) return;
+            if (_forStep) _phase = TS_IDLE;  // RTC not ticking
+            else          fail();
+            _forStep = false;
+            return;
+        }
+        _edgeMillis = millis();
+        _edgeUtc    = (uint32_t)(utcNowMs() / 1000);
+
+        if (_forStep) {
+            applyStep();
+            return;
+        }
+        _udp.begin(NTP_LOCAL_PORT);
+        _sent      = 0;
+        _gotSample = false;
+        _phase     = TS_QUERY;
+        sendRequest();
+    }
+
+    void applyStep() {
+        RtcDriftEstimator& d = timeSyncRtc.drift;
+        int32_t step = d.dueStepMs(rtcMsAt(_edgeMillis));
+        if (step != 0) {
+            setRtcUtc(_edgeUtc + step / 1000);
+            d.applied(step);
+            timeSyncRtc.stats.corrections++;
+        }
+        _phase   = TS_IDLE;
+        _forStep = false;
+    }
+
+    void sendRequest() {
+        _sentAt = millis();
+        _t1     = rtcMsAt(_sentAt);
+        ntpBuildRequest(_request, _t1);
+        _udp.beginPacket(_server, _port);
+        _udp.write(_request, NTP_PACKET_SIZE);
+        _udp.endPacket();
+        _sent++;
+    }
+
+    void pollQuery() {
+        int n = _udp.parsePacket();
+        if (n > 0) {
+            uint8_t  pkt[NTP_PACKET_SIZE];
+            uint32_t now = millis();
+            int      len = _udp.read(pkt, sizeof(pkt));
+            NtpReply reply;
+            if (len > 0 && ntpParseReply(pkt, (size_t)len, _request, reply)) {
+                NtpSample s = ntpComputeSample(_t1, reply.receiveMs, reply.transmitMs, rtcMsAt(now));
+                if (!_gotSample || s.delayMs < _best.delayMs) _best = s;
+                _gotSample = true;
+                nextOrDone();
+            }
+            return;
+        }
+        if (millis() - _sentAt > NTP_REPLY_TIMEOUT_MS) nextOrDone();
+    }
+
+    void nextOrDone() {
+        if (_sent < NTP_SAMPLES) {
+            sendRequest();
+            return;
+        }
+        _udp.stop();
+        if (!_gotSample) {
+            fail();
+            return;
+        }
+        // Write the RTC on the next true second boundary
+        uint32_t now = millis();
+        _syncTrueMs  = rtcMsAt(now) + _best.offsetMs;
+        _alignSecond = (uint32_t)(_syncTrueMs / 1000) + 1;
+        _alignAt     = now + (uint32_t)((int64_t)_alignSecond * 1000 - _syncTrueMs);
+        _phase       = TS_ALIGN;
+    }
+
+    void finishSync() {
+        RtcDriftEstimator& d = timeSyncRtc.drift;
+        TimeSyncStats&     s = timeSyncRtc.stats;
+        if (d.onSync(_syncTrueMs, (int32_t)_best.offsetMs)) {
+            _prefs.begin("timesync", false);
+            _prefs.putFloat("ppm", d.ppm);
+            _prefs.putFloat("spread", d.spreadPpm);
+            _prefs.end();
+            Metrics::nvsCommits.inc();
+        }
+        s.syncs++;
+        s.lastOffsetMs  = (int32_t)_best.offsetMs;
+        s.lastDelayMs   = (uint32_t)_best.delayMs;
+        s.lastSyncEpoch = (uint32_t)(_syncTrueMs / 1000);
+        s.nextSyncEpoch = s.lastSyncEpoch + d.resyncIntervalS(_maxErrorMs);
+        _phase = TS_IDLE;
+        DLOG_I(TIME, TIME_SYNCED, (int)s.lastOffsetMs, (unsigned)s.lastDelayMs);
+    }
+
+    void fail() {
+        _udp.stop();
+        timeSyncRtc.stats.failures++;
+        timeSyncRtc.stats.nextSyncEpoch = (uint32_t)(utcNowMs() / 1000) + TIME_SYNC_RETRY_S;
+        _phase   = TS_IDLE;
+        _forStep = false;
+    }
+};
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef UPLINK_M5STICK_ADAPTER_H
+#define UPLINK_M5STICK_ADAPTER_H
+
+#include <Arduino.h>
+#include <esp_attr.h>
+#include "../ports/uplink_port.h"
+#include "../ports/mqtt_helper_port.h"
+#include "../ports/battery_handler_port.h"
+#include "../ports/rtc_utils_port.h"
+#include "../ports/time_sync_port.h"
+#include "../core/uplink_window.h"
+#include "../wifi_helper.h"
+
+#define UPLINK_RTC_MAGIC  0x55504C4B
+
+// Last window and totals survive deep sleep, the cadence is kept across wakes
+struct UplinkRtcState {
+    uint32_t           magic;
+    uint32_t           lastWindowEpoch;
+    UplinkWindowRecord last;
+    UplinkStats        stats;
+};
+
+RTC_DATA_ATTR static UplinkRtcState uplinkRtc;
+
+// Wi-Fi (best known network) and MQTT are only up during a window. The MQTT
+// helper must have been begin()'d; its outbox holds what is published between
+// windows. Closing the window powers the radio down with cutAllNonCore(),
+// which also sleeps the display: meant for units that go back to sleep.
+class UplinkM5StickAdapter final : public IUplinkScheduler {
+public:
+    UplinkM5StickAdapter(MQTTHelperT* mqtt, BatteryHandlerT* battery, RtcUtilsT* rtc)
+        : _mqtt(mqtt), _battery(battery), _rtc(rtc), _timeSync(nullptr), _manual(false), _wifiFailed(false) {
+        UplinkPolicy policy = { 900, 4096, 8000, 500 };
+        _window.setPolicy(policy);
+    }
+
+    void begin() override {
+        if (uplinkRtc.magic != UPLINK_RTC_MAGIC) {
+            memset(&uplinkRtc, 0, sizeof(uplinkRtc));
+            uplinkRtc.magic = UPLINK_RTC_MAGIC;
+        }
+    }
+
+    void update() override {
+        // The time sync is driven from here only: drift steps between
+        // windows, the sync itself inside one
+        if (_timeSync) _timeSync->update();
+
+        if (!_window.isOpen()) {
+            MqttOutboxStats q = _mqtt->getOutboxStats();
+            UplinkTrigger t = _manual ? UPLINK_TRIGGER_MANUAL
+                                      : uplinkWindowDue(_window.policy(), _rtc->epochNow(),
+                                                        uplinkRtc.lastWindowEpoch, q.bytesUsed);
+            if (t != UPLINK_TRIGGER_NONE) open(t, q.depth + q.spillDepth);
+            return;
+        }
+
+        WiFiHelper::update();
+        MqttOutboxStats q = _mqtt->getOutboxStats();
+        uint32_t pending = q.depth + q.spillDepth;
+        if (_wifiFailed) {
+            act(_window.fail(millis(), UPLINK_NO_WIFI, pending));
+            return;
+        }
+        // A due or running time sync holds the window like a queued message
+        if (_timeSync && (_timeSync->isSyncing() || (WiFiHelper::isConnected() && _timeSync->isSyncDue()))) {
+            pending++;
+        }
+        act(_window.step(millis(), WiFiHelper::isConnected(), _mqtt->isConnected(), pending));
+    }
+
+    void setPolicy(const UplinkPolicy& policy) override { _window.setPolicy(policy); }
+
+    void openWindow() override { _manual = true; }
+
+    bool isWindowOpen() override { return _window.isOpen() || _manual; }
+
+    void setTimeSync(ITimeSync* timeSync) override { _timeSync = timeSync; }
+
+    uint32_t secondsUntilNextWindow() override {
+        return uplinkSecondsUntilDue(_window.policy(), _rtc->epochNow(), uplinkRtc.lastWindowEpoch);
+    }
+
+    void onWindowClosed(std::function<void(const UplinkWindowRecord&)> callback) override {
+        _onClosed = callback;
+    }
+
+    const UplinkWindowRecord& getLastWindow() override { return uplinkRtc.last; }
+    const UplinkStats&        getStats() override { return uplinkRtc.stats; }
+
+    void printReport() override {
+        const UplinkStats&        s = uplinkRtc.stats;
+        const UplinkWindowRecord& w = uplinkRtc.last;
+        Serial.println("=== Uplink ===");
+        Serial.printf("Windows: %u (ok %u, no wifi %u, no mqtt %u, budget %u)\n", (unsigned)s.windows,
+                      (unsigned)s.outcomes[UPLINK_OK], (unsigned)s.outcomes[UPLINK_NO_WIFI],
+                      (unsigned)s.outcomes[UPLINK_NO_MQTT], (unsigned)s.outcomes[UPLINK_BUDGET]);
+        Serial.printf("Radio on: avg %u ms, max %u ms, total %u s, budget %u ms\n",
+                      (unsigned)s.averageRadioOnMs(), (unsigned)s.maxRadioOnMs,
+                      (unsigned)(s.totalRadioOnMs / 1000), (unsigned)_window.policy().budgetMs);
+        if (s.windows) {
+            Serial.printf("Last: %s, %s, radio %u ms (wifi %u, mqtt %u), queue %u -> %u\n",
+                          uplinkTriggerName(w.trigger), uplinkOutcomeName(w.outcome), (unsigned)w.radioOnMs,
+                          (unsigned)w.wifiMs, (unsigned)w.mqttMs, (unsigned)w.pendingAtOpen,
+                          (unsigned)w.pendingAtClose);
+        }
+        Serial.printf("Next window in %u s\n", (unsigned)secondsUntilNextWindow());
+        Serial.println("==============");
+    }
+
+private:
+    MQTTHelperT*     _mqtt;
+    BatteryHandlerT* _battery;
+    RtcUtilsT*       _rtc;
+    ITimeSync*       _timeSync;
+    UplinkWindow     _window;
+    bool             _manual;
+    volatile bool    _wifiFailed;
+    std::function<void(const UplinkWindowRecord&)> _onClosed;
+
+    void open(UplinkTrigger trigger, uint32_t pending) {
+        uint32_t epoch = _rtc->epochNow();
+        _manual     = false;
+        _wifiFailed = false;
+        // Cadence restarts at the window start, a failed window waits for the next slot
+        uplinkRtc.lastWindowEpoch = epoch;
+        act(_window.open(trigger, millis(), epoch, pending));
+    }
+
+    void act(UplinkAction action) {
+        switch (action) {
+            case UPLINK_ACT_CONNECT_WIFI:
+                WiFiHelper::connectBest([this](bool connected, uint32_t) {
+                    if (!connected) _wifiFailed = true;
+                });
+                break;
+            case UPLINK_ACT_CONNECT_MQTT:
+                _mqtt->connect();
+                break;
+            case UPLINK_ACT_CLOSE:
+                shutdown();
+                break;
+            default:
+                break;
+        }
+    }
+
+    void shutdown() {
+        _mqtt->disconnect();     // also stops a pending reconnect
+        _mqtt->persistOutbox();  // what is left goes out in the next window
+        WiFiHelper::disconnect();
+        _battery->cutAllNonCore();
+        _window.radioOff(millis());
+
+        uplinkRtc.last = _window.record();
+        uplinkRtc.stats.record(uplinkRtc.last);
+        if (_onClosed) _onClosed(uplinkRtc.last);
+    }
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef VALUE_PICKER_M5STICK_ADAPTER_H
+#define VALUE_PICKER_M5STICK_ADAPTER_H
+
+#include <M5Unified.h>
+#include <Arduino.h>
+#include <functional>
+#include "../ports/value_picker_port.h"
+#include "../ports/display_handler_port.h"
+#include "../settings_manager.h"
+
+class ValuePickerM5StickAdapter final : public IValuePicker {
+public:
+    ValuePickerM5StickAdapter(DisplayHandlerT* disp, const char* titleText = "Set Value")
+        : _display(disp), _active(false) {
+        _settings = SettingsManager::getInstance();
+        setTitle(titleText);
+    }
+
+    bool configure(const PickerField* fields, uint8_t count, const int16_t* initial = nullptr) override {
+        return _model.configure(fields, count, initial);
+    }
+
+    void setTitle(const char* title) override {
+        strncpy(_title, title ? title : "", sizeof(_title) - 1);
+        _title[sizeof(_title) - 1] = '\0';
+    }
+
+    void setOnComplete(std::function<void(const ValuePickerModel&)> callback) override {
+        _onComplete = callback;
+    }
+
+    void start() override {
+        if (!_model.count()) return;
+        _model.restart();
+        _active = true;
+        refresh();
+    }
+
+    void stop() override { _active = false; }
+    bool isActive() override { return _active; }
+
+    void navigateUp() override {
+        if (!_active) return;
+        _model.step(-1);
+        if (_settings->getUiSound()) M5.Speaker.tone(2800, 30);
+        refresh();
+    }
+
+    void navigateDown() override {
+        if (!_active) return;
+        _model.step(+1);
+        if (_settings->getUiSound()) M5.Speaker.tone(2400, 30);
+        refresh();
+    }
+
+    void select() override {
+        if (!_active) return;
+        if (_settings->getUiSound()) M5.Speaker.tone(3000, 50);
+        if (_model.next()) {
+            _active = false;
+            if (_onComplete) _onComplete(_model);
+            return;
+        }
+        refresh();
+    }
+
+    void draw() override {
+        if (!_active) return;
+        _model.takeDirty();
+        _display->clearScreen();
+        _display->drawCenteredText(_title, 10, TFT_WHITE, 2);
+
+        char progress[8];
+        snprintf(progress, sizeof(progress), "%d/%d", _model.current() + 1, _model.count());
+        M5.Display.setTextColor(TFT_DARKGREY);
+        M5.Display.setTextSize(1);
+        M5.Display.setCursor(M5.Display.width() - 30, 10);
+        M5.Display.print(progress);
+
+        drawValues();
+        _display->drawCenteredText(_model.field(_model.current()).label, LABEL_Y, TFT_CYAN, 1);
+
+        M5.Display.setTextColor(TFT_DARKGREY);
+        M5.Display.setTextSize(1);
+        M5.Display.setCursor(5, M5.Display.height() - 15);
+        M5.Display.print("PWR/B:Nav A:OK");
+    }
+
+    const ValuePickerModel& getModel() override { return _model; }
+
+private:
+    static const int PREV_Y  = 32;
+    static const int VALUE_Y = 52;
+    static const int NEXT_Y  = 88;
+    static const int BAND_H  = 72;   // PREV_Y .. end of the next value
+    static const int LABEL_Y = 108;
+
+    DisplayHandlerT*  _display;
+    SettingsManager*  _settings;
+    ValuePickerModel  _model;
+    std::function<void(const ValuePickerModel&)> _onComplete;
+    char              _title[24];
+    bool              _active;
+
+    // A new value only repaints the band of values, a new field everything
+    void refresh() {
+        uint8_t dirty = _model.takeDirty();
+        if (dirty & (PICKER_DIRTY_FIELD | PICKER_DIRTY_ALL)) {
+            draw();
+        } else if (dirty & PICKER_DIRTY_VALUE) {
+            M5.Display.fillRect(0, PREV_Y, M5.Display.width(), BAND_H, TFT_BLACK);
+            drawValues();
+        }
+    }
+
+    void drawValues() {
+        char text[16];
+        _model.format(_model.current(), _model.neighbour(-1), text, sizeof(text));
+        _display->drawCenteredText(text, PREV_Y, TFT_DARKGREY, 2);
+
+        size_t n = _model.format(_model.current(), _model.value(_model.current()), text, sizeof(text));
+        _display->drawCenteredText(text, VALUE_Y, TFT_YELLOW, n > 6 ? 3 : 4);
+
+        _model.format(_model.current(), _model.neighbour(+1), text, sizeof(text));
+        _display->drawCenteredText(text, NEXT_Y, TFT_DARKGREY, 2);
+    }
+};
+
+#endif
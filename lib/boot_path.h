@@ -0,0 +1,176 @@
+#ifndef BOOT_PATH_H
+#define BOOT_PATH_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <time.h>
+#include <esp_attr.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <driver/gpio.h>
+#include <driver/ledc.h>
+#include "core/boot_latency.h"
+
+#define BOOT_LATENCY_RTC_MAGIC  0x424F4F54
+#define ALARM_BUZZER_GPIO       GPIO_NUM_2
+#define ALARM_STOP_GPIO         GPIO_NUM_37   // button A, active low
+#define ALARM_LEDC_TIMER        LEDC_TIMER_3
+#define ALARM_LEDC_CHANNEL      LEDC_CHANNEL_7
+#define ALARM_BEEPS             8
+#define ALARM_BEEP_MS           200
+#define ALARM_GAP_MS            50
+#define RTC_BARE_SDA            21            // internal bus, BM8563 RTC
+#define RTC_BARE_SCL            22
+#define RTC_BARE_ADDR           0x51
+
+struct BootLatencyRtc {
+    uint32_t         magic;
+    BootLatencyTable table;
+};
+
+RTC_DATA_ATTR static BootLatencyRtc bootLatencyRtc;
+
+// Wake cause and boot latencies. On an alarm wake the buzzer is driven
+// straight through LEDC before M5.begin() and the rest of setup(), then the
+// pin is handed back to M5.Speaker. The RTC can be read the same way, so an
+// alarm that goes back to sleep never needs M5.begin().
+// Latencies are esp_timer time, i.e. from the start of the app: ROM and
+// bootloader (~300 ms) come on top and are the same for every path.
+class BootPath {
+private:
+    static BootPath instance;
+
+    uint8_t cause;
+    bool    marked[BOOT_MARK_COUNT];
+
+    BootPath() : cause(BOOT_COLD) {
+        for (uint8_t m = 0; m < BOOT_MARK_COUNT; m++) marked[m] = false;
+    }
+
+    static void buzz(bool on) {
+        ledc_set_duty(LEDC_LOW_SPEED_MODE, ALARM_LEDC_CHANNEL, on ? 512 : 0);
+        ledc_update_duty(LEDC_LOW_SPEED_MODE, ALARM_LEDC_CHANNEL);
+    }
+
+    // True as soon as button A is down
+    static uint8_t bcd(uint8_t v) { return (v >> 4) * 10 + (v & 0x0F); }
+
+    static bool waitOrPress(uint32_t ms) {
+        uint32_t start = millis();
+        while (millis() - start < ms) {
+            if (digitalRead(ALARM_STOP_GPIO) == LOW) return true;
+            delay(2);
+        }
+        return false;
+    }
+
+public:
+    static BootPath* getInstance() { return &instance; }
+
+    // First thing in setup()
+    void begin() {
+        if (bootLatencyRtc.magic != BOOT_LATENCY_RTC_MAGIC) {
+            bootLatencyRtc.table.clear();
+            bootLatencyRtc.magic = BOOT_LATENCY_RTC_MAGIC;
+        }
+        switch (esp_sleep_get_wakeup_cause()) {
+            case ESP_SLEEP_WAKEUP_UNDEFINED: cause = BOOT_COLD;   break;
+            case ESP_SLEEP_WAKEUP_TIMER:     cause = BOOT_TIMER;  break;
+            case ESP_SLEEP_WAKEUP_EXT0:
+            case ESP_SLEEP_WAKEUP_EXT1:      cause = BOOT_BUTTON; break;
+            default:                         cause = BOOT_OTHER;  break;
+        }
+    }
+
+    uint8_t getCause() { return cause; }
+    bool isTimerWake() { return cause == BOOT_TIMER; }
+
+    // Once per boot and milestone
+    void mark(uint8_t m) {
+        if (m >= BOOT_MARK_COUNT || marked[m]) return;
+        marked[m] = true;
+        bootLatencyRtc.table.record(cause, m, (uint32_t)esp_timer_get_time());
+    }
+
+    // Beeps on the bare buzzer, needs nothing initialised. Returns true when
+    // button A stopped it, after the button is released.
+    bool soundAlarm(uint32_t freqHz) {
+        pinMode(ALARM_STOP_GPIO, INPUT);
+
+        ledc_timer_config_t timer = {};
+        timer.speed_mode      = LEDC_LOW_SPEED_MODE;
+        timer.duty_resolution = LEDC_TIMER_10_BIT;
+        timer.timer_num       = ALARM_LEDC_TIMER;
+        timer.freq_hz         = freqHz;
+        timer.clk_cfg         = LEDC_AUTO_CLK;
+        ledc_timer_config(&timer);
+
+        ledc_channel_config_t channel = {};
+        channel.gpio_num   = ALARM_BUZZER_GPIO;
+        channel.speed_mode = LEDC_LOW_SPEED_MODE;
+        channel.channel    = ALARM_LEDC_CHANNEL;
+        channel.timer_sel  = ALARM_LEDC_TIMER;
+        channel.duty       = 0;
+        ledc_channel_config(&channel);
+
+        bool stopped = false;
+        for (int i = 0; i < ALARM_BEEPS && !stopped; i++) {
+            buzz(true);
+            mark(BOOT_MARK_ALARM);
+            stopped = waitOrPress(ALARM_BEEP_MS);
+            buzz(false);
+            if (!stopped) stopped = waitOrPress(ALARM_GAP_MS);
+        }
+
+        ledc_stop(LEDC_LOW_SPEED_MODE, ALARM_LEDC_CHANNEL, 0);
+        gpio_reset_pin(ALARM_BUZZER_GPIO);
+        while (stopped && digitalRead(ALARM_STOP_GPIO) == LOW) delay(5);  // not seen as a press by the UI
+        return stopped;
+    }
+
+    // Epoch from the BM8563 over a bare Wire bus, same conversion as the RTC
+    // adapter. Returns 0 when the chip does not answer or lost its time.
+    uint32_t rtcEpoch() {
+        uint8_t r[7];
+        uint8_t n = 0;
+        Wire.begin(RTC_BARE_SDA, RTC_BARE_SCL);
+        Wire.beginTransmission(RTC_BARE_ADDR);
+        Wire.write(0x02);                       // seconds, then the six next registers
+        if (Wire.endTransmission(false) == 0 && Wire.requestFrom(RTC_BARE_ADDR, 7) == 7) {
+            while (n < 7) r[n++] = Wire.read();
+        }
+        Wire.end();
+        if (n < 7 || (r[0] & 0x80)) return 0;  // VL bit: oscillator stopped
+
+        struct tm tmv = {0};
+        tmv.tm_sec  = bcd(r[0] & 0x7F);
+        tmv.tm_min  = bcd(r[1] & 0x7F);
+        tmv.tm_hour = bcd(r[2] & 0x3F);
+        tmv.tm_mday = bcd(r[3] & 0x3F);
+        tmv.tm_mon  = bcd(r[5] & 0x1F) - 1;
+        tmv.tm_year = bcd(r[6]) + ((r[5] & 0x80) ? 0 : 100);   // century bit set: 19xx
+        return (uint32_t)mktime(&tmv);
+    }
+
+    void printReport() {
+        char line[BOOT_LATENCY_ROW_MAX];
+        Serial.printf("boot: %s, ms since app start\n", bootCauseName(cause));
+        for (uint8_t c = 0; c < BOOT_CAUSE_COUNT; c++) {
+            for (uint8_t m = 0; m < BOOT_MARK_COUNT; m++) {
+                if (!bootLatencyRtc.table.get(c, m).count) continue;
+                bootFormatLatencyRow(bootLatencyRtc.table, c, m, line, sizeof(line));
+                Serial.println(line);
+            }
+        }
+    }
+
+    void handleConsole(const char* args) {
+        if (strcmp(args, "reset") == 0) bootLatencyRtc.table.clear();
+        printReport();
+    }
+};
+
+// Initialize static members
+BootPath BootPath::instance;
+
+#endif
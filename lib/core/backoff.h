@@ -0,0 +1,61 @@
+#ifndef BACKOFF_H
+#define BACKOFF_H
+
+#include <stdint.h>
+
+// Exponential backoff with "equal jitter": the n-th retry waits between half
+// and all of min(cap, base * 2^n), so a fleet that lost the same broker does
+// not come back in lockstep while each device keeps a guaranteed minimum wait.
+struct ExponentialBackoff {
+    uint32_t baseMs;
+    uint32_t capMs;
+    uint16_t attempt;
+
+    void configure(uint32_t base, uint32_t cap) {
+        baseMs  = base ? base : 1;
+        capMs   = cap < baseMs ? baseMs : cap;
+        attempt = 0;
+    }
+
+    void reset() { attempt = 0; }
+
+    // Upper bound of the next delay, without jitter
+    uint32_t ceilingMs() const {
+        uint32_t d = baseMs;
+        for (uint16_t i = 0; i < attempt && d < capMs; i++) {
+            d = d > capMs / 2 ? capMs : d * 2;
+        }
+        return d < capMs ? d : capMs;
+    }
+
+    // Delay before the next attempt; random is any 32-bit random value
+    uint32_t next(uint32_t random) {
+        uint32_t ceiling = ceilingMs();
+        if (attempt < 0xFFFF) attempt++;
+        uint32_t half = ceiling / 2;
+        return half + random % (ceiling - half + 1);
+    }
+};
+
+// Reconnect bookkeeping shared by the connection state machines
+struct ReconnectStats {
+    uint32_t disconnects;       // unexpected connection losses
+    uint32_t attempts;          // connect attempts made by the state machine
+    uint32_t reconnects;        // successful reconnects
+    uint32_t lastReconnectMs;   // loss -> connected, last time
+    uint32_t maxReconnectMs;
+    uint32_t totalReconnectMs;  // sum, for the average
+    uint32_t nextRetryMs;       // delay currently scheduled, 0 when idle
+
+    uint32_t averageReconnectMs() const { return reconnects ? totalReconnectMs / reconnects : 0; }
+
+    void recordReconnect(uint32_t elapsedMs) {
+        reconnects++;
+        lastReconnectMs   = elapsedMs;
+        totalReconnectMs += elapsedMs;
+        if (elapsedMs > maxReconnectMs) maxReconnectMs = elapsedMs;
+        nextRetryMs = 0;
+    }
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef BOOT_LATENCY_H
+#define BOOT_LATENCY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// Time from reset to a boot milestone, per wake cause. Plain data, kept in
+// RTC memory so alarm wakes that go straight back to sleep still count.
+
+enum BootCause : uint8_t {
+    BOOT_COLD = 0,      // power on, reset, flash
+    BOOT_TIMER,         // wake-up timer, i.e. an alarm
+    BOOT_BUTTON,
+    BOOT_OTHER,
+    BOOT_CAUSE_COUNT
+};
+
+enum BootMark : uint8_t {
+    BOOT_MARK_ALARM = 0,   // first tone of the alarm
+    BOOT_MARK_UI,          // first frame on screen
+    BOOT_MARK_COUNT
+};
+
+inline const char* bootCauseName(uint8_t cause) {
+    static const char* const NAMES[BOOT_CAUSE_COUNT] = { "cold", "timer", "button", "other" };
+    return cause < BOOT_CAUSE_COUNT ? NAMES[cause] : "?";
+}
+
+inline const char* bootMarkName(uint8_t mark) {
+    static const char* const NAMES[BOOT_MARK_COUNT] = { "alarm", "ui" };
+    return mark < BOOT_MARK_COUNT ? NAMES[mark] : "?";
+}
+
+struct BootLatencyStat {
+    uint32_t count;
+    uint32_t lastUs;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint64_t sumUs;
+
+    void clear() {
+        count = lastUs = minUs = maxUs = 0;
+        sumUs = 0;
+    }
+
+    void add(uint32_t us) {
+        if (!count || us < minUs) minUs = us;
+        if (us > maxUs) maxUs = us;
+        lastUs = us;
+        sumUs += us;
+        count++;
+    }
+
+    uint32_t meanUs() const { return count ? (uint32_t)(sumUs / count) : 0; }
+};
+
+struct BootLatencyTable {
+    BootLatencyStat stats[BOOT_CAUSE_COUNT][BOOT_MARK_COUNT];
+
+    void clear() {
+        for (uint8_t c = 0; c < BOOT_CAUSE_COUNT; c++) {
+            for (uint8_t m = 0; m < BOOT_MARK_COUNT; m++) stats[c][m].clear();
+        }
+    }
+
+    void record(uint8_t cause, uint8_t mark, uint32_t us) {
+        if (cause >= BOOT_CAUSE_COUNT || mark >= BOOT_MARK_COUNT) return;
+        stats[cause][mark].add(us);
+    }
+
+    const BootLatencyStat& get(uint8_t cause, uint8_t mark) const { return stats[cause][mark]; }
+};
+
+#define BOOT_LATENCY_ROW_MAX  112   // longest row, every field at its uint32 maximum
+
+//   timer   alarm  n     3  last    41.5  min    40.2  mean    41.0  max    41.5 ms
+// Fixed point tenths of a ms keep each field bounded; formatted whole
+// first, then cut to cap
+inline size_t bootFormatLatencyRow(const BootLatencyTable& t, uint8_t cause, uint8_t mark, char* out, size_t cap) {
+    const BootLatencyStat& s = t.get(cause, mark);
+    uint32_t tenths[4] = { s.lastUs, s.minUs, s.meanUs(), s.maxUs };
+    for (uint8_t i = 0; i < 4; i++) tenths[i] = (uint32_t)(((uint64_t)tenths[i] + 50) / 100);
+
+    char row[BOOT_LATENCY_ROW_MAX];
+    int  n = snprintf(row, sizeof(row),
+                      "%-7s %-6s n %5u  last %5lu.%lu  min %5lu.%lu  mean %5lu.%lu  max %5lu.%lu ms",
+                      bootCauseName(cause), bootMarkName(mark), (unsigned)s.count,
+                      (unsigned long)(tenths[0] / 10), (unsigned long)(tenths[0] % 10),
+                      (unsigned long)(tenths[1] / 10), (unsigned long)(tenths[1] % 10),
+                      (unsigned long)(tenths[2] / 10), (unsigned long)(tenths[2] % 10),
+                      (unsigned long)(tenths[3] / 10), (unsigned long)(tenths[3] % 10));
+    if (!cap) return 0;
+    size_t len = n < 0 ? 0 : (size_t)n < sizeof(row) ? (size_t)n : sizeof(row) - 1;
+    if (len >= cap) len = cap - 1;
+    memcpy(out, row, len);
+    out[len] = '\0';
+    return len;
+}
+
+#endif
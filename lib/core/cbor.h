@@ -0,0 +1,219 @@
+#ifndef CBOR_H
+#define CBOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+
+// Minimal CBOR (RFC 8949) writer and pull reader covering what a JSON
+// document can hold: integers, floats, text strings, arrays, maps, booleans
+// and null. Lengths are always definite; the reader rejects indefinite
+// length items and skips tags.
+
+class CborWriter {
+public:
+    // buf may be null to only measure the encoded size
+    CborWriter(uint8_t* buf, size_t capacity) : _buf(buf), _cap(capacity), _len(0), _overflow(false) {}
+
+    void writeNull()          { put(0xF6); }
+    void writeBool(bool v)    { put(v ? 0xF5 : 0xF4); }
+    void writeUInt(uint64_t v) { head(0, v); }
+    void writeInt(int64_t v) {
+        if (v >= 0) head(0, (uint64_t)v);
+        else        head(1, (uint64_t)(-1 - v));
+    }
+
+    // Single precision when it is lossless, double otherwise
+    void writeFloat(double v) {
+        float f = (float)v;
+        if ((double)f == v || v != v) {
+            uint32_t bits;
+            memcpy(&bits, &f, sizeof(bits));
+            put(0xFA);
+            putBE(bits, 4);
+        } else {
+            uint64_t bits;
+            memcpy(&bits, &v, sizeof(bits));
+            put(0xFB);
+            putBE(bits, 8);
+        }
+    }
+
+    void writeString(const char* s, size_t len) {
+        head(3, len);
+        for (size_t i = 0; i < len; i++) put((uint8_t)s[i]);
+    }
+
+    void writeArray(size_t count) { head(4, count); }
+    void writeMap(size_t count)   { head(5, count); }
+
+    size_t size()       const { return _len; }
+    bool   overflowed() const { return _overflow; }
+
+private:
+    uint8_t* _buf;
+    size_t   _cap;
+    size_t   _len;
+    bool     _overflow;
+
+    void put(uint8_t b) {
+        if (_buf) {
+            if (_len >= _cap) { _overflow = true; return; }
+            _buf[_len] = b;
+        }
+        _len++;
+    }
+
+    void putBE(uint64_t v, int bytes) {
+        for (int i = bytes - 1; i >= 0; i--) put((uint8_t)(v >> (8 * i)));
+    }
+
+    void head(uint8_t major, uint64_t v) {
+        uint8_t m = (uint8_t)(major << 5);
+        if (v < 24)               { put(m | (uint8_t)v); }
+        else if (v <= 0xFF)       { put(m | 24); putBE(v, 1); }
+        else if (v <= 0xFFFF)     { put(m | 25); putBE(v, 2); }
+        else if (v <= 0xFFFFFFFF) { put(m | 26); putBE(v, 4); }
+        else                      { put(m | 27); putBE(v, 8); }
+    }
+};
+
+enum CborType {
+    CBOR_UINT = 0,
+    CBOR_NEGINT,   // value in item.i
+    CBOR_BYTES,
+    CBOR_TEXT,
+    CBOR_ARRAY,    // item.count elements follow
+    CBOR_MAP,      // item.count key/value pairs follow
+    CBOR_BOOL,
+    CBOR_NULL,
+    CBOR_FLOAT
+};
+
+struct CborItem {
+    CborType    type;
+    uint64_t    u;      // UINT, BOOL
+    int64_t     i;      // NEGINT
+    double      f;      // FLOAT
+    const char* str;    // BYTES, TEXT (not NUL-terminated)
+    size_t      count;  // BYTES/TEXT length, ARRAY/MAP size
+};
+
+class CborReader {
+public:
+    CborReader(const uint8_t* data, size_t len) : _data(data), _len(len), _pos(0) {}
+
+    // Reads the next item, false at the end of input or on malformed data
+    bool next(CborItem& item) {
+        uint8_t  major, info;
+        uint64_t arg;
+        do {  // tags only annotate the item that follows
+            uint8_t ib;
+            if (!get(ib)) return false;
+            major = ib >> 5;
+            info  = ib & 0x1F;
+            if (major == 7) return simple(info, item);
+            if (!argument(info, arg)) return false;
+        } while (major == 6);
+
+        switch (major) {
+            case 0: item.type = CBOR_UINT; item.u = arg; return true;
+            case 1:
+                if (arg > (uint64_t)INT64_MAX) return false;
+                item.type = CBOR_NEGINT;
+                item.i    = -1 - (int64_t)arg;
+                return true;
+            case 2:
+            case 3:
+                if (arg > _len - _pos) return false;
+                item.type  = major == 2 ? CBOR_BYTES : CBOR_TEXT;
+                item.str   = (const char*)(_data + _pos);
+                item.count = (size_t)arg;
+                _pos += (size_t)arg;
+                return true;
+            default:
+                // Each element needs at least one byte, rejects absurd counts early
+                if (arg > _len - _pos) return false;
+                item.type  = major == 4 ? CBOR_ARRAY : CBOR_MAP;
+                item.count = (size_t)arg;
+                return true;
+        }
+    }
+
+    size_t position() const { return _pos; }
+    bool   atEnd()    const { return _pos >= _len; }
+
+private:
+    const uint8_t* _data;
+    size_t         _len;
+    size_t         _pos;
+
+    bool get(uint8_t& b) {
+        if (_pos >= _len) return false;
+        b = _data[_pos++];
+        return true;
+    }
+
+    bool getBE(int bytes, uint64_t& v) {
+        if ((size_t)bytes > _len - _pos) return false;
+        v = 0;
+        for (int i = 0; i < bytes; i++) v = (v << 8) | _data[_pos++];
+        return true;
+    }
+
+    // 31 (indefinite length) and 28-30 (reserved) are refused
+    bool argument(uint8_t info, uint64_t& v) {
+        if (info < 24) { v = info; return true; }
+        switch (info) {
+            case 24: return getBE(1, v);
+            case 25: return getBE(2, v);
+            case 26: return getBE(4, v);
+            case 27: return getBE(8, v);
+            default: return false;
+        }
+    }
+
+    bool simple(uint8_t info, CborItem& item) {
+        uint64_t bits;
+        switch (info) {
+            case 20: item.type = CBOR_BOOL; item.u = 0; return true;
+            case 21: item.type = CBOR_BOOL; item.u = 1; return true;
+            case 22:
+            case 23: item.type = CBOR_NULL; return true;  // null, undefined
+            case 25:
+                if (!getBE(2, bits)) return false;
+                item.type = CBOR_FLOAT;
+                item.f    = halfToDouble((uint16_t)bits);
+                return true;
+            case 26: {
+                if (!getBE(4, bits)) return false;
+                uint32_t b32 = (uint32_t)bits;
+                float    f;
+                memcpy(&f, &b32, sizeof(f));
+                item.type = CBOR_FLOAT;
+                item.f    = f;
+                return true;
+            }
+            case 27:
+                if (!getBE(8, bits)) return false;
+                item.type = CBOR_FLOAT;
+                memcpy(&item.f, &bits, sizeof(item.f));
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    static double halfToDouble(uint16_t h) {
+        int    exp  = (h >> 10) & 0x1F;
+        int    mant = h & 0x3FF;
+        double v;
+        if (exp == 0)       v = ldexp((double)mant, -24);
+        else if (exp != 31) v = ldexp((double)(mant + 1024), exp - 25);
+        else                v = mant ? NAN : INFINITY;
+        return (h & 0x8000) ? -v : v;
+    }
+};
+
+#endif
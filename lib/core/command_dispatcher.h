@@ -0,0 +1,194 @@
+#ifndef COMMAND_DISPATCHER_H
+#define COMMAND_DISPATCHER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <mutex>
+#include <ArduinoJson.h>
+#include "command_table.h"
+#include "fixed_pool_allocator.h"
+#include "payload_codec.h"
+
+// Payload: {"id":"42","action":"set_config","args":{"user_id":3,"zone_id":7}}
+//
+// submit() runs on the receiving task (MQTT, or serial, BLE...): one
+// filtered parse into a fixed-capacity document, perfect-hash lookup, typed
+// arguments copied into a queued job. Submits from several tasks take turns
+// on a lock, the document and the producer end of the queue are shared.
+// runPending() runs the handlers on the UI task and hands each result to the
+// reply callback. Neither touches the heap; the filter (union of every
+// argument name of the table) is built once in begin(). Commands come as
+// JSON or MessagePack: the CBOR reader has no filter and copies strings
+// through malloc, CBOR commands get a parse error.
+
+typedef void (*CommandReplyFn)(void* ctx, const CommandJob& job, const CommandSpec* spec, const CommandResult& result);
+
+// POOL_BYTES: ArduinoJson takes a whole slot pool on the first value
+// (64 slots of 16 bytes on the ESP32), strings come on top of it.
+template <size_t SLOTS = 64, size_t QUEUE_DEPTH = 8, size_t POOL_BYTES = 1536>
+class CommandDispatcher {
+public:
+    CommandDispatcher()
+        : _table(nullptr), _count(0), _pool(_poolBuf, sizeof(_poolBuf)), _doc(&_pool) {
+        memset(&_stats, 0, sizeof(_stats));
+    }
+
+    bool begin(const CommandSpec* table, size_t count) {
+        _table = table;
+        _count = count;
+        _filter.clear();
+        _filter["id"]     = true;
+        _filter["action"] = true;
+        for (size_t c = 0; c < count; c++) {
+            for (size_t a = 0; a < CMD_MAX_ARGS && table[c].args[a].name; a++) {
+                _filter["args"][table[c].args[a].name] = true;
+            }
+        }
+        return _index.build(table, count);
+    }
+
+    // Producer side, any task. Errors are queued too, so they get a reply like any command.
+    CommandStatus submit(const uint8_t* data, size_t len, uint32_t nowUs) {
+        std::lock_guard<std::mutex> lock(_submitLock);
+        _stats.received++;
+        CommandJob* job = _queue.reserve();
+        if (!job) {
+            _stats.dropped++;
+            return CMD_ERR_FAILED;
+        }
+        job->receivedUs = nowUs;
+        job->command    = -1;
+        job->id[0]      = '\0';
+        job->args.clear();
+        job->status = parse(data, len, *job);
+        _doc.clear();
+
+        switch (job->status) {
+            case CMD_ERR_UNKNOWN: _stats.unknown++;     break;
+            case CMD_ERR_ARGS:    _stats.badArgs++;     break;
+            case CMD_ERR_PARSE:   _stats.parseErrors++; break;
+            default:              break;
+        }
+        _queue.commit();
+        uint32_t depth = _queue.size();
+        if (depth > _stats.maxQueued) _stats.maxQueued = depth;
+        return job->status;
+    }
+
+    // Consumer side, returns the number of jobs handled
+    size_t runPending(CommandReplyFn reply, void* ctx, uint32_t (*nowUs)(), size_t maxJobs = QUEUE_DEPTH) {
+        size_t done = 0;
+        CommandJob* job;
+        while (done < maxJobs && (job = _queue.front()) != nullptr) {
+            const CommandSpec* spec = job->command >= 0 ? &_table[job->command] : nullptr;
+            CommandResult result = { job->status, nullptr };
+            if (job->status == CMD_OK && spec) {
+                result = spec->handler(job->args);
+                if (result.status != CMD_OK) _stats.failed++;
+                _stats.executed++;
+                uint32_t latency = nowUs() - job->receivedUs;
+                _stats.lastLatencyUs   = latency;
+                _stats.totalLatencyUs += latency;
+                if (latency > _stats.maxLatencyUs) _stats.maxLatencyUs = latency;
+            }
+            if (reply) reply(ctx, *job, spec, result);
+            _queue.release();
+            done++;
+        }
+        return done;
+    }
+
+    int  find(const char* action) const { return _index.find(action); }
+    size_t pending() const { return _queue.size(); }
+
+    const CommandStats&       stats() const { return _stats; }
+    const FixedPoolAllocator& pool()  const { return _pool; }
+
+private:
+    const CommandSpec*              _table;
+    size_t                          _count;
+    CommandIndex<SLOTS>             _index;
+    CommandQueue<QUEUE_DEPTH>       _queue;
+    CommandStats                    _stats;
+    uint64_t                        _poolBuf[(POOL_BYTES + 7) / 8];
+    FixedPoolAllocator              _pool;
+    JsonDocument                    _doc;
+    JsonDocument                    _filter;
+    std::mutex                      _submitLock;
+
+    // Correlation ids are echoed into a JSON reply: only keep safe characters
+    static void copyId(char* dst, const char* src) {
+        size_t n = 0;
+        for (; src && *src && n < CMD_ID_MAX - 1; src++) {
+            char c = *src;
+            bool ok = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                      c == '-' || c == '_' || c == '.' || c == ':';
+            if (ok) dst[n++] = c;
+        }
+        dst[n] = '\0';
+    }
+
+    DeserializationError deserialize(const uint8_t* data, size_t len) {
+        switch (detectPayloadEncoding(data, len)) {
+            case PAYLOAD_MSGPACK:
+                return deserializeMsgPack(_doc, data + PAYLOAD_MARKER_SIZE, len - PAYLOAD_MARKER_SIZE,
+                                          DeserializationOption::Filter(_filter));
+            case PAYLOAD_CBOR:
+                return DeserializationError::InvalidInput;
+            default:
+                return deserializeJson(_doc, (const char*)data, len, DeserializationOption::Filter(_filter));
+        }
+    }
+
+    CommandStatus parse(const uint8_t* data, size_t len, CommandJob& job) {
+        if (deserialize(data, len)) return CMD_ERR_PARSE;
+        copyId(job.id, _doc["id"].template as<const char*>());
+
+        JsonString action = _doc["action"].template as<JsonString>();
+        if (!action.c_str()) return CMD_ERR_PARSE;
+        int index = _index.find(action.c_str(), action.size());
+        if (index < 0) return CMD_ERR_UNKNOWN;
+        job.command = (int16_t)index;
+
+        const CommandSpec& spec = _table[index];
+        JsonVariantConst   args = _doc["args"];
+        for (uint8_t a = 0; a < CMD_MAX_ARGS && spec.args[a].name; a++) {
+            JsonVariantConst v = args[spec.args[a].name];
+            if (v.isNull()) {
+                if (spec.args[a].required) return CMD_ERR_ARGS;
+                continue;
+            }
+            if (!readArg(v, spec.args[a].type, a, job.args)) return CMD_ERR_ARGS;
+        }
+        return CMD_OK;
+    }
+
+    static bool readArg(JsonVariantConst v, CommandArgType type, uint8_t a, CommandArgs& out) {
+        switch (type) {
+            case CMD_ARG_INT:
+                if (!v.is<int32_t>()) return false;
+                out.values[a].i = v.as<int32_t>();
+                break;
+            case CMD_ARG_FLOAT:
+                if (!v.is<float>()) return false;
+                out.values[a].f = v.as<float>();
+                break;
+            case CMD_ARG_BOOL:
+                if (!v.is<bool>()) return false;
+                out.values[a].b = v.as<bool>();
+                break;
+            case CMD_ARG_STRING: {
+                if (!v.is<const char*>()) return false;
+                JsonString s = v.as<JsonString>();
+                return out.setString(a, s.c_str(), s.size());
+            }
+            default:
+                return false;
+        }
+        out.present[a] = true;
+        return true;
+    }
+};
+
+#endif
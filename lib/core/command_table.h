@@ -0,0 +1,237 @@
+#ifndef COMMAND_TABLE_H
+#define COMMAND_TABLE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+
+// Remote commands: a table of {name, typed arguments, handler} written at
+// compile time, looked up through a perfect hash of the action name and
+// executed later from a fixed-size queue. Nothing here allocates.
+
+#define CMD_MAX_ARGS     4
+#define CMD_TEXT_MAX     64   // all string arguments of one command
+#define CMD_ID_MAX       24   // correlation id echoed in the reply
+
+// FNV-1a, usable in constant expressions: switch (h) { case cmdHash("sleep"): }
+constexpr uint32_t cmdHashFrom(const char* s, uint32_t h) {
+    return *s ? cmdHashFrom(s + 1, (h ^ (uint8_t)*s) * 16777619UL) : h;
+}
+constexpr uint32_t cmdHash(const char* s) { return cmdHashFrom(s, 2166136261UL); }
+
+inline uint32_t cmdHashN(const char* s, size_t len) {
+    uint32_t h = 2166136261UL;
+    for (size_t i = 0; i < len; i++) h = (h ^ (uint8_t)s[i]) * 16777619UL;
+    return h;
+}
+
+enum CommandArgType {
+    CMD_ARG_NONE = 0,
+    CMD_ARG_INT,
+    CMD_ARG_FLOAT,
+    CMD_ARG_BOOL,
+    CMD_ARG_STRING
+};
+
+enum CommandStatus {
+    CMD_OK = 0,
+    CMD_ERR_UNKNOWN,    // no such action
+    CMD_ERR_ARGS,       // missing or mistyped argument
+    CMD_ERR_PARSE,      // payload not a valid document
+    CMD_ERR_FAILED      // the handler refused
+};
+
+struct CommandArgSpec {
+    const char*    name;
+    CommandArgType type;
+    bool           required;
+};
+
+// Arguments by position in the spec, already typed
+struct CommandArgs {
+    union Value {
+        int32_t     i;
+        float       f;
+        bool        b;
+        const char* s;   // points into text
+    };
+    Value   values[CMD_MAX_ARGS];
+    bool    present[CMD_MAX_ARGS];
+    char    text[CMD_TEXT_MAX];
+    uint8_t textUsed;
+
+    void clear() {
+        memset(present, 0, sizeof(present));
+        textUsed = 0;
+    }
+
+    bool        has(uint8_t i) const { return i < CMD_MAX_ARGS && present[i]; }
+    int32_t     getInt(uint8_t i, int32_t def = 0) const { return has(i) ? values[i].i : def; }
+    float       getFloat(uint8_t i, float def = 0) const { return has(i) ? values[i].f : def; }
+    bool        getBool(uint8_t i, bool def = false) const { return has(i) ? values[i].b : def; }
+    const char* getString(uint8_t i, const char* def = "") const { return has(i) ? values[i].s : def; }
+
+    // Copies the string into text, false when it does not fit
+    bool setString(uint8_t i, const char* s, size_t len) {
+        if (i >= CMD_MAX_ARGS || textUsed + len + 1 > CMD_TEXT_MAX) return false;
+        char* dst = text + textUsed;
+        memcpy(dst, s, len);
+        dst[len]    = '\0';
+        textUsed   += (uint8_t)(len + 1);
+        values[i].s = dst;
+        present[i]  = true;
+        return true;
+    }
+};
+
+struct CommandResult {
+    CommandStatus status;
+    const char*   detail;   // static string or nullptr
+
+    static CommandResult ok(const char* detail = nullptr)   { CommandResult r = { CMD_OK, detail }; return r; }
+    static CommandResult fail(const char* detail = nullptr) { CommandResult r = { CMD_ERR_FAILED, detail }; return r; }
+};
+
+typedef CommandResult (*CommandFn)(const CommandArgs& args);
+
+struct CommandSpec {
+    const char*    name;
+    CommandFn      handler;
+    CommandArgSpec args[CMD_MAX_ARGS];
+};
+
+inline const char* commandStatusName(CommandStatus s) {
+    switch (s) {
+        case CMD_OK:          return "ok";
+        case CMD_ERR_UNKNOWN: return "unknown_command";
+        case CMD_ERR_ARGS:    return "bad_args";
+        case CMD_ERR_PARSE:   return "bad_payload";
+        default:              return "failed";
+    }
+}
+
+// Perfect hash over the names of a command table: one multiply, one slot,
+// one strcmp to reject unknown names. The seed is searched once in build().
+template <size_t SLOTS>
+class CommandIndex {
+    static_assert((SLOTS & (SLOTS - 1)) == 0, "SLOTS must be a power of two");
+
+public:
+    CommandIndex() : _table(nullptr), _count(0), _seed(0), _shift(0) { memset(_slots, 0, sizeof(_slots)); }
+
+    // False on duplicate names or a table too large for SLOTS
+    bool build(const CommandSpec* table, size_t count) {
+        _table = table;
+        _count = 0;
+        if (count >= SLOTS || count > 254) return false;
+        for (size_t i = 0; i < count; i++) {
+            for (size_t j = 0; j < i; j++) {
+                if (strcmp(table[i].name, table[j].name) == 0) return false;
+            }
+        }
+        _shift = 32;
+        for (size_t s = SLOTS; s > 1; s >>= 1) _shift--;
+
+        for (uint32_t seed = 1; seed < 100000; seed++) {
+            memset(_slots, 0, sizeof(_slots));
+            bool ok = true;
+            for (size_t i = 0; i < count && ok; i++) {
+                size_t slot = slotOf(cmdHash(table[i].name), seed);
+                if (_slots[slot]) ok = false;
+                else              _slots[slot] = (uint8_t)(i + 1);
+            }
+            if (ok) {
+                _seed  = seed;
+                _count = count;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Index in the table, -1 if unknown
+    int find(const char* name, size_t len) const {
+        if (!_count) return -1;
+        uint8_t e = _slots[slotOf(cmdHashN(name, len), _seed)];
+        if (!e) return -1;
+        const char* candidate = _table[e - 1].name;
+        return strncmp(candidate, name, len) == 0 && candidate[len] == '\0' ? e - 1 : -1;
+    }
+
+    int find(const char* name) const { return find(name, strlen(name)); }
+
+    uint32_t seed() const { return _seed; }
+
+private:
+    const CommandSpec* _table;
+    size_t             _count;
+    uint32_t           _seed;
+    uint8_t            _shift;
+    uint8_t            _slots[SLOTS];   // table index + 1, 0 = empty
+
+    size_t slotOf(uint32_t hash, uint32_t seed) const {
+        uint32_t mixed = (hash ^ seed) * 0x9E3779B1UL;
+        return _shift >= 32 ? 0 : mixed >> _shift;
+    }
+};
+
+struct CommandStats {
+    uint32_t received;
+    uint32_t executed;
+    uint32_t failed;        // handler returned an error
+    uint32_t unknown;
+    uint32_t badArgs;
+    uint32_t parseErrors;
+    uint32_t dropped;       // queue full
+    uint32_t maxQueued;
+    uint32_t lastLatencyUs; // received -> handler done
+    uint32_t maxLatencyUs;
+    uint64_t totalLatencyUs;
+
+    uint32_t averageLatencyUs() const { return executed ? (uint32_t)(totalLatencyUs / executed) : 0; }
+};
+
+// Parsed command waiting for the UI task
+struct CommandJob {
+    int16_t       command;     // table index, -1 for an error reply only
+    CommandStatus status;      // CMD_OK when the handler has to run
+    uint32_t      receivedUs;
+    char          id[CMD_ID_MAX];
+    CommandArgs   args;
+};
+
+// Single producer / single consumer (UI task) ring. Producers on several
+// tasks must take turns: CommandDispatcher::submit() holds a lock.
+template <size_t DEPTH>
+class CommandQueue {
+    static_assert((DEPTH & (DEPTH - 1)) == 0, "DEPTH must be a power of two");
+
+public:
+    CommandQueue() : _head(0), _tail(0) {}
+
+    // Producer: slot to fill, then commit(). nullptr when full.
+    CommandJob* reserve() {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= DEPTH) return nullptr;
+        return &_jobs[head & (DEPTH - 1)];
+    }
+    void commit() { _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Consumer: oldest job, then release()
+    CommandJob* front() {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) return nullptr;
+        return &_jobs[tail & (DEPTH - 1)];
+    }
+    void release() { _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    size_t size() const { return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire); }
+
+private:
+    CommandJob            _jobs[DEPTH];
+    std::atomic<uint32_t> _head;
+    std::atomic<uint32_t> _tail;
+};
+
+#endif
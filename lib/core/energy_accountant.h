@@ -0,0 +1,245 @@
+#ifndef ENERGY_ACCOUNTANT_H
+#define ENERGY_ACCOUNTANT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Platform independent energy bookkeeping.
+//
+// Current samples (mA drawn from the battery) are integrated over time and
+// charged to the context that was active during each interval: page in
+// front, backlight level, speaker and radio state. Deep sleep is accounted
+// separately from its duration and an estimated sleep current. Named spans
+// (e.g. "pomodoro") collect everything charged while they are open, deep
+// sleep included; a paused span stays open but is not charged.
+//
+// The object is POD so the adapter can keep it in RTC slow memory and carry
+// the counters across deep sleep cycles.
+
+#define ENERGY_MAX_CONTEXTS 24
+#define ENERGY_MAX_SPANS    4
+#define ENERGY_SPAN_NAME    12
+
+struct EnergyContext {
+    int8_t  page;       // page index, -1 when no page is in front
+    uint8_t backlight;  // backlight level 0-255, 0 means display off
+    bool    speaker;
+    bool    radio;
+};
+
+// Backlight levels are grouped in the same buckets as the backlight governor
+inline uint8_t energyBacklightBucket(uint8_t level) {
+    return level == 0 ? 0 : 1 + (level - 1) / 64;
+}
+
+// Key of a context once the backlight level is bucketed:
+// page+1 (6 bits) | backlight bucket (3 bits) | speaker | radio
+inline uint16_t energyContextKey(const EnergyContext& c) {
+    return (uint16_t)(((c.page + 1) & 0x3F) << 5) | (energyBacklightBucket(c.backlight) << 2) |
+           (c.speaker ? 2 : 0) | (c.radio ? 1 : 0);
+}
+
+struct EnergyCounter {
+    uint32_t ms;
+    double   maMs;  // integrated charge in mA*ms
+
+    double mAh()      const { return maMs / 3600000.0; }
+    double averageMa() const { return ms ? maMs / ms : 0; }
+};
+
+struct EnergyContextSlot {
+    uint16_t      key;
+    EnergyContext context;
+    EnergyCounter counter;
+};
+
+struct EnergySpan {
+    char          name[ENERGY_SPAN_NAME];
+    bool          open;
+    bool          paused;
+    uint32_t      runs;
+    EnergyCounter counter;
+};
+
+// One line of a recorded trace: "t_ms,current_ma,page,backlight,speaker,radio"
+struct EnergyTraceSample {
+    uint32_t      tMs;
+    float         currentMa;
+    EnergyContext context;
+};
+
+inline bool parseEnergyTraceLine(const char* line, EnergyTraceSample& out) {
+    unsigned long t;
+    float         ma;
+    int           page, backlight, speaker, radio;
+    if (sscanf(line, "%lu,%f,%d,%d,%d,%d", &t, &ma, &page, &backlight, &speaker, &radio) != 6) {
+        return false;
+    }
+    out.tMs               = (uint32_t)t;
+    out.currentMa         = ma;
+    out.context.page      = (int8_t)page;
+    out.context.backlight = (uint8_t)backlight;
+    out.context.speaker   = speaker != 0;
+    out.context.radio     = radio != 0;
+    return true;
+}
+
+struct EnergyAccountant {
+    EnergyContextSlot slots[ENERGY_MAX_CONTEXTS];
+    uint8_t           slotCount;
+    uint32_t          droppedMs;      // time that found no free context slot
+    EnergyCounter     sleep;
+    EnergyCounter     total;
+    EnergySpan        spans[ENERGY_MAX_SPANS];
+    EnergyContext     context;
+    float             lastCurrentMa;
+    uint32_t          lastMs;
+    bool              started;
+
+    void reset() {
+        memset(this, 0, sizeof(*this));
+        context.page = -1;
+    }
+
+    // Charges the elapsed time at the last known current, then switches context
+    void setContext(uint32_t nowMs, const EnergyContext& ctx) {
+        advance(nowMs);
+        context = ctx;
+    }
+
+    void addSample(uint32_t nowMs, float currentMa) {
+        advance(nowMs);
+        lastCurrentMa = currentMa < 0 ? 0 : currentMa;
+    }
+
+    // Deep sleep cannot be sampled: duration x estimated sleep current
+    void addSleep(uint32_t sleepMs, float sleepCurrentMa) {
+        double charge = (double)sleepCurrentMa * sleepMs;
+        sleep.ms   += sleepMs;
+        sleep.maMs += charge;
+        total.ms   += sleepMs;
+        total.maMs += charge;
+        chargeSpans(sleepMs, charge);
+    }
+
+    // Resynchronises the clock after a reboot/wake without charging anything
+    void resume(uint32_t nowMs) {
+        lastMs  = nowMs;
+        started = true;
+    }
+
+    bool beginSpan(const char* name) {
+        EnergySpan* span = findSpan(name);
+        if (!span) {
+            for (int i = 0; i < ENERGY_MAX_SPANS && !span; i++) {
+                if (spans[i].name[0] == '\0') span = &spans[i];
+            }
+            if (!span) return false;
+            strncpy(span->name, name, ENERGY_SPAN_NAME - 1);
+        }
+        if (!span->open) span->runs++;
+        span->open   = true;
+        span->paused = false;
+        return true;
+    }
+
+    void endSpan(const char* name) {
+        EnergySpan* span = findSpan(name);
+        if (span) span->open = span->paused = false;
+    }
+
+    // Stops and restarts the charging of an open span, the run goes on
+    void pauseSpan(const char* name) {
+        EnergySpan* span = findSpan(name);
+        if (span && span->open) span->paused = true;
+    }
+
+    void resumeSpan(const char* name) {
+        EnergySpan* span = findSpan(name);
+        if (span) span->paused = false;
+    }
+
+    EnergySpan* findSpan(const char* name) {
+        for (int i = 0; i < ENERGY_MAX_SPANS; i++) {
+            if (spans[i].name[0] != '\0' && strncmp(spans[i].name, name, ENERGY_SPAN_NAME - 1) == 0) {
+                return &spans[i];
+            }
+        }
+        return nullptr;
+    }
+
+    // Host simulator: feeds a recorded trace, each sample also carrying the
+    // context that was active from that point on
+    void replay(const EnergyTraceSample* trace, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            if (!started) resume(trace[i].tMs);
+            setContext(trace[i].tMs, trace[i].context);
+            addSample(trace[i].tMs, trace[i].currentMa);
+        }
+    }
+
+    // Aggregates over every context matching a predicate, e.g. one page
+    template <typename Predicate>
+    EnergyCounter sum(Predicate matches) const {
+        EnergyCounter c = { 0, 0 };
+        for (uint8_t i = 0; i < slotCount; i++) {
+            if (!matches(slots[i].context)) continue;
+            c.ms   += slots[i].counter.ms;
+            c.maMs += slots[i].counter.maMs;
+        }
+        return c;
+    }
+
+    const EnergyContextSlot* slotFor(const EnergyContext& ctx) const {
+        uint16_t key = energyContextKey(ctx);
+        for (uint8_t i = 0; i < slotCount; i++) {
+            if (slots[i].key == key) return &slots[i];
+        }
+        return nullptr;
+    }
+
+private:
+    void advance(uint32_t nowMs) {
+        if (!started) { resume(nowMs); return; }
+        uint32_t dt = nowMs - lastMs;
+        lastMs = nowMs;
+        if (dt == 0) return;
+
+        double charge = (double)lastCurrentMa * dt;
+        total.ms   += dt;
+        total.maMs += charge;
+        chargeSpans(dt, charge);
+
+        EnergyContextSlot* slot = slotForWrite(context);
+        if (!slot) { droppedMs += dt; return; }
+        slot->counter.ms   += dt;
+        slot->counter.maMs += charge;
+    }
+
+    void chargeSpans(uint32_t dt, double charge) {
+        for (int i = 0; i < ENERGY_MAX_SPANS; i++) {
+            if (!spans[i].open || spans[i].paused) continue;
+            spans[i].counter.ms   += dt;
+            spans[i].counter.maMs += charge;
+        }
+    }
+
+    EnergyContextSlot* slotForWrite(const EnergyContext& ctx) {
+        uint16_t key = energyContextKey(ctx);
+        for (uint8_t i = 0; i < slotCount; i++) {
+            if (slots[i].key == key) return &slots[i];
+        }
+        if (slotCount >= ENERGY_MAX_CONTEXTS) return nullptr;
+        EnergyContextSlot& s = slots[slotCount++];
+        s.key     = key;
+        s.context = ctx;
+        s.counter.ms   = 0;
+        s.counter.maMs = 0;
+        return &s;
+    }
+};
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef FIXED_POOL_ALLOCATOR_H
+#define FIXED_POOL_ALLOCATOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <ArduinoJson.h>
+
+// ArduinoJson allocator over a fixed buffer: a JsonDocument built on it never
+// touches the heap and fails with NoMemory instead of growing. Bump
+// allocation, the whole buffer is reclaimed when the last block is freed
+// (JsonDocument::clear() or a new deserialize). The buffer must be 8-byte
+// aligned, e.g. a uint64_t array.
+class FixedPoolAllocator : public ArduinoJson::Allocator {
+public:
+    FixedPoolAllocator(void* buffer, size_t size)
+        : _buf((uint8_t*)buffer), _size(size), _used(0), _live(0), _last(nullptr),
+          _allocations(0), _failures(0), _highWater(0) {}
+
+    void* allocate(size_t n) override {
+        n = align(n);
+        _allocations++;
+        if (n + HEADER > _size - _used) {
+            _failures++;
+            return nullptr;
+        }
+        uint8_t* p = _buf + _used + HEADER;
+        blockSize(p) = n;
+        _used += HEADER + n;
+        _live++;
+        _last = p;
+        if (_used > _highWater) _highWater = _used;
+        return p;
+    }
+
+    void deallocate(void* p) override {
+        if (!p) return;
+        if (p == _last) {  // last block, give the space back now
+            _used = (uint8_t*)p - HEADER - _buf;
+            _last = nullptr;
+        }
+        if (_live && --_live == 0) {
+            _used = 0;
+            _last = nullptr;
+        }
+    }
+
+    // ArduinoJson grows string buffers and shrinks its slot pools this way:
+    // in place for the last block or when shrinking, a copy otherwise
+    void* reallocate(void* p, size_t n) override {
+        if (!p) return allocate(n);
+        n = align(n);
+        uint8_t* b = (uint8_t*)p;
+        if (b == _last) {
+            size_t start = b - _buf;
+            if (n > _size - start) {
+                _failures++;
+                return nullptr;
+            }
+            blockSize(b) = n;
+            _used = start + n;
+            if (_used > _highWater) _highWater = _used;
+            return p;
+        }
+        if (n <= blockSize(b)) return p;
+        void* q = allocate(n);
+        if (!q) return nullptr;
+        memcpy(q, p, blockSize(b));
+        _live--;  // p is abandoned until the pool resets
+        return q;
+    }
+
+    size_t   used()        const { return _used; }
+    size_t   capacity()    const { return _size; }
+    size_t   highWater()   const { return _highWater; }
+    uint32_t allocations() const { return _allocations; }
+    uint32_t failures()    const { return _failures; }
+
+private:
+    uint8_t* _buf;
+    size_t   _size;
+    size_t   _used;
+    size_t   _live;
+    uint8_t* _last;
+    uint32_t _allocations;
+    uint32_t _failures;
+    size_t   _highWater;
+
+    static const size_t HEADER = 8;  // block size, keeps blocks 8-byte aligned
+
+    static size_t  align(size_t n) { return (n + 7) & ~(size_t)7; }
+    static size_t& blockSize(uint8_t* p) { return *(size_t*)(p - HEADER); }
+};
+
+#endif
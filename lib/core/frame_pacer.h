@@ -0,0 +1,122 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// When the current page's loop() runs. A page declares a frame rate, or
+// an explicit time for its next frame, or neither: then loop() runs on
+// every main loop pass as it always did. Rate frames are on a fixed
+// schedule with a fixed timestep; when frames could not be run in time
+// the missed ones are skipped (dropped) and the next delta covers them.
+// Between frames the main loop may idle until the next one is due.
+
+#define FRAME_LATE_US  2000   // a frame starting later than this after its time is late
+
+struct PageFrameStats {
+    uint32_t frames;
+    uint32_t late;
+    uint32_t dropped;     // rate frames skipped
+    uint32_t timed;       // run at a time set by the page
+    uint32_t maxLateUs;
+    int64_t  activeUs;    // time as the current page, up to the last switch
+
+    void clear() {
+        frames = late = dropped = timed = maxLateUs = 0;
+        activeUs = 0;
+    }
+
+    // Achieved rate in tenths of a frame per second
+    uint32_t fpsX10(int64_t activeUs) const {
+        return activeUs > 0 ? (uint32_t)((int64_t)frames * 10000000LL / activeUs) : 0;
+    }
+};
+
+class FramePacer {
+public:
+    FramePacer() : _fps(0), _periodUs(0), _nextUs(0), _lastUs(0), _explicit(false) {}
+
+    // New policy, first frame at firstUs (now on a page switch)
+    void setRate(uint16_t fps, int64_t firstUs) {
+        _fps      = fps;
+        _periodUs = fps ? 1000000UL / fps : 0;
+        _nextUs   = firstUs;
+        _lastUs   = firstUs;
+        _explicit = false;
+    }
+
+    // Next frame at atUs instead, for that frame only; 0 keeps the rate.
+    // A time before the last frame (or the page switch) is stale: due now,
+    // not late by however long the page was away.
+    void setDeadline(int64_t atUs) {
+        if (!atUs) return;
+        _nextUs   = atUs > _lastUs ? atUs : _lastUs;
+        _explicit = true;
+    }
+
+    bool paced()             const { return _periodUs || _explicit; }
+    bool due(int64_t nowUs)  const { return !paced() || nowUs >= _nextUs; }
+
+    // At a due frame, returns the delta to pass to loop()
+    uint32_t beginFrame(int64_t nowUs, PageFrameStats& stats) {
+        if (paced()) {
+            int64_t lateUs = nowUs - _nextUs;
+            if (lateUs > FRAME_LATE_US) stats.late++;
+            if (lateUs > (int64_t)stats.maxLateUs) stats.maxLateUs = lateUs < UINT32_MAX ? (uint32_t)lateUs : UINT32_MAX;
+        }
+
+        uint32_t dt;
+        if (_explicit) stats.timed++;
+        if (_explicit || !_periodUs) {
+            dt      = (uint32_t)(nowUs - _lastUs);
+            _nextUs = nowUs + _periodUs;
+        } else {
+            // Fixed timestep, a multiple of the period when frames were skipped
+            dt       = _periodUs;
+            _nextUs += _periodUs;
+            while (_nextUs <= nowUs) {
+                _nextUs += _periodUs;
+                dt      += _periodUs;
+                stats.dropped++;
+            }
+        }
+        _explicit = false;
+        _lastUs   = nowUs;
+        stats.frames++;
+        return dt;
+    }
+
+    // How long the caller may idle before the next frame, at most maxUs
+    uint32_t idleUs(int64_t nowUs, uint32_t maxUs) const {
+        if (!paced()) return maxUs;
+        if (_nextUs <= nowUs) return 0;
+        return _nextUs - nowUs < maxUs ? (uint32_t)(_nextUs - nowUs) : maxUs;
+    }
+
+    uint16_t fps()      const { return _fps; }
+    uint32_t periodUs() const { return _periodUs; }
+    int64_t  nextUs()   const { return _nextUs; }
+
+private:
+    uint16_t _fps;
+    uint32_t _periodUs;   // 0: every pass
+    int64_t  _nextUs;
+    int64_t  _lastUs;
+    bool     _explicit;
+};
+
+inline size_t formatFrameStatsRow(const char* page, uint16_t targetFps, const PageFrameStats& s, int64_t activeUs,
+                                  char* out, size_t cap) {
+    uint32_t fps = s.fpsX10(activeUs);
+    char target[8];
+    if (s.timed)        snprintf(target, sizeof(target), "timed");
+    else if (targetFps) snprintf(target, sizeof(target), "%u", (unsigned)targetFps);
+    else                snprintf(target, sizeof(target), "pass");
+    int n = snprintf(out, cap, "%-10s %6s %5lu.%lu %8lu %6lu %7lu %6.1f", page, target,
+                     (unsigned long)(fps / 10), (unsigned long)(fps % 10), (unsigned long)s.frames,
+                     (unsigned long)s.late, (unsigned long)s.dropped, s.maxLateUs / 1000.0);
+    if (n < 0) n = 0;
+    return (size_t)n < cap ? (size_t)n : (cap ? cap - 1 : 0);
+}
+
+#endif
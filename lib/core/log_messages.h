@@ -0,0 +1,61 @@
+#ifndef LOG_MESSAGES_H
+#define LOG_MESSAGES_H
+
+#include <stdint.h>
+
+// Every deferred log message, X(ID, "format"). Records carry the index in
+// this list, never the text: append new entries at the end so older
+// captures still decode (tools/log_decode.py reads this file).
+// Arguments are 32 bits, %s is copied into the record (truncated).
+#define LOG_MESSAGES(X)                                                             \
+    X(LOG_DROPPED,          "%u log records dropped")                               \
+    X(MQTT_CONFIGURED,      "MQTT configured for %s:%u")                            \
+    X(MQTT_NO_WIFI,         "WiFi not connected, cannot connect to MQTT")           \
+    X(MQTT_CONNECTING,      "Connecting to MQTT broker %s")                         \
+    X(MQTT_DISCONNECTED,    "MQTT disconnected")                                    \
+    X(MQTT_PAYLOAD_TOO_LARGE, "%s payload for %s is %u bytes (max %u)")             \
+    X(MQTT_NOT_CONNECTED,   "Not connected to MQTT, %s subscribed on connect")      \
+    X(MQTT_SUBSCRIBING,     "Subscribing to %s")                                    \
+    X(MQTT_CANNOT_ROUTE,    "Cannot route %s")                                      \
+    X(MQTT_CONNECTED,       "Connected to MQTT broker, session present: %u")        \
+    X(MQTT_LOST,            "Disconnected from MQTT, reason %d")                    \
+    X(WIFI_CONNECTING,      "Connecting to WiFi...")                                \
+    X(WIFI_CONNECTED,       "WiFi connected in %u ms (%s), IP %u.%u.%u.%u")         \
+    X(WIFI_FAILED,          "WiFi connection failed after %u ms")                   \
+    X(WIFI_DISCONNECTED,    "WiFi disconnected")                                    \
+    X(WIFI_FAST_FALLBACK,   "Cached WiFi join failed after %u ms, full connect")    \
+    X(WIFI_SCAN_DONE,       "WiFi scan: %d networks in %u ms")                      \
+    X(TIME_SYNCED,          "Time synced, RTC was off by %d ms (delay %u ms)")      \
+    X(CMD_TABLE_REJECTED,   "Command table of %u rejected, duplicate or too many")
+
+#define LOG_MODULES(X) \
+    X(APP)                                                                          \
+    X(MQTT)                                                                         \
+    X(WIFI)                                                                         \
+    X(UPLINK)                                                                       \
+    X(TIME)                                                                         \
+    X(CMD)
+
+#define LOG_MSG_ENUM(id, fmt) LOG_MSG_##id,
+enum LogMessageId { LOG_MESSAGES(LOG_MSG_ENUM) LOG_MSG_COUNT };
+#undef LOG_MSG_ENUM
+
+#define LOG_MODULE_ENUM(name) LOG_MODULE_##name,
+enum LogModule { LOG_MODULES(LOG_MODULE_ENUM) LOG_MODULE_COUNT };
+#undef LOG_MODULE_ENUM
+
+inline const char* logMessageFormat(uint16_t id) {
+#define LOG_MSG_FORMAT(id, fmt) fmt,
+    static const char* const FORMATS[] = { LOG_MESSAGES(LOG_MSG_FORMAT) };
+#undef LOG_MSG_FORMAT
+    return id < LOG_MSG_COUNT ? FORMATS[id] : "?";
+}
+
+inline const char* logModuleName(uint8_t module) {
+#define LOG_MODULE_NAME(name) #name,
+    static const char* const NAMES[] = { LOG_MODULES(LOG_MODULE_NAME) };
+#undef LOG_MODULE_NAME
+    return module < LOG_MODULE_COUNT ? NAMES[module] : "?";
+}
+
+#endif
@@ -0,0 +1,211 @@
+#ifndef LOG_RING_H
+#define LOG_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include "log_messages.h"
+
+// Deferred logging: the caller only packs a fixed-size binary record (time,
+// level, module, message id, raw arguments) into a lock-free ring. Turning
+// it into text is done later by the drain side, or on the host from a
+// binary capture.
+
+#define LOG_ARG_WORDS     10
+#define LOG_SYNC_0        0xA5   // binary capture framing, before each record
+#define LOG_SYNC_1        0x5A
+
+enum LogLevel {
+    LOG_LEVEL_NONE = 0,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_DEBUG
+};
+
+// 48 bytes, little endian on the wire (same as in memory on ESP32)
+struct LogRecord {
+    uint32_t timeMs;
+    uint16_t message;
+    uint8_t  levelModule;   // level << 4 | module
+    uint8_t  words;         // argument words used
+    uint32_t args[LOG_ARG_WORDS];
+
+    uint8_t level()  const { return levelModule >> 4; }
+    uint8_t module() const { return levelModule & 0x0F; }
+};
+
+inline char logLevelLetter(uint8_t level) {
+    static const char LETTERS[] = "-EWID";
+    return level <= LOG_LEVEL_DEBUG ? LETTERS[level] : '?';
+}
+
+// Argument packing, one overload per accepted type
+inline void logPutWord(LogRecord& r, uint32_t v) {
+    if (r.words < LOG_ARG_WORDS) r.args[r.words++] = v;
+}
+inline void logPut(LogRecord& r, int v)           { logPutWord(r, (uint32_t)v); }
+inline void logPut(LogRecord& r, unsigned v)      { logPutWord(r, (uint32_t)v); }
+inline void logPut(LogRecord& r, long v)          { logPutWord(r, (uint32_t)v); }
+inline void logPut(LogRecord& r, unsigned long v) { logPutWord(r, (uint32_t)v); }
+inline void logPut(LogRecord& r, bool v)          { logPutWord(r, (uint32_t)v); }
+inline void logPut(LogRecord& r, double v) {
+    float    f = (float)v;
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    logPutWord(r, bits);
+}
+// Copied NUL-terminated into the remaining words, truncated to fit
+inline void logPut(LogRecord& r, const char* s) {
+    if (r.words >= LOG_ARG_WORDS) return;
+    char*  dst  = (char*)&r.args[r.words];
+    size_t room = (LOG_ARG_WORDS - r.words) * 4;
+    size_t len  = s ? strlen(s) : 0;
+    if (len > room - 1) len = room - 1;
+    if (len) memcpy(dst, s, len);
+    dst[len] = '\0';
+    r.words += (uint8_t)((len + 4) / 4);
+}
+
+inline void logPack(LogRecord&) {}
+
+template <typename T, typename... Rest>
+inline void logPack(LogRecord& r, T first, Rest... rest) {
+    logPut(r, first);
+    logPack(r, rest...);
+}
+
+// printf of the message format with the packed arguments. Length modifiers
+// are ignored, every argument is 32 bits. Returns the length written.
+inline size_t logFormatRecord(const LogRecord& r, char* out, size_t cap) {
+    const char* fmt  = logMessageFormat(r.message);
+    size_t      n    = 0;
+    uint8_t     word = 0;
+    if (!cap) return 0;
+
+    while (*fmt && n + 1 < cap) {
+        if (*fmt != '%') {
+            out[n++] = *fmt++;
+            continue;
+        }
+        if (fmt[1] == '%') {
+            out[n++] = '%';
+            fmt += 2;
+            continue;
+        }
+        char   spec[16];
+        size_t s = 0;
+        spec[s++] = *fmt++;
+        while (*fmt && strchr("-+ #0123456789.", *fmt) && s < sizeof(spec) - 2) spec[s++] = *fmt++;
+        while (*fmt && strchr("hlzjt", *fmt)) fmt++;
+        char conv = *fmt ? *fmt++ : 'd';
+        spec[s++] = conv;
+        spec[s]   = '\0';
+
+        int written;
+        if (conv == 's') {
+            const char* str = "?";
+            if (word < r.words) {
+                str = (const char*)&r.args[word];
+                size_t len = strnlen(str, (r.words - word) * 4);
+                word += (uint8_t)((len + 4) / 4);
+            }
+            written = snprintf(out + n, cap - n, spec, str);
+        } else if (word >= r.words) {
+            written = snprintf(out + n, cap - n, "?");
+        } else if (strchr("feEgGaA", conv)) {
+            float f;
+            memcpy(&f, &r.args[word++], sizeof(f));
+            written = snprintf(out + n, cap - n, spec, (double)f);
+        } else if (strchr("di", conv)) {
+            written = snprintf(out + n, cap - n, spec, (int)(int32_t)r.args[word++]);
+        } else {
+            written = snprintf(out + n, cap - n, spec, (unsigned)r.args[word++]);
+        }
+        if (written < 0) break;
+        n += (size_t)written < cap - n ? (size_t)written : cap - n - 1;
+    }
+    out[n] = '\0';
+    return n;
+}
+
+// "[   12.345] I MQTT  Connected to MQTT broker, session present: 1"
+inline size_t logFormatLine(const LogRecord& r, char* out, size_t cap) {
+    int head = snprintf(out, cap, "[%6u.%03u] %c %-6s ", (unsigned)(r.timeMs / 1000), (unsigned)(r.timeMs % 1000),
+                        logLevelLetter(r.level()), logModuleName(r.module()));
+    if (head < 0 || (size_t)head >= cap) return cap ? cap - 1 : 0;
+    return head + logFormatRecord(r, out + head, cap - head);
+}
+
+// Bounded multi-producer / multi-consumer queue (Vyukov): writers on any
+// task or core claim a cell with one compare-and-swap, no lock, no wait.
+// A full ring drops the new record and counts it.
+template <size_t N>
+class LogRing {
+    static_assert((N & (N - 1)) == 0, "N must be a power of two");
+
+public:
+    LogRing() : _enqueue(0), _dequeue(0), _dropped(0), _written(0) {
+        for (size_t i = 0; i < N; i++) _cells[i].seq.store((uint32_t)i, std::memory_order_relaxed);
+    }
+
+    bool push(const LogRecord& record) {
+        uint32_t pos = _enqueue.load(std::memory_order_relaxed);
+        Cell*    cell;
+        for (;;) {
+            cell = &_cells[pos & (N - 1)];
+            int32_t diff = (int32_t)(cell->seq.load(std::memory_order_acquire) - pos);
+            if (diff == 0) {
+                if (_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = _enqueue.load(std::memory_order_relaxed);
+            }
+        }
+        cell->record = record;
+        cell->seq.store(pos + 1, std::memory_order_release);
+        _written.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool pop(LogRecord& out) {
+        uint32_t pos = _dequeue.load(std::memory_order_relaxed);
+        Cell*    cell;
+        for (;;) {
+            cell = &_cells[pos & (N - 1)];
+            int32_t diff = (int32_t)(cell->seq.load(std::memory_order_acquire) - (pos + 1));
+            if (diff == 0) {
+                if (_dequeue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _dequeue.load(std::memory_order_relaxed);
+            }
+        }
+        out = cell->record;
+        cell->seq.store(pos + N, std::memory_order_release);
+        return true;
+    }
+
+    size_t   size()    const { return _enqueue.load(std::memory_order_relaxed) - _dequeue.load(std::memory_order_relaxed); }
+    uint32_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+    uint32_t written() const { return _written.load(std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<uint32_t> seq;
+        LogRecord             record;
+    };
+
+    Cell                  _cells[N];
+    std::atomic<uint32_t> _enqueue;
+    std::atomic<uint32_t> _dequeue;
+    std::atomic<uint32_t> _dropped;
+    std::atomic<uint32_t> _written;
+};
+
+#endif
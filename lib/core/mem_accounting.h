@@ -0,0 +1,156 @@
+#ifndef MEM_ACCOUNTING_H
+#define MEM_ACCOUNTING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+
+// Heap accounting per subsystem: live bytes, peak, allocation and free
+// counts, plus allocations made after setup() was sealed. Every field is a
+// relaxed atomic and the constructor is constexpr, so a static instance is
+// usable by operator new before any static constructor has run.
+
+// X(TAG, "name"): append only, the tag is stored in each block header
+#define MEM_TAGS(X)                 \
+    X(OTHER,     "other")           \
+    X(DISPLAY,   "display")         \
+    X(INPUT,     "input")           \
+    X(UI,        "ui")              \
+    X(POWER,     "power")           \
+    X(TIME,      "time")            \
+    X(NET,       "net")             \
+    X(TELEMETRY, "telemetry")
+
+enum MemTag : uint8_t {
+#define MEM_TAG_ENUM(tag, name) MEM_TAG_##tag,
+    MEM_TAGS(MEM_TAG_ENUM)
+#undef MEM_TAG_ENUM
+    MEM_TAG_COUNT
+};
+
+inline const char* memTagName(uint8_t tag) {
+    static const char* const NAMES[] = {
+#define MEM_TAG_NAME(tag, name) name,
+        MEM_TAGS(MEM_TAG_NAME)
+#undef MEM_TAG_NAME
+    };
+    return tag < MEM_TAG_COUNT ? NAMES[tag] : "?";
+}
+
+struct MemTagStats {
+    std::atomic<uint32_t> live;     // bytes
+    std::atomic<uint32_t> peak;
+    std::atomic<uint32_t> allocs;
+    std::atomic<uint32_t> frees;
+
+    constexpr MemTagStats() : live(0), peak(0), allocs(0), frees(0) {}
+};
+
+class MemAccounting {
+public:
+    constexpr MemAccounting() : _tags(), _sealed(false), _lateAllocs(0), _lateCaller(0) {}
+
+    // Returns true when the allocation happened after seal()
+    bool onAlloc(uint8_t tag, uint32_t bytes, uintptr_t caller = 0) {
+        MemTagStats& s = _tags[tag < MEM_TAG_COUNT ? tag : (uint8_t)MEM_TAG_OTHER];
+        s.allocs.fetch_add(1, std::memory_order_relaxed);
+        uint32_t live = s.live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        uint32_t peak = s.peak.load(std::memory_order_relaxed);
+        while (live > peak && !s.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        if (!_sealed.load(std::memory_order_relaxed)) return false;
+        _lateAllocs.fetch_add(1, std::memory_order_relaxed);
+        if (caller) _lateCaller.store(caller, std::memory_order_relaxed);
+        return true;
+    }
+
+    void onFree(uint8_t tag, uint32_t bytes) {
+        MemTagStats& s = _tags[tag < MEM_TAG_COUNT ? tag : (uint8_t)MEM_TAG_OTHER];
+        s.frees.fetch_add(1, std::memory_order_relaxed);
+        s.live.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    // End of setup(): from now on every allocation is counted as late
+    void seal()         { _sealed.store(true, std::memory_order_relaxed); }
+    bool sealed() const { return _sealed.load(std::memory_order_relaxed); }
+
+    uint32_t  live(uint8_t tag)   const { return _tags[tag].live.load(std::memory_order_relaxed); }
+    uint32_t  peak(uint8_t tag)   const { return _tags[tag].peak.load(std::memory_order_relaxed); }
+    uint32_t  allocs(uint8_t tag) const { return _tags[tag].allocs.load(std::memory_order_relaxed); }
+    uint32_t  frees(uint8_t tag)  const { return _tags[tag].frees.load(std::memory_order_relaxed); }
+    uint32_t  lateAllocs()        const { return _lateAllocs.load(std::memory_order_relaxed); }
+    uintptr_t lateCaller()        const { return _lateCaller.load(std::memory_order_relaxed); }
+
+    uint32_t totalLive() const {
+        uint32_t n = 0;
+        for (uint8_t t = 0; t < MEM_TAG_COUNT; t++) n += live(t);
+        return n;
+    }
+
+    // Peaks restart from the current live bytes
+    void resetPeaks() {
+        for (uint8_t t = 0; t < MEM_TAG_COUNT; t++) _tags[t].peak.store(live(t), std::memory_order_relaxed);
+    }
+
+private:
+    MemTagStats              _tags[MEM_TAG_COUNT];
+    std::atomic<bool>        _sealed;
+    std::atomic<uint32_t>    _lateAllocs;
+    std::atomic<uintptr_t>   _lateCaller;   // return address of the last late allocation
+};
+
+// Bump allocator over a static buffer, lock-free. Nothing is ever given
+// back: meant for objects that live as long as the firmware.
+class StaticArena {
+public:
+    constexpr StaticArena(uint8_t* buffer, size_t size) : _buf(buffer), _size(size), _used(0), _failures(0) {}
+
+    void* allocate(size_t n, size_t alignment = 8) {
+        size_t used = _used.load(std::memory_order_relaxed);
+        for (;;) {
+            size_t start = (used + alignment - 1) & ~(alignment - 1);
+            if (start > _size || n > _size - start) {
+                _failures.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            if (_used.compare_exchange_weak(used, start + n, std::memory_order_relaxed)) return _buf + start;
+        }
+    }
+
+    bool contains(const void* p) const { return (const uint8_t*)p >= _buf && (const uint8_t*)p < _buf + _size; }
+
+    size_t   used()     const { return _used.load(std::memory_order_relaxed); }
+    size_t   capacity() const { return _size; }
+    uint32_t failures() const { return _failures.load(std::memory_order_relaxed); }
+
+private:
+    uint8_t*              _buf;
+    size_t                _size;
+    std::atomic<size_t>   _used;
+    std::atomic<uint32_t> _failures;
+};
+
+// Share of the free heap that a single allocation cannot reach, in percent
+inline uint8_t memFragmentationPct(size_t freeBytes, size_t largestBlock) {
+    if (!freeBytes || largestBlock >= freeBytes) return 0;
+    return (uint8_t)(100 - (uint64_t)largestBlock * 100 / freeBytes);
+}
+
+#define MEM_TAG_ROW_MAX  96   // longest row, 10-digit counters included
+
+//   display       live    1284  peak    1284  allocs    3  frees    0
+// Formatted whole first, then cut to cap: a short out only loses the end
+inline size_t memFormatTagRow(const MemAccounting& m, uint8_t tag, char* out, size_t cap) {
+    char row[MEM_TAG_ROW_MAX];
+    int  n = snprintf(row, sizeof(row), "%-10s live %7u  peak %7u  allocs %5u  frees %5u", memTagName(tag),
+                      (unsigned)m.live(tag), (unsigned)m.peak(tag), (unsigned)m.allocs(tag), (unsigned)m.frees(tag));
+    if (!cap) return 0;
+    size_t len = n < 0 ? 0 : (size_t)n < sizeof(row) ? (size_t)n : sizeof(row) - 1;
+    if (len >= cap) len = cap - 1;
+    memcpy(out, row, len);
+    out[len] = '\0';
+    return len;
+}
+
+#endif
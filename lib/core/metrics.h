@@ -0,0 +1,188 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+
+// Runtime metrics: counters, gauges and fixed-bucket histograms declared as
+// static objects, which link themselves into one registry at startup.
+// Updates are relaxed atomics, safe from any task or core; a snapshot may
+// mix values from slightly different instants, which is fine for metrics.
+
+#define METRIC_MAX_BUCKETS  8   // plus one overflow bucket
+
+enum MetricType {
+    METRIC_COUNTER = 0,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM
+};
+
+class Metric {
+public:
+    const char*   name() const { return _name; }
+    MetricType    type() const { return _type; }
+    const Metric* next() const { return _next; }
+
+    // Registry, in declaration order
+    static const Metric* first() { return registry().head; }
+
+    static const Metric* find(const char* name) {
+        for (const Metric* m = first(); m; m = m->next()) {
+            if (strcmp(m->name(), name) == 0) return m;
+        }
+        return nullptr;
+    }
+
+    static size_t count() {
+        size_t n = 0;
+        for (const Metric* m = first(); m; m = m->next()) n++;
+        return n;
+    }
+
+protected:
+    Metric(const char* name, MetricType type) : _name(name), _type(type), _next(nullptr) {
+        Registry& r = registry();
+        if (r.tail) r.tail->_next = this;
+        else        r.head        = this;
+        r.tail = this;
+    }
+
+private:
+    struct Registry {
+        Metric* head;
+        Metric* tail;
+    };
+
+    // Constant-initialized, usable before any other static constructor runs
+    static Registry& registry() {
+        static Registry r = { nullptr, nullptr };
+        return r;
+    }
+
+    const char* _name;
+    MetricType  _type;
+    Metric*     _next;
+
+    Metric(const Metric&);
+    Metric& operator=(const Metric&);
+};
+
+class MetricCounter : public Metric {
+public:
+    explicit MetricCounter(const char* name) : Metric(name, METRIC_COUNTER), _value(0) {}
+
+    void     inc()                { _value.fetch_add(1, std::memory_order_relaxed); }
+    void     add(uint32_t n)      { _value.fetch_add(n, std::memory_order_relaxed); }
+    uint32_t value() const        { return _value.load(std::memory_order_relaxed); }
+    void     reset()              { _value.store(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> _value;
+};
+
+class MetricGauge : public Metric {
+public:
+    explicit MetricGauge(const char* name) : Metric(name, METRIC_GAUGE), _value(0) {}
+
+    void    set(int32_t v)  { _value.store(v, std::memory_order_relaxed); }
+    void    add(int32_t d)  { _value.fetch_add(d, std::memory_order_relaxed); }
+    int32_t value() const   { return _value.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int32_t> _value;
+};
+
+// bounds: ascending upper limits (inclusive), values above the last one go
+// to the overflow bucket
+class MetricHistogram : public Metric {
+public:
+    MetricHistogram(const char* name, const uint32_t* bounds, uint8_t boundCount)
+        : Metric(name, METRIC_HISTOGRAM), _bounds(bounds),
+          _boundCount(boundCount > METRIC_MAX_BUCKETS ? METRIC_MAX_BUCKETS : boundCount) {
+        reset();
+    }
+
+    void observe(uint32_t v) {
+        uint8_t b = 0;
+        while (b < _boundCount && v > _bounds[b]) b++;
+        _buckets[b].fetch_add(1, std::memory_order_relaxed);
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _sum.fetch_add(v, std::memory_order_relaxed);
+        uint32_t seen = _max.load(std::memory_order_relaxed);
+        while (v > seen && !_max.compare_exchange_weak(seen, v, std::memory_order_relaxed)) {}
+    }
+
+    uint8_t  boundCount()       const { return _boundCount; }
+    uint32_t bound(uint8_t i)   const { return _bounds[i]; }
+    uint32_t bucket(uint8_t i)  const { return _buckets[i].load(std::memory_order_relaxed); }  // 0..boundCount
+    uint32_t count()            const { return _count.load(std::memory_order_relaxed); }
+    uint32_t sum()              const { return _sum.load(std::memory_order_relaxed); }
+    uint32_t max()              const { return _max.load(std::memory_order_relaxed); }
+    uint32_t average()          const { uint32_t n = count(); return n ? sum() / n : 0; }
+
+    // Upper bound of the bucket holding the p-th percentile (max() past the last bound)
+    uint32_t percentile(uint8_t p) const {
+        uint32_t n = count();
+        if (!n) return 0;
+        uint32_t rank = (n * p + 99) / 100, seen = 0;
+        for (uint8_t b = 0; b < _boundCount; b++) {
+            seen += bucket(b);
+            if (seen >= rank) return _bounds[b];
+        }
+        return max();
+    }
+
+    void reset() {
+        for (uint8_t b = 0; b <= METRIC_MAX_BUCKETS; b++) _buckets[b].store(0, std::memory_order_relaxed);
+        _count.store(0, std::memory_order_relaxed);
+        _sum.store(0, std::memory_order_relaxed);
+        _max.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    const uint32_t*       _bounds;
+    uint8_t               _boundCount;
+    std::atomic<uint32_t> _buckets[METRIC_MAX_BUCKETS + 1];
+    std::atomic<uint32_t> _count;
+    std::atomic<uint32_t> _sum;
+    std::atomic<uint32_t> _max;
+};
+
+// Counters and histograms back to zero, gauges keep their last value
+inline void metricsReset() {
+    for (const Metric* m = Metric::first(); m; m = m->next()) {
+        if (m->type() == METRIC_COUNTER)   ((MetricCounter*)m)->reset();
+        if (m->type() == METRIC_HISTOGRAM) ((MetricHistogram*)m)->reset();
+    }
+}
+
+// One row of the text table:
+//   page_switches         counter       12
+//   wifi_connect_ms       histogram     n=5 avg=812 p90<=2000 max=1900 | 0 1 3 1 0 0 0 0
+inline size_t metricsFormatRow(const Metric& m, char* out, size_t cap) {
+    int n = 0;
+    switch (m.type()) {
+        case METRIC_COUNTER:
+            n = snprintf(out, cap, "%-22s counter   %10u", m.name(), (unsigned)((const MetricCounter&)m).value());
+            break;
+        case METRIC_GAUGE:
+            n = snprintf(out, cap, "%-22s gauge     %10d", m.name(), (int)((const MetricGauge&)m).value());
+            break;
+        case METRIC_HISTOGRAM: {
+            const MetricHistogram& h = (const MetricHistogram&)m;
+            n = snprintf(out, cap, "%-22s histogram n=%u avg=%u p90<=%u max=%u |", m.name(), (unsigned)h.count(),
+                         (unsigned)h.average(), (unsigned)h.percentile(90), (unsigned)h.max());
+            for (uint8_t b = 0; b <= h.boundCount() && n > 0 && (size_t)n < cap; b++) {
+                n += snprintf(out + n, cap - n, " %u", (unsigned)h.bucket(b));
+            }
+            break;
+        }
+    }
+    if (n < 0) n = 0;
+    return (size_t)n < cap ? (size_t)n : (cap ? cap - 1 : 0);
+}
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef MQTT_MESSAGE_H
+#define MQTT_MESSAGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Read-only view of a received MQTT message. Nothing is copied for single
+// segment messages: topic and payload point into the client's receive buffer
+// (or a reassembly buffer) and are only valid during the callback.
+// The payload is NOT NUL-terminated, always use length.
+struct MqttMessageView {
+    const char* topic;
+    const char* payload;
+    size_t      length;
+    uint8_t     qos;
+    bool        retain;
+    bool        dup;
+};
+
+struct MqttMessageProperties {
+    uint8_t qos;
+    bool    retain;
+    bool    dup;
+};
+
+struct MqttRxStats {
+    uint32_t messages;       // delivered to subscribers
+    uint32_t zeroCopy;       // delivered straight from the client buffer
+    uint32_t reassembled;    // delivered from a reassembly buffer
+    uint32_t fragments;      // segments received for split messages
+    uint32_t poolExhausted;  // split messages dropped, no free buffer
+    uint32_t oversize;       // split messages dropped, larger than a buffer
+    uint32_t outOfOrder;     // split messages dropped, gap between segments
+    uint32_t orphans;        // segments belonging to an already dropped message
+    uint32_t expired;        // split messages dropped, next segment never came
+};
+
+#endif
@@ -0,0 +1,248 @@
+#ifndef MQTT_OUTBOX_H
+#define MQTT_OUTBOX_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <functional>
+
+// Store-and-forward queue for publishes made while the client is offline.
+//
+// Records (topic, payload, qos, retain, enqueue time) are packed back to back
+// in a caller-provided byte arena used as a ring, so the adapter decides where
+// the memory lives (PSRAM or a static buffer). Replay is strictly FIFO.
+//
+// When full, the oldest records are evicted; with an evict handler set they
+// are offered to it first (e.g. to spill them to flash). With
+// KEEP_LATEST_PER_TOPIC a new publish also supersedes the queued ones on the
+// same topic, which are skipped on replay and reclaimed when they reach the head.
+
+enum MqttOutboxPolicy {
+    MQTT_OUTBOX_DROP_OLDEST = 0,
+    MQTT_OUTBOX_KEEP_LATEST_PER_TOPIC
+};
+
+struct MqttOutboxRecord {
+    const char*    topic;
+    const uint8_t* payload;
+    size_t         length;
+    uint8_t        qos;
+    bool           retain;
+    uint32_t       enqueuedMs;
+};
+
+struct MqttOutboxStats {
+    uint32_t depth;        // live records queued in RAM
+    uint32_t bytesUsed;
+    uint32_t capacity;
+    uint32_t oldestAgeMs;
+    uint32_t spillDepth;   // records waiting in the flash spill, if any
+    uint32_t enqueued;
+    uint32_t replayed;
+    uint32_t dropped;      // evicted and lost
+    uint32_t superseded;   // replaced by a newer publish on the same topic
+    uint32_t rejected;     // larger than the whole outbox
+    uint32_t spilled;      // evicted to the evict handler
+};
+
+typedef std::function<bool(const MqttOutboxRecord&)> MqttOutboxEvictHandler;
+
+class MqttOutbox {
+public:
+    static const size_t HEADER_SIZE = 12;
+
+    MqttOutbox() : _buf(nullptr), _size(0), _policy(MQTT_OUTBOX_DROP_OLDEST) {
+        memset(&_stats, 0, sizeof(_stats));
+        clear();
+    }
+
+    void begin(uint8_t* buffer, size_t size, MqttOutboxPolicy policy = MQTT_OUTBOX_DROP_OLDEST) {
+        _buf    = buffer;
+        _size   = size & ~(size_t)3;
+        _policy = policy;
+        clear();
+    }
+
+    void setPolicy(MqttOutboxPolicy policy)           { _policy = policy; }
+    MqttOutboxPolicy policy() const                   { return _policy; }
+    void setEvictHandler(MqttOutboxEvictHandler h)    { _onEvict = h; }
+
+    void clear() {
+        _head = _tail = 0;
+        _records = _live = 0;
+    }
+
+    bool push(const char* topic, const uint8_t* payload, size_t length,
+              uint8_t qos, bool retain, uint32_t nowMs) {
+        size_t topicLen = strlen(topic);
+        size_t need     = recordSize(topicLen, length);
+        if (!_buf || topicLen >= 0xFFFF || length > 0xFFFF || need > _size) {
+            _stats.rejected++;
+            return false;
+        }
+
+        if (_policy == MQTT_OUTBOX_KEEP_LATEST_PER_TOPIC) supersede(topic, topicLen);
+
+        size_t at;
+        while (!reserve(need, at)) evictOldest();
+
+        Header h;
+        h.topicLen   = (uint16_t)topicLen;
+        h.payloadLen = (uint16_t)length;
+        h.enqueuedMs = nowMs;
+        h.qos        = qos;
+        h.flags      = retain ? FLAG_RETAIN : 0;
+        h.reserved   = 0;
+        memcpy(_buf + at, &h, HEADER_SIZE);
+        memcpy(_buf + at + HEADER_SIZE, topic, topicLen + 1);
+        if (length) memcpy(_buf + at + HEADER_SIZE + topicLen + 1, payload, length);
+
+        _tail = at + need;
+        _records++;
+        _live++;
+        _stats.enqueued++;
+        return true;
+    }
+
+    // Oldest live record. Pointers stay valid until the next push/pop/clear.
+    bool peek(MqttOutboxRecord& out) {
+        while (_records > 0) {
+            Header h = header(_head);
+            if (!(h.flags & FLAG_DEAD)) {
+                out.topic      = (const char*)(_buf + _head + HEADER_SIZE);
+                out.payload    = _buf + _head + HEADER_SIZE + h.topicLen + 1;
+                out.length     = h.payloadLen;
+                out.qos        = h.qos;
+                out.retain     = (h.flags & FLAG_RETAIN) != 0;
+                out.enqueuedMs = h.enqueuedMs;
+                return true;
+            }
+            release();
+        }
+        return false;
+    }
+
+    // Removes the record returned by peek() once it has been handed to the client
+    void pop() {
+        MqttOutboxRecord r;
+        if (!peek(r)) return;
+        _live--;
+        _stats.replayed++;
+        release();
+    }
+
+    bool     empty() const { return _live == 0; }
+    uint32_t depth() const { return _live; }
+
+    size_t bytesUsed() const {
+        if (_records == 0) return 0;
+        return _tail > _head ? _tail - _head : _size - _head + _tail;
+    }
+
+    uint32_t oldestAgeMs(uint32_t nowMs) {
+        MqttOutboxRecord r;
+        return peek(r) ? nowMs - r.enqueuedMs : 0;
+    }
+
+    MqttOutboxStats stats(uint32_t nowMs) {
+        MqttOutboxStats s = _stats;
+        s.depth       = _live;
+        s.bytesUsed   = (uint32_t)bytesUsed();
+        s.capacity    = (uint32_t)_size;
+        s.oldestAgeMs = oldestAgeMs(nowMs);
+        return s;
+    }
+
+    void resetStats() { memset(&_stats, 0, sizeof(_stats)); }
+
+private:
+    static const uint8_t  FLAG_RETAIN = 0x01;
+    static const uint8_t  FLAG_DEAD   = 0x02;
+    static const uint16_t WRAP_MARKER = 0xFFFF;
+
+    struct Header {
+        uint16_t topicLen;
+        uint16_t payloadLen;
+        uint32_t enqueuedMs;
+        uint8_t  qos;
+        uint8_t  flags;
+        uint16_t reserved;
+    };
+
+    uint8_t*               _buf;
+    size_t                 _size;
+    MqttOutboxPolicy       _policy;
+    MqttOutboxEvictHandler _onEvict;
+    size_t                 _head;     // oldest record
+    size_t                 _tail;     // next write position
+    uint32_t               _records;  // live + superseded
+    uint32_t               _live;
+    MqttOutboxStats        _stats;
+
+    static size_t recordSize(size_t topicLen, size_t payloadLen) {
+        return (HEADER_SIZE + topicLen + 1 + payloadLen + 3) & ~(size_t)3;
+    }
+
+    Header header(size_t at) const {
+        Header h;
+        memcpy(&h, _buf + at, HEADER_SIZE);
+        return h;
+    }
+
+    // Finds room for a contiguous record, wrapping to the start when needed
+    bool reserve(size_t need, size_t& at) {
+        if (_records == 0) { _head = _tail = 0; at = 0; return true; }
+        if (_tail > _head) {
+            if (_size - _tail >= need) { at = _tail; return true; }
+            if (_head >= need) {
+                if (_size - _tail >= HEADER_SIZE) {
+                    uint16_t marker = WRAP_MARKER;
+                    memcpy(_buf + _tail, &marker, sizeof(marker));
+                }
+                at = 0;
+                return true;
+            }
+            return false;
+        }
+        if (_head - _tail >= need) { at = _tail; return true; }
+        return false;
+    }
+
+    void evictOldest() {
+        Header h = header(_head);
+        if (!(h.flags & FLAG_DEAD)) {
+            MqttOutboxRecord r;
+            peek(r);
+            if (_onEvict && _onEvict(r)) _stats.spilled++;
+            else                         _stats.dropped++;
+            _live--;
+        }
+        release();
+    }
+
+    // Frees the record at the head
+    void release() {
+        Header h = header(_head);
+        _head += recordSize(h.topicLen, h.payloadLen);
+        if (--_records == 0) { _head = _tail = 0; return; }
+        if (_size - _head < HEADER_SIZE || header(_head).topicLen == WRAP_MARKER) _head = 0;
+    }
+
+    void supersede(const char* topic, size_t topicLen) {
+        size_t at = _head;
+        for (uint32_t i = 0; i < _records; i++) {
+            if (_size - at < HEADER_SIZE || header(at).topicLen == WRAP_MARKER) at = 0;
+            Header h = header(at);
+            if (!(h.flags & FLAG_DEAD) && h.topicLen == topicLen &&
+                memcmp(_buf + at + HEADER_SIZE, topic, topicLen) == 0) {
+                h.flags |= FLAG_DEAD;
+                memcpy(_buf + at, &h, HEADER_SIZE);
+                _live--;
+                _stats.superseded++;
+            }
+            at += recordSize(h.topicLen, h.payloadLen);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef MQTT_REASSEMBLER_H
+#define MQTT_REASSEMBLER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "mqtt_message.h"
+
+// Reassembles MQTT payloads split across TCP segments (AsyncMqttClient calls
+// onMessage once per segment with index/total) into a fixed pool of buffers.
+// Unsplit messages are passed through without copying. No heap, no logging.
+// A split message whose next segment does not come within
+// MQTT_RX_PART_TIMEOUT_MS gives its buffer back.
+
+#ifndef MQTT_RX_PART_TIMEOUT_MS
+#define MQTT_RX_PART_TIMEOUT_MS 5000
+#endif
+
+template <size_t SLOTS, size_t SLOT_SIZE, size_t TOPIC_MAX>
+class MqttReassembler {
+public:
+    MqttReassembler() : _stats() { reset(); }
+
+    // Frees every buffer, e.g. after a disconnect cut a message in half
+    void reset() {
+        for (size_t i = 0; i < SLOTS; i++) _slots[i].busy = false;
+    }
+
+    const MqttRxStats& stats() const { return _stats; }
+    void resetStats() { memset(&_stats, 0, sizeof(_stats)); }
+
+    size_t busySlots() const {
+        size_t n = 0;
+        for (size_t i = 0; i < SLOTS; i++) if (_slots[i].busy) n++;
+        return n;
+    }
+
+    // deliver(const MqttMessageView&) is called once per complete message
+    template <typename Deliver>
+    void feed(const char* topic, const char* payload, size_t len, size_t index, size_t total,
+              const MqttMessageProperties& props, uint32_t nowMs, Deliver& deliver) {
+        if (index == 0 && len >= total) {
+            MqttMessageView view = { topic, payload, total, props.qos, props.retain, props.dup };
+            _stats.messages++;
+            _stats.zeroCopy++;
+            deliver(view);
+            return;
+        }
+
+        _stats.fragments++;
+        expire(nowMs);
+        Slot* slot = find(topic, total);
+
+        if (index == 0) {
+            if (slot) { slot->busy = false; _stats.outOfOrder++; }  // restarted, drop stale copy
+            if (total > SLOT_SIZE || strlen(topic) >= TOPIC_MAX) { _stats.oversize++; return; }
+            slot = acquire();
+            if (!slot) { _stats.poolExhausted++; return; }
+            strcpy(slot->topic, topic);
+            slot->total    = total;
+            slot->received = 0;
+            slot->props    = props;
+        } else if (!slot) {
+            _stats.orphans++;
+            return;
+        }
+
+        if (index != slot->received || index + len > slot->total) {
+            slot->busy = false;
+            _stats.outOfOrder++;
+            return;
+        }
+
+        memcpy(slot->data + index, payload, len);
+        slot->received += len;
+        slot->lastMs    = nowMs;
+        if (slot->received < slot->total) return;
+
+        MqttMessageView view = { slot->topic, slot->data, slot->total,
+                                 slot->props.qos, slot->props.retain, slot->props.dup };
+        _stats.messages++;
+        _stats.reassembled++;
+        deliver(view);
+        slot->busy = false;
+    }
+
+private:
+    struct Slot {
+        bool                  busy;
+        size_t                total;
+        size_t                received;
+        uint32_t              lastMs;     // last segment
+        MqttMessageProperties props;
+        char                  topic[TOPIC_MAX];
+        char                  data[SLOT_SIZE];
+    };
+
+    Slot        _slots[SLOTS];
+    MqttRxStats _stats;
+
+    Slot* find(const char* topic, size_t total) {
+        for (size_t i = 0; i < SLOTS; i++) {
+            if (_slots[i].busy && _slots[i].total == total && strcmp(_slots[i].topic, topic) == 0) {
+                return &_slots[i];
+            }
+        }
+        return nullptr;
+    }
+
+    void expire(uint32_t nowMs) {
+        for (size_t i = 0; i < SLOTS; i++) {
+            if (_slots[i].busy && nowMs - _slots[i].lastMs > MQTT_RX_PART_TIMEOUT_MS) {
+                _slots[i].busy = false;
+                _stats.expired++;
+            }
+        }
+    }
+
+    Slot* acquire() {
+        for (size_t i = 0; i < SLOTS; i++) {
+            if (!_slots[i].busy) { _slots[i].busy = true; return &_slots[i]; }
+        }
+        return nullptr;
+    }
+};
+
+#endif
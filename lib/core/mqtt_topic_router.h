@@ -0,0 +1,349 @@
+#ifndef MQTT_TOPIC_ROUTER_H
+#define MQTT_TOPIC_ROUTER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <functional>
+#include "mqtt_message.h"
+
+typedef std::function<void(const MqttMessageView&)> MqttMessageHandler;
+
+// Reference matcher (MQTT 3.1.1 §4.7): "+" matches one level, a trailing "#"
+// matches the parent level and everything below, wildcards in the first
+// level never match topics starting with '$'.
+inline bool mqttTopicMatches(const char* filter, const char* topic) {
+    if (topic[0] == '$' && (filter[0] == '+' || filter[0] == '#')) return false;
+    while (true) {
+        if (filter[0] == '#' && filter[1] == '\0') return true;
+        const char* fEnd = strchr(filter, '/');
+        const char* tEnd = strchr(topic, '/');
+        size_t fLen = fEnd ? (size_t)(fEnd - filter) : strlen(filter);
+        size_t tLen = tEnd ? (size_t)(tEnd - topic) : strlen(topic);
+        if (!(fLen == 1 && filter[0] == '+') && (fLen != tLen || memcmp(filter, topic, fLen) != 0)) {
+            return false;
+        }
+        if (!fEnd && !tEnd) return true;
+        if (!tEnd) return fEnd[1] == '#' && fEnd[2] == '\0';  // "a/#" matches "a"
+        if (!fEnd) return false;
+        filter = fEnd + 1;
+        topic  = tEnd + 1;
+    }
+}
+
+inline bool mqttFilterIsValid(const char* filter) {
+    if (!filter || !filter[0]) return false;
+    for (const char* p = filter; *p; p++) {
+        bool levelStart = (p == filter) || p[-1] == '/';
+        bool levelEnd   = p[1] == '\0' || p[1] == '/';
+        if (*p == '+' && !(levelStart && levelEnd)) return false;
+        if (*p == '#' && !(levelStart && p[1] == '\0')) return false;
+    }
+    return true;
+}
+
+// Subscription router. Filters are compiled into a trie whose edges live in
+// an open addressed hash table keyed by (parent node, level token), so an
+// incoming topic is routed with one lookup per level plus the "+" and "#"
+// branches. All storage is fixed at compile time; unsubscribing gives the
+// filter's pool space and subscription slot back, so subscribe/unsubscribe
+// cycles do not wear the router out (trie nodes are kept for reuse).
+template <size_t MAX_FILTERS, size_t MAX_NODES, size_t POOL_SIZE>
+class MqttTopicRouter {
+    static_assert((MAX_NODES & (MAX_NODES - 1)) == 0, "MAX_NODES must be a power of two");
+    static_assert(MAX_NODES < 0xFFFF && MAX_FILTERS < 0xFFFF && POOL_SIZE < 0xFFFF, "indexes are 16 bit");
+
+public:
+    static const uint16_t NONE = 0xFFFF;
+
+    MqttTopicRouter() { clear(); }
+
+    void clear() {
+        _nodeCount = 1;  // node 0 is the root
+        initNode(0, NONE, 0, 0);
+        _poolUsed = 0;
+        _subCount = 0;
+        _dispatching = 0;
+        for (size_t i = 0; i < EDGE_CAP; i++) _edges[i] = NONE;
+        for (size_t i = 0; i < MAX_FILTERS; i++) { _subs[i].active = false; _subs[i].handler = nullptr; }
+    }
+
+    // Registers a handler for a filter. An empty handler only records the
+    // filter (so it is restored on reconnect) and is not added twice.
+    // Returns false when the filter is invalid or the router is full.
+    bool subscribe(const char* filter, uint8_t qos, MqttMessageHandler handler) {
+        if (!mqttFilterIsValid(filter)) return false;
+        if (!handler && contains(filter)) return true;
+        int slot = freeSubscription();
+        if (slot < 0) return false;
+
+        size_t len = strlen(filter);
+        uint16_t node = 0;
+        bool multi = false;
+        const char* level = filter;
+        while (true) {
+            const char* end = strchr(level, '/');
+            size_t tokenLen = end ? (size_t)(end - level) : strlen(level);
+            if (tokenLen == 1 && level[0] == '#') { multi = true; break; }
+            node = (tokenLen == 1 && level[0] == '+') ? plusChild(node)
+                                                      : findOrCreate(node, level, tokenLen, true);
+            if (node == NONE) return false;
+            if (!end) break;
+            level = end + 1;
+        }
+
+        // Same filter again: its string is shared
+        uint16_t offset = filterOffset(filter);
+        if (offset == NONE) offset = store(filter, len);
+        if (offset == NONE) return false;
+
+        _subCount++;
+        Subscription& s = _subs[slot];
+        s.active  = true;
+        s.node    = node;
+        s.multi   = multi;
+        s.qos     = qos;
+        s.filter  = offset;
+        s.handler = handler;
+        if (multi) { s.next = _nodes[node].multiSubs; _nodes[node].multiSubs = slot; }
+        else       { s.next = _nodes[node].exactSubs; _nodes[node].exactSubs = slot; }
+        return true;
+    }
+
+    // Removes every handler registered for exactly this filter and frees
+    // the filter string
+    size_t unsubscribe(const char* filter) {
+        uint16_t offset = filterOffset(filter);
+        if (offset == NONE) return 0;
+        size_t removed = 0;
+        for (size_t i = 0; i < _subCount; i++) {
+            if (_subs[i].active && _subs[i].filter == offset) {
+                unlink(i);
+                removed++;
+            }
+        }
+        release(offset, strlen(filter) + 1);
+        if (!_dispatching) compactSubscriptions();
+        return removed;
+    }
+
+    bool contains(const char* filter) const { return filterOffset(filter) != NONE; }
+
+    // Calls every matching handler, returns the number of matching subscriptions.
+    // Handlers may unsubscribe, the slots are compacted once the walk is done.
+    size_t dispatch(const MqttMessageView& msg) {
+        _dispatching++;
+        size_t n = walk(0, msg.topic, msg.topic[0] == '$', msg);
+        if (--_dispatching == 0) compactSubscriptions();
+        return n;
+    }
+
+    // Each distinct active filter once, e.g. to resubscribe after a reconnect
+    template <typename Fn>
+    void forEachFilter(Fn fn) const {
+        for (size_t i = 0; i < _subCount; i++) {
+            if (!_subs[i].active) continue;
+            bool seen = false;
+            for (size_t j = 0; j < i && !seen; j++) {
+                seen = _subs[j].active && _subs[j].filter == _subs[i].filter;
+            }
+            if (!seen) fn(filterOf(i), maxQos(filterOf(i)));
+        }
+    }
+
+    size_t subscriptionCount() const {
+        size_t n = 0;
+        for (size_t i = 0; i < _subCount; i++) if (_subs[i].active) n++;
+        return n;
+    }
+    size_t nodeCount() const { return _nodeCount; }
+    size_t poolUsed()  const { return _poolUsed; }
+
+private:
+    static const size_t EDGE_CAP = MAX_NODES * 2;
+
+    struct Node {
+        uint16_t parent;
+        uint16_t token;      // offset in _pool
+        uint8_t  tokenLen;
+        uint32_t hash;
+        uint16_t plus;       // child for "+"
+        uint16_t exactSubs;  // filters ending at this node
+        uint16_t multiSubs;  // filters "<this node>/#"
+    };
+
+    struct Subscription {
+        bool               active;
+        bool               multi;
+        uint8_t            qos;
+        uint16_t           node;
+        uint16_t           filter;  // offset in _pool
+        uint16_t           next;
+        MqttMessageHandler handler;
+    };
+
+    Node         _nodes[MAX_NODES];
+    size_t       _nodeCount;
+    uint16_t     _edges[EDGE_CAP];
+    Subscription _subs[MAX_FILTERS];
+    size_t       _subCount;      // slots in use, holes only while dispatching
+    char         _pool[POOL_SIZE];
+    size_t       _poolUsed;
+    uint8_t      _dispatching;
+
+    static uint32_t hashToken(const char* s, size_t len) {
+        uint32_t h = 2166136261UL;
+        for (size_t i = 0; i < len; i++) { h ^= (uint8_t)s[i]; h *= 16777619UL; }
+        return h;
+    }
+
+    static size_t edgeSlot(uint16_t parent, uint32_t hash) {
+        uint32_t h = hash ^ ((uint32_t)parent * 2654435761UL);
+        return (h ^ (h >> 15)) & (EDGE_CAP - 1);
+    }
+
+    void initNode(uint16_t i, uint16_t parent, uint16_t token, uint8_t len) {
+        Node& n = _nodes[i];
+        n.parent = parent; n.token = token; n.tokenLen = len; n.hash = 0;
+        n.plus = NONE; n.exactSubs = NONE; n.multiSubs = NONE;
+    }
+
+    uint16_t newNode(uint16_t parent, uint16_t token, uint8_t len) {
+        if (_nodeCount >= MAX_NODES) return NONE;
+        uint16_t i = (uint16_t)_nodeCount++;
+        initNode(i, parent, token, len);
+        return i;
+    }
+
+    uint16_t plusChild(uint16_t parent) {
+        if (_nodes[parent].plus == NONE) _nodes[parent].plus = newNode(parent, 0, 0);
+        return _nodes[parent].plus;
+    }
+
+    uint16_t findOrCreate(uint16_t parent, const char* token, size_t len, bool create) {
+        uint32_t h = hashToken(token, len);
+        size_t slot = edgeSlot(parent, h);
+        for (size_t probe = 0; probe < EDGE_CAP; probe++) {
+            uint16_t e = _edges[slot];
+            if (e == NONE) break;
+            const Node& n = _nodes[e];
+            if (n.hash == h && n.parent == parent && n.tokenLen == len &&
+                memcmp(_pool + n.token, token, len) == 0) {
+                return e;
+            }
+            slot = (slot + 1) & (EDGE_CAP - 1);
+        }
+        if (!create || len > 255) return NONE;
+
+        uint16_t offset = store(token, len);
+        if (offset == NONE) return NONE;
+        uint16_t e = newNode(parent, offset, (uint8_t)len);
+        if (e == NONE) return NONE;
+        _nodes[e].hash = h;
+        _edges[slot] = e;
+        return e;
+    }
+
+    uint16_t store(const char* s, size_t len) {
+        if (_poolUsed + len + 1 > POOL_SIZE) return NONE;
+        uint16_t offset = (uint16_t)_poolUsed;
+        memcpy(_pool + offset, s, len);
+        _pool[offset + len] = '\0';
+        _poolUsed += len + 1;
+        return offset;
+    }
+
+    // Removes len bytes at offset from the pool, shifting what follows
+    void release(uint16_t offset, size_t len) {
+        memmove(_pool + offset, _pool + offset + len, _poolUsed - offset - len);
+        _poolUsed -= len;
+        for (size_t i = 1; i < _nodeCount; i++) {
+            if (_nodes[i].tokenLen && _nodes[i].token > offset) _nodes[i].token -= len;
+        }
+        for (size_t i = 0; i < _subCount; i++) {
+            if (_subs[i].filter > offset) _subs[i].filter -= len;
+        }
+    }
+
+    const char* filterOf(size_t i) const { return _pool + _subs[i].filter; }
+
+    uint16_t filterOffset(const char* filter) const {
+        for (size_t i = 0; i < _subCount; i++) {
+            if (_subs[i].active && strcmp(filterOf(i), filter) == 0) return _subs[i].filter;
+        }
+        return NONE;
+    }
+
+    uint8_t maxQos(const char* filter) const {
+        uint8_t q = 0;
+        for (size_t i = 0; i < _subCount; i++) {
+            if (_subs[i].active && _subs[i].qos > q && strcmp(filterOf(i), filter) == 0) q = _subs[i].qos;
+        }
+        return q;
+    }
+
+    // Holes only exist during a dispatch, and a walk may still step over
+    // them: new subscriptions always go after the last slot
+    int freeSubscription() const {
+        return _subCount < MAX_FILTERS ? (int)_subCount : -1;
+    }
+
+    uint16_t* listRef(const Subscription& s) {
+        return s.multi ? &_nodes[s.node].multiSubs : &_nodes[s.node].exactSubs;
+    }
+
+    // Out of its node's list; the slot keeps its next so a walk in progress
+    // can step over it
+    void unlink(size_t i) {
+        Subscription& s = _subs[i];
+        uint16_t* head = listRef(s);
+        while (*head != NONE && *head != i) head = &_subs[*head].next;
+        if (*head == i) *head = s.next;
+        s.active  = false;
+        s.handler = nullptr;
+    }
+
+    // Moves the last subscriptions into the holes, relinking them
+    void compactSubscriptions() {
+        while (_subCount && !_subs[_subCount - 1].active) _subCount--;
+        for (size_t i = 0; i < _subCount; i++) {
+            if (_subs[i].active) continue;
+            uint16_t last = (uint16_t)(_subCount - 1);
+            uint16_t* ref = listRef(_subs[last]);
+            while (*ref != last) ref = &_subs[*ref].next;
+            *ref = (uint16_t)i;
+            _subs[i] = _subs[last];
+            _subs[last].active  = false;
+            _subs[last].handler = nullptr;
+            while (_subCount && !_subs[_subCount - 1].active) _subCount--;
+        }
+    }
+
+    size_t deliver(uint16_t head, const MqttMessageView& msg) {
+        size_t n = 0;
+        for (uint16_t i = head; i != NONE; i = _subs[i].next) {
+            if (_subs[i].handler) _subs[i].handler(msg);
+            n++;
+        }
+        return n;
+    }
+
+    // topic points at the first character of the level to match under node
+    size_t walk(uint16_t node, const char* topic, bool dollar, const MqttMessageView& msg) {
+        const Node& n = _nodes[node];
+        size_t matched = 0;
+        if (!dollar || node != 0) matched += deliver(n.multiSubs, msg);
+        if (!topic) return matched + deliver(n.exactSubs, msg);
+
+        const char* end = strchr(topic, '/');
+        size_t len = end ? (size_t)(end - topic) : strlen(topic);
+        const char* rest = end ? end + 1 : nullptr;
+
+        uint16_t exact = findOrCreate(node, topic, len, false);
+        if (exact != NONE) matched += walk(exact, rest, dollar, msg);
+        if (n.plus != NONE && !(dollar && node == 0)) matched += walk(n.plus, rest, dollar, msg);
+        return matched;
+    }
+};
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef PAYLOAD_CODEC_H
+#define PAYLOAD_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ArduinoJson.h>
+#include "cbor.h"
+#include "mqtt_message.h"
+
+// Wire encodings for JSON documents. MQTT 3.1.1 has no content-type property,
+// so binary payloads carry a 2-byte in-band marker: 0xC1 (a byte that is
+// neither valid UTF-8 nor a MessagePack type) followed by 'm' or 'c'.
+// Unmarked payloads are text JSON, which keeps older devices readable.
+
+enum PayloadEncoding {
+    PAYLOAD_JSON = 0,
+    PAYLOAD_MSGPACK,
+    PAYLOAD_CBOR
+};
+
+#define PAYLOAD_MARKER       0xC1
+#define PAYLOAD_MARKER_SIZE  2
+#define PAYLOAD_MAX_NESTING  10
+
+inline PayloadEncoding detectPayloadEncoding(const uint8_t* data, size_t len) {
+    if (len >= PAYLOAD_MARKER_SIZE && data[0] == PAYLOAD_MARKER) {
+        if (data[1] == 'm') return PAYLOAD_MSGPACK;
+        if (data[1] == 'c') return PAYLOAD_CBOR;
+    }
+    return PAYLOAD_JSON;
+}
+
+inline const char* payloadEncodingName(PayloadEncoding e) {
+    switch (e) {
+        case PAYLOAD_MSGPACK: return "msgpack";
+        case PAYLOAD_CBOR:    return "cbor";
+        default:              return "json";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// CBOR <-> JsonDocument
+// ---------------------------------------------------------------------------
+
+inline void cborWriteVariant(CborWriter& w, JsonVariantConst v) {
+    if (v.is<JsonObjectConst>()) {
+        JsonObjectConst obj = v.as<JsonObjectConst>();
+        w.writeMap(obj.size());
+        for (JsonPairConst kv : obj) {
+            w.writeString(kv.key().c_str(), kv.key().size());
+            cborWriteVariant(w, kv.value());
+        }
+    } else if (v.is<JsonArrayConst>()) {
+        JsonArrayConst arr = v.as<JsonArrayConst>();
+        w.writeArray(arr.size());
+        for (JsonVariantConst item : arr) cborWriteVariant(w, item);
+    } else if (v.is<bool>()) {
+        w.writeBool(v.as<bool>());
+    } else if (v.is<int64_t>()) {
+        w.writeInt(v.as<int64_t>());
+    } else if (v.is<uint64_t>()) {
+        w.writeUInt(v.as<uint64_t>());
+    } else if (v.is<double>()) {
+        w.writeFloat(v.as<double>());
+    } else if (v.is<const char*>()) {
+        JsonString s = v.as<JsonString>();
+        w.writeString(s.c_str(), s.size());
+    } else {
+        w.writeNull();
+    }
+}
+
+// Strings are copied (through a char*) since the input buffer is transient
+// and not NUL-terminated
+template <typename Dst>
+inline bool cborReadValue(CborReader& r, Dst dst, uint8_t depth) {
+    CborItem it;
+    if (depth > PAYLOAD_MAX_NESTING || !r.next(it)) return false;
+
+    switch (it.type) {
+        case CBOR_UINT:   dst.set(it.u); return true;
+        case CBOR_NEGINT: dst.set(it.i); return true;
+        case CBOR_BOOL:   dst.set(it.u != 0); return true;
+        case CBOR_FLOAT:  dst.set(it.f); return true;
+        case CBOR_NULL:   dst.set(nullptr); return true;
+        case CBOR_BYTES:
+        case CBOR_TEXT: {
+            char* s = (char*)malloc(it.count + 1);
+            if (!s) return false;
+            memcpy(s, it.str, it.count);
+            s[it.count] = '\0';
+            bool ok = dst.set(s);
+            free(s);
+            return ok;
+        }
+        case CBOR_ARRAY: {
+            JsonArray arr = dst.template to<JsonArray>();
+            for (size_t i = 0; i < it.count; i++) {
+                if (!cborReadValue(r, arr.template add<JsonVariant>(), depth + 1)) return false;
+            }
+            return true;
+        }
+        case CBOR_MAP: {
+            JsonObject obj = dst.template to<JsonObject>();
+            for (size_t i = 0; i < it.count; i++) {
+                CborItem key;
+                if (!r.next(key) || key.type != CBOR_TEXT) return false;
+                char  small[32];
+                char* k = key.count < sizeof(small) ? small : (char*)malloc(key.count + 1);
+                if (!k) return false;
+                memcpy(k, key.str, key.count);
+                k[key.count] = '\0';
+                bool ok = cborReadValue(r, obj[k], depth + 1);
+                if (k != small) free(k);
+                if (!ok) return false;
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// Payload level helpers
+// ---------------------------------------------------------------------------
+
+// Encoded size including the marker
+inline size_t measurePayload(const JsonDocument& doc, PayloadEncoding enc) {
+    switch (enc) {
+        case PAYLOAD_MSGPACK: return PAYLOAD_MARKER_SIZE + measureMsgPack(doc);
+        case PAYLOAD_CBOR: {
+            CborWriter w(nullptr, 0);
+            cborWriteVariant(w, doc.as<JsonVariantConst>());
+            return PAYLOAD_MARKER_SIZE + w.size();
+        }
+        default: return measureJson(doc);
+    }
+}
+
+// Returns the payload length, 0 when it does not fit
+inline size_t encodePayload(const JsonDocument& doc, PayloadEncoding enc, uint8_t* out, size_t capacity) {
+    if (enc == PAYLOAD_JSON) {
+        size_t n = serializeJson(doc, (char*)out, capacity);
+        return n && measureJson(doc) == n ? n : 0;
+    }
+    if (capacity < PAYLOAD_MARKER_SIZE) return 0;
+    out[0] = PAYLOAD_MARKER;
+    out[1] = enc == PAYLOAD_MSGPACK ? 'm' : 'c';
+
+    size_t room = capacity - PAYLOAD_MARKER_SIZE;
+    if (enc == PAYLOAD_MSGPACK) {
+        size_t n = serializeMsgPack(doc, out + PAYLOAD_MARKER_SIZE, room);
+        return n && n <= room && measureMsgPack(doc) == n ? PAYLOAD_MARKER_SIZE + n : 0;
+    }
+    CborWriter w(out + PAYLOAD_MARKER_SIZE, room);
+    cborWriteVariant(w, doc.as<JsonVariantConst>());
+    return w.overflowed() ? 0 : PAYLOAD_MARKER_SIZE + w.size();
+}
+
+// Decodes any of the three encodings, picked from the marker
+inline DeserializationError deserializePayload(JsonDocument& doc, const uint8_t* data, size_t len) {
+    switch (detectPayloadEncoding(data, len)) {
+        case PAYLOAD_MSGPACK:
+            return deserializeMsgPack(doc, data + PAYLOAD_MARKER_SIZE, len - PAYLOAD_MARKER_SIZE);
+        case PAYLOAD_CBOR: {
+            doc.clear();
+            CborReader r(data + PAYLOAD_MARKER_SIZE, len - PAYLOAD_MARKER_SIZE);
+            if (r.atEnd()) return DeserializationError::EmptyInput;
+            if (!cborReadValue(r, doc.to<JsonVariant>(), 0)) {
+                return doc.overflowed() ? DeserializationError::NoMemory : DeserializationError::InvalidInput;
+            }
+            return DeserializationError::Ok;
+        }
+        default:
+            return deserializeJson(doc, (const char*)data, len);
+    }
+}
+
+inline DeserializationError deserializePayload(JsonDocument& doc, const MqttMessageView& msg) {
+    return deserializePayload(doc, (const uint8_t*)msg.payload, msg.length);
+}
+
+#endif
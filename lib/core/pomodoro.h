@@ -0,0 +1,171 @@
+#ifndef POMODORO_H
+#define POMODORO_H
+
+#include <stdint.h>
+
+// Pomodoro cycle: WORK, SHORT_BREAK, WORK, ... with a LONG_BREAK instead of
+// the short one after every `cycles` work sessions. Plain data with no
+// constructor so it can sit in RTC slow memory across deep sleeps; the
+// caller passes the time (RTC epoch), a virtual clock in tests.
+//
+// Each phase starts at the planned end of the previous one, not when the
+// device noticed: a late wake catches up every phase that ended meanwhile
+// and the cycle stays on schedule.
+
+#define POMODORO_STATS_BATCH  4    // work sessions held in RTC memory before a NVS write
+#define POMODORO_MAX_MINUTES  240
+
+enum PomodoroPhase : uint8_t {
+    POMO_IDLE = 0,
+    POMO_WORK,
+    POMO_SHORT_BREAK,
+    POMO_LONG_BREAK
+};
+
+inline const char* pomodoroPhaseName(uint8_t phase) {
+    switch (phase) {
+        case POMO_WORK:        return "Work";
+        case POMO_SHORT_BREAK: return "Break";
+        case POMO_LONG_BREAK:  return "Long break";
+        default:               return "Idle";
+    }
+}
+
+struct PomodoroConfig {
+    uint16_t workMin;
+    uint16_t shortBreakMin;
+    uint16_t longBreakMin;
+    uint8_t  cycles;          // work sessions before a long break
+};
+
+#define POMODORO_DEFAULT_CONFIG  { 25, 5, 15, 4 }
+
+struct PomodoroStats {
+    uint32_t workSessions;    // completed ones
+    uint32_t workMinutes;     // completed and interrupted
+    uint32_t longBreaks;
+    uint32_t interrupted;     // stopped during a work session
+
+    void clear() { workSessions = workMinutes = longBreaks = interrupted = 0; }
+
+    void add(const PomodoroStats& o) {
+        workSessions += o.workSessions;
+        workMinutes  += o.workMinutes;
+        longBreaks   += o.longBreaks;
+        interrupted  += o.interrupted;
+    }
+};
+
+struct PomodoroCycle {
+    PomodoroConfig config;
+    uint8_t        phase;
+    uint8_t        workDone;      // work sessions since the last long break
+    uint32_t       phaseStart;
+    uint32_t       phaseEnd;
+    PomodoroStats  pending;       // not in NVS yet
+
+    void reset(const PomodoroConfig& cfg) {
+        config     = sanitize(cfg);
+        phase      = POMO_IDLE;
+        workDone   = 0;
+        phaseStart = 0;
+        phaseEnd   = 0;
+        pending.clear();
+    }
+
+    void start(uint32_t now) {
+        workDone = 0;
+        enter(POMO_WORK, now);
+    }
+
+    void stop(uint32_t now) {
+        if (phase == POMO_WORK) {
+            pending.interrupted++;
+            if (now > phaseStart) pending.workMinutes += (now - phaseStart) / 60;
+        }
+        phase      = POMO_IDLE;
+        phaseStart = 0;
+        phaseEnd   = 0;
+    }
+
+    // Takes effect from the next phase
+    void configure(const PomodoroConfig& cfg) { config = sanitize(cfg); }
+
+    bool active() const { return phase != POMO_IDLE; }
+
+    uint32_t remaining(uint32_t now) const {
+        if (!active() || now >= phaseEnd) return 0;
+        return phaseEnd - now;
+    }
+
+    // Moves past every phase that ended by now, returns how many did
+    uint16_t advance(uint32_t now) {
+        uint16_t ended = 0;
+        while (active() && now >= phaseEnd) {
+            finishPhase();
+            if (ended < 0xFFFF) ended++;
+        }
+        return ended;
+    }
+
+    // Phase that follows the current one
+    uint8_t upcoming() const {
+        if (phase == POMO_IDLE) return POMO_IDLE;
+        if (phase != POMO_WORK) return POMO_WORK;
+        return workDone + 1 >= config.cycles ? POMO_LONG_BREAK : POMO_SHORT_BREAK;
+    }
+
+    // 1-based position of the current work session in its set
+    uint8_t session() const {
+        return phase == POMO_WORK ? workDone + 1 : (workDone ? workDone : config.cycles);
+    }
+
+    bool statsDue() const { return pending.workSessions >= POMODORO_STATS_BATCH; }
+
+    static PomodoroConfig sanitize(PomodoroConfig c) {
+        c.workMin       = bound(c.workMin);
+        c.shortBreakMin = bound(c.shortBreakMin);
+        c.longBreakMin  = bound(c.longBreakMin);
+        if (c.cycles < 1) c.cycles = 1;
+        return c;
+    }
+
+private:
+    static uint16_t bound(uint16_t minutes) {
+        if (minutes < 1) return 1;   // a zero phase would never let advance() stop
+        return minutes > POMODORO_MAX_MINUTES ? POMODORO_MAX_MINUTES : minutes;
+    }
+
+    uint32_t minutesOf(uint8_t p) const {
+        switch (p) {
+            case POMO_WORK:        return config.workMin;
+            case POMO_SHORT_BREAK: return config.shortBreakMin;
+            default:               return config.longBreakMin;
+        }
+    }
+
+    void enter(uint8_t p, uint32_t at) {
+        phase      = p;
+        phaseStart = at;
+        phaseEnd   = at + minutesOf(p) * 60;
+    }
+
+    void finishPhase() {
+        uint32_t end = phaseEnd;
+        if (phase != POMO_WORK) {
+            enter(POMO_WORK, end);
+            return;
+        }
+        pending.workSessions++;
+        pending.workMinutes += config.workMin;
+        if (++workDone >= config.cycles) {
+            workDone = 0;
+            pending.longBreaks++;
+            enter(POMO_LONG_BREAK, end);
+        } else {
+            enter(POMO_SHORT_BREAK, end);
+        }
+    }
+};
+
+#endif
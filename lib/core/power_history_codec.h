@@ -0,0 +1,308 @@
+#ifndef POWER_HISTORY_CODEC_H
+#define POWER_HISTORY_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// Platform independent encoding of the battery/power history.
+//
+// The log is a ring of fixed-size pages. Every page is self contained: its
+// first record is a keyframe holding absolute values, every following record
+// only stores the difference to the previous one as zigzag varints, so an
+// idle battery sample costs 5-6 bytes instead of 14.
+//
+// Page layout (little endian):
+//   [0..1]  magic  0x4850 ("PH")
+//   [2..5]  sequence number (monotonic, selects the slot in the ring)
+//   [6..7]  payload length
+//   [8.. ]  records
+
+#define POWER_HISTORY_PAGE_SIZE   256
+#define POWER_HISTORY_HEADER_SIZE 8
+#define POWER_HISTORY_PAYLOAD_MAX (POWER_HISTORY_PAGE_SIZE - POWER_HISTORY_HEADER_SIZE)
+#define POWER_HISTORY_MAGIC       0x4850
+
+enum PowerRecordType {
+    POWER_RECORD_KEYFRAME = 1,
+    POWER_RECORD_SAMPLE   = 2,
+    POWER_RECORD_EVENT    = 3
+};
+
+enum PowerEvent {
+    POWER_EVENT_BOOT         = 1,
+    POWER_EVENT_WAKE         = 2,
+    POWER_EVENT_SLEEP        = 3,
+    POWER_EVENT_CHARGE_START = 4,
+    POWER_EVENT_CHARGE_STOP  = 5
+};
+
+// Record tag: low nibble is the PowerRecordType, bit 7 the charging flag,
+// bit 6 marks a keyframe carried over from the last sample (not a reading)
+#define POWER_TAG_CHARGING 0x80
+#define POWER_TAG_CARRIED  0x40
+
+struct PowerHistoryEntry {
+    uint8_t  type;
+    uint32_t epoch;
+    int32_t  level;
+    int32_t  voltage;
+    int32_t  current;
+    bool     charging;
+    bool     carried;   // keyframe repeating the last sample, not a new reading
+    uint8_t  event;
+    uint8_t  arg;
+};
+
+namespace power_codec {
+
+inline uint32_t zigzag(int32_t v)    { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+inline int32_t  unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+// Returns the number of bytes written (max 5), 0 if it does not fit
+inline size_t putVarint(uint8_t* out, size_t room, uint32_t v) {
+    size_t n = 0;
+    do {
+        if (n >= room) return 0;
+        uint8_t b = v & 0x7F;
+        v >>= 7;
+        out[n++] = v ? (b | 0x80) : b;
+    } while (v);
+    return n;
+}
+
+// Returns the number of bytes consumed, 0 on truncated/overlong input
+inline size_t getVarint(const uint8_t* in, size_t avail, uint32_t* v) {
+    uint32_t result = 0;
+    for (size_t n = 0; n < avail && n < 5; n++) {
+        result |= (uint32_t)(in[n] & 0x7F) << (7 * n);
+        if (!(in[n] & 0x80)) { *v = result; return n + 1; }
+    }
+    return 0;
+}
+
+inline void putU16(uint8_t* p, uint16_t v) { p[0] = v & 0xFF; p[1] = v >> 8; }
+inline void putU32(uint8_t* p, uint32_t v) { for (int i = 0; i < 4; i++) p[i] = (v >> (8 * i)) & 0xFF; }
+inline uint16_t getU16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+inline uint32_t getU32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+} // namespace power_codec
+
+// Builds one page at a time. The whole object is POD so it can live in RTC
+// slow memory and keep staging records across deep sleep cycles.
+struct PowerHistoryEncoder {
+    uint8_t  page[POWER_HISTORY_PAGE_SIZE];
+    uint16_t used;
+    uint32_t lastEpoch;
+    int32_t  lastLevel;
+    int32_t  lastVoltage;
+    int32_t  lastCurrent;
+    bool     lastCharging;
+
+    void startPage(uint32_t sequence) {
+        memset(page, 0xFF, sizeof(page));
+        power_codec::putU16(page, POWER_HISTORY_MAGIC);
+        power_codec::putU32(page + 2, sequence);
+        used = 0;
+        sealLength();
+    }
+
+    uint32_t sequence() const { return power_codec::getU32(page + 2); }
+    bool     isEmpty()  const { return used == 0; }
+
+    // Returns false when the page is full; the caller must persist the page,
+    // start the next one and append again.
+    bool appendSample(uint32_t epoch, int32_t level, int32_t voltage, int32_t current, bool charging) {
+        uint8_t rec[24];
+        size_t  n;
+        if (used == 0) {
+            n = encodeKeyframe(rec, epoch, level, voltage, current, charging);
+        } else {
+            if (epoch < lastEpoch) epoch = lastEpoch;
+            rec[0] = POWER_RECORD_SAMPLE | (charging ? POWER_TAG_CHARGING : 0);
+            n = 1;
+            n += power_codec::putVarint(rec + n, sizeof(rec) - n, epoch - lastEpoch);
+            n += power_codec::putVarint(rec + n, sizeof(rec) - n, power_codec::zigzag(level - lastLevel));
+            n += power_codec::putVarint(rec + n, sizeof(rec) - n, power_codec::zigzag(voltage - lastVoltage));
+            n += power_codec::putVarint(rec + n, sizeof(rec) - n, power_codec::zigzag(current - lastCurrent));
+        }
+        if (!commit(rec, n)) return false;
+        lastEpoch    = epoch;
+        lastLevel    = level;
+        lastVoltage  = voltage;
+        lastCurrent  = current;
+        lastCharging = charging;
+        return true;
+    }
+
+    // Events reuse the last sample as keyframe when they open a page, flagged
+    // as carried so exports do not show it as a reading at the event's time
+    bool appendEvent(uint32_t epoch, uint8_t event, uint8_t arg) {
+        uint8_t rec[32];
+        size_t  n = 0;
+        if (used == 0) {
+            n = encodeKeyframe(rec, epoch, lastLevel, lastVoltage, lastCurrent, lastCharging);
+            rec[0] |= POWER_TAG_CARRIED;
+        } else if (epoch < lastEpoch) {
+            epoch = lastEpoch;
+        }
+        rec[n++] = POWER_RECORD_EVENT;
+        n += power_codec::putVarint(rec + n, sizeof(rec) - n, used == 0 ? 0 : epoch - lastEpoch);
+        rec[n++] = event;
+        rec[n++] = arg;
+        if (!commit(rec, n)) return false;
+        lastEpoch = epoch;
+        return true;
+    }
+
+private:
+    size_t encodeKeyframe(uint8_t* rec, uint32_t epoch, int32_t level, int32_t voltage,
+                          int32_t current, bool charging) {
+        size_t n = 0;
+        rec[n++] = POWER_RECORD_KEYFRAME | (charging ? POWER_TAG_CHARGING : 0);
+        power_codec::putU32(rec + n, epoch);
+        n += 4;
+        n += power_codec::putVarint(rec + n, 5, power_codec::zigzag(level));
+        n += power_codec::putVarint(rec + n, 5, power_codec::zigzag(voltage));
+        n += power_codec::putVarint(rec + n, 5, power_codec::zigzag(current));
+        return n;
+    }
+
+    bool commit(const uint8_t* rec, size_t n) {
+        if (used + n > POWER_HISTORY_PAYLOAD_MAX) return false;
+        memcpy(page + POWER_HISTORY_HEADER_SIZE + used, rec, n);
+        used += n;
+        sealLength();
+        return true;
+    }
+
+    void sealLength() { power_codec::putU16(page + 6, used); }
+};
+
+// Walks the records of one page, expanding deltas back into absolute values.
+class PowerHistoryDecoder {
+public:
+    PowerHistoryDecoder(const uint8_t* page, size_t size)
+        : _payload(nullptr), _length(0), _offset(0), _sequence(0) {
+        memset(&_state, 0, sizeof(_state));
+        if (size < POWER_HISTORY_HEADER_SIZE) return;
+        if (power_codec::getU16(page) != POWER_HISTORY_MAGIC) return;
+        uint16_t len = power_codec::getU16(page + 6);
+        if (len > POWER_HISTORY_PAYLOAD_MAX || (size_t)POWER_HISTORY_HEADER_SIZE + len > size) return;
+        _sequence = power_codec::getU32(page + 2);
+        _payload  = page + POWER_HISTORY_HEADER_SIZE;
+        _length   = len;
+    }
+
+    bool     isValid()  const { return _payload != nullptr; }
+    uint32_t sequence() const { return _sequence; }
+
+    // Returns false at the end of the page or on a corrupt record
+    bool next(PowerHistoryEntry& out) {
+        if (!_payload || _offset >= _length) return false;
+        const uint8_t* p   = _payload + _offset;
+        size_t avail       = _length - _offset;
+        uint8_t tag        = p[0];
+        uint8_t type       = tag & 0x0F;
+        size_t n           = 1;
+        uint32_t v;
+
+        if (type == POWER_RECORD_KEYFRAME) {
+            if (avail < 5) return fail();
+            _state.epoch = power_codec::getU32(p + 1);
+            n = 5;
+            if (!readSigned(p, avail, n, &_state.level))   return fail();
+            if (!readSigned(p, avail, n, &_state.voltage)) return fail();
+            if (!readSigned(p, avail, n, &_state.current)) return fail();
+            _state.charging = (tag & POWER_TAG_CHARGING) != 0;
+            _state.carried  = (tag & POWER_TAG_CARRIED) != 0;
+            _state.event = 0;
+            _state.arg   = 0;
+        } else if (type == POWER_RECORD_SAMPLE) {
+            int32_t dl, dv, dc;
+            if (!readUnsigned(p, avail, n, &v)) return fail();
+            if (!readSigned(p, avail, n, &dl))  return fail();
+            if (!readSigned(p, avail, n, &dv))  return fail();
+            if (!readSigned(p, avail, n, &dc))  return fail();
+            _state.epoch   += v;
+            _state.level   += dl;
+            _state.voltage += dv;
+            _state.current += dc;
+            _state.charging = (tag & POWER_TAG_CHARGING) != 0;
+            _state.carried  = false;
+            _state.event = 0;
+            _state.arg   = 0;
+        } else if (type == POWER_RECORD_EVENT) {
+            if (!readUnsigned(p, avail, n, &v)) return fail();
+            if (n + 2 > avail) return fail();
+            _state.epoch  += v;
+            _state.carried = false;
+            _state.event   = p[n];
+            _state.arg     = p[n + 1];
+            n += 2;
+        } else {
+            return fail();
+        }
+
+        _state.type = type;
+        _offset += n;
+        out = _state;
+        return true;
+    }
+
+private:
+    const uint8_t*    _payload;
+    size_t            _length;
+    size_t            _offset;
+    uint32_t          _sequence;
+    PowerHistoryEntry _state;
+
+    bool fail() { _offset = _length; return false; }
+
+    static bool readUnsigned(const uint8_t* p, size_t avail, size_t& n, uint32_t* v) {
+        size_t used = power_codec::getVarint(p + n, avail - n, v);
+        n += used;
+        return used > 0;
+    }
+
+    static bool readSigned(const uint8_t* p, size_t avail, size_t& n, int32_t* v) {
+        uint32_t raw;
+        if (!readUnsigned(p, avail, n, &raw)) return false;
+        *v = power_codec::unzigzag(raw);
+        return true;
+    }
+};
+
+#define POWER_HISTORY_CSV_HEADER "epoch,type,level,voltage_mv,current_ma,charging,event,arg"
+
+inline const char* powerEventName(uint8_t event) {
+    switch (event) {
+        case POWER_EVENT_BOOT:         return "boot";
+        case POWER_EVENT_WAKE:         return "wake";
+        case POWER_EVENT_SLEEP:        return "sleep";
+        case POWER_EVENT_CHARGE_START: return "charge_start";
+        case POWER_EVENT_CHARGE_STOP:  return "charge_stop";
+        default:                       return "unknown";
+    }
+}
+
+// Formats one entry as a CSV line (no trailing newline). Carried keyframes
+// are not readings: they give an empty line and 0, the caller skips them.
+inline int formatPowerHistoryCsv(const PowerHistoryEntry& e, char* buf, size_t size) {
+    if (e.carried) {
+        if (size) buf[0] = '\0';
+        return 0;
+    }
+    if (e.type == POWER_RECORD_EVENT) {
+        return snprintf(buf, size, "%lu,event,,,,,%s,%u",
+                        (unsigned long)e.epoch, powerEventName(e.event), e.arg);
+    }
+    return snprintf(buf, size, "%lu,sample,%ld,%ld,%ld,%d,,",
+                    (unsigned long)e.epoch, (long)e.level, (long)e.voltage,
+                    (long)e.current, e.charging ? 1 : 0);
+}
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef RTC_DRIFT_H
+#define RTC_DRIFT_H
+
+#include <stdint.h>
+#include <math.h>
+
+// Learns the RTC crystal drift from successive time syncs and predicts the
+// error in between, so the clock can be stepped before it is off by more
+// than half a second and the next sync pushed as far as the estimate allows.
+//
+// At each sync the RTC is set, so the offset measured at the next sync plus
+// the steps applied meanwhile is the free-running error over that span.
+
+#define RTC_DRIFT_MIN_SPAN_S     3600          // shorter spans are mostly read/set noise
+#define RTC_DRIFT_MAX_PPM        200.0f        // beyond that it was a manual change, not drift
+#define RTC_DRIFT_FLOOR_PPM      0.5f          // uncertainty never assumed below this
+#define RTC_RESYNC_MIN_S         3600
+#define RTC_RESYNC_MAX_S         (7 * 86400UL)
+#define RTC_RESYNC_DEFAULT_S     (6 * 3600UL)  // until there is an estimate
+
+struct RtcDriftEstimator {
+    int64_t  anchorMs;      // UTC ms of the last sync, 0 before the first one
+    int32_t  correctedMs;   // steps added to the RTC since the anchor
+    float    ppm;           // > 0: the RTC runs slow
+    float    spreadPpm;     // average distance between measurements and estimate
+    uint16_t samples;
+
+    void reset() {
+        anchorMs    = 0;
+        correctedMs = 0;
+        ppm         = 0;
+        spreadPpm   = 0;
+        samples     = 0;
+    }
+
+    // offsetMs = true - RTC measured at trueMs, right before the RTC is set.
+    // Returns true when the drift estimate was updated.
+    bool onSync(int64_t trueMs, int32_t offsetMs) {
+        bool updated = false;
+        int64_t span = trueMs - anchorMs;
+        if (anchorMs != 0 && span >= (int64_t)RTC_DRIFT_MIN_SPAN_S * 1000) {
+            float measured = (float)(offsetMs + correctedMs) * 1e6f / (float)span;
+            if (fabsf(measured) <= RTC_DRIFT_MAX_PPM) {
+                // Plain average for the first samples, then an exponential one
+                float w = samples < 3 ? 1.0f / (samples + 1) : 0.25f;
+                float distance = samples ? fabsf(measured - ppm) : fabsf(measured) / 2;
+                spreadPpm = samples ? spreadPpm + w * (distance - spreadPpm) : distance;
+                ppm      += w * (measured - ppm);
+                samples++;
+                updated = true;
+            }
+        }
+        anchorMs    = trueMs;
+        correctedMs = 0;
+        return updated;
+    }
+
+    // Expected true - RTC now, steps already applied taken into account
+    int32_t predictedErrorMs(int64_t nowMs) const {
+        if (anchorMs == 0 || samples == 0) return 0;
+        return (int32_t)(ppm * ((float)(nowMs - anchorMs) / 1e6f)) - correctedMs;
+    }
+
+    // Whole seconds to add to the RTC now, keeps the error within +-500 ms
+    int32_t dueStepMs(int64_t nowMs) const {
+        int32_t e = predictedErrorMs(nowMs);
+        if (e >= 500)  return ((e + 500) / 1000) * 1000;
+        if (e <= -500) return -(((-e) + 500) / 1000) * 1000;
+        return 0;
+    }
+
+    void applied(int32_t stepMs) { correctedMs += stepMs; }
+
+    // Time after a sync until the error may exceed maxErrorMs
+    uint32_t resyncIntervalS(uint32_t maxErrorMs) const {
+        if (samples == 0) return RTC_RESYNC_DEFAULT_S;
+        float uncertainty = spreadPpm > RTC_DRIFT_FLOOR_PPM ? spreadPpm : RTC_DRIFT_FLOOR_PPM;
+        float s = (float)maxErrorMs * 1000.0f / uncertainty;
+        if (s < RTC_RESYNC_MIN_S) return RTC_RESYNC_MIN_S;
+        if (s > RTC_RESYNC_MAX_S) return RTC_RESYNC_MAX_S;
+        return (uint32_t)s;
+    }
+};
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef SECOND_TICKER_H
+#define SECOND_TICKER_H
+
+#include <stdint.h>
+#include <math.h>
+
+// One tick per RTC second, a few ms after the RTC seconds actually change,
+// on the esp_timer timebase (us). The RTC only gives whole seconds, so the
+// phase comes from an observed edge (seconds register polled until it
+// changes, or the RTC clock output) and the following edges are predicted
+// from it. Each observed edge also refines the length of an RTC second as
+// seen by esp_timer, which keeps the prediction within the guard between
+// two calibrations.
+//
+// Ticks follow the predicted edges, not the previous tick, so lateness does
+// not accumulate; ticks that could not be taken are skipped, not bunched.
+
+#define SECOND_TICK_GUARD_US     2000     // after the predicted edge
+#define SECOND_TICK_RECAL_TICKS  120      // observe a new edge this often
+#define SECOND_TICK_MAX_PPM      500      // beyond that the edge was misread
+#define SECOND_TICK_MIN_SPAN_S   8        // shorter spans do not refine the period
+#define SECOND_EDGE_LEAD_US      25000    // edge polling starts this long before the expected edge
+#define SECOND_EDGE_TIMEOUT_US   50000    // and gives up this long after the start
+
+struct SecondTickStats {
+    uint32_t ticks;
+    uint32_t slips;          // the RTC second had not changed at a tick
+    uint32_t skipped;        // seconds without a tick (page not in front, busy loop)
+    uint32_t calibrations;
+    int32_t  minLateUs;      // tick time - predicted edge
+    int32_t  maxLateUs;
+    int64_t  sumLateUs;
+    double   sumSqLateUs;
+
+    void clear() {
+        ticks = slips = skipped = calibrations = 0;
+        minLateUs = maxLateUs = 0;
+        sumLateUs = 0;
+        sumSqLateUs = 0;
+    }
+
+    void addLateness(int32_t us) {
+        if (!ticks || us < minLateUs) minLateUs = us;
+        if (!ticks || us > maxLateUs) maxLateUs = us;
+        sumLateUs   += us;
+        sumSqLateUs += (double)us * us;
+        ticks++;
+    }
+
+    int32_t meanLateUs() const { return ticks ? (int32_t)(sumLateUs / ticks) : 0; }
+
+    // Standard deviation of the lateness
+    int32_t jitterUs() const {
+        if (ticks < 2) return 0;
+        double mean = (double)sumLateUs / ticks;
+        double var  = sumSqLateUs / ticks - mean * mean;
+        return var > 0 ? (int32_t)sqrt(var) : 0;
+    }
+};
+
+// Polls readSeconds() from windowUs until it differs from lastSecond and
+// returns now() at the change, or -1 if the change was not seen happen:
+// the window was reached more than SECOND_EDGE_LEAD_US late, the seconds
+// had already changed at the first read (the edge is somewhere behind, a
+// time taken now would be off by up to a second), or nothing changed
+// before the timeout.
+template <typename ReadSeconds, typename Now>
+int64_t observeSecondEdge(int64_t windowUs, uint8_t lastSecond, ReadSeconds readSeconds, Now now,
+                          uint8_t* second) {
+    if (now() - windowUs > SECOND_EDGE_LEAD_US) return -1;
+    if (readSeconds() != lastSecond) return -1;
+    while (now() - windowUs < SECOND_EDGE_TIMEOUT_US) {
+        uint8_t s = readSeconds();
+        if (s != lastSecond) {
+            *second = s;
+            return now();
+        }
+    }
+    return -1;
+}
+
+class SecondTicker {
+public:
+    SecondTicker() { reset(); }
+
+    void reset() {
+        _locked     = false;
+        _anchorUs   = 0;
+        _periodNs   = 1000000000LL;
+        _next       = 0;
+        _sinceCal   = 0;
+        _recal      = false;
+        _stats.clear();
+    }
+
+    // The RTC was written: its edges moved, the period learned so far still
+    // holds but the next edge must not be measured against the old anchor
+    void resync() {
+        _locked = false;
+        _recal  = false;
+    }
+
+    bool locked() const { return _locked; }
+
+    // An observed edge: the RTC seconds changed at edgeUs. The tick for
+    // that second is taken by the caller, the next one is due a second on.
+    void calibrate(int64_t edgeUs) {
+        if (_locked) {
+            int64_t span = edgeUs - _anchorUs;
+            int64_t n    = (span * 1000 + _periodNs / 2) / _periodNs;
+            if (n >= SECOND_TICK_MIN_SPAN_S) {
+                int64_t period = span * 1000 / n;
+                int64_t limit  = 1000LL * SECOND_TICK_MAX_PPM;   // ns per second
+                if (period > 1000000000LL - limit && period < 1000000000LL + limit) _periodNs = period;
+            }
+        }
+        _anchorUs = edgeUs;
+        _next     = 1;
+        _sinceCal = 0;
+        _recal    = false;
+        _locked   = true;
+        _stats.calibrations++;
+    }
+
+    int64_t edgeUs(int64_t k)   const { return _anchorUs + k * _periodNs / 1000; }
+    int64_t nextEdgeUs()        const { return edgeUs(_next); }
+    int64_t nextTickUs()        const { return nextEdgeUs() + SECOND_TICK_GUARD_US; }
+    bool    due(int64_t nowUs)  const { return _locked && nowUs >= nextTickUs(); }
+
+    // Call when due(). secondChanged: the RTC seconds differ from the
+    // previous tick. False when the phase looks lost (slip); a new edge
+    // should then be observed before trusting the ticks again.
+    bool onTick(int64_t nowUs, bool secondChanged) {
+        int64_t edge = nextEdgeUs();
+        _stats.addLateness((int32_t)(nowUs - edge));
+
+        // Next edge still ahead of now, the ones in between are skipped
+        _next++;
+        while (nowUs >= nextTickUs()) {
+            _next++;
+            _stats.skipped++;
+        }
+
+        if (!secondChanged) {
+            _stats.slips++;
+            _recal = true;
+        }
+        if (++_sinceCal >= SECOND_TICK_RECAL_TICKS) _recal = true;
+        return secondChanged;
+    }
+
+    bool calibrationDue() const { return !_locked || _recal; }
+
+    // esp_timer drift against the RTC, in ppm (> 0: the RTC second is longer)
+    int32_t periodPpm() const { return (int32_t)((_periodNs - 1000000000LL) / 1000); }
+
+    const SecondTickStats& stats() const { return _stats; }
+    void resetStats() { _stats.clear(); }
+
+private:
+    bool            _locked;
+    int64_t         _anchorUs;     // last observed edge
+    int64_t         _periodNs;     // RTC second in esp_timer ns
+    int64_t         _next;         // index of the next edge after the anchor
+    uint32_t        _sinceCal;
+    bool            _recal;
+    SecondTickStats _stats;
+};
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef SERVICE_GRAPH_H
+#define SERVICE_GRAPH_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Start-up of the app's services. Each one declares the services it needs
+// and when it should start: before the first frame (early), one per loop
+// iteration after it (background), or only when used. use() starts the
+// dependencies first, so the order comes from the declarations and not
+// from setup(). Every start is timed into the boot timeline.
+//
+//   graph.add(SVC_ENERGY, "energy", SERVICE_BACKGROUND, SERVICE_BIT(SVC_BATTERY), [] { energy->begin(); });
+
+#define SERVICE_MAX      16
+#define SERVICE_BIT(id)  (1UL << (id))
+
+typedef void (*ServiceInit)();
+
+enum ServiceStage : uint8_t {
+    SERVICE_EARLY = 0,
+    SERVICE_BACKGROUND,
+    SERVICE_LAZY
+};
+
+enum ServiceState : uint8_t {
+    SERVICE_NONE = 0,     // not registered
+    SERVICE_IDLE,
+    SERVICE_STARTING,
+    SERVICE_READY,
+    SERVICE_FAILED        // dependency cycle or missing dependency
+};
+
+// Why a service was started
+enum ServiceTrigger : uint8_t {
+    SERVICE_BY_EARLY = 0,
+    SERVICE_BY_BACKGROUND,
+    SERVICE_BY_USE,
+    SERVICE_BY_DEPENDENCY
+};
+
+inline const char* serviceTriggerName(uint8_t trigger) {
+    static const char* const NAMES[] = { "early", "background", "use", "dependency" };
+    return trigger <= SERVICE_BY_DEPENDENCY ? NAMES[trigger] : "?";
+}
+
+struct ServiceTimelineEntry {
+    uint8_t  id;
+    uint8_t  trigger;
+    uint32_t startUs;
+    uint32_t durationUs;   // own init only, dependencies run before
+};
+
+class ServiceGraph {
+public:
+    typedef uint32_t (*Clock)();   // microseconds
+
+    explicit ServiceGraph(Clock clock) : _clock(clock), _timelineCount(0), _firstFrameUs(0) {
+        for (uint8_t i = 0; i < SERVICE_MAX; i++) _services[i].state = SERVICE_NONE;
+    }
+
+    bool add(uint8_t id, const char* name, uint8_t stage, uint32_t deps, ServiceInit init) {
+        if (id >= SERVICE_MAX || _services[id].state != SERVICE_NONE) return false;
+        Service& s = _services[id];
+        s.name  = name;
+        s.stage = stage;
+        s.deps  = deps;
+        s.init  = init;
+        s.state = SERVICE_IDLE;
+        return true;
+    }
+
+    // Starts the service and what it depends on if needed. False if it
+    // cannot start (cycle, unregistered dependency).
+    bool use(uint8_t id) { return start(id, SERVICE_BY_USE); }
+
+    // Every service of the stage, in id order with dependencies first
+    uint8_t runStage(uint8_t stage) {
+        uint8_t started = 0;
+        while (runNext(stage)) started++;
+        return started;
+    }
+
+    // Starts the next service of the stage, false when none is left
+    bool runNext(uint8_t stage) {
+        for (uint8_t i = 0; i < SERVICE_MAX; i++) {
+            if (_services[i].state == SERVICE_IDLE && _services[i].stage == stage) {
+                start(i, stage == SERVICE_EARLY ? SERVICE_BY_EARLY : SERVICE_BY_BACKGROUND);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool pending(uint8_t stage) const {
+        for (uint8_t i = 0; i < SERVICE_MAX; i++) {
+            if (_services[i].state == SERVICE_IDLE && _services[i].stage == stage) return true;
+        }
+        return false;
+    }
+
+    bool        ready(uint8_t id) const { return id < SERVICE_MAX && _services[id].state == SERVICE_READY; }
+    uint8_t     state(uint8_t id) const { return id < SERVICE_MAX ? _services[id].state : (uint8_t)SERVICE_NONE; }
+    const char* name(uint8_t id)  const { return id < SERVICE_MAX && _services[id].state ? _services[id].name : "?"; }
+
+    void     markFirstFrame()     { if (!_firstFrameUs) _firstFrameUs = _clock(); }
+    uint32_t firstFrameUs() const { return _firstFrameUs; }
+
+    uint8_t                     timelineCount()     const { return _timelineCount; }
+    const ServiceTimelineEntry& timeline(uint8_t i) const { return _timeline[i]; }
+
+    size_t formatTimelineRow(uint8_t i, char* out, size_t cap) const {
+        const ServiceTimelineEntry& e = _timeline[i];
+        int n = snprintf(out, cap, "%8.1f %8.1f  %-14s %s", e.startUs / 1000.0, e.durationUs / 1000.0,
+                         name(e.id), serviceTriggerName(e.trigger));
+        if (n < 0) n = 0;
+        return (size_t)n < cap ? (size_t)n : (cap ? cap - 1 : 0);
+    }
+
+private:
+    struct Service {
+        const char* name;
+        ServiceInit init;
+        uint32_t    deps;
+        uint8_t     stage;
+        uint8_t     state;
+    };
+
+    Clock                _clock;
+    Service              _services[SERVICE_MAX];
+    ServiceTimelineEntry _timeline[SERVICE_MAX];
+    uint8_t              _timelineCount;
+    uint32_t             _firstFrameUs;
+
+    bool start(uint8_t id, uint8_t trigger) {
+        if (id >= SERVICE_MAX) return false;
+        Service& s = _services[id];
+        if (s.state == SERVICE_READY) return true;
+        if (s.state != SERVICE_IDLE) {
+            if (s.state == SERVICE_STARTING) s.state = SERVICE_FAILED;   // reached again through its dependencies
+            return false;
+        }
+
+        s.state = SERVICE_STARTING;
+        for (uint8_t d = 0; d < SERVICE_MAX; d++) {
+            if ((s.deps & SERVICE_BIT(d)) && !start(d, SERVICE_BY_DEPENDENCY)) {
+                s.state = SERVICE_FAILED;
+                return false;
+            }
+        }
+        if (s.state != SERVICE_STARTING) return false;
+
+        uint32_t t0 = _clock();
+        if (s.init) s.init();
+        s.state = SERVICE_READY;
+
+        if (_timelineCount < SERVICE_MAX) {
+            ServiceTimelineEntry& e = _timeline[_timelineCount++];
+            e.id         = id;
+            e.trigger    = trigger;
+            e.startUs    = t0;
+            e.durationUs = _clock() - t0;
+        }
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef SNTP_H
+#define SNTP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// SNTP v4 client side (RFC 4330): request packet, reply validation and the
+// offset/delay computation. Times are Unix milliseconds on int64_t.
+
+#define NTP_PACKET_SIZE   48
+#define NTP_UNIX_OFFSET   2208988800ULL  // seconds from 1900 to 1970
+#define NTP_ORIGINATE_POS 24
+#define NTP_RECEIVE_POS   32
+#define NTP_TRANSMIT_POS  40
+
+struct NtpReply {
+    int64_t receiveMs;    // T2, server clock
+    int64_t transmitMs;   // T3, server clock
+    uint8_t stratum;
+    uint8_t leap;
+};
+
+struct NtpSample {
+    int64_t offsetMs;     // server - local
+    int64_t delayMs;      // round trip minus server processing
+};
+
+inline uint32_t ntpGet32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+inline void ntpPut32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+inline int64_t ntpReadMs(const uint8_t* p) {
+    uint64_t sec  = ntpGet32(p);
+    uint64_t frac = ntpGet32(p + 4);
+    if (!(sec & 0x80000000UL)) sec += 0x100000000ULL;  // era 1, from 2036 (RFC 4330 section 3)
+    return (int64_t)(sec - NTP_UNIX_OFFSET) * 1000 + (int64_t)((frac * 1000) >> 32);
+}
+
+inline void ntpWriteMs(uint8_t* p, int64_t ms) {
+    int64_t  sec = ms / 1000;
+    int64_t  rem = ms % 1000;
+    if (rem < 0) { rem += 1000; sec--; }
+    ntpPut32(p, (uint32_t)(sec + (int64_t)NTP_UNIX_OFFSET));
+    ntpPut32(p + 4, (uint32_t)((((uint64_t)rem << 32) + 999) / 1000));  // rounded up, reads back exact
+}
+
+// Client request, v4 mode 3. The transmit timestamp is echoed back by the
+// server in the originate field, which ties the reply to this request.
+inline void ntpBuildRequest(uint8_t* pkt, int64_t localMs) {
+    memset(pkt, 0, NTP_PACKET_SIZE);
+    pkt[0] = (4 << 3) | 3;
+    ntpWriteMs(pkt + NTP_TRANSMIT_POS, localMs);
+}
+
+// Rejects short packets, non-server modes, kiss-o'-death (stratum 0),
+// unsynchronized servers and replies to another request
+inline bool ntpParseReply(const uint8_t* pkt, size_t len, const uint8_t* request, NtpReply& out) {
+    if (len < NTP_PACKET_SIZE) return false;
+    uint8_t leap    = pkt[0] >> 6;
+    uint8_t version = (pkt[0] >> 3) & 7;
+    uint8_t mode    = pkt[0] & 7;
+    if (mode != 4 || version < 3 || leap == 3) return false;
+    if (pkt[1] == 0 || pkt[1] > 15) return false;
+    if (memcmp(pkt + NTP_ORIGINATE_POS, request + NTP_TRANSMIT_POS, 8) != 0) return false;
+    if (ntpGet32(pkt + NTP_TRANSMIT_POS) == 0) return false;
+
+    out.receiveMs  = ntpReadMs(pkt + NTP_RECEIVE_POS);
+    out.transmitMs = ntpReadMs(pkt + NTP_TRANSMIT_POS);
+    out.stratum    = pkt[1];
+    out.leap       = leap;
+    return true;
+}
+
+// t1/t4: local send/receive, t2/t3: server receive/transmit
+inline NtpSample ntpComputeSample(int64_t t1, int64_t t2, int64_t t3, int64_t t4) {
+    NtpSample s;
+    s.offsetMs = ((t2 - t1) + (t3 - t4)) / 2;
+    s.delayMs  = (t4 - t1) - (t3 - t2);
+    if (s.delayMs < 0) s.delayMs = 0;
+    return s;
+}
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef STOPWATCH_H
+#define STOPWATCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Stopwatch on a microsecond timebase (esp_timer on the device), laps kept
+// in a fixed ring, and a fixed-width time string compared character by
+// character so only the changed digits are redrawn.
+
+#define STOPWATCH_MAX_LAPS  10   // newest kept, one menu of laps
+#define STOPWATCH_TEXT_LEN  8    // "MM:SS.hh"
+
+struct StopwatchLap {
+    uint16_t number;     // from 1, keeps counting when older laps are dropped
+    int64_t  splitUs;    // since the previous lap
+    int64_t  totalUs;
+};
+
+class StopwatchLaps {
+public:
+    StopwatchLaps() { clear(); }
+
+    void clear() { _total = 0; }
+
+    void push(int64_t splitUs, int64_t totalUs) {
+        StopwatchLap& l = _laps[_total % STOPWATCH_MAX_LAPS];
+        l.number  = (uint16_t)(_total + 1);
+        l.splitUs = splitUs;
+        l.totalUs = totalUs;
+        _total++;
+    }
+
+    // Laps still in the ring, newest first: get(0) is the last lap
+    uint8_t count() const { return _total < STOPWATCH_MAX_LAPS ? (uint8_t)_total : STOPWATCH_MAX_LAPS; }
+    uint32_t total() const { return _total; }
+    const StopwatchLap& get(uint8_t i) const { return _laps[(_total - 1 - i) % STOPWATCH_MAX_LAPS]; }
+
+private:
+    StopwatchLap _laps[STOPWATCH_MAX_LAPS];
+    uint32_t     _total;
+};
+
+class Stopwatch {
+public:
+    Stopwatch() { reset(); }
+
+    void reset() {
+        _running   = false;
+        _startUs   = 0;
+        _elapsedUs = 0;
+        _lastLapUs = 0;
+        _laps.clear();
+    }
+
+    // Start or resume
+    void start(int64_t nowUs) {
+        if (_running) return;
+        _startUs = nowUs;
+        _running = true;
+    }
+
+    void stop(int64_t nowUs) {
+        if (!_running) return;
+        _elapsedUs += nowUs - _startUs;
+        _running = false;
+    }
+
+    bool lap(int64_t nowUs) {
+        if (!_running) return false;
+        int64_t total = elapsedUs(nowUs);
+        _laps.push(total - _lastLapUs, total);
+        _lastLapUs = total;
+        return true;
+    }
+
+    bool    running() const { return _running; }
+    int64_t elapsedUs(int64_t nowUs) const { return _running ? _elapsedUs + nowUs - _startUs : _elapsedUs; }
+    int64_t currentLapUs(int64_t nowUs) const { return elapsedUs(nowUs) - _lastLapUs; }
+
+    const StopwatchLaps& laps() const { return _laps; }
+
+private:
+    bool          _running;
+    int64_t       _startUs;     // of the current run
+    int64_t       _elapsedUs;   // of the previous runs
+    int64_t       _lastLapUs;
+    StopwatchLaps _laps;
+};
+
+inline uint32_t stopwatchHours(int64_t us) { return (uint32_t)(us / 3600000000LL); }
+
+// "MM:SS.hh", minutes within the hour (hours are shown apart), truncated to
+// the hundredth like any stopwatch. out holds STOPWATCH_TEXT_LEN + 1.
+inline void stopwatchFormat(int64_t us, char* out) {
+    if (us < 0) us = 0;
+    uint32_t cs = (uint32_t)((us / 10000) % 360000);
+    snprintf(out, STOPWATCH_TEXT_LEN + 1, "%02u:%02u.%02u",
+             (unsigned)(cs / 6000), (unsigned)(cs / 100 % 60), (unsigned)(cs % 100));
+}
+
+// Bit i set when character i differs
+inline uint32_t stopwatchChangedMask(const char* prev, const char* next, uint8_t len) {
+    uint32_t mask = 0;
+    for (uint8_t i = 0; i < len && i < 32; i++) {
+        if (prev[i] != next[i]) mask |= 1UL << i;
+    }
+    return mask;
+}
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef TELEMETRY_BATCH_H
+#define TELEMETRY_BATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// Streams telemetry samples straight into a bounded JSON payload:
+//
+//   {"t0":1735732800,"s":[[0,0,23.5],[1000,1,40],[2000,0,23.6]],"k":["temp","hum"]}
+//
+// t0 is the epoch of the first sample, each reading is [dt ms, key index,
+// value] and key names are written once at the end. Space for the closing
+// part (key table included) is always kept free, so add() refuses a sample
+// instead of ever overflowing: that is the caller's cue to flush.
+
+#define TELEMETRY_MAX_KEYS  16
+#define TELEMETRY_KEY_POOL  128
+
+enum TelemetryAddResult {
+    TELEMETRY_ADDED = 0,
+    TELEMETRY_FULL,        // flush, then add again
+    TELEMETRY_REJECTED     // bad key, NaN/inf value or key table full, dropping is the only option
+};
+
+enum TelemetryFlushReason {
+    TELEMETRY_FLUSH_SIZE = 0,
+    TELEMETRY_FLUSH_AGE,
+    TELEMETRY_FLUSH_SLEEP,
+    TELEMETRY_FLUSH_MANUAL,
+    TELEMETRY_FLUSH_REASONS
+};
+
+struct TelemetryStats {
+    uint32_t samples;     // accepted samples
+    uint32_t dropped;     // rejected samples
+    uint32_t packets;     // batches published
+    uint32_t bytes;       // payload bytes published
+    uint32_t flushes[TELEMETRY_FLUSH_REASONS];
+
+    float    bytesPerSample() const { return samples ? (float)bytes / samples : 0; }
+    // One packet per sample without batching
+    uint32_t packetsSaved()   const { return samples > packets ? samples - packets : 0; }
+};
+
+template <size_t CAPACITY>
+class TelemetryBatch {
+public:
+    TelemetryBatch() { reset(); }
+
+    void reset() {
+        _len = 0;
+        _samples = 0;
+        _keyCount = 0;
+        _keyPoolUsed = 0;
+        _keyTableLen = 0;
+        _firstMs = 0;
+        _buf[0] = '\0';
+    }
+
+    TelemetryAddResult add(uint32_t nowMs, uint32_t epoch, const char* key, float value) {
+        if (!validKey(key) || !isfinite(value)) return TELEMETRY_REJECTED;  // JSON has no nan/inf
+
+        int  index  = findKey(key);
+        bool newKey = index < 0;
+        if (newKey && (_keyCount >= TELEMETRY_MAX_KEYS ||
+                       _keyPoolUsed + strlen(key) + 1 > TELEMETRY_KEY_POOL)) {
+            return _samples ? TELEMETRY_FULL : TELEMETRY_REJECTED;
+        }
+
+        char   head[32];
+        size_t headLen = 0;
+        if (_samples == 0) {
+            headLen  = (size_t)snprintf(head, sizeof(head), "{\"t0\":%lu,\"s\":[", (unsigned long)epoch);
+            _firstMs = nowMs;
+        }
+
+        char   sample[48];
+        size_t sampleLen = (size_t)snprintf(sample, sizeof(sample), "%s[%lu,%d,%.6g]",
+                                            _samples ? "," : "", (unsigned long)(nowMs - _firstMs),
+                                            newKey ? _keyCount : index, (double)value);
+
+        size_t keyTable = _keyTableLen + (newKey ? strlen(key) + 2 + (_keyCount ? 1 : 0) : 0);
+        if (_len + headLen + sampleLen + closingSize(keyTable) + 1 > CAPACITY) {
+            if (_samples == 0) _firstMs = 0;
+            return _samples ? TELEMETRY_FULL : TELEMETRY_REJECTED;
+        }
+
+        if (newKey) index = addKey(key);
+        memcpy(_buf + _len, head, headLen);
+        _len += headLen;
+        memcpy(_buf + _len, sample, sampleLen);
+        _len += sampleLen;
+        _keyTableLen = keyTable;
+        _samples++;
+        return TELEMETRY_ADDED;
+    }
+
+    // Closes the JSON document and returns it; the batch must be reset after use
+    const char* finish(size_t* length = nullptr) {
+        if (_samples == 0) { if (length) *length = 0; return nullptr; }
+        size_t n = _len;
+        n += (size_t)snprintf(_buf + n, CAPACITY - n, "],\"k\":[");
+        for (uint8_t i = 0; i < _keyCount; i++) {
+            n += (size_t)snprintf(_buf + n, CAPACITY - n, "%s\"%s\"", i ? "," : "", _keyPool + _keys[i]);
+        }
+        n += (size_t)snprintf(_buf + n, CAPACITY - n, "]}");
+        if (length) *length = n;
+        return _buf;
+    }
+
+    bool     empty()       const { return _samples == 0; }
+    uint32_t samples()     const { return _samples; }
+    uint32_t firstMs()     const { return _firstMs; }
+    size_t   size()        const { return _samples ? _len + closingSize(_keyTableLen) : 0; }
+    size_t   capacity()    const { return CAPACITY; }
+
+private:
+    char     _buf[CAPACITY];
+    size_t   _len;
+    uint32_t _samples;
+    uint32_t _firstMs;
+    uint16_t _keys[TELEMETRY_MAX_KEYS];  // offsets in _keyPool
+    uint8_t  _keyCount;
+    char     _keyPool[TELEMETRY_KEY_POOL];
+    size_t   _keyPoolUsed;
+    size_t   _keyTableLen;               // bytes of the quoted, comma separated names
+
+    // "],"k":[" + names + "]}"
+    static size_t closingSize(size_t keyTable) { return 7 + keyTable + 2; }
+
+    static bool validKey(const char* key) {
+        if (!key || !key[0]) return false;
+        for (const char* p = key; *p; p++) {
+            if (*p == '"' || *p == '\\' || (unsigned char)*p < 0x20) return false;
+        }
+        return true;
+    }
+
+    int findKey(const char* key) const {
+        for (uint8_t i = 0; i < _keyCount; i++) {
+            if (strcmp(_keyPool + _keys[i], key) == 0) return i;
+        }
+        return -1;
+    }
+
+    int addKey(const char* key) {
+        size_t len = strlen(key);
+        memcpy(_keyPool + _keyPoolUsed, key, len + 1);
+        _keys[_keyCount] = (uint16_t)_keyPoolUsed;
+        _keyPoolUsed += len + 1;
+        return _keyCount++;
+    }
+};
+
+#endif
@@ -0,0 +1,212 @@
+#ifndef UPLINK_WINDOW_H
+#define UPLINK_WINDOW_H
+
+#include <stdint.h>
+#include <string.h>
+
+// Duty-cycled uplink: the radio is off except during short connectivity
+// windows. A window opens on a cadence or when enough data is queued, then
+//   WIFI -> MQTT -> DRAIN (outbox empty) -> LINGER (inbound commands) -> closed
+// and is cut short when its radio-on budget runs out.
+
+enum UplinkTrigger {
+    UPLINK_TRIGGER_NONE = 0,
+    UPLINK_TRIGGER_CADENCE,
+    UPLINK_TRIGGER_QUEUE,
+    UPLINK_TRIGGER_MANUAL,
+    UPLINK_TRIGGER_COUNT
+};
+
+enum UplinkPhase {
+    UPLINK_CLOSED = 0,
+    UPLINK_WIFI,
+    UPLINK_MQTT,
+    UPLINK_DRAIN,
+    UPLINK_LINGER
+};
+
+enum UplinkOutcome {
+    UPLINK_OK = 0,      // drained and lingered
+    UPLINK_NO_WIFI,
+    UPLINK_NO_MQTT,
+    UPLINK_BUDGET,      // budget ran out with data still queued
+    UPLINK_OUTCOME_COUNT
+};
+
+// What the caller has to do after step()
+enum UplinkAction {
+    UPLINK_ACT_NONE = 0,
+    UPLINK_ACT_CONNECT_WIFI,
+    UPLINK_ACT_CONNECT_MQTT,
+    UPLINK_ACT_CLOSE        // disconnect and power the radio down
+};
+
+struct UplinkPolicy {
+    uint32_t cadenceSec;   // 0 = no periodic window
+    uint32_t queueBytes;   // 0 = no threshold window
+    uint32_t budgetMs;     // radio-on time allowed per window
+    uint32_t lingerMs;     // stay connected after draining, for inbound commands
+};
+
+struct UplinkWindowRecord {
+    uint32_t startEpoch;
+    uint32_t radioOnMs;    // window open -> radio off
+    uint32_t wifiMs;       // window open -> Wi-Fi up
+    uint32_t mqttMs;       // Wi-Fi up -> MQTT up
+    uint32_t pendingAtOpen;
+    uint32_t pendingAtClose;
+    uint8_t  trigger;
+    uint8_t  outcome;
+};
+
+struct UplinkStats {
+    uint32_t windows;
+    uint32_t outcomes[UPLINK_OUTCOME_COUNT];
+    uint32_t triggers[UPLINK_TRIGGER_COUNT];
+    uint32_t totalRadioOnMs;
+    uint32_t maxRadioOnMs;
+
+    uint32_t averageRadioOnMs() const { return windows ? totalRadioOnMs / windows : 0; }
+
+    void record(const UplinkWindowRecord& w) {
+        windows++;
+        if (w.outcome < UPLINK_OUTCOME_COUNT) outcomes[w.outcome]++;
+        if (w.trigger < UPLINK_TRIGGER_COUNT) triggers[w.trigger]++;
+        totalRadioOnMs += w.radioOnMs;
+        if (w.radioOnMs > maxRadioOnMs) maxRadioOnMs = w.radioOnMs;
+    }
+};
+
+inline const char* uplinkOutcomeName(uint8_t o) {
+    switch (o) {
+        case UPLINK_OK:      return "ok";
+        case UPLINK_NO_WIFI: return "no wifi";
+        case UPLINK_NO_MQTT: return "no mqtt";
+        case UPLINK_BUDGET:  return "budget";
+        default:             return "?";
+    }
+}
+
+inline const char* uplinkTriggerName(uint8_t t) {
+    switch (t) {
+        case UPLINK_TRIGGER_CADENCE: return "cadence";
+        case UPLINK_TRIGGER_QUEUE:   return "queue";
+        case UPLINK_TRIGGER_MANUAL:  return "manual";
+        default:                     return "none";
+    }
+}
+
+// lastEpoch is 0 before the first window. A clock that went backwards makes
+// the window due rather than postponing it for years.
+inline UplinkTrigger uplinkWindowDue(const UplinkPolicy& p, uint32_t nowEpoch, uint32_t lastEpoch,
+                                     uint32_t queuedBytes) {
+    if (p.queueBytes && queuedBytes >= p.queueBytes) return UPLINK_TRIGGER_QUEUE;
+    if (p.cadenceSec && (lastEpoch == 0 || nowEpoch < lastEpoch || nowEpoch - lastEpoch >= p.cadenceSec)) {
+        return UPLINK_TRIGGER_CADENCE;
+    }
+    return UPLINK_TRIGGER_NONE;
+}
+
+// Time to program the wake-up timer with, 0 when a window is due
+inline uint32_t uplinkSecondsUntilDue(const UplinkPolicy& p, uint32_t nowEpoch, uint32_t lastEpoch) {
+    if (!p.cadenceSec) return 0xFFFFFFFF;
+    if (lastEpoch == 0 || nowEpoch < lastEpoch) return 0;
+    uint32_t elapsed = nowEpoch - lastEpoch;
+    return elapsed >= p.cadenceSec ? 0 : p.cadenceSec - elapsed;
+}
+
+// One window, driven by step() with the link state sampled by the caller
+class UplinkWindow {
+public:
+    UplinkWindow() : _phase(UPLINK_CLOSED), _start(0), _lingerStart(0) {
+        memset(&_policy, 0, sizeof(_policy));
+        memset(&_record, 0, sizeof(_record));
+    }
+
+    void setPolicy(const UplinkPolicy& policy) { _policy = policy; }
+    const UplinkPolicy& policy() const { return _policy; }
+
+    UplinkAction open(UplinkTrigger trigger, uint32_t nowMs, uint32_t epoch, uint32_t pending) {
+        memset(&_record, 0, sizeof(_record));
+        _record.trigger       = (uint8_t)trigger;
+        _record.startEpoch    = epoch;
+        _record.pendingAtOpen = pending;
+        _start = nowMs;
+        _phase = UPLINK_WIFI;
+        return UPLINK_ACT_CONNECT_WIFI;
+    }
+
+    UplinkAction step(uint32_t nowMs, bool wifiUp, bool mqttUp, uint32_t pending) {
+        if (_phase == UPLINK_CLOSED) return UPLINK_ACT_NONE;
+        uint32_t elapsed = nowMs - _start;
+
+        switch (_phase) {
+            case UPLINK_WIFI:
+                if (!wifiUp) break;
+                _record.wifiMs = elapsed;
+                _phase = UPLINK_MQTT;
+                return UPLINK_ACT_CONNECT_MQTT;
+
+            case UPLINK_MQTT:
+                if (!mqttUp) break;
+                _record.mqttMs = elapsed - _record.wifiMs;
+                _phase = UPLINK_DRAIN;  // the outbox may already be empty
+                // fall through
+
+            case UPLINK_DRAIN:
+                if (!mqttUp || pending > 0) break;
+                _phase       = UPLINK_LINGER;
+                _lingerStart = nowMs;
+                // fall through
+
+            case UPLINK_LINGER:
+                if (nowMs - _lingerStart >= _policy.lingerMs) return close(nowMs, UPLINK_OK, pending);
+                break;
+
+            default:
+                break;
+        }
+
+        if (elapsed >= _policy.budgetMs) return close(nowMs, budgetOutcome(pending), pending);
+        return UPLINK_ACT_NONE;
+    }
+
+    // Gives up on the window, e.g. no known network in range
+    UplinkAction fail(uint32_t nowMs, UplinkOutcome outcome, uint32_t pending) {
+        if (_phase == UPLINK_CLOSED) return UPLINK_ACT_NONE;
+        return close(nowMs, outcome, pending);
+    }
+
+    // Called once the radio is really off, shutdown time counts as radio-on
+    void radioOff(uint32_t nowMs) { _record.radioOnMs = nowMs - _start; }
+
+    bool        isOpen() const { return _phase != UPLINK_CLOSED; }
+    UplinkPhase phase()  const { return _phase; }
+    const UplinkWindowRecord& record() const { return _record; }
+
+private:
+    UplinkPolicy       _policy;
+    UplinkPhase        _phase;
+    uint32_t           _start;
+    uint32_t           _lingerStart;
+    UplinkWindowRecord _record;
+
+    UplinkOutcome budgetOutcome(uint32_t pending) const {
+        switch (_phase) {
+            case UPLINK_WIFI:   return UPLINK_NO_WIFI;
+            case UPLINK_MQTT:   return UPLINK_NO_MQTT;
+            case UPLINK_DRAIN:  return pending ? UPLINK_BUDGET : UPLINK_NO_MQTT;
+            default:            return UPLINK_OK;
+        }
+    }
+
+    UplinkAction close(uint32_t nowMs, UplinkOutcome outcome, uint32_t pending) {
+        _record.outcome        = (uint8_t)outcome;
+        _record.pendingAtClose = pending;
+        _record.radioOnMs      = nowMs - _start;
+        _phase = UPLINK_CLOSED;
+        return UPLINK_ACT_CLOSE;
+    }
+};
+
+#endif
@@ -0,0 +1,232 @@
+#ifndef VALUE_PICKER_H
+#define VALUE_PICKER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// Multi-field value picker, driven by a constant table of field
+// descriptors. Fields are edited one after the other with up/down; a day
+// field follows the month and year fields of the same table (month length,
+// leap years). No heap: the model keeps the values, the table stays in
+// flash.
+//
+//   static constexpr PickerField DATE[] = { pickYear(), pickMonth(), pickDay() };
+//   model.configure(DATE, 3, initial);
+
+#define PICKER_MAX_FIELDS  6
+
+enum PickerKind : uint8_t {
+    PICK_INT = 0,     // bounded integer, optional step
+    PICK_ENUM,        // index into names
+    PICK_YEAR,
+    PICK_MONTH,       // 1..12
+    PICK_DAY,         // 1..length of the month
+    PICK_HOURS,       // time of day or duration part
+    PICK_MINUTES,
+    PICK_SECONDS
+};
+
+struct PickerField {
+    const char*        label;
+    PickerKind         kind;
+    int16_t            minValue;
+    int16_t            maxValue;
+    uint8_t            step;
+    const char* const* names;   // PICK_ENUM only
+};
+
+constexpr PickerField pickInt(const char* label, int16_t minValue, int16_t maxValue, uint8_t step = 1) {
+    return { label, PICK_INT, minValue, maxValue, step, nullptr };
+}
+constexpr PickerField pickEnum(const char* label, const char* const* names, uint8_t count) {
+    return { label, PICK_ENUM, 0, (int16_t)(count - 1), 1, names };
+}
+constexpr PickerField pickYear(const char* label = "Year", int16_t first = 2024, int16_t last = 2099) {
+    return { label, PICK_YEAR, first, last, 1, nullptr };
+}
+constexpr PickerField pickMonth(const char* label = "Month") { return { label, PICK_MONTH, 1, 12, 1, nullptr }; }
+constexpr PickerField pickDay(const char* label = "Day")     { return { label, PICK_DAY, 1, 31, 1, nullptr }; }
+constexpr PickerField pickHours(const char* label = "Hours", int16_t maxValue = 23) {
+    return { label, PICK_HOURS, 0, maxValue, 1, nullptr };
+}
+constexpr PickerField pickMinutes(const char* label = "Minutes") { return { label, PICK_MINUTES, 0, 59, 1, nullptr }; }
+constexpr PickerField pickSeconds(const char* label = "Seconds") { return { label, PICK_SECONDS, 0, 59, 1, nullptr }; }
+
+inline bool pickerIsLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+inline uint8_t pickerDaysInMonth(int year, int month) {
+    static const uint8_t DAYS[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    if (month < 1 || month > 12) return 31;
+    return month == 2 && pickerIsLeapYear(year) ? 29 : DAYS[month - 1];
+}
+
+// 0 = Sunday, what the RTC expects
+inline uint8_t pickerWeekDay(int year, int month, int day) {
+    static const uint8_t T[12] = { 0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4 };
+    if (month < 3) year--;
+    return (uint8_t)((year + year / 4 - year / 100 + year / 400 + T[(month - 1) % 12] + day) % 7);
+}
+
+// What changed since the last takeDirty(), for partial redraws
+enum PickerDirty : uint8_t {
+    PICKER_DIRTY_VALUE = 1,   // the value of the current field
+    PICKER_DIRTY_FIELD = 2,   // another field is current
+    PICKER_DIRTY_ALL   = 4
+};
+
+class ValuePickerModel {
+public:
+    ValuePickerModel() : _fields(nullptr), _count(0), _current(0), _dirty(0) {}
+
+    // initial may be nullptr (minimum of each field); values are clamped.
+    // False when the table has more than PICKER_MAX_FIELDS fields.
+    bool configure(const PickerField* fields, uint8_t count, const int16_t* initial = nullptr) {
+        if (count > PICKER_MAX_FIELDS) return false;
+        _fields  = fields;
+        _count   = count;
+        _current = 0;
+        for (uint8_t i = 0; i < count; i++) _values[i] = initial ? initial[i] : fields[i].minValue;
+        for (uint8_t i = 0; i < count; i++) {
+            if (fields[i].kind != PICK_DAY) _values[i] = clamp(i, _values[i]);
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            if (fields[i].kind == PICK_DAY) _values[i] = clamp(i, _values[i]);  // once month and year are valid
+        }
+        _dirty = PICKER_DIRTY_ALL;
+        return true;
+    }
+
+    uint8_t            count()              const { return _count; }
+    uint8_t            current()            const { return _current; }
+    const PickerField& field(uint8_t i)     const { return _fields[i]; }
+    int16_t            value(uint8_t i)     const { return i < _count ? _values[i] : 0; }
+
+    // Index of the first field of that kind, -1 if none
+    int find(PickerKind kind) const {
+        for (uint8_t i = 0; i < _count; i++) {
+            if (_fields[i].kind == kind) return i;
+        }
+        return -1;
+    }
+
+    int16_t valueOf(PickerKind kind, int16_t def = 0) const {
+        int i = find(kind);
+        return i < 0 ? def : _values[i];
+    }
+
+    // Upper bound of a field right now: a day follows month and year
+    int16_t maxOf(uint8_t i) const {
+        const PickerField& f = _fields[i];
+        if (f.kind != PICK_DAY) return f.maxValue;
+        int16_t days = pickerDaysInMonth(valueOf(PICK_YEAR, 2000), valueOf(PICK_MONTH, 1));
+        if (find(PICK_MONTH) < 0) days = 31;
+        return days < f.maxValue ? days : f.maxValue;
+    }
+
+    // Value of the current field after dir steps (+1 up, -1 down), wrapping
+    int16_t neighbour(int dir) const {
+        const PickerField& f = _fields[_current];
+        int16_t lo = f.minValue, hi = maxOf(_current);
+        int32_t span = (hi - lo) / f.step + 1;
+        int32_t pos  = (_values[_current] - lo) / f.step + dir;
+        pos = ((pos % span) + span) % span;
+        return (int16_t)(lo + pos * f.step);
+    }
+
+    void step(int dir) {
+        if (!_count || _current >= _count) return;
+        setValue(_current, neighbour(dir));
+    }
+
+    void setValue(uint8_t i, int16_t v) {
+        if (i >= _count) return;
+        _values[i] = clamp(i, v);
+        if (i == _current) _dirty |= PICKER_DIRTY_VALUE;
+        int day = find(PICK_DAY);
+        if (day >= 0 && day != i && _values[day] > maxOf(day)) _values[day] = maxOf(day);  // 31 -> Feb
+    }
+
+    // Back to the first field, values kept
+    void restart() {
+        _current = 0;
+        _dirty   = PICKER_DIRTY_ALL;
+    }
+
+    // Confirms the current field; true once the last one is confirmed
+    bool next() {
+        if (_current < _count) _current++;
+        _dirty |= PICKER_DIRTY_FIELD;
+        return _current >= _count;
+    }
+
+    // Back to the previous field, false on the first one
+    bool back() {
+        if (_current == 0) return false;
+        _current--;
+        _dirty |= PICKER_DIRTY_FIELD;
+        return true;
+    }
+
+    bool complete() const { return _count && _current >= _count; }
+
+    uint8_t takeDirty() {
+        uint8_t d = _dirty;
+        _dirty = 0;
+        return d;
+    }
+
+    // Hours, minutes and seconds fields added up, for durations
+    uint32_t totalSeconds() const {
+        uint32_t total = 0;
+        for (uint8_t i = 0; i < _count; i++) {
+            switch (_fields[i].kind) {
+                case PICK_HOURS:   total += (uint32_t)_values[i] * 3600; break;
+                case PICK_MINUTES: total += (uint32_t)_values[i] * 60;   break;
+                case PICK_SECONDS: total += (uint32_t)_values[i];        break;
+                default:           break;
+            }
+        }
+        return total;
+    }
+
+    size_t format(uint8_t i, int16_t v, char* out, size_t cap) const {
+        const PickerField& f = _fields[i];
+        int n;
+        switch (f.kind) {
+            case PICK_ENUM:
+                n = snprintf(out, cap, "%s", f.names && v >= 0 && v <= f.maxValue ? f.names[v] : "?");
+                break;
+            case PICK_YEAR:
+                n = snprintf(out, cap, "%04d", v);
+                break;
+            case PICK_INT:
+                n = snprintf(out, cap, "%d", v);
+                break;
+            default:
+                n = snprintf(out, cap, "%02d", v);
+                break;
+        }
+        if (n < 0) n = 0;
+        return (size_t)n < cap ? (size_t)n : (cap ? cap - 1 : 0);
+    }
+
+private:
+    const PickerField* _fields;
+    uint8_t            _count;
+    uint8_t            _current;
+    uint8_t            _dirty;
+    int16_t            _values[PICKER_MAX_FIELDS];
+
+    int16_t clamp(uint8_t i, int16_t v) const {
+        const PickerField& f = _fields[i];
+        int16_t hi = maxOf(i);
+        if (v < f.minValue) return f.minValue;
+        if (v > hi) return hi;
+        return (int16_t)(f.minValue + (v - f.minValue) / f.step * f.step);
+    }
+};
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef WIFI_RANKING_H
+#define WIFI_RANKING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// Ranking of the known networks currently in range. Each candidate gets an
+// estimate of the time it will take to join, lowest first:
+//   average connect time of the profile
+// + a penalty for weak signal (retries, low PHY rate, slow DHCP)
+// + failure rate * cost of a failed attempt
+
+#define WIFI_RANK_UNKNOWN_MS    3000   // assumed connect time without history
+#define WIFI_RANK_FAIL_COST_MS  10000  // a failed attempt burns the full timeout
+#define WIFI_RANK_RSSI_GOOD     -67    // dBm, no penalty above
+#define WIFI_RANK_MS_PER_DB     150    // penalty per dB below WIFI_RANK_RSSI_GOOD
+
+// Per-profile connect history, 8 bytes so it can live in NVS and RTC memory
+struct WifiProfileStats {
+    uint16_t attempts;
+    uint16_t failures;
+    uint16_t avgConnectMs;   // exponential average of successful connects
+    uint16_t lastConnectMs;
+
+    void record(bool ok, uint32_t ms) {
+        if (ms > 0xFFFF) ms = 0xFFFF;
+        if (attempts == 0xFFFF) {  // keep the ratio, forget old history
+            attempts /= 2;
+            failures /= 2;
+        }
+        attempts++;
+        if (!ok) {
+            failures++;
+            return;
+        }
+        lastConnectMs = (uint16_t)ms;
+        // First sample sets the average, then weight 1/4
+        avgConnectMs = attempts - failures == 1 ? (uint16_t)ms
+                                                : (uint16_t)((3UL * avgConnectMs + ms) / 4);
+    }
+
+    // Failure rate in per mille, counted as if there had been one more
+    // success so a single failure out of one attempt does not rule a network out
+    uint16_t failurePermille() const { return (uint16_t)(failures * 1000UL / (attempts + 1)); }
+};
+
+struct WifiCandidate {
+    uint8_t profile;   // index in the profile store
+    int8_t  rssi;
+    uint8_t channel;
+    uint8_t bssid[6];
+    int32_t score;     // estimated ms to join, lower is better
+};
+
+inline int32_t wifiCandidateScore(int rssi, const WifiProfileStats& stats) {
+    int32_t expected = stats.attempts > stats.failures ? stats.avgConnectMs : WIFI_RANK_UNKNOWN_MS;
+    if (rssi < WIFI_RANK_RSSI_GOOD) expected += (WIFI_RANK_RSSI_GOOD - rssi) * WIFI_RANK_MS_PER_DB;
+    expected += (int32_t)((uint32_t)stats.failurePermille() * WIFI_RANK_FAIL_COST_MS / 1000);
+    return expected;
+}
+
+// Adds a scan result for a known profile, keeping only the strongest AP of
+// each profile. Returns the new candidate count.
+inline size_t wifiAddCandidate(WifiCandidate* list, size_t count, size_t capacity, uint8_t profile, int rssi,
+                               uint8_t channel, const uint8_t* bssid) {
+    for (size_t i = 0; i < count; i++) {
+        if (list[i].profile != profile) continue;
+        if (rssi <= list[i].rssi) return count;
+        list[i].rssi    = (int8_t)rssi;
+        list[i].channel = channel;
+        if (bssid) memcpy(list[i].bssid, bssid, 6);
+        return count;
+    }
+    if (count >= capacity) return count;
+    WifiCandidate& c = list[count];
+    c.profile = profile;
+    c.rssi    = (int8_t)rssi;
+    c.channel = channel;
+    if (bssid) memcpy(c.bssid, bssid, 6);
+    else       memset(c.bssid, 0, 6);
+    c.score = 0;
+    return count + 1;
+}
+
+// Scores and sorts the candidates, best first. stats is indexed by profile.
+inline void wifiRankCandidates(WifiCandidate* list, size_t count, const WifiProfileStats* stats) {
+    for (size_t i = 0; i < count; i++) list[i].score = wifiCandidateScore(list[i].rssi, stats[list[i].profile]);
+    // Insertion sort: a handful of entries, stable on ties (scan order = RSSI order)
+    for (size_t i = 1; i < count; i++) {
+        WifiCandidate c = list[i];
+        size_t j = i;
+        while (j > 0 && list[j - 1].score > c.score) {
+            list[j] = list[j - 1];
+            j--;
+        }
+        list[j] = c;
+    }
+}
+
+#endif
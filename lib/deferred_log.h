@@ -0,0 +1,170 @@
+#ifndef DEFERRED_LOG_H
+#define DEFERRED_LOG_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "core/log_ring.h"
+
+#ifndef LOG_RING_RECORDS
+#define LOG_RING_RECORDS   64     // 48 bytes each, power of two
+#endif
+#define LOG_DRAIN_STACK    3072
+#define LOG_DRAIN_PRIORITY 1      // just above idle
+#define LOG_DRAIN_IDLE_MS  20
+#define LOG_LINE_MAX       160
+
+// DLOG_I(MQTT, MQTT_CONNECTING, host): module and message are names from
+// core/log_messages.h. Safe from any task or core; a disabled level costs
+// one compare, an enabled one a 48-byte copy into the ring.
+#define DLOG(level, module, msg, ...) \
+    DeferredLog::write(level, LOG_MODULE_##module, LOG_MSG_##msg, ##__VA_ARGS__)
+#define DLOG_E(module, msg, ...) DLOG(LOG_LEVEL_ERROR, module, msg, ##__VA_ARGS__)
+#define DLOG_W(module, msg, ...) DLOG(LOG_LEVEL_WARN, module, msg, ##__VA_ARGS__)
+#define DLOG_I(module, msg, ...) DLOG(LOG_LEVEL_INFO, module, msg, ##__VA_ARGS__)
+#define DLOG_D(module, msg, ...) DLOG(LOG_LEVEL_DEBUG, module, msg, ##__VA_ARGS__)
+
+// Singleton owning the ring. Records are turned into text (or sent raw for
+// tools/log_decode.py) by a low priority task, so Serial never blocks the
+// code that logs.
+class DeferredLog {
+private:
+    static DeferredLog instance;
+
+    LogRing<LOG_RING_RECORDS> ring;
+    volatile uint8_t          levels[LOG_MODULE_COUNT];
+    volatile bool             binary;
+    TaskHandle_t              task;
+    uint32_t                  reportedDrops;
+
+    DeferredLog() : binary(false), task(nullptr), reportedDrops(0) {
+        for (uint8_t m = 0; m < LOG_MODULE_COUNT; m++) levels[m] = LOG_LEVEL_INFO;
+    }
+
+    static void drainTask(void*) {
+        for (;;) {
+            if (!instance.drain(16)) vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_IDLE_MS));
+        }
+    }
+
+    void reportDrops() {
+        uint32_t dropped = ring.dropped();
+        if (dropped == reportedDrops) return;
+        LogRecord r;
+        r.timeMs      = millis();
+        r.message     = LOG_MSG_LOG_DROPPED;
+        r.levelModule = (LOG_LEVEL_WARN << 4) | LOG_MODULE_APP;
+        r.words       = 0;
+        logPack(r, (unsigned)(dropped - reportedDrops));
+        if (ring.push(r)) reportedDrops = dropped;
+    }
+
+    void output(const LogRecord& r) {
+        if (binary) {
+            static const uint8_t SYNC[2] = { LOG_SYNC_0, LOG_SYNC_1 };
+            Serial.write(SYNC, sizeof(SYNC));
+            Serial.write((const uint8_t*)&r, sizeof(r));
+            return;
+        }
+        char line[LOG_LINE_MAX];
+        size_t n = logFormatLine(r, line, sizeof(line));
+        Serial.write((const uint8_t*)line, n);
+        Serial.write('\n');
+    }
+
+    static int parseLevel(const char* s) {
+        static const char* const NAMES[] = { "none", "error", "warn", "info", "debug" };
+        for (int l = 0; l <= LOG_LEVEL_DEBUG; l++) {
+            if (strcasecmp(s, NAMES[l]) == 0) return l;
+        }
+        return -1;
+    }
+
+public:
+    static DeferredLog* getInstance() { return &instance; }
+
+    template <typename... Args>
+    static inline void write(LogLevel level, LogModule module, LogMessageId message, Args... args) {
+        if (level > instance.levels[module]) return;
+        LogRecord r;
+        r.timeMs      = millis();
+        r.message     = (uint16_t)message;
+        r.levelModule = (uint8_t)((level << 4) | module);
+        r.words       = 0;
+        logPack(r, args...);
+        instance.ring.push(r);
+    }
+
+    // Starts the drain task. Without it, call drain() from loop().
+    void begin(bool startTask = true) {
+        if (startTask && !task) {
+            xTaskCreate(drainTask, "logDrain", LOG_DRAIN_STACK, nullptr, LOG_DRAIN_PRIORITY, &task);
+        }
+    }
+
+    // Outputs up to max records, returns how many
+    size_t drain(size_t max = LOG_RING_RECORDS) {
+        reportDrops();
+        LogRecord r;
+        size_t    n = 0;
+        while (n < max && ring.pop(r)) {
+            output(r);
+            n++;
+        }
+        return n;
+    }
+
+    void setLevel(LogModule module, LogLevel level) { levels[module] = level; }
+    void setLevel(LogLevel level) {
+        for (uint8_t m = 0; m < LOG_MODULE_COUNT; m++) levels[m] = level;
+    }
+    LogLevel getLevel(LogModule module) { return (LogLevel)levels[module]; }
+
+    // Raw records framed with A5 5A, decoded on the host by tools/log_decode.py
+    void setBinaryOutput(bool enable) { binary = enable; }
+
+    uint32_t getWritten() { return ring.written(); }
+    uint32_t getDropped() { return ring.dropped(); }
+
+    // Console: "log" | "log bin" | "log text" | "log <module|all> <none|error|warn|info|debug>"
+    void handleConsole(const char* args) {
+        if (strcmp(args, "bin") == 0)  { setBinaryOutput(true);  return; }
+        if (strcmp(args, "text") == 0) { setBinaryOutput(false); return; }
+
+        char        module[12];
+        const char* space = strchr(args, ' ');
+        if (space && (size_t)(space - args) < sizeof(module)) {
+            memcpy(module, args, space - args);
+            module[space - args] = '\0';
+            int level = parseLevel(space + 1);
+            if (level >= 0) {
+                if (strcasecmp(module, "all") == 0) {
+                    setLevel((LogLevel)level);
+                    return;
+                }
+                for (uint8_t m = 0; m < LOG_MODULE_COUNT; m++) {
+                    if (strcasecmp(module, logModuleName(m)) == 0) {
+                        setLevel((LogModule)m, (LogLevel)level);
+                        return;
+                    }
+                }
+            }
+        }
+        printStats();
+    }
+
+    void printStats() {
+        Serial.println("=== Log ===");
+        Serial.printf("Records: %u written, %u dropped, %u queued / %u\n", (unsigned)ring.written(),
+                      (unsigned)ring.dropped(), (unsigned)ring.size(), (unsigned)LOG_RING_RECORDS);
+        for (uint8_t m = 0; m < LOG_MODULE_COUNT; m++) {
+            Serial.printf("  %-6s %c\n", logModuleName(m), logLevelLetter(levels[m]));
+        }
+        Serial.println("===========");
+    }
+};
+
+// Initialize static instance
+DeferredLog DeferredLog::instance;
+
+#endif
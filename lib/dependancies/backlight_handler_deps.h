@@ -0,0 +1,13 @@
+#ifndef BACKLIGHT_HANDLER_DEPS_H
+#define BACKLIGHT_HANDLER_DEPS_H
+
+#include "../ports/backlight_handler_port.h"
+#include "../ports/battery_handler_port.h"
+#include "../adapters/backlight_handler_m5stick_adapter.h"
+#include "../mem_tracker.h"
+
+inline BacklightHandlerT* getM5StickBacklightHandler(BatteryHandlerT* battery) {
+    return memNew<BacklightHandlerM5StickAdapter>(MEM_TAG_POWER, battery);
+}
+
+#endif
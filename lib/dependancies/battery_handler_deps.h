@@ -4,9 +4,10 @@
 #include "../ports/battery_handler_port.h"
 #include "../ports/display_handler_port.h"
 #include "../adapters/battery_handler_m5stick_adapter.h"
+#include "../mem_tracker.h"
 
-inline IBatteryHandler* getM5StickBatteryHandler(IDisplayHandler* display, uint32_t intervalMs = 5000) {
-    return new BatteryHandlerM5StickAdapter(display, intervalMs);
+inline BatteryHandlerT* getM5StickBatteryHandler(DisplayHandlerT* display, uint32_t intervalMs = 5000) {
+    return memNew<BatteryHandlerM5StickAdapter>(MEM_TAG_POWER, display, intervalMs);
 }
 
 #endif
@@ -3,9 +3,10 @@
 
 #include "../ports/button_handler_port.h"
 #include "../adapters/button_handler_m5stick_adapter.h"
+#include "../mem_tracker.h"
 
-inline IButtonHandler* getM5StickButtonHandler(int btnType = 1, uint32_t doubleClickMs = 400) {
-    return new ButtonHandlerM5StickAdapter(btnType, doubleClickMs);
+inline ButtonHandlerT* getM5StickButtonHandler(int btnType = 1, uint32_t doubleClickMs = 400) {
+    return memNew<ButtonHandlerM5StickAdapter>(MEM_TAG_INPUT, btnType, doubleClickMs);
 }
 
 #endif
@@ -6,9 +6,10 @@
 #include "../ports/battery_handler_port.h"
 #include "../ports/rtc_utils_port.h"
 #include "../adapters/clock_handler_m5stick_adapter.h"
+#include "../mem_tracker.h"
 
-inline IClockHandler* getM5StickClockHandler(IDisplayHandler* display, IBatteryHandler* battery, IRtcUtils* rtc) {
-    return new ClockHandlerM5StickAdapter(display, battery, rtc);
+inline ClockHandlerT* getM5StickClockHandler(DisplayHandlerT* display, BatteryHandlerT* battery, RtcUtilsT* rtc) {
+    return memNew<ClockHandlerM5StickAdapter>(MEM_TAG_TIME, display, battery, rtc);
 }
 
 #endif
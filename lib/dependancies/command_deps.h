@@ -0,0 +1,13 @@
+#ifndef COMMAND_DEPS_H
+#define COMMAND_DEPS_H
+
+#include "../ports/command_port.h"
+#include "../ports/mqtt_helper_port.h"
+#include "../adapters/command_m5stick_adapter.h"
+#include "../mem_tracker.h"
+
+inline CommandServiceT* getM5StickCommands(MQTTHelperT* mqtt, const CommandSpec* table, size_t count) {
+    return memNew<CommandM5StickAdapter>(MEM_TAG_NET, mqtt, table, count);
+}
+
+#endif
@@ -3,9 +3,10 @@
 
 #include "../ports/display_handler_port.h"
 #include "../adapters/display_handler_m5stick_adapter.h"
+#include "../mem_tracker.h"
 
-inline IDisplayHandler* getM5StickDisplayHandler() {
-    return new DisplayHandlerM5StickAdapter();
+inline DisplayHandlerT* getM5StickDisplayHandler() {
+    return memNew<DisplayHandlerM5StickAdapter>(MEM_TAG_DISPLAY);
 }
 
 #endif
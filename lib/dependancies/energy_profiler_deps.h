@@ -0,0 +1,17 @@
+#ifndef ENERGY_PROFILER_DEPS_H
+#define ENERGY_PROFILER_DEPS_H
+
+#include "../ports/energy_profiler_port.h"
+#include "../ports/battery_handler_port.h"
+#include "../ports/page_manager_port.h"
+#include "../ports/backlight_handler_port.h"
+#include "../ports/rtc_utils_port.h"
+#include "../adapters/energy_profiler_m5stick_adapter.h"
+#include "../mem_tracker.h"
+
+inline EnergyProfilerT* getM5StickEnergyProfiler(BatteryHandlerT* battery, PageManagerT* pages,
+                                                 BacklightHandlerT* backlight, RtcUtilsT* rtc) {
+    return memNew<EnergyProfilerM5StickAdapter>(MEM_TAG_POWER, battery, pages, backlight, rtc);
+}
+
+#endif
@@ -4,9 +4,10 @@
 #include "../ports/menu_handler_port.h"
 #include "../adapters/menu_handler_m5stick_adapter.h"
 #include "../ports/display_handler_port.h"
+#include "../mem_tracker.h"
 
-inline IMenuHandler* getM5StickMenuHandler(IDisplayHandler* disp, const char* title = "Menu") {
-    return new MenuHandlerM5StickAdapter(disp, title);
+inline MenuHandlerT* getM5StickMenuHandler(DisplayHandlerT* disp, const char* title = "Menu") {
+    return memNew<MenuHandlerM5StickAdapter>(MEM_TAG_UI, disp, title);
 }
 
 #endif
@@ -4,9 +4,10 @@
 #include "../ports/menu_manager_port.h"
 #include "../ports/display_handler_port.h"
 #include "../adapters/menu_manager_m5stick_adapter.h"
+#include "../mem_tracker.h"
 
-inline IMenuManager* getM5StickMenuManager(IDisplayHandler* display) {
-    return new MenuManagerM5StickAdapter(display);
+inline MenuManagerT* getM5StickMenuManager(DisplayHandlerT* display) {
+    return memNew<MenuManagerM5StickAdapter>(MEM_TAG_UI, display);
 }
 
 #endif
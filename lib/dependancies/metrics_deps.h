@@ -0,0 +1,14 @@
+#ifndef METRICS_DEPS_H
+#define METRICS_DEPS_H
+
+#include "../ports/metrics_port.h"
+#include "../ports/mqtt_helper_port.h"
+#include "../adapters/metrics_m5stick_adapter.h"
+#include "../mem_tracker.h"
+
+// mqtt may be nullptr: Serial table only
+inline MetricsExporterT* getM5StickMetrics(MQTTHelperT* mqtt = nullptr) {
+    return memNew<MetricsM5StickAdapter>(MEM_TAG_TELEMETRY, mqtt);
+}
+
+#endif
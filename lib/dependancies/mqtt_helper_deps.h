@@ -3,9 +3,10 @@
 
 #include "../ports/mqtt_helper_port.h"
 #include "../adapters/mqtt_helper_m5stick_adapter.h"
+#include "../mem_tracker.h"
 
-inline IMQTTHelper* getM5StickMQTTHelper() {
-    return new MQTTHelperM5StickAdapter();
+inline MQTTHelperT* getM5StickMQTTHelper() {
+    return memNew<MQTTHelperM5StickAdapter>(MEM_TAG_NET);
 }
 
 #endif
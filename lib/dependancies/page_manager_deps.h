@@ -3,9 +3,10 @@
 
 #include "../ports/page_manager_port.h"
 #include "../adapters/page_manager_m5stick_adapter.h"
+#include "../mem_tracker.h"
 
-inline IPageManager* getM5StickPageManager() {
-    return new PageManagerM5StickAdapter();
+inline PageManagerT* getM5StickPageManager() {
+    return memNew<PageManagerM5StickAdapter>(MEM_TAG_UI);
 }
 
 #endif
@@ -0,0 +1,14 @@
+#ifndef POMODORO_DEPS_H
+#define POMODORO_DEPS_H
+
+#include "../ports/pomodoro_port.h"
+#include "../ports/battery_handler_port.h"
+#include "../ports/rtc_utils_port.h"
+#include "../adapters/pomodoro_m5stick_adapter.h"
+#include "../mem_tracker.h"
+
+inline PomodoroT* getM5StickPomodoro(BatteryHandlerT* battery, RtcUtilsT* rtc) {
+    return memNew<PomodoroM5StickAdapter>(MEM_TAG_TIME, battery, rtc);
+}
+
+#endif
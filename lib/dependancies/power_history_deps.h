@@ -0,0 +1,14 @@
+#ifndef POWER_HISTORY_DEPS_H
+#define POWER_HISTORY_DEPS_H
+
+#include "../ports/power_history_port.h"
+#include "../ports/battery_handler_port.h"
+#include "../ports/rtc_utils_port.h"
+#include "../adapters/power_history_m5stick_adapter.h"
+#include "../mem_tracker.h"
+
+inline PowerHistoryT* getM5StickPowerHistory(BatteryHandlerT* battery, RtcUtilsT* rtc, uint32_t sampleIntervalMs = 60000) {
+    return memNew<PowerHistoryM5StickAdapter>(MEM_TAG_POWER, battery, rtc, sampleIntervalMs);
+}
+
+#endif
@@ -3,9 +3,10 @@
 
 #include "../ports/rtc_utils_port.h"
 #include "../adapters/rtc_utils_m5stick_adapter.h"
+#include "../mem_tracker.h"
 
-inline IRtcUtils* getM5StickRtcUtils() {
-    return new RtcUtilsM5StickAdapter();
+inline RtcUtilsT* getM5StickRtcUtils() {
+    return memNew<RtcUtilsM5StickAdapter>(MEM_TAG_TIME);
 }
 
 #endif
@@ -0,0 +1,41 @@
+#ifndef STATIC_WIRING_H
+#define STATIC_WIRING_H
+
+#include "../adapters/display_handler_m5stick_adapter.h"
+#include "../adapters/battery_handler_m5stick_adapter.h"
+#include "../adapters/rtc_utils_m5stick_adapter.h"
+#include "../adapters/clock_handler_m5stick_adapter.h"
+#include "../adapters/page_manager_m5stick_adapter.h"
+#include "../adapters/power_history_m5stick_adapter.h"
+#include "../adapters/backlight_handler_m5stick_adapter.h"
+#include "../adapters/energy_profiler_m5stick_adapter.h"
+#include "../adapters/metrics_m5stick_adapter.h"
+#include "../adapters/pomodoro_m5stick_adapter.h"
+
+// Composition root for the default app, without the heap: every adapter is
+// a member, built in dependency order. Each port also defines a <Name>T
+// type: with -DSTATIC_WIRING it is the adapter class (declared final), so
+// everything holding a DisplayHandlerT* calls the adapter directly and the
+// compiler can inline; otherwise it is the interface and this struct simply
+// replaces the get* factories. Tests and simulators keep using the ports.
+// The port forward-declares the adapter before the typedef because the
+// adapter includes its own port first.
+struct StaticWiring {
+    DisplayHandlerM5StickAdapter   display;
+    BatteryHandlerM5StickAdapter   battery;
+    RtcUtilsM5StickAdapter         rtc;
+    ClockHandlerM5StickAdapter     clock;
+    PageManagerM5StickAdapter      pages;
+    PowerHistoryM5StickAdapter     powerHistory;
+    BacklightHandlerM5StickAdapter backlight;
+    EnergyProfilerM5StickAdapter   energy;
+    MetricsM5StickAdapter          metrics;
+    PomodoroM5StickAdapter         pomodoro;
+
+    StaticWiring()
+        : battery(&display), clock(&display, &battery, &rtc), powerHistory(&battery, &rtc),
+          backlight(&battery), energy(&battery, &pages, &backlight, &rtc), metrics(nullptr),
+          pomodoro(&battery, &rtc) {}
+};
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef TELEMETRY_DEPS_H
+#define TELEMETRY_DEPS_H
+
+#include "../ports/telemetry_port.h"
+#include "../ports/mqtt_helper_port.h"
+#include "../ports/rtc_utils_port.h"
+#include "../adapters/telemetry_m5stick_adapter.h"
+#include "../mem_tracker.h"
+
+inline TelemetryT* getM5StickTelemetry(MQTTHelperT* mqtt, RtcUtilsT* rtc, const char* topic,
+                                       uint32_t windowMs = 60000) {
+    return memNew<TelemetryM5StickAdapter>(MEM_TAG_TELEMETRY, mqtt, rtc, topic, windowMs);
+}
+
+#endif
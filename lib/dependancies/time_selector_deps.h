@@ -4,9 +4,10 @@
 #include "../ports/time_selector_port.h"
 #include "../ports/display_handler_port.h"
 #include "../adapters/time_selector_m5stick_adapter.h"
+#include "../mem_tracker.h"
 
-inline ITimeSelector* getM5StickTimeSelector(IDisplayHandler* display, const char* title = "Set Time") {
-    return new TimeSelectorM5StickAdapter(display, title);
+inline TimeSelectorT* getM5StickTimeSelector(DisplayHandlerT* display, const char* title = "Set Time") {
+    return memNew<TimeSelectorM5StickAdapter>(MEM_TAG_UI, display, title);
 }
 
 #endif
@@ -0,0 +1,13 @@
+#ifndef TIME_SYNC_DEPS_H
+#define TIME_SYNC_DEPS_H
+
+#include "../ports/time_sync_port.h"
+#include "../ports/rtc_utils_port.h"
+#include "../adapters/time_sync_m5stick_adapter.h"
+#include "../mem_tracker.h"
+
+inline TimeSyncT* getM5StickTimeSync(RtcUtilsT* rtc, const char* server = "pool.ntp.org") {
+    return memNew<TimeSyncM5StickAdapter>(MEM_TAG_TIME, rtc, server);
+}
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef UPLINK_DEPS_H
+#define UPLINK_DEPS_H
+
+#include "../ports/uplink_port.h"
+#include "../ports/mqtt_helper_port.h"
+#include "../ports/battery_handler_port.h"
+#include "../ports/rtc_utils_port.h"
+#include "../adapters/uplink_m5stick_adapter.h"
+#include "../mem_tracker.h"
+
+inline UplinkSchedulerT* getM5StickUplink(MQTTHelperT* mqtt, BatteryHandlerT* battery, RtcUtilsT* rtc) {
+    return memNew<UplinkM5StickAdapter>(MEM_TAG_NET, mqtt, battery, rtc);
+}
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef VALUE_PICKER_DEPS_H
+#define VALUE_PICKER_DEPS_H
+
+#include "../ports/value_picker_port.h"
+#include "../ports/display_handler_port.h"
+#include "../adapters/value_picker_m5stick_adapter.h"
+#include "../mem_tracker.h"
+
+inline ValuePickerT* getM5StickValuePicker(DisplayHandlerT* display, const char* title = "Set Value") {
+    return memNew<ValuePickerM5StickAdapter>(MEM_TAG_UI, display, title);
+}
+
+#endif
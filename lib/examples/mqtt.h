@@ -5,6 +5,7 @@
 #include "../wifi_helper.h"
 #include "../display_handler.h"
 #include "../battery_handler.h"
+#include "../dependancies/command_deps.h"
 
 // Instance globale
 MQTTHelper mqtt;
@@ -30,31 +31,37 @@ void setupMQTT() {
         "password"           // Password (optional)
     );
     
-    // 3. define callbacks (optional)
-    mqtt.onConnect([](bool sessionPresent) {
-        Serial.println("Connected,now subscribing to topics");
-        mqtt.subscribe("home/temperature");
-        mqtt.subscribe("home/commands");
+    // 3. one handler per topic filter, subscriptions are restored on reconnect
+    mqtt.subscribe("home/temperature", [](const MqttMessageView& msg) {
+        Serial.print("Temperature: ");
+        Serial.write((const uint8_t*)msg.payload, msg.length);
+        Serial.println();
     });
-    
-    mqtt.onMessage([](char* topic, char* payload, size_t len) {
-        Serial.print("New message on: ");
-        Serial.print(topic);
-        Serial.print(": ");
-        Serial.println(payload);
-        
-        // Parse json
-        StaticJsonDocument<256> doc;
-        DeserializationError err = deserializeJson(doc, payload, len);
-        
+
+    // The view is only valid inside the callback and the payload is not
+    // NUL-terminated: always use msg.length
+    mqtt.subscribe("home/+/commands", [](const MqttMessageView& msg) {
+        // Accepts JSON, MessagePack and CBOR payloads
+        JsonDocument doc;
+        DeserializationError err = deserializePayload(doc, msg);
+
         if (!err) {
             const char* command = doc["command"];
-            Serial.print("Commande: ");
-            Serial.println(command);
+            Serial.printf("Command for %s: %s\n", msg.topic, command);
         }
     });
-    
-    // 4. Connect to the broker 
+
+    // 4. catch-all callback (optional), called for every message after the routed handlers
+    mqtt.onMessage([](const MqttMessageView& msg) {
+        Serial.printf("Message on %s (%u bytes)\n", msg.topic, (unsigned)msg.length);
+    });
+
+    // 5. connection callback (optional)
+    mqtt.onConnect([](bool sessionPresent) {
+        Serial.println("Connected");
+    });
+
+    // 6. Connect to the broker 
     mqtt.connect();
 }
 
@@ -93,46 +100,55 @@ void publishSimpleMessage() {
 // EXEMPLE 4 : listen commands
 // ═══════════════════════════════════════════════════════════
 
+// Payload on device/<id>/cmd (JSON or MessagePack, CBOR is refused):
+//   {"id":"42","action":"set_config","args":{"user_id":3,"zone_id":7}}
+// Reply on device/<id>/reply:
+//   {"id":"42","action":"set_config","status":"ok","detail":""}
+
+static unsigned long restartAt = 0;
+static unsigned long sleepAt   = 0;
+
+// Handlers run from commands->update() on the loop task: no blocking
+// here, the reply is only sent once the handler returns
+CommandResult cmdRestart(const CommandArgs& args) {
+    restartAt = millis() + 500;  // let the reply go out first
+    return CommandResult::ok();
+}
+
+CommandResult cmdSleep(const CommandArgs& args) {
+    sleepAt = millis() + 500;  // same: the reply would never leave from deep sleep
+    return CommandResult::ok();
+}
+
+CommandResult cmdSetConfig(const CommandArgs& args) {
+    int userId = args.getInt(0);
+    int zoneId = args.getInt(1);
+    Serial.printf("Config updated: User=%d, Zone=%d\n", userId, zoneId);
+
+    // settings->setUserId(userId);
+    // settings->setZoneId(zoneId);
+    return CommandResult::ok();
+}
+
+// The table is fixed at compile time: name, handler, then typed arguments
+// {name, type, required}. Missing or mistyped arguments are answered with
+// "bad_args" without calling the handler.
+static const CommandSpec COMMANDS[] = {
+    { "restart",    cmdRestart,   {} },
+    { "sleep",      cmdSleep,     {} },
+    { "set_config", cmdSetConfig, { { "user_id", CMD_ARG_INT, true }, { "zone_id", CMD_ARG_INT, true } } },
+};
+
+ICommandService* commands = getM5StickCommands(&mqtt, COMMANDS, sizeof(COMMANDS) / sizeof(COMMANDS[0]));
+
 void setupCommandListener() {
-    // 1. Subscribe to a specific topic to the device with getDeviceId
-    String commandTopic = "device/" + MQTTHelper::getDeviceId() + "/commands";
-    
-    mqtt.onConnect([commandTopic](bool sessionPresent) {
-        mqtt.subscribe(commandTopic.c_str(), 1);
-    });
-    
-    // 2. Listen to RECEIVED message
-    mqtt.onMessage([](char* topic, char* payload, size_t len) {
-        StaticJsonDocument<256> doc;
-        DeserializationError err = deserializeJson(doc, payload, len);
-        
-        if (err) {
-            Serial.println("Invalid JSON command");
-            return;
-        }
-        
-        const char* action = doc["action"];
-        
-        if (strcmp(action, "restart") == 0) {
-            Serial.println("Restarting device");
-            delay(1000);
-            ESP.restart();
-        }
-        else if (strcmp(action, "sleep") == 0) {
-            Serial.println("Going to sleep");
-            batteryHandler.M5deepSleep();
-        }
-        else if (strcmp(action, "set_config") == 0) {
-            int userId = doc["user_id"];
-            int zoneId = doc["zone_id"];
-            
-            Serial.printf("Config updated: User=%d, Zone=%d\n", userId, zoneId);
-            
-            // Save in preferences
-            // settings->setUserId(userId);
-            // settings->setZoneId(zoneId);
-        }
-    });
+    commands->begin();  // subscribes to device/<id>/cmd
+}
+
+void updateCommandListener() {
+    commands->update();
+    if (restartAt && (long)(millis() - restartAt) >= 0) ESP.restart();
+    if (sleepAt && (long)(millis() - sleepAt) >= 0) batteryHandler.M5deepSleep();
 }
 
 // ═══════════════════════════════════════════════════════════
@@ -153,6 +169,8 @@ void setup() {
 
 void loop() {
     M5.update();
+    mqtt.update();  // replays what was published while offline
+    updateCommandListener();
     
     // Send data every 10s
     static unsigned long lastPublish = 0;
@@ -170,16 +188,19 @@ void loop() {
 // ═══════════════════════════════════════════════════════════
 
 void setupWithAutoReconnect() {
+    // Reconnects in the background: 1s, 2s, 4s ... up to 60s, with jitter.
+    // Never delay() in these callbacks, they run on the async TCP task.
     mqtt.setAutoReconnect(true);
+    mqtt.setReconnectBackoff(1000, 60000);
     
     mqtt.onDisconnect([]() {
-        Serial.println("⚠️ MQTT disconnected!");
-        
-        // wait 5s then reconnect
-        delay(5000);
-        if (WiFiHelper::isConnected()) {
-            mqtt.connect();
-        }
+        Serial.println("⚠️ MQTT disconnected, retrying in the background");
+    });
+
+    mqtt.onConnect([](bool sessionPresent) {
+        const ReconnectStats& s = mqtt.getReconnectStats();
+        Serial.printf("MQTT up, %u reconnects, last took %u ms\n",
+                      (unsigned)s.reconnects, (unsigned)s.lastReconnectMs);
     });
 }
 
@@ -201,4 +222,163 @@ void publishWithOptions() {
     mqtt.publishText("status/last_seen", "2025-01-01 12:34:56", 0, true);
 }
 
-#endif
\ No newline at end of file
+// ═══════════════════════════════════════════════════════════
+// EXEMPLE 8 : Publish while offline
+// ═══════════════════════════════════════════════════════════
+
+void publishWhileOffline() {
+    // Only the last value of each topic matters for a dashboard
+    mqtt.setOutboxPolicy(MQTT_OUTBOX_KEEP_LATEST_PER_TOPIC);
+
+    // Not connected yet: queued with its QoS/retain flags, returns 0
+    mqtt.publishText("status/battery", "86%", 1, false);
+
+    // Sent in order by mqtt.update() once the broker is back
+    MqttOutboxStats s = mqtt.getOutboxStats();
+    Serial.printf("Outbox: %u queued, oldest %ums, %u dropped\n",
+                  (unsigned)s.depth, (unsigned)s.oldestAgeMs, (unsigned)s.dropped);
+
+    // Before deep sleep (PSRAM is not retained), with -DMQTT_OUTBOX_SPILL
+    mqtt.persistOutbox();
+}
+
+// ═══════════════════════════════════════════════════════════
+// EXEMPLE 9 : Binary payloads
+// ═══════════════════════════════════════════════════════════
+
+void setupBinaryEncoding() {
+    // Everything under sensors/ as CBOR, status stays readable JSON.
+    // The receiving side only needs deserializePayload(), the payload carries
+    // a marker telling which encoding was used.
+    mqtt.setEncoding("sensors/#", PAYLOAD_CBOR);
+    mqtt.setEncoding("device/+/state", PAYLOAD_MSGPACK);
+}
+
+// ═══════════════════════════════════════════════════════════
+// EXEMPLE 10 : Batch sensor samples
+// ═══════════════════════════════════════════════════════════
+
+/*
+ITelemetry* telemetry = getM5StickTelemetry(&mqtt, rtcUtils, "sensors/batch", 60000);
+
+void sampleSensors() {
+    // Every call only appends to the batch, one message per minute is sent
+    telemetry->add("temp", 23.5);
+    telemetry->add("hum", 65.2);
+    telemetry->add("battery", batteryHandler->getLevel());
+}
+
+void loop() {
+    telemetry->update();  // age based flush
+    mqtt.update();
+}
+
+void beforeSleep() {
+    telemetry->flushBeforeSleep();
+    telemetry->printReport();
+}
+*/
+
+
+// ═══════════════════════════════════════════════════════════
+// EXEMPLE 11 : Non-blocking WiFi after a deep sleep wake
+// ═══════════════════════════════════════════════════════════
+
+/*
+void setup() {
+    // Reuses the channel, BSSID and IP lease of the last connection (kept in
+    // RTC memory) and falls back to a full scan + DHCP when that fails
+    WiFiHelper::connectAsync("VOTRE_SSID", "VOTRE_PASSWORD", [](bool connected, uint32_t ms) {
+        energyProfiler->setRadioOn(connected);  // radio time charged in the energy report
+        if (!connected) return;
+        Serial.printf("WiFi up in %u ms\n", (unsigned)ms);
+        mqtt.connect();
+    });
+}
+
+void loop() {
+    WiFiHelper::update();  // drives the attempt, calls the callback once
+    mqtt.update();
+}
+*/
+
+
+// ═══════════════════════════════════════════════════════════
+// EXEMPLE 12 : Several WiFi networks
+// ═══════════════════════════════════════════════════════════
+
+/*
+void setupNetworks() {
+    // Stored in NVS, only needed once (or from a settings page)
+    WiFiHelper::addNetwork("HOME_SSID", "HOME_PASSWORD");
+    WiFiHelper::addNetwork("OFFICE_SSID", "OFFICE_PASSWORD");
+}
+
+void setup() {
+    // Last network first without scanning, then the best ranked one in range
+    WiFiHelper::connectBest([](bool connected, uint32_t ms) {
+        if (connected) mqtt.connect();
+        WiFiHelper::printStats();
+    });
+}
+*/
+
+
+// ═══════════════════════════════════════════════════════════
+// EXEMPLE 13 : Duty-cycled uplink on battery
+// ═══════════════════════════════════════════════════════════
+
+/*
+IUplinkScheduler* uplink   = getM5StickUplink(&mqtt, batteryHandler, rtcUtils);
+ITimeSync*        timeSync = getM5StickTimeSync(rtcUtils);
+
+void setup() {
+    mqtt.begin("mqtt.example.com");
+
+    UplinkPolicy policy = { 900, 4096, 8000, 500 };  // 15 min, 4 KB queued, 8 s radio, 0.5 s linger
+    uplink->setPolicy(policy);
+    uplink->setTimeSync(timeSync);  // NTP when due while a window is open, drift steps in between
+    timeSync->setUtcOffset(3600);
+    timeSync->onRtcSet([]() { clockHandler->resyncTick(); });  // the second ticks follow the new edge
+    timeSync->begin();
+    uplink->begin();
+}
+
+void loop() {
+    uplink->update();  // also drives timeSync
+    telemetry->update();
+
+    if (!uplink->isWindowOpen()) {
+        telemetry->flushBeforeSleep();
+        batteryHandler->deepSleep((uint64_t)uplink->secondsUntilNextWindow() * 1000000ULL);
+    }
+}
+*/
+
+
+// ═══════════════════════════════════════════════════════════
+// EXEMPLE 14 : Metrics
+// ═══════════════════════════════════════════════════════════
+
+/*
+IMetricsExporter* metrics = getM5StickMetrics(&mqtt);
+
+static const uint32_t SAMPLE_BOUNDS[] = { 100, 500, 2000 };
+static MetricCounter   samplesTaken("samples_taken");
+static MetricHistogram sampleUs("sample_us", SAMPLE_BOUNDS, 3);
+
+void setup() {
+    metrics->begin();  // device/<id>/metrics every 60 s
+}
+
+void loop() {
+    uint32_t start = micros();
+    // ... read a sensor ...
+    samplesTaken.inc();
+    sampleUs.observe(micros() - start);
+
+    metrics->update();
+}
+*/
+
+#endif
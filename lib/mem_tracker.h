@@ -0,0 +1,195 @@
+#ifndef MEM_TRACKER_H
+#define MEM_TRACKER_H
+
+#include <Arduino.h>
+#include <new>
+#include <utility>
+#include <esp_heap_caps.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "core/mem_accounting.h"
+
+// Build flags:
+//   -DMEM_STATIC_POOLS          memNew() places objects in a static arena and
+//                               any allocation from the loop task after
+//                               memSealSetup() aborts with the caller address
+//   -DMEM_STATIC_POOL_BYTES=n   arena size
+//   -DMEM_TRACK_GLOBAL_NEW=0    leave the global operator new alone
+#ifndef MEM_STATIC_POOL_BYTES
+#define MEM_STATIC_POOL_BYTES  24576
+#endif
+#ifndef MEM_TRACK_GLOBAL_NEW
+#define MEM_TRACK_GLOBAL_NEW   1
+#endif
+#define MEM_MAX_WATCHED_TASKS  10
+#define MEM_BLOCK_HEADER       8      // size and tag, keeps blocks 8-byte aligned
+
+// Singleton: tagged allocations for the deps factories, heap fragmentation
+// and the stack high-water mark of each watched FreeRTOS task.
+class MemTracker {
+private:
+    static MemTracker     instance;
+    static MemAccounting  accounting;
+    static TaskHandle_t   sealedTask;
+#ifdef MEM_STATIC_POOLS
+    static uint64_t       poolBuffer[(MEM_STATIC_POOL_BYTES + 7) / 8];
+    static StaticArena    arena;
+#endif
+
+    struct WatchedTask {
+        const char*  name;
+        TaskHandle_t handle;
+    };
+    WatchedTask tasks[MEM_MAX_WATCHED_TASKS];
+    uint8_t     taskCount;
+
+    MemTracker() : taskCount(0) {}
+
+    struct BlockHeader {
+        uint32_t size;
+        uint8_t  tag;
+    };
+
+    static BlockHeader* header(void* p) { return (BlockHeader*)((uint8_t*)p - MEM_BLOCK_HEADER); }
+
+    static void fatal(const char* what, uint8_t tag, uintptr_t caller) {
+        Serial.printf("\n[mem] %s: tag %s, caller 0x%08x\n", what, memTagName(tag), (unsigned)caller);
+        Serial.flush();
+        abort();
+    }
+
+    static bool onLoopTask() { return sealedTask && xTaskGetCurrentTaskHandle() == sealedTask; }
+
+public:
+    static MemTracker* getInstance() { return &instance; }
+    static MemAccounting& stats() { return accounting; }
+
+    // Heap block with the header in front, accounted to tag. caller is only
+    // used to report allocations made after setup.
+    static void* heapAlloc(uint8_t tag, size_t n, uintptr_t caller) {
+        uint8_t* raw = (uint8_t*)malloc(n + MEM_BLOCK_HEADER);
+        if (!raw) return nullptr;
+        BlockHeader* h = (BlockHeader*)raw;
+        h->size = (uint32_t)n;
+        h->tag  = tag;
+        if (accounting.onAlloc(tag, (uint32_t)n, caller)) {
+#ifdef MEM_STATIC_POOLS
+            if (onLoopTask()) fatal("allocation after setup", tag, caller);
+#endif
+        }
+        return raw + MEM_BLOCK_HEADER;
+    }
+
+    static void heapFree(void* p) {
+        if (!p) return;
+#ifdef MEM_STATIC_POOLS
+        if (arena.contains(p)) {
+            accounting.onFree(header(p)->tag, header(p)->size);
+            return;  // arena space is never reused
+        }
+#endif
+        BlockHeader* h = header(p);
+        accounting.onFree(h->tag, h->size);
+        free(h);
+    }
+
+    // Objects made by the deps factories: the static arena with
+    // MEM_STATIC_POOLS, the heap otherwise
+    static void* allocate(uint8_t tag, size_t n, uintptr_t caller) {
+#ifdef MEM_STATIC_POOLS
+        if (accounting.sealed()) fatal("allocation after setup", tag, caller);
+        uint8_t* raw = (uint8_t*)arena.allocate(n + MEM_BLOCK_HEADER);
+        if (!raw) fatal("static pool exhausted, raise MEM_STATIC_POOL_BYTES", tag, caller);
+        BlockHeader* h = (BlockHeader*)raw;
+        h->size = (uint32_t)n;
+        h->tag  = tag;
+        accounting.onAlloc(tag, (uint32_t)n, caller);
+        return raw + MEM_BLOCK_HEADER;
+#else
+        return heapAlloc(tag, n, caller);
+#endif
+    }
+
+    static void release(void* p) { heapFree(p); }
+
+    // Last line of setup(): later allocations are counted (and fatal on the
+    // loop task with MEM_STATIC_POOLS)
+    void sealSetup() {
+        sealedTask = xTaskGetCurrentTaskHandle();
+        watchTask("loopTask", sealedTask);
+        accounting.seal();
+    }
+
+    // handle nullptr: looked up by name at report time
+    bool watchTask(const char* name, TaskHandle_t handle = nullptr) {
+        for (uint8_t i = 0; i < taskCount; i++) {
+            if (strcmp(tasks[i].name, name) == 0) {
+                if (handle) tasks[i].handle = handle;
+                return true;
+            }
+        }
+        if (taskCount >= MEM_MAX_WATCHED_TASKS) return false;
+        tasks[taskCount].name   = name;
+        tasks[taskCount].handle = handle;
+        taskCount++;
+        return true;
+    }
+
+    // Console: "mem" | "mem peaks" (restart the peaks from now)
+    void handleConsole(const char* args) {
+        if (strcmp(args, "peaks") == 0) accounting.resetPeaks();
+        printReport();
+    }
+
+    void printReport() {
+        size_t freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+        size_t largest   = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+        Serial.println("=== Memory ===");
+        Serial.printf("Heap: %u free, %u min free, largest block %u, fragmentation %u%%\n", (unsigned)freeBytes,
+                      (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT), (unsigned)largest,
+                      (unsigned)memFragmentationPct(freeBytes, largest));
+#ifdef MEM_STATIC_POOLS
+        Serial.printf("Static pool: %u / %u bytes\n", (unsigned)arena.used(), (unsigned)arena.capacity());
+#endif
+        char row[MEM_TAG_ROW_MAX];
+        for (uint8_t t = 0; t < MEM_TAG_COUNT; t++) {
+            if (!accounting.allocs(t)) continue;
+            memFormatTagRow(accounting, t, row, sizeof(row));
+            Serial.printf("  %s\n", row);
+        }
+        Serial.printf("Tracked live: %u bytes, after setup: %u allocations", (unsigned)accounting.totalLive(),
+                      (unsigned)accounting.lateAllocs());
+        if (accounting.lateCaller()) Serial.printf(" (last from 0x%08x)", (unsigned)accounting.lateCaller());
+        Serial.println();
+
+        Serial.println("Stack high-water (bytes left):");
+        for (uint8_t i = 0; i < taskCount; i++) {
+            TaskHandle_t h = tasks[i].handle ? tasks[i].handle : xTaskGetHandle(tasks[i].name);
+            if (!h) continue;
+            Serial.printf("  %-14s %6u\n", tasks[i].name, (unsigned)uxTaskGetStackHighWaterMark(h));
+        }
+        Serial.println("==============");
+    }
+};
+
+#define MEM_CALLER() ((uintptr_t)__builtin_return_address(0))
+
+// new T(args...) accounted to tag; free with memDelete()
+template <typename T, typename... Args>
+inline T* memNew(MemTag tag, Args&&... args) {
+    void* p = MemTracker::allocate(tag, sizeof(T), MEM_CALLER());
+    return new (p) T(std::forward<Args>(args)...);
+}
+
+template <typename T>
+inline void memDelete(T* p) {
+    if (!p) return;
+    p->~T();
+    MemTracker::release(p);
+}
+
+inline void memSealSetup() { MemTracker::getInstance()->sealSetup(); }
+
+// Static members and the global operator new/delete: src/mem_tracker.cpp
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef METRICS_BUILTIN_H
+#define METRICS_BUILTIN_H
+
+#include "core/metrics.h"
+
+// Built-in instrumentation, defined once in src/metrics.cpp: the registry
+// links every instance, a copy per translation unit would show each name
+// twice with split counts.
+namespace Metrics {
+
+extern MetricCounter   pageSwitches;
+extern MetricCounter   menuDraws;
+extern MetricHistogram menuDrawUs;
+extern MetricGauge     frameBudgetUs;   // current page, 0 when not rate-paced
+extern MetricCounter   framesLate;
+extern MetricCounter   framesDropped;   // rate frames skipped
+extern MetricHistogram stopwatchRenderUs;
+extern MetricCounter   nvsCommits;
+extern MetricCounter   batterySamples;
+extern MetricGauge     batteryLevel;
+extern MetricGauge     batteryMv;
+extern MetricCounter   mqttPublished;
+extern MetricCounter   mqttQueued;      // went to the outbox
+extern MetricCounter   mqttDropped;     // evicted from the outbox and lost
+extern MetricCounter   mqttEncodeErrors;
+extern MetricHistogram wifiConnectMs;
+extern MetricCounter   wifiFailures;
+extern MetricGauge     heapFree;        // refreshed at each export
+extern MetricGauge     heapMinFree;
+
+}
+
+#endif
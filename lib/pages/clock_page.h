@@ -4,24 +4,35 @@
 #include "page_base.h"
 #include "../ports/clock_handler_port.h"
 #include "../ports/battery_handler_port.h"
-#include "../ports/time_selector_port.h"
+#include "../ports/value_picker_port.h"
 #include "../ports/rtc_utils_port.h"
-#include "../dependancies/time_selector_deps.h"
+#include "../ports/energy_profiler_port.h"
+#include "../ports/pomodoro_port.h"
+#include "../dependancies/value_picker_deps.h"
 #include "../settings_manager.h"
 
+static constexpr PickerField SLEEP_DELAY_FIELDS[] = { pickInt("Seconds", 5, 120) };
+static constexpr PickerField DATE_TIME_FIELDS[]   = {
+    pickYear(), pickMonth(), pickDay(), pickHours(), pickMinutes(), pickSeconds()
+};
+static constexpr PickerField POMODORO_FIELDS[]    = {
+    pickInt("Work (min)", 1, 90), pickInt("Break (min)", 1, 30),
+    pickInt("Long break (min)", 1, 60), pickInt("Sessions / long", 1, 8)
+};
+
 class ClockPage : public PageBase {
 private:
-    IClockHandler* clockHandler;
-    IBatteryHandler* batteryHandler;
+    ClockHandlerT* clockHandler;
+    BatteryHandlerT* batteryHandler;
     
-    unsigned long lastClockUpdate;
-    uint32_t clockRefreshInterval;
-    
-    IMenuHandler*  settingsMenu;
-    ITimeSelector* timeSelector;
-    IRtcUtils*     rtcUtils;
+    MenuHandlerT*  settingsMenu;
+    ValuePickerT*  picker;
+    RtcUtilsT*     rtcUtils;
+    EnergyProfilerT* energyProfiler;
+    PomodoroT*     pomodoro;
     
     char soundLabel[32];
+    char brightnessLabel[32];
     char timeFormatLabel[32];
     char autoSleepLabel[32];
     char sleepDelayLabel[48];
@@ -30,6 +41,9 @@ private:
         sprintf(soundLabel, "UI Sound: %s", 
                 settings->getUiSound() ? "ON" : "OFF");
         
+        sprintf(brightnessLabel, "Brightness: %d%%",
+                (settings->getBrightness() * 100 + 127) / 255);
+        
         sprintf(timeFormatLabel, "Time: %s", 
                 settings->getTime24h() ? "24h" : "12h");
         
@@ -43,29 +57,53 @@ private:
     void rebuildMainMenu() {
         mainMenu->clear();
         
-        mainMenu->addItem("Start Pomodoro", [this]() { onStartPomodoro(); });
+        if (pomodoro && pomodoro->isActive()) {
+            mainMenu->addItem("Stop Pomodoro", [this]() { onStopPomodoro(); });
+        } else {
+            mainMenu->addItem("Start Pomodoro", [this]() { onStartPomodoro(); });
+        }
         mainMenu->addItem("Set Timer", [this]() { onSetTimer(); });
         mainMenu->addItem("Settings", [this]() { onSettings(); });
     }
     
     void rebuildSettingsMenu() {
-        if (!settingsMenu) {
-            settingsMenu = getM5StickMenuHandler(display, "Settings");
-        } else {
-            settingsMenu->clear();
-        }
-        
+        settingsMenu->clear();
+
         updateMenuLabels();
         
         settingsMenu->addItem(soundLabel, [this]() { onToggleSound(); });
+        settingsMenu->addItem(brightnessLabel, [this]() { onCycleBrightness(); });
         settingsMenu->addItem(timeFormatLabel, [this]() { onToggleTimeFormat(); });
         settingsMenu->addItem(autoSleepLabel, [this]() { onToggleAutoSleep(); });
         settingsMenu->addItem(sleepDelayLabel, [this]() { onConfigureSleepDelay(); });
+        settingsMenu->addItem("Pomodoro", [this]() { onConfigurePomodoro(); });
         settingsMenu->addItem("Set Time", [this]() { onSetTime(); });
     }
     
     void onStartPomodoro() {
-        clockHandler->armPomodoroAndSleep();
+        if (!pomodoro) return;
+        pomodoro->start();
+
+        char msg[32];
+        sprintf(msg, "Work %u min", pomodoro->getConfig().workMin);
+        display->showFullScreenMessage("Pomodoro", msg, MSG_SUCCESS, 1500);
+
+        if (energyProfiler) {
+            energyProfiler->beginSpan("pomodoro");
+            energyProfiler->notifySleep();
+        }
+        pomodoro->sleepUntilPhaseEnd();
+    }
+
+    void onStopPomodoro() {
+        if (!pomodoro) return;
+        pomodoro->stop();
+        if (energyProfiler) energyProfiler->endSpan("pomodoro");
+        display->showFullScreenMessage("Pomodoro", "Stopped", MSG_INFO, 800);
+
+        menuManager->closeAll();
+        rebuildMainMenu();
+        setup();
     }
     
     void onSetTimer() {
@@ -93,6 +131,23 @@ private:
         settingsMenu->draw();
     }
     
+    void onCycleBrightness() {
+        static const uint8_t steps[] = { 64, 128, 191, 255 };
+        uint8_t current = settings->getBrightness();
+        uint8_t next = steps[0];
+        for (size_t i = 0; i < sizeof(steps); i++) {
+            if (steps[i] > current) { next = steps[i]; break; }
+        }
+        settings->setBrightness(next);
+        
+        char msg[16];
+        sprintf(msg, "%d%%", (next * 100 + 127) / 255);
+        display->showFullScreenMessage("Brightness", msg, MSG_INFO, 800);
+        
+        rebuildSettingsMenu();
+        settingsMenu->draw();
+    }
+    
     void onToggleTimeFormat() {
         bool current = settings->getTime24h();
         settings->setTime24h(!current);
@@ -126,58 +181,96 @@ private:
     void onConfigureSleepDelay() {
         menuManager->closeAll();
         
-        uint16_t currentDelay = settings->getAutoSleepDelay();
-        timeSelector->configureSeconds(currentDelay, 5, 120);
+        int16_t currentDelay = settings->getAutoSleepDelay();
+        picker->setTitle("Sleep Delay");
+        picker->configure(SLEEP_DELAY_FIELDS, 1, &currentDelay);
         
-        timeSelector->setOnComplete([this](TimeValue result) {
-            settings->setAutoSleepDelay(result.seconds);
+        picker->setOnComplete([this](const ValuePickerModel& result) {
+            settings->setAutoSleepDelay(result.value(0));
             
             char msg[32];
-            sprintf(msg, "%d seconds", result.seconds);
+            sprintf(msg, "%d seconds", result.value(0));
             display->showFullScreenMessage("Sleep Delay", msg, MSG_SUCCESS, 1000);
             
             rebuildSettingsMenu();
             menuManager->pushMenu(settingsMenu);
         });
         
-        timeSelector->start();
+        picker->start();
     }
     
+    void onConfigurePomodoro() {
+        if (!pomodoro) return;
+        menuManager->closeAll();
+
+        const PomodoroConfig& config = pomodoro->getConfig();
+        int16_t current[4] = {
+            (int16_t)config.workMin, (int16_t)config.shortBreakMin,
+            (int16_t)config.longBreakMin, (int16_t)config.cycles
+        };
+        picker->setTitle("Pomodoro");
+        picker->configure(POMODORO_FIELDS, 4, current);
+
+        picker->setOnComplete([this](const ValuePickerModel& result) {
+            PomodoroConfig config = {
+                (uint16_t)result.value(0), (uint16_t)result.value(1),
+                (uint16_t)result.value(2), (uint8_t)result.value(3)
+            };
+            pomodoro->setConfig(config);
+
+            char msg[32];
+            sprintf(msg, "%u/%u/%u x%u", config.workMin, config.shortBreakMin,
+                    config.longBreakMin, config.cycles);
+            display->showFullScreenMessage("Pomodoro", msg, MSG_SUCCESS, 1000);
+
+            rebuildSettingsMenu();
+            menuManager->pushMenu(settingsMenu);
+        });
+
+        picker->start();
+    }
+
     void onSetTime() {
         menuManager->closeAll();
         
-        uint8_t currentHour   = rtcUtils->getHours();
-        uint8_t currentMinute = rtcUtils->getMinutes();
-        
-        timeSelector->configureHoursMinutes(currentHour, currentMinute);
+        int16_t now[6] = {
+            (int16_t)clockHandler->getYear(),  (int16_t)clockHandler->getMonth(),   (int16_t)clockHandler->getDay(),
+            (int16_t)clockHandler->getHours(), (int16_t)clockHandler->getMinutes(), (int16_t)clockHandler->getSeconds()
+        };
+        picker->setTitle("Set Date & Time");
+        picker->configure(DATE_TIME_FIELDS, 6, now);
         
-        timeSelector->setOnComplete([this](TimeValue result) {
-            // Udpate RTC with new time, keep seconds to 0 just to simplify
-            rtcUtils->setTime(result.hours, result.minutes, 0);
+        picker->setOnComplete([this](const ValuePickerModel& result) {
+            // Committed on the press that confirms the seconds, before any redraw
+            int year = result.value(0), month = result.value(1), day = result.value(2);
+            rtcUtils->setDateTime(result.value(3), result.value(4), result.value(5), year, month, day,
+                                  pickerWeekDay(year, month, day));
+            clockHandler->resyncTick();
             
             char msg[32];
-            sprintf(msg, "%02d:%02d", result.hours, result.minutes);
+            sprintf(msg, "%04d-%02d-%02d %02d:%02d:%02d", year, month, day,
+                    result.value(3), result.value(4), result.value(5));
             display->showFullScreenMessage("Time Set", msg, MSG_SUCCESS, 1000);
             
             rebuildSettingsMenu();
             menuManager->pushMenu(settingsMenu);
         });
         
-        timeSelector->start();
+        picker->start();
     }
     
-    // Callback overrides to handle TimeSelector
+    // Callback overrides to handle the picker
     void onButtonPWRPressed() override {
-        if (timeSelector->isActive()) {
-            timeSelector->navigateUp();
+        if (picker->isActive()) {
+            picker->navigateUp();
         } else if (hasActiveMenu()) {
             navigateMenuUp();
         }
     }
     
     void onButtonAPressed() override {
-        if (timeSelector->isActive()) {
-            timeSelector->select();
+        if (picker->isActive()) {
+            picker->select();
         } else if (hasActiveMenu()) {
             selectMenuItem();
         } else {
@@ -186,49 +279,44 @@ private:
     }
     
     void onButtonBShortPress() override {
-        if (timeSelector->isActive()) {
-            timeSelector->navigateDown();
+        if (picker->isActive()) {
+            picker->navigateDown();
         } else if (hasActiveMenu()) {
             navigateMenuDown();
         }
     }
     
 public:
-    ClockPage(IDisplayHandler* disp, IClockHandler* clock, IBatteryHandler* battery, IRtcUtils* rtc)
+    ClockPage(DisplayHandlerT* disp, ClockHandlerT* clock, BatteryHandlerT* battery, RtcUtilsT* rtc)
         : PageBase(disp, "Clock Menu"),
           clockHandler(clock),
           batteryHandler(battery),
           rtcUtils(rtc),
+          energyProfiler(nullptr),
+          pomodoro(nullptr),
           settingsMenu(nullptr) {
 
         settings = SettingsManager::getInstance();
 
-        lastClockUpdate = 0;
-        clockRefreshInterval = 1000;
-
-        timeSelector = getM5StickTimeSelector(display, "Set Time");
+        picker       = getM5StickValuePicker(display);
+        settingsMenu = getM5StickMenuHandler(display, "Settings");  // up front, nothing allocates after setup
         
         updateMenuLabels();
         rebuildMainMenu();
     }
     
     ~ClockPage() {
-        if (settingsMenu) {
-            delete settingsMenu;
-        }
-        if (timeSelector) {
-            delete timeSelector;
-        }
+        memDelete(settingsMenu);
+        memDelete(picker);
     }
     
     void setup() override {
         display->clearScreen();
         clockHandler->drawClock(0);
-        lastClockUpdate = millis();
     }
     
-    void loop() override {
-        if (timeSelector->isActive()) {
+    void loop(uint32_t dtUs) override {
+        if (picker->isActive()) {
             return;
         }
         
@@ -236,35 +324,37 @@ public:
             return;
         }
         
-        unsigned long now = millis();
-        if (now - lastClockUpdate >= clockRefreshInterval) {
-            uint32_t target = clockHandler->readTarget();
-            uint32_t remain = 0;
+        // On the RTC second edge, so the seconds digit changes with the RTC
+        if (clockHandler->secondTick()) {
+            // From the cycle in RTC memory, no NVS read per refresh
+            uint32_t remain = pomodoro ? pomodoro->getRemaining() : 0;
+            const char* label = pomodoroPhaseName(pomodoro ? pomodoro->getPhase() : POMO_IDLE);
             
-            if (target) {
-                uint32_t nowE = rtcUtils->epochNow();
-                if (nowE < target) {
-                    remain = target - nowE;
-                } else {
-                    clockHandler->clearTarget();
-                }
-            }
-            
-            clockHandler->drawClock(remain);
+            clockHandler->drawClock(remain, label);
             batteryHandler->displayInfo();
-            lastClockUpdate = now;
         }
     }
     
     void handleInput() override {
         handleBasicInputInteractions();
     }
+
+    // Next frame at the next second tick; menus and the picker are input driven
+    int64_t getNextFrameUs() override {
+        if (picker->isActive() || hasActiveMenu()) return 0;
+        return clockHandler->nextTickDueUs();
+    }
     
     const char* getName() override {
         return "Clock";
     }
     
-    IClockHandler* getClockHandler() { return clockHandler; }
+    ClockHandlerT* getClockHandler() { return clockHandler; }
+    void setEnergyProfiler(EnergyProfilerT* profiler) { energyProfiler = profiler; }
+    void setPomodoro(PomodoroT* p) {
+        pomodoro = p;
+        rebuildMainMenu();
+    }
 };
 
 #endif
\ No newline at end of file
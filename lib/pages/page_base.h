@@ -8,14 +8,16 @@
 #include "../dependancies/menu_handler_deps.h"
 #include "../dependancies/menu_manager_deps.h"
 #include "../settings_manager.h"
+#include "../core/frame_pacer.h"
 
 class PageBase {
 protected:
     bool initialized;
-    IDisplayHandler* display;
-    IMenuManager* menuManager;
-    IMenuHandler* mainMenu;
+    DisplayHandlerT* display;
+    MenuManagerT* menuManager;
+    MenuHandlerT* mainMenu;
     SettingsManager* settings;
+    const PageFrameStats* frameStats;   // kept by the page manager
     
     // Button B long press tracking
     unsigned long btnBPressStart;
@@ -59,11 +61,12 @@ protected:
     }
     
 public:
-    PageBase(IDisplayHandler* disp, const char* menuTitle = "Options") 
+    PageBase(DisplayHandlerT* disp, const char* menuTitle = "Options") 
         : initialized(false), display(disp) {
         menuManager = getM5StickMenuManager(disp);
         mainMenu = getM5StickMenuHandler(disp, menuTitle);
         settings = SettingsManager::getInstance();
+        frameStats = nullptr;
         btnBPressStart = 0;
         btnBLongPressTriggered = false;
         lastBtnBState = false;
@@ -71,12 +74,13 @@ public:
     }
     
     virtual ~PageBase() {
-        delete mainMenu;
-        delete menuManager;
+        memDelete(mainMenu);
+        memDelete(menuManager);
     }
     
     virtual void setup() = 0;
-    virtual void loop() = 0;
+    // dtUs: time covered by this frame, a fixed step for rate-paced pages
+    virtual void loop(uint32_t dtUs) = 0;
     
     virtual void cleanup() {
         if (menuManager) {
@@ -86,6 +90,17 @@ public:
     
     virtual const char* getName() = 0;
     
+    // Percentage of the user brightness this page wants (backlight governor)
+    virtual uint8_t getBacklightLevel() { return 100; }
+
+    // Frame pacing, read after each frame: loop() runs at this rate, or on
+    // every main loop pass for 0...
+    virtual uint16_t getTargetFps() { return 0; }
+    // ...or at this esp_timer time (us) for the next frame, when not 0
+    virtual int64_t getNextFrameUs() { return 0; }
+
+    void setFrameStats(const PageFrameStats* stats) { frameStats = stats; }
+    
     bool isInitialized() { return initialized; }
     void setInitialized(bool value) { initialized = value; }
 
@@ -181,9 +196,9 @@ public:
         }
     }
     
-    IMenuManager* getMenuManager() { return menuManager; }
-    IMenuHandler* getMainMenu() { return mainMenu; }
-    IDisplayHandler* getDisplay() { return display; }
+    MenuManagerT* getMenuManager() { return menuManager; }
+    MenuHandlerT* getMainMenu() { return mainMenu; }
+    DisplayHandlerT* getDisplay() { return display; }
 };
 
 #endif
\ No newline at end of file
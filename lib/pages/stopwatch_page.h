@@ -0,0 +1,245 @@
+#ifndef STOPWATCH_PAGE_H
+#define STOPWATCH_PAGE_H
+
+#include <esp_timer.h>
+#include "page_base.h"
+#include "../core/stopwatch.h"
+#include "../metrics.h"
+
+#define STOPWATCH_FPS  30
+
+// Button A: click starts, then takes a lap; hold stops (at the press, not
+// at the hold), hold again for the menu (resume, laps, reset, frame stats).
+// While running, the page asks for STOPWATCH_FPS frames per second and only
+// the characters that changed since the previous frame are drawn again.
+class StopwatchPage : public PageBase {
+private:
+    // A fixed-width text line redrawn character by character
+    struct DigitLine {
+        int     x, y, size;
+        MessageType type;
+        char    shown[STOPWATCH_TEXT_LEN + 1];
+
+        void invalidate() { memset(shown, 0xFF, STOPWATCH_TEXT_LEN); shown[STOPWATCH_TEXT_LEN] = '\0'; }
+
+        // Runs of changed characters, one overwrite each
+        void draw(DisplayHandlerT* display, const char* text) {
+            uint32_t mask = stopwatchChangedMask(shown, text, STOPWATCH_TEXT_LEN);
+            uint8_t i = 0;
+            while (mask >> i) {
+                if (!(mask & (1UL << i))) { i++; continue; }
+                uint8_t end = i;
+                while (end < STOPWATCH_TEXT_LEN && (mask & (1UL << end))) end++;
+                char run[STOPWATCH_TEXT_LEN + 1];
+                memcpy(run, text + i, end - i);
+                run[end - i] = '\0';
+                display->overwriteTextAt(run, x + i * display->charWidth(size), y, size, type);
+                i = end;
+            }
+            memcpy(shown, text, STOPWATCH_TEXT_LEN);
+        }
+    };
+
+    Stopwatch   stopwatch;
+    DigitLine   totalLine;
+    DigitLine   lapLine;
+    uint32_t    shownHours;
+    uint32_t    shownLaps;
+    uint32_t    maxRenderUs;
+    int64_t     pressUs;
+    bool        pressArmed;      // A went down with no menu open
+
+    MenuHandlerT* lapsMenu;
+    char startLabel[16];
+    char lapsLabel[16];
+    char lapLabels[STOPWATCH_MAX_LAPS][24];
+
+    void rebuildMainMenu() {
+        mainMenu->clear();
+        snprintf(startLabel, sizeof(startLabel), "%s", stopwatch.elapsedUs(0) ? "Resume" : "Start");
+        snprintf(lapsLabel, sizeof(lapsLabel), "Laps (%u)", (unsigned)stopwatch.laps().total());
+        mainMenu->addItem(startLabel, [this]() { onResume(); });
+        mainMenu->addItem(lapsLabel, [this]() { onLaps(); });
+        mainMenu->addItem("Reset", [this]() { onReset(); });
+        mainMenu->addItem("Frame stats", [this]() { onFrameStats(); });
+    }
+
+    void rebuildLapsMenu() {
+        lapsMenu->clear();
+        const StopwatchLaps& laps = stopwatch.laps();
+        for (uint8_t i = 0; i < laps.count(); i++) {
+            const StopwatchLap& lap = laps.get(i);
+            char split[STOPWATCH_TEXT_LEN + 1];
+            stopwatchFormat(lap.splitUs, split);
+            snprintf(lapLabels[i], sizeof(lapLabels[i]), "#%u %s", (unsigned)lap.number, split);
+            lapsMenu->addItem(lapLabels[i], [this, i]() { onLapDetail(i); });
+        }
+    }
+
+    void onResume() {
+        menuManager->closeAll();
+        stopwatch.start(esp_timer_get_time());
+        setup();
+    }
+
+    void onLaps() {
+        if (!stopwatch.laps().count()) {
+            display->showFullScreenMessage("Laps", "None yet", MSG_INFO, 800);
+            mainMenu->draw();
+            return;
+        }
+        rebuildLapsMenu();
+        menuManager->pushMenu(lapsMenu);
+    }
+
+    void onLapDetail(uint8_t i) {
+        const StopwatchLap& lap = stopwatch.laps().get(i);
+        char title[16], total[STOPWATCH_TEXT_LEN + 1], msg[24];
+        snprintf(title, sizeof(title), "Lap %u", (unsigned)lap.number);
+        stopwatchFormat(lap.totalUs, total);
+        snprintf(msg, sizeof(msg), "at %s", total);
+        display->showFullScreenMessage(title, msg, MSG_INFO, 1500);
+        lapsMenu->draw();
+    }
+
+    void onReset() {
+        stopwatch.reset();
+        menuManager->closeAll();
+        display->showFullScreenMessage("Stopwatch", "Reset", MSG_INFO, 600);
+        setup();
+    }
+
+    void onFrameStats() {
+        char msg[32];
+        snprintf(msg, sizeof(msg), "%lu drop, max %lums",
+                 (unsigned long)(frameStats ? frameStats->dropped : 0), (unsigned long)(maxRenderUs / 1000));
+        display->showFullScreenMessage("Frames", msg, MSG_INFO, 1500);
+        mainMenu->draw();
+    }
+
+    void onButtonAClick() {
+        if (!stopwatch.running()) {
+            stopwatch.start(pressUs);
+            setup();
+        } else if (stopwatch.lap(pressUs)) {
+            if (settings->getUiSound()) M5.Speaker.tone(3000, 30);
+        }
+    }
+
+    void onButtonAHold() {
+        if (stopwatch.running()) {
+            stopwatch.stop(pressUs);
+            setup();
+        } else {
+            rebuildMainMenu();
+            openMenu();
+        }
+    }
+
+    // The menu gets button A as usual, the stopwatch only presses made outside of it
+    void onButtonAPressed() override {
+        if (hasActiveMenu()) {
+            selectMenuItem();
+            return;
+        }
+        pressUs    = esp_timer_get_time();
+        pressArmed = true;
+    }
+
+    void drawStatic() {
+        display->clearScreen();
+        display->displayTextAt("Stopwatch", 10, 5, 1, MSG_INFO);
+        display->displayTextAt(stopwatch.running() ? "A: lap   hold A: stop" : "A: start   hold A: menu",
+                               10, 122, 1, MSG_NORMAL);
+        totalLine.invalidate();
+        lapLine.invalidate();
+        shownHours = 0xFFFFFFFF;
+        shownLaps  = 0xFFFFFFFF;
+    }
+
+    void drawFrame(int64_t nowUs) {
+        char text[STOPWATCH_TEXT_LEN + 1];
+        int64_t elapsed = stopwatch.elapsedUs(nowUs);
+
+        stopwatchFormat(elapsed, text);
+        totalLine.draw(display, text);
+
+        if (stopwatch.laps().total() != shownLaps) {
+            shownLaps = stopwatch.laps().total();
+            char label[12];
+            snprintf(label, sizeof(label), "Lap %-3u", (unsigned)(shownLaps + 1));
+            display->overwriteTextAt(label, lapLine.x - 8 * display->charWidth(2), lapLine.y, 2, MSG_NORMAL);
+        }
+        stopwatchFormat(stopwatch.currentLapUs(nowUs), text);
+        lapLine.draw(display, text);
+
+        uint32_t hours = stopwatchHours(elapsed);
+        if (hours != shownHours) {
+            shownHours = hours;
+            char label[8];
+            snprintf(label, sizeof(label), hours ? "+%luh" : "    ", (unsigned long)hours);
+            display->overwriteTextAt(label, 200, 5, 1, MSG_NORMAL);
+        }
+    }
+
+public:
+    StopwatchPage(DisplayHandlerT* disp)
+        : PageBase(disp, "Stopwatch"),
+          shownHours(0), shownLaps(0), maxRenderUs(0), pressUs(0), pressArmed(false) {
+        totalLine.x = 24;  totalLine.y = 40; totalLine.size = 4; totalLine.type = MSG_NORMAL;
+        lapLine.x   = 132; lapLine.y   = 90; lapLine.size   = 2; lapLine.type   = MSG_INFO;
+        totalLine.invalidate();
+        lapLine.invalidate();
+
+        lapsMenu = getM5StickMenuHandler(display, "Laps");  // up front, nothing allocates after setup
+        rebuildMainMenu();
+    }
+
+    ~StopwatchPage() {
+        memDelete(lapsMenu);
+    }
+
+    void setup() override {
+        drawStatic();
+        drawFrame(esp_timer_get_time());
+    }
+
+    // The time shown comes from esp_timer, not from the summed deltas
+    void loop(uint32_t dtUs) override {
+        if (hasActiveMenu() || !stopwatch.running()) return;
+
+        // Running counts as activity, deep sleep would lose the esp_timer base
+        settings->resetInactivityTimer();
+
+        int64_t now = esp_timer_get_time();
+        drawFrame(now);
+        uint32_t renderUs = (uint32_t)(esp_timer_get_time() - now);
+        if (renderUs > maxRenderUs) maxRenderUs = renderUs;
+        Metrics::stopwatchRenderUs.observe(renderUs);
+    }
+
+    // Stopped or in a menu, nothing moves: back to the default pacing
+    uint16_t getTargetFps() override {
+        return stopwatch.running() && !hasActiveMenu() ? STOPWATCH_FPS : 0;
+    }
+
+    void handleInput() override {
+        handleBasicInputInteractions();
+
+        // Timestamped on the press; a click or a hold only known later
+        if (!pressArmed || hasActiveMenu()) return;
+        if (M5.BtnA.wasHold()) {
+            pressArmed = false;
+            onButtonAHold();
+        } else if (M5.BtnA.wasClicked()) {
+            pressArmed = false;
+            onButtonAClick();
+        }
+    }
+
+    const char* getName() override {
+        return "Stopwatch";
+    }
+};
+
+#endif
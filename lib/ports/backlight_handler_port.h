@@ -0,0 +1,43 @@
+#ifndef BACKLIGHT_HANDLER_PORT_H
+#define BACKLIGHT_HANDLER_PORT_H
+
+#include <stdint.h>
+
+#define BACKLIGHT_ENERGY_BUCKETS 5
+
+struct BacklightEnergyBucket {
+    uint32_t activeMs;    // time spent with the backlight in this bucket
+    double   chargeMaMs;  // battery discharge integrated over that time (mA*ms)
+};
+
+class IBacklightHandler {
+public:
+    virtual ~IBacklightHandler() = default;
+
+    virtual void begin() = 0;
+    virtual void update() = 0;
+
+    // User brightness (0-255), persisted through SettingsManager
+    virtual void    setBrightness(uint8_t level) = 0;
+    virtual uint8_t getBrightness() = 0;
+
+    // Percentage of the user brightness wanted by the page in front
+    virtual void setPageLevel(uint8_t percent) = 0;
+
+    virtual uint8_t getCurrentLevel() = 0;
+    virtual bool    isDimmed() = 0;
+    virtual bool    isOn() = 0;
+
+    virtual const BacklightEnergyBucket* getEnergyBuckets() = 0;
+    virtual void printEnergyReport() = 0;
+};
+
+#ifdef STATIC_WIRING
+#include "../adapters/backlight_handler_m5stick_adapter.h"
+class BacklightHandlerM5StickAdapter;
+typedef BacklightHandlerM5StickAdapter BacklightHandlerT;
+#else
+typedef IBacklightHandler BacklightHandlerT;
+#endif
+
+#endif
@@ -11,6 +11,8 @@ public:
     virtual void update() = 0;
     virtual void displayInfo() = 0;
     virtual void deepSleep(uint64_t microseconds = 0) = 0;
+    // Between main loop passes, for as long as the pages allow
+    virtual void idle(uint32_t microseconds) = 0;
     virtual void cutAllNonCore() = 0;
 
     virtual int32_t getCurrent() = 0;
@@ -19,4 +21,12 @@ public:
     virtual bool    isCharging() = 0;
 };
 
+#ifdef STATIC_WIRING
+#include "../adapters/battery_handler_m5stick_adapter.h"
+class BatteryHandlerM5StickAdapter;
+typedef BatteryHandlerM5StickAdapter BatteryHandlerT;
+#else
+typedef IBatteryHandler BatteryHandlerT;
+#endif
+
 #endif
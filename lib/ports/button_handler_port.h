@@ -8,4 +8,12 @@ public:
     virtual void update() = 0;
 };
 
+#ifdef STATIC_WIRING
+#include "../adapters/button_handler_m5stick_adapter.h"
+class ButtonHandlerM5StickAdapter;
+typedef ButtonHandlerM5StickAdapter ButtonHandlerT;
+#else
+typedef IButtonHandler ButtonHandlerT;
+#endif
+
 #endif
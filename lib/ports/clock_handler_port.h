@@ -2,6 +2,7 @@
 #define CLOCK_HANDLER_PORT_H
 
 #include <stdint.h>
+#include "../core/second_ticker.h"
 
 class IClockHandler {
 public:
@@ -13,9 +14,20 @@ public:
     virtual const char* getCurrentFullDateUS() = 0;
     virtual const char* getCurrentFullDateISO() = 0;
 
-    virtual void drawClock(uint32_t remainSec = 0) = 0;
-    virtual void armPomodoroAndSleep() = 0;
+    // remainSec > 0 adds a "<label>: mm:ss" countdown line
+    virtual void drawClock(uint32_t remainSec = 0, const char* label = "Timer") = 0;
     virtual void armTimerAndSleep(uint32_t minutes) = 0;
+    // True once per RTC second, a few ms after the seconds change; poll it
+    // from the loop instead of a millis() interval
+    virtual bool secondTick() = 0;
+    // esp_timer time (us) secondTick() next has something to do, 0 when it
+    // needs polling from every loop pass
+    virtual int64_t nextTickDueUs() = 0;
+    // Call after writing the RTC: secondTick() looks for the new edge again
+    virtual void resyncTick() = 0;
+    virtual void printTickStats() = 0;
+    virtual void resetTickStats() = 0;
+
     virtual void writeTarget(uint32_t epoch) = 0;
     virtual uint32_t readTarget() = 0;
     virtual void clearTarget() = 0;
@@ -29,4 +41,12 @@ public:
     virtual int getWeekDay() = 0;
 };
 
+#ifdef STATIC_WIRING
+#include "../adapters/clock_handler_m5stick_adapter.h"
+class ClockHandlerM5StickAdapter;
+typedef ClockHandlerM5StickAdapter ClockHandlerT;
+#else
+typedef IClockHandler ClockHandlerT;
+#endif
+
 #endif
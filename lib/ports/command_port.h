@@ -0,0 +1,36 @@
+#ifndef COMMAND_PORT_H
+#define COMMAND_PORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "../core/command_table.h"
+
+class ICommandService {
+public:
+    virtual ~ICommandService() = default;
+
+    // Listens on <base>/cmd and replies on <base>/reply, base defaults to
+    // device/<id>. False if the table has duplicate names or is too large.
+    virtual bool begin(const char* topicBase = nullptr) = 0;
+
+    // Runs the queued commands and sends their replies. Call from loop(): the
+    // handlers run on the UI task, never on the MQTT one.
+    virtual void update() = 0;
+
+    // Same path for commands coming from elsewhere (serial, BLE...), from
+    // any task: submits are serialized with the MQTT one
+    virtual CommandStatus submit(const uint8_t* payload, size_t length) = 0;
+
+    virtual const CommandStats& getStats() = 0;
+    virtual void                printReport() = 0;
+};
+
+#ifdef STATIC_WIRING
+#include "../adapters/command_m5stick_adapter.h"
+class CommandM5StickAdapter;
+typedef CommandM5StickAdapter CommandServiceT;
+#else
+typedef ICommandService CommandServiceT;
+#endif
+
+#endif
@@ -34,6 +34,9 @@ public:
     virtual void displayStatus(const char* text, MessageType type = MSG_NORMAL) = 0;
     virtual void displayText(const char* text, DisplayZone zone, int textSize = 2, MessageType type = MSG_NORMAL) = 0;
     virtual void displayTextAt(const char* text, int x, int y, int textSize = 2, MessageType type = MSG_NORMAL) = 0;
+    // Like displayTextAt, on an opaque background: replaces what was there without a clear
+    virtual void overwriteTextAt(const char* text, int x, int y, int textSize = 2, MessageType type = MSG_NORMAL) = 0;
+    virtual int  charWidth(int textSize = 2) = 0;
     virtual void drawCenteredText(const char* text, int y, uint16_t color, int textSize = 2) = 0;
     virtual void displayBatteryLevel(int level, int color, bool isCharging = false) = 0;
     virtual void showLoading(const char* message = "Loading...") = 0;
@@ -42,4 +45,12 @@ public:
     virtual int getHeight() = 0;
 };
 
+#ifdef STATIC_WIRING
+#include "../adapters/display_handler_m5stick_adapter.h"
+class DisplayHandlerM5StickAdapter;
+typedef DisplayHandlerM5StickAdapter DisplayHandlerT;
+#else
+typedef IDisplayHandler DisplayHandlerT;
+#endif
+
 #endif
@@ -0,0 +1,38 @@
+#ifndef ENERGY_PROFILER_PORT_H
+#define ENERGY_PROFILER_PORT_H
+
+#include "../core/energy_accountant.h"
+
+class IEnergyProfiler {
+public:
+    virtual ~IEnergyProfiler() = default;
+
+    virtual void begin() = 0;
+    virtual void update() = 0;
+
+    // Named spans, e.g. a full pomodoro cycle including its deep sleep
+    virtual bool beginSpan(const char* name) = 0;
+    virtual void endSpan(const char* name) = 0;
+    virtual void pauseSpan(const char* name) = 0;
+    virtual void resumeSpan(const char* name) = 0;
+
+    // Call right before entering deep sleep
+    virtual void notifySleep() = 0;
+
+    // Radio state, from whatever brings Wi-Fi up and down
+    virtual void setRadioOn(bool on) = 0;
+
+    virtual void reset() = 0;
+    virtual void printReport() = 0;
+    virtual const EnergyAccountant& getAccountant() = 0;
+};
+
+#ifdef STATIC_WIRING
+#include "../adapters/energy_profiler_m5stick_adapter.h"
+class EnergyProfilerM5StickAdapter;
+typedef EnergyProfilerM5StickAdapter EnergyProfilerT;
+#else
+typedef IEnergyProfiler EnergyProfilerT;
+#endif
+
+#endif
@@ -25,4 +25,12 @@ public:
     virtual void resetSelection() = 0;
 };
 
+#ifdef STATIC_WIRING
+#include "../adapters/menu_handler_m5stick_adapter.h"
+class MenuHandlerM5StickAdapter;
+typedef MenuHandlerM5StickAdapter MenuHandlerT;
+#else
+typedef IMenuHandler MenuHandlerT;
+#endif
+
 #endif
@@ -18,4 +18,12 @@ public:
     virtual IMenuHandler* getCurrentMenu() = 0;
 };
 
+#ifdef STATIC_WIRING
+#include "../adapters/menu_manager_m5stick_adapter.h"
+class MenuManagerM5StickAdapter;
+typedef MenuManagerM5StickAdapter MenuManagerT;
+#else
+typedef IMenuManager MenuManagerT;
+#endif
+
 #endif
@@ -0,0 +1,32 @@
+#ifndef METRICS_PORT_H
+#define METRICS_PORT_H
+
+#include <stdint.h>
+#include "../core/metrics.h"
+
+class IMetricsExporter {
+public:
+    virtual ~IMetricsExporter() = default;
+
+    // Publishes every periodMs on topic (device/<id>/metrics by default),
+    // 0 disables the periodic publish
+    virtual void begin(const char* topic = nullptr, uint32_t periodMs = 60000) = 0;
+    virtual void update() = 0;
+
+    // One batched payload with every registered metric, 0 if not sent
+    virtual uint16_t publishNow() = 0;
+    virtual void     printTable() = 0;
+
+    // Counters and histograms back to zero
+    virtual void reset() = 0;
+};
+
+#ifdef STATIC_WIRING
+#include "../adapters/metrics_m5stick_adapter.h"
+class MetricsM5StickAdapter;
+typedef MetricsM5StickAdapter MetricsExporterT;
+#else
+typedef IMetricsExporter MetricsExporterT;
+#endif
+
+#endif
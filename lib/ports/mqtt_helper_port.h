@@ -5,6 +5,11 @@
 #include <functional>
 #include <ArduinoJson.h>
 #include <Arduino.h>
+#include "../core/mqtt_message.h"
+#include "../core/mqtt_topic_router.h"
+#include "../core/mqtt_outbox.h"
+#include "../core/payload_codec.h"
+#include "../core/backoff.h"
 
 class IMQTTHelper {
 public:
@@ -16,19 +21,48 @@ public:
     virtual void disconnect() = 0;
     virtual bool isConnected() = 0;
 
+    // Publishes made while offline are queued and replayed by update().
+    // publishJson encodes with the encoding set for the topic, receivers
+    // decode any of them with deserializePayload().
     virtual uint16_t publishText(const char* topic, const char* payload,
                                  uint8_t qos = 0, bool retain = false) = 0;
     virtual uint16_t publishJson(const char* topic, JsonDocument& doc,
                                  uint8_t qos = 0, bool retain = false) = 0;
+    virtual void            setEncoding(const char* topicFilter, PayloadEncoding encoding) = 0;
+    virtual PayloadEncoding getEncoding(const char* topic) = 0;
+
     virtual uint16_t subscribe(const char* topic, uint8_t qos = 0) = 0;
     virtual uint16_t unsubscribe(const char* topic) = 0;
 
+    // Routed subscription: the handler only receives messages matching the
+    // filter ("+" and "#" allowed). Kept across reconnects.
+    virtual bool subscribe(const char* topicFilter, MqttMessageHandler handler, uint8_t qos = 0) = 0;
+
     virtual void onConnect(std::function<void(bool)> callback) = 0;
-    virtual void onMessage(std::function<void(char*, char*, size_t)> callback) = 0;
+    virtual void onMessage(std::function<void(const MqttMessageView&)> callback) = 0;
     virtual void onDisconnect(std::function<void()> callback) = 0;
 
+    // Reconnects in the background after a loss, with exponential backoff
     virtual void   setAutoReconnect(bool enable) = 0;
-    virtual String getDeviceId() = 0;
+    virtual void   setReconnectBackoff(uint32_t baseMs, uint32_t capMs) = 0;
+    virtual const ReconnectStats& getReconnectStats() = 0;
+    virtual const char* getDeviceId() = 0;  // MAC address, "AA:BB:CC:DD:EE:FF"
+
+    virtual const MqttRxStats& getRxStats() = 0;
+    virtual uint32_t           getEncodeErrors() = 0;  // documents too large to publish or not encodable
+
+    virtual void            update() = 0;
+    virtual void            setOutboxPolicy(MqttOutboxPolicy policy) = 0;
+    virtual MqttOutboxStats getOutboxStats() = 0;
+    virtual void            persistOutbox() = 0;
 };
 
+#ifdef STATIC_WIRING
+#include "../adapters/mqtt_helper_m5stick_adapter.h"
+class MQTTHelperM5StickAdapter;
+typedef MQTTHelperM5StickAdapter MQTTHelperT;
+#else
+typedef IMQTTHelper MQTTHelperT;
+#endif
+
 #endif
@@ -12,13 +12,27 @@ public:
     virtual void goToPage(int index) = 0;
     virtual void nextPage() = 0;
     virtual void previousPage() = 0;
+    // Runs the current page's loop() when its next frame is due
     virtual void update() = 0;
     virtual void handleInput() = 0;
+    // How long the main loop may idle before the next frame or input poll
+    virtual uint32_t getIdleUs() = 0;
 
     virtual int getCurrentPageIndex() = 0;
     virtual int getPageCount() = 0;
     virtual PageBase* getCurrentPage() = 0;
     virtual const char* getCurrentPageName() = 0;
+
+    virtual void printFrameStats() = 0;
+    virtual void resetFrameStats() = 0;
 };
 
+#ifdef STATIC_WIRING
+#include "../adapters/page_manager_m5stick_adapter.h"
+class PageManagerM5StickAdapter;
+typedef PageManagerM5StickAdapter PageManagerT;
+#else
+typedef IPageManager PageManagerT;
+#endif
+
 #endif
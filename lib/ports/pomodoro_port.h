@@ -0,0 +1,43 @@
+#ifndef POMODORO_PORT_H
+#define POMODORO_PORT_H
+
+#include <stdint.h>
+#include "../core/pomodoro.h"
+
+class IPomodoro {
+public:
+    virtual ~IPomodoro() = default;
+
+    // Restores the cycle kept over deep sleep and catches up ended phases
+    virtual void begin() = 0;
+    // Returns the number of phases that ended since the last call
+    virtual uint16_t update() = 0;
+
+    virtual void start() = 0;
+    virtual void stop() = 0;
+    virtual bool isActive() = 0;
+    virtual uint8_t getPhase() = 0;
+    virtual uint32_t getRemaining() = 0;
+    virtual const PomodoroCycle& getCycle() = 0;
+
+    virtual void setConfig(const PomodoroConfig& config) = 0;
+    virtual const PomodoroConfig& getConfig() = 0;
+
+    // Deep sleep with the wake-up timer on the end of the current phase
+    virtual void sleepUntilPhaseEnd() = 0;
+    // Same with the time already read, works without begin() (alarm-only wakes)
+    virtual void sleepUntilPhaseEnd(uint32_t now) = 0;
+
+    virtual void flushStats() = 0;
+    virtual void printStats() = 0;
+};
+
+#ifdef STATIC_WIRING
+#include "../adapters/pomodoro_m5stick_adapter.h"
+class PomodoroM5StickAdapter;
+typedef PomodoroM5StickAdapter PomodoroT;
+#else
+typedef IPomodoro PomodoroT;
+#endif
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef POWER_HISTORY_PORT_H
+#define POWER_HISTORY_PORT_H
+
+#include <stdint.h>
+#include "../core/power_history_codec.h"
+
+class IPowerHistory {
+public:
+    virtual ~IPowerHistory() = default;
+
+    virtual void begin() = 0;
+    virtual void update() = 0;
+    virtual void recordEvent(uint8_t event, uint8_t arg = 0) = 0;
+    // Time given by the caller, works without begin() (alarm-only wakes)
+    virtual void recordEventAt(uint32_t epoch, uint8_t event, uint8_t arg = 0) = 0;
+    virtual void clear() = 0;
+
+    virtual void exportCsv() = 0;
+    virtual void exportBinary() = 0;
+
+    virtual uint32_t getStoredPages() = 0;
+    virtual uint32_t getCapacityPages() = 0;
+};
+
+#ifdef STATIC_WIRING
+#include "../adapters/power_history_m5stick_adapter.h"
+class PowerHistoryM5StickAdapter;
+typedef PowerHistoryM5StickAdapter PowerHistoryT;
+#else
+typedef IPowerHistory PowerHistoryT;
+#endif
+
+#endif
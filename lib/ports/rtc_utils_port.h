@@ -16,4 +16,12 @@ public:
                                  int year, int month, int day, int weekDay = 0) = 0;
 };
 
+#ifdef STATIC_WIRING
+#include "../adapters/rtc_utils_m5stick_adapter.h"
+class RtcUtilsM5StickAdapter;
+typedef RtcUtilsM5StickAdapter RtcUtilsT;
+#else
+typedef IRtcUtils RtcUtilsT;
+#endif
+
 #endif
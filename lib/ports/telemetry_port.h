@@ -0,0 +1,31 @@
+#ifndef TELEMETRY_PORT_H
+#define TELEMETRY_PORT_H
+
+#include <stdint.h>
+#include "../core/telemetry_batch.h"
+
+class ITelemetry {
+public:
+    virtual ~ITelemetry() = default;
+
+    virtual void begin() = 0;
+    virtual void update() = 0;
+
+    // Queues a reading in the current batch, published on the next flush
+    virtual bool add(const char* key, float value) = 0;
+    virtual bool flush() = 0;
+    virtual void flushBeforeSleep() = 0;
+
+    virtual TelemetryStats getStats() = 0;
+    virtual void           printReport() = 0;
+};
+
+#ifdef STATIC_WIRING
+#include "../adapters/telemetry_m5stick_adapter.h"
+class TelemetryM5StickAdapter;
+typedef TelemetryM5StickAdapter TelemetryT;
+#else
+typedef ITelemetry TelemetryT;
+#endif
+
+#endif
@@ -33,4 +33,12 @@ public:
     virtual void draw() = 0;
 };
 
+#ifdef STATIC_WIRING
+#include "../adapters/time_selector_m5stick_adapter.h"
+class TimeSelectorM5StickAdapter;
+typedef TimeSelectorM5StickAdapter TimeSelectorT;
+#else
+typedef ITimeSelector TimeSelectorT;
+#endif
+
 #endif
@@ -0,0 +1,50 @@
+#ifndef TIME_SYNC_PORT_H
+#define TIME_SYNC_PORT_H
+
+#include <stdint.h>
+#include <functional>
+#include "../core/rtc_drift.h"
+
+struct TimeSyncStats {
+    uint32_t syncs;
+    uint32_t failures;
+    uint32_t corrections;    // drift steps applied between syncs
+    int32_t  lastOffsetMs;   // true - RTC at the last sync
+    uint32_t lastDelayMs;    // round trip of the best sample
+    uint32_t lastSyncEpoch;  // UTC
+    uint32_t nextSyncEpoch;
+};
+
+class ITimeSync {
+public:
+    virtual ~ITimeSync() = default;
+
+    virtual void begin() = 0;
+    // Syncs when due and Wi-Fi is up, applies drift steps in between
+    virtual void update() = 0;
+
+    virtual void setServer(const char* host, uint16_t port = 123) = 0;
+    virtual void setUtcOffset(int32_t seconds) = 0;  // the RTC holds local time
+    virtual void setMaxErrorMs(uint32_t ms) = 0;     // drives the resync interval
+
+    // Called right after each RTC write (sync or drift step)
+    virtual void onRtcSet(std::function<void()> callback) = 0;
+
+    virtual void requestSync() = 0;
+    virtual bool isSyncDue() = 0;
+    virtual bool isSyncing() = 0;
+
+    virtual const TimeSyncStats&     getStats() = 0;
+    virtual const RtcDriftEstimator& getDrift() = 0;
+    virtual void                     printReport() = 0;
+};
+
+#ifdef STATIC_WIRING
+#include "../adapters/time_sync_m5stick_adapter.h"
+class TimeSyncM5StickAdapter;
+typedef TimeSyncM5StickAdapter TimeSyncT;
+#else
+typedef ITimeSync TimeSyncT;
+#endif
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef UPLINK_PORT_H
+#define UPLINK_PORT_H
+
+#include <stdint.h>
+#include <functional>
+#include "../core/uplink_window.h"
+#include "time_sync_port.h"
+
+class IUplinkScheduler {
+public:
+    virtual ~IUplinkScheduler() = default;
+
+    virtual void begin() = 0;
+    // Opens a window when one is due and drives the open one, call from loop()
+    virtual void update() = 0;
+
+    virtual void setPolicy(const UplinkPolicy& policy) = 0;
+    virtual void openWindow() = 0;  // manual trigger
+    virtual bool isWindowOpen() = 0;
+
+    // Optional: windows also sync the RTC when a sync is due and stay open
+    // (within budget) until it is done. update() then drives the time sync,
+    // do not call its update() as well.
+    virtual void setTimeSync(ITimeSync* timeSync) = 0;
+
+    // For the deep sleep timer: seconds until the next cadence window
+    virtual uint32_t secondsUntilNextWindow() = 0;
+
+    virtual void onWindowClosed(std::function<void(const UplinkWindowRecord&)> callback) = 0;
+    virtual const UplinkWindowRecord& getLastWindow() = 0;
+    virtual const UplinkStats&        getStats() = 0;
+    virtual void                      printReport() = 0;
+};
+
+#ifdef STATIC_WIRING
+#include "../adapters/uplink_m5stick_adapter.h"
+class UplinkM5StickAdapter;
+typedef UplinkM5StickAdapter UplinkSchedulerT;
+#else
+typedef IUplinkScheduler UplinkSchedulerT;
+#endif
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef VALUE_PICKER_PORT_H
+#define VALUE_PICKER_PORT_H
+
+#include <stdint.h>
+#include <functional>
+#include "../core/value_picker.h"
+
+class IValuePicker {
+public:
+    virtual ~IValuePicker() = default;
+
+    // fields must outlive the picker (a static table); false if too many
+    virtual bool configure(const PickerField* fields, uint8_t count, const int16_t* initial = nullptr) = 0;
+    virtual void setTitle(const char* title) = 0;
+
+    // Called from select() on the last field, before anything is redrawn
+    virtual void setOnComplete(std::function<void(const ValuePickerModel&)> callback) = 0;
+
+    virtual void start() = 0;
+    virtual void stop() = 0;
+    virtual bool isActive() = 0;
+
+    virtual void navigateUp() = 0;
+    virtual void navigateDown() = 0;
+    virtual void select() = 0;
+    virtual void draw() = 0;
+
+    virtual const ValuePickerModel& getModel() = 0;
+};
+
+#ifdef STATIC_WIRING
+#include "../adapters/value_picker_m5stick_adapter.h"
+class ValuePickerM5StickAdapter;
+typedef ValuePickerM5StickAdapter ValuePickerT;
+#else
+typedef IValuePicker ValuePickerT;
+#endif
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+#include <Arduino.h>
+#include <functional>
+
+#define MAX_CONSOLE_COMMANDS 16
+#define CONSOLE_LINE_MAX     64
+
+// Singleton line-based command console on Serial.
+// Subsystems register a command word, the rest of the line is passed as args.
+// update() never blocks: it only consumes what is already in the UART buffer.
+class SerialConsole {
+private:
+    static SerialConsole* instance;
+
+    struct Command {
+        const char* name;
+        const char* help;
+        std::function<void(const char*)> handler;
+    };
+
+    Command commands[MAX_CONSOLE_COMMANDS];
+    int     commandCount;
+    char    line[CONSOLE_LINE_MAX];
+    size_t  lineLength;
+
+    SerialConsole() : commandCount(0), lineLength(0) {
+        // Private constructor (singleton)
+    }
+
+    void execute(char* input) {
+        char* args = strchr(input, ' ');
+        if (args) {
+            *args++ = '\0';
+            while (*args == ' ') args++;
+        } else {
+            args = input + strlen(input);
+        }
+
+        if (strcmp(input, "help") == 0) {
+            printHelp();
+            return;
+        }
+
+        for (int i = 0; i < commandCount; i++) {
+            if (strcmp(commands[i].name, input) == 0) {
+                commands[i].handler(args);
+                return;
+            }
+        }
+        Serial.printf("Unknown command '%s', try 'help'\n", input);
+    }
+
+public:
+    static SerialConsole* getInstance() {
+        if (instance == nullptr) {
+            instance = new SerialConsole();
+        }
+        return instance;
+    }
+
+    bool registerCommand(const char* name, const char* help, std::function<void(const char*)> handler) {
+        if (commandCount >= MAX_CONSOLE_COMMANDS) return false;
+        commands[commandCount].name    = name;
+        commands[commandCount].help    = help;
+        commands[commandCount].handler = handler;
+        commandCount++;
+        return true;
+    }
+
+    void update() {
+        while (Serial.available() > 0) {
+            char c = (char)Serial.read();
+            if (c == '\r') continue;
+            if (c == '\n') {
+                line[lineLength] = '\0';
+                if (lineLength > 0) execute(line);
+                lineLength = 0;
+            } else if (lineLength < CONSOLE_LINE_MAX - 1) {
+                line[lineLength++] = c;
+            }
+        }
+    }
+
+    void printHelp() {
+        Serial.println("=== Console commands ===");
+        for (int i = 0; i < commandCount; i++) {
+            Serial.printf("%-10s %s\n", commands[i].name, commands[i].help);
+        }
+        Serial.println("========================");
+    }
+};
+
+// Initialize static instance
+SerialConsole* SerialConsole::instance = nullptr;
+
+#endif
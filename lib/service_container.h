@@ -0,0 +1,40 @@
+#ifndef SERVICE_CONTAINER_H
+#define SERVICE_CONTAINER_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "core/service_graph.h"
+
+// Singleton service graph of the app, timed with esp_timer (from app
+// start, like the boot latencies). Type `services` in the serial monitor
+// for the timeline of this boot.
+class ServiceContainer : public ServiceGraph {
+private:
+    static ServiceContainer instance;
+
+    static uint32_t clockUs() { return (uint32_t)esp_timer_get_time(); }
+
+    ServiceContainer() : ServiceGraph(clockUs) {}
+
+public:
+    static ServiceContainer* getInstance() { return &instance; }
+
+    void printTimeline() {
+        char line[64];
+        Serial.printf("boot timeline, ms since app start, first frame at %.1f\n", firstFrameUs() / 1000.0);
+        Serial.println("   start     took  service        trigger");
+        for (uint8_t i = 0; i < timelineCount(); i++) {
+            formatTimelineRow(i, line, sizeof(line));
+            Serial.println(line);
+        }
+        for (uint8_t id = 0; id < SERVICE_MAX; id++) {
+            if (state(id) == SERVICE_IDLE)   Serial.printf("          not started  %s\n", name(id));
+            if (state(id) == SERVICE_FAILED) Serial.printf("          FAILED       %s (dependency cycle or missing)\n", name(id));
+        }
+    }
+};
+
+// Initialize static members
+ServiceContainer ServiceContainer::instance;
+
+#endif
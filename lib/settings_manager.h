@@ -3,6 +3,7 @@
 
 #include <Preferences.h>
 #include <Arduino.h>
+#include "metrics.h"
 
 // Singleton with cache for settings since prefs reading is slow and power consuming
 class SettingsManager {
@@ -40,6 +41,7 @@ public:
         
         // Load UI settings
         cache.uiSound = prefs.getBool("ui_sound", true);
+        cache.brightness = prefs.getUChar("brightness", 128);
         
         // Load time settings (not used yet)
         cache.time24h = prefs.getBool("time_24h", true);
@@ -54,6 +56,7 @@ public:
     // GETTERS (just read the cache)
     
     bool getUiSound() { return cache.uiSound; }
+    uint8_t getBrightness() { return cache.brightness; }
     bool getTime24h() { return cache.time24h; }
     bool getAutoSleep() { return cache.autoSleep; }
     uint16_t getAutoSleepDelay() { return cache.autoSleepDelay; }
@@ -64,6 +67,15 @@ public:
         prefs.begin("settings", false);
         prefs.putBool("ui_sound", value);
         prefs.end();
+        Metrics::nvsCommits.inc();
+    }
+    
+    void setBrightness(uint8_t value) {
+        cache.brightness = value;
+        prefs.begin("settings", false);
+        prefs.putUChar("brightness", value);
+        prefs.end();
+        Metrics::nvsCommits.inc();
     }
     
     void setTime24h(bool value) {
@@ -71,6 +83,7 @@ public:
         prefs.begin("settings", false);
         prefs.putBool("time_24h", value);
         prefs.end();
+        Metrics::nvsCommits.inc();
     }
     
     void setAutoSleep(bool value) {
@@ -78,6 +91,7 @@ public:
         prefs.begin("settings", false);
         prefs.putBool("auto_sleep", value);
         prefs.end();
+        Metrics::nvsCommits.inc();
     }
     
     void setAutoSleepDelay(uint16_t seconds) {
@@ -85,6 +99,7 @@ public:
         prefs.begin("settings", false);
         prefs.putUShort("sleep_delay", seconds);
         prefs.end();
+        Metrics::nvsCommits.inc();
     }
     
     // Reset to defaults
@@ -92,6 +107,7 @@ public:
         prefs.begin("settings", false);
         prefs.clear();
         prefs.end();
+        Metrics::nvsCommits.inc();
         
         // Reload defaults
         begin();
@@ -102,6 +118,10 @@ public:
         timeForAutoDeepSleep = millis() + (cache.autoSleepDelay * 1000UL);
     }
 
+    unsigned long getInactiveMs() {
+        return millis() - lastActionTime;
+    }
+
     bool shouldGoToSleep() {
         if (!cache.autoSleep) {
             return false;
@@ -121,6 +141,7 @@ public:
     void printAll() {
         Serial.println("=== Current Settings ===");
         Serial.printf("UI Sound: %s\n", cache.uiSound ? "ON" : "OFF");
+        Serial.printf("Brightness: %d\n", cache.brightness);
         Serial.printf("Time Format: %s\n", cache.time24h ? "24h" : "12h");
         Serial.printf("Auto Sleep: %s\n", cache.autoSleep ? "ON" : "OFF");
         Serial.printf("Sleep Delay: %d s\n", cache.autoSleepDelay);
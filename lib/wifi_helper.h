@@ -3,6 +3,12 @@
 
 #include <WiFi.h>
 #include <Arduino.h>
+#include <esp_attr.h>
+#include <functional>
+#include "wifi_profiles.h"
+#include "core/wifi_ranking.h"
+#include "deferred_log.h"
+#include "metrics.h"
 
 // Structure pour les credentials
 struct WifiCredentials {
@@ -10,52 +16,459 @@ struct WifiCredentials {
     const char* password;
 };
 
+#define WIFI_RTC_MAGIC            0x57494643
+#define WIFI_FAST_TIMEOUT_MS      1500   // cached attempt, then full scan + DHCP
+#define WIFI_CACHE_MAX_REUSE      50     // full DHCP connect now and then to renew the lease
+#define WIFI_SCAN_CACHE_MS        30000  // scan results reused by connectBest()
+#define WIFI_SCAN_MS_PER_CHANNEL  120    // active scan dwell time
+
+// Last good connection, kept in RTC slow memory so a deep sleep wake can
+// join the same AP on the same channel with the same IP config: no scan, no DHCP
+struct WifiRtcCache {
+    uint32_t magic;
+    uint32_t ssidHash;
+    uint8_t  bssid[6];
+    uint8_t  channel;
+    uint8_t  reuse;
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t mask;
+    uint32_t dns1;
+    uint32_t dns2;
+};
+
+RTC_DATA_ATTR static WifiRtcCache wifiRtcCache;
+
+struct WifiConnectStats {
+    uint32_t attempts;
+    uint32_t fastConnects;    // connected with the cached config
+    uint32_t fastFallbacks;   // cached config failed, fell back to a full connect
+    uint32_t fullConnects;
+    uint32_t failures;
+    uint32_t lastMs;          // connectAsync() -> connected
+    uint32_t bestMs;
+    uint32_t totalMs;
+    uint32_t scans;
+    uint32_t lastScanMs;
+    bool     lastWasFast;
+
+    uint32_t averageMs() const {
+        uint32_t ok = fastConnects + fullConnects;
+        return ok ? totalMs / ok : 0;
+    }
+};
+
+// Called once the attempt is over, from WiFiHelper::update()
+typedef std::function<void(bool connected, uint32_t elapsedMs)> WifiConnectCallback;
+
 class WiFiHelper {
 private:
     static const unsigned long CONNECTION_TIMEOUT = 10000; // 10 secondes
-    
+
+    enum Phase { PHASE_IDLE, PHASE_SCAN, PHASE_FAST, PHASE_FULL };
+
+    struct State {
+        Phase               phase;
+        char                ssid[33];
+        char                password[65];
+        int8_t              profile;      // store index of the network being tried, -1 if unknown
+        uint8_t             hintChannel;  // from the scan, 0 = let the driver scan
+        uint8_t             hintBssid[6];
+        unsigned long       start;
+        unsigned long       attemptStart;
+        unsigned long       phaseStart;
+        WifiConnectCallback callback;
+        WifiConnectStats    stats;
+        bool                eventsHooked;
+        volatile bool       linkFailed;  // set from the WiFi event task
+
+        // connectBest(): ranked candidates from the last scan
+        bool                multi;
+        bool                scanned;
+        int8_t              skipProfile;  // already tried from the RTC cache
+        uint8_t             tryIndex;
+        bool                scanning;
+        bool                scanValid;
+        unsigned long       scanStart;
+        unsigned long       scanAt;
+        uint8_t             candidateCount;
+        WifiCandidate       candidates[WIFI_MAX_PROFILES];
+    };
+
+    static State& state() {
+        static State s;
+        return s;
+    }
+
+    static uint32_t hashSsid(const char* ssid) {
+        uint32_t h = 2166136261UL;
+        while (*ssid) { h ^= (uint8_t)*ssid++; h *= 16777619UL; }
+        return h;
+    }
+
+    static bool cacheValidFor(const char* ssid) {
+        return wifiRtcCache.magic == WIFI_RTC_MAGIC && wifiRtcCache.ssidHash == hashSsid(ssid) &&
+               wifiRtcCache.ip != 0 && wifiRtcCache.reuse < WIFI_CACHE_MAX_REUSE;
+    }
+
+    static bool scanFresh() {
+        State& s = state();
+        return s.scanValid && millis() - s.scanAt < WIFI_SCAN_CACHE_MS;
+    }
+
+    static void hookEvents() {
+        State& s = state();
+        if (s.eventsHooked) return;
+        s.eventsHooked = true;
+        WiFi.onEvent([](arduino_event_id_t event, arduino_event_info_t info) {
+            // Wrong channel/BSSID shows up as a disconnect: give up on the fast path early
+            if (state().phase == PHASE_FAST) state().linkFailed = true;
+        }, ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+    }
+
+    static void startFast() {
+        State& s = state();
+        s.phase      = PHASE_FAST;
+        s.phaseStart = millis();
+        s.linkFailed = false;
+        WiFi.config(IPAddress(wifiRtcCache.ip), IPAddress(wifiRtcCache.gateway), IPAddress(wifiRtcCache.mask),
+                    IPAddress(wifiRtcCache.dns1), IPAddress(wifiRtcCache.dns2));
+        WiFi.begin(s.ssid, s.password, wifiRtcCache.channel, wifiRtcCache.bssid);
+    }
+
+    static void startFull() {
+        State& s = state();
+        if (s.phase == PHASE_FAST) WiFi.disconnect();
+        s.phase      = PHASE_FULL;
+        s.phaseStart = millis();
+        WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);  // back to DHCP
+        if (s.hintChannel) WiFi.begin(s.ssid, s.password, s.hintChannel, s.hintBssid);
+        else               WiFi.begin(s.ssid, s.password);
+    }
+
+    static void beginAttempt(int8_t profile, const char* ssid, const char* password, uint8_t channel,
+                             const uint8_t* bssid) {
+        State& s = state();
+        strncpy(s.ssid, ssid, sizeof(s.ssid) - 1);
+        s.ssid[sizeof(s.ssid) - 1] = '\0';
+        strncpy(s.password, password ? password : "", sizeof(s.password) - 1);
+        s.password[sizeof(s.password) - 1] = '\0';
+        s.profile      = profile;
+        s.hintChannel  = bssid ? channel : 0;
+        if (bssid) memcpy(s.hintBssid, bssid, sizeof(s.hintBssid));
+        s.attemptStart = millis();
+        s.phase        = PHASE_IDLE;
+
+        WiFi.persistent(false);  // no NVS write on every begin()
+        WiFi.mode(WIFI_STA);
+        if (cacheValidFor(s.ssid)) startFast();
+        else                       startFull();
+    }
+
+    static bool startScan() {
+        State& s = state();
+        if (s.scanning) return true;
+        WiFi.mode(WIFI_STA);
+        int16_t r = WiFi.scanNetworks(true, false, false, WIFI_SCAN_MS_PER_CHANNEL);
+        s.scanning  = r != WIFI_SCAN_FAILED;
+        s.scanStart = millis();
+        return s.scanning;
+    }
+
+    static void pollScan() {
+        State& s = state();
+        if (!s.scanning) return;
+        int16_t n = WiFi.scanComplete();
+        if (n == WIFI_SCAN_RUNNING) return;
+        s.scanning = false;
+
+        WifiProfileStore* store = WifiProfileStore::getInstance();
+        store->begin();
+        size_t count = 0;
+        for (int16_t i = 0; i < n; i++) {
+            int p = store->find(WiFi.SSID(i).c_str());
+            if (p < 0) continue;
+            count = wifiAddCandidate(s.candidates, count, WIFI_MAX_PROFILES, (uint8_t)p, WiFi.RSSI(i),
+                                     (uint8_t)WiFi.channel(i), WiFi.BSSID(i));
+        }
+        WiFi.scanDelete();
+        s.candidateCount   = (uint8_t)count;
+        s.scanValid        = n >= 0;
+        s.scanAt           = millis();
+        s.stats.scans++;
+        s.stats.lastScanMs = s.scanAt - s.scanStart;
+        DLOG_D(WIFI, WIFI_SCAN_DONE, (int)n, (unsigned)s.stats.lastScanMs);
+
+        if (s.phase == PHASE_SCAN) {
+            s.phase = PHASE_IDLE;
+            wifiRankCandidates(s.candidates, s.candidateCount, store->stats());
+            if (!tryCandidate()) complete(false);
+        }
+    }
+
+    static bool tryCandidate() {
+        State& s = state();
+        while (s.tryIndex < s.candidateCount && s.candidates[s.tryIndex].profile == s.skipProfile) s.tryIndex++;
+        if (s.tryIndex >= s.candidateCount) return false;
+        const WifiCandidate& c = s.candidates[s.tryIndex];
+        const WifiProfile&   p = WifiProfileStore::getInstance()->get(c.profile);
+        beginAttempt(c.profile, p.ssid, p.password, c.channel, c.bssid);
+        return true;
+    }
+
+    // connectBest(): next network to try after a failure, false when none is left
+    static bool nextCandidate() {
+        State& s = state();
+        if (!s.scanned) {
+            s.scanned  = true;
+            s.tryIndex = 0;
+            if (scanFresh()) {
+                wifiRankCandidates(s.candidates, s.candidateCount, WifiProfileStore::getInstance()->stats());
+                return tryCandidate();
+            }
+            s.phase = PHASE_SCAN;
+            if (startScan()) return true;
+            s.phase = PHASE_IDLE;
+            return false;
+        }
+        s.tryIndex++;
+        return tryCandidate();
+    }
+
+    static void saveCache(bool fast) {
+        wifiRtcCache.magic    = WIFI_RTC_MAGIC;
+        wifiRtcCache.ssidHash = hashSsid(state().ssid);
+        wifiRtcCache.channel  = (uint8_t)WiFi.channel();
+        uint8_t* bssid = WiFi.BSSID();
+        if (bssid) memcpy(wifiRtcCache.bssid, bssid, sizeof(wifiRtcCache.bssid));
+        wifiRtcCache.ip      = (uint32_t)WiFi.localIP();
+        wifiRtcCache.gateway = (uint32_t)WiFi.gatewayIP();
+        wifiRtcCache.mask    = (uint32_t)WiFi.subnetMask();
+        wifiRtcCache.dns1    = (uint32_t)WiFi.dnsIP(0);
+        wifiRtcCache.dns2    = (uint32_t)WiFi.dnsIP(1);
+        wifiRtcCache.reuse   = fast ? wifiRtcCache.reuse + 1 : 0;
+    }
+
+    // End of one network attempt
+    static void finish(bool connected) {
+        State& s    = state();
+        bool   fast = s.phase == PHASE_FAST;
+        s.phase = PHASE_IDLE;
+        if (s.profile >= 0) {
+            WifiProfileStore::getInstance()->record(s.profile, connected, millis() - s.attemptStart);
+        }
+
+        if (connected) {
+            if (fast) s.stats.fastConnects++;
+            else      s.stats.fullConnects++;
+            s.stats.lastWasFast = fast;
+            saveCache(fast);
+        } else if (s.multi && nextCandidate()) {
+            return;
+        }
+        complete(connected);
+    }
+
+    // End of the whole connectAsync()/connectBest() call
+    static void complete(bool connected) {
+        State&   s       = state();
+        uint32_t elapsed = millis() - s.start;
+        s.phase = PHASE_IDLE;
+        s.multi = false;
+
+        if (connected) {
+            s.stats.lastMs   = elapsed;
+            s.stats.totalMs += elapsed;
+            if (s.stats.bestMs == 0 || elapsed < s.stats.bestMs) s.stats.bestMs = elapsed;
+            Metrics::wifiConnectMs.observe(elapsed);
+        } else {
+            s.stats.failures++;
+            Metrics::wifiFailures.inc();
+        }
+
+        WifiConnectCallback callback = s.callback;
+        s.callback = nullptr;
+        if (callback) callback(connected, elapsed);
+    }
+
 public:
-    // WiFi connect with timeout
+    // Non-blocking connect: tries the cached channel/BSSID/IP first, falls
+    // back to a full scan + DHCP. Drive it with update() from loop().
+    static void connectAsync(const char* ssid, const char* password, WifiConnectCallback callback = nullptr) {
+        State& s = state();
+        hookEvents();
+        WifiProfileStore* store = WifiProfileStore::getInstance();
+        store->begin();
+        s.callback = callback;
+        s.start    = millis();
+        s.multi    = false;
+        s.stats.attempts++;
+        beginAttempt((int8_t)store->find(ssid), ssid, password, 0, nullptr);
+    }
+
+    // Non-blocking connect to the best known network: the one of the last
+    // connection first (no scan), then every profile in range ranked by
+    // expected time to join (RSSI, connect history, failure rate)
+    static void connectBest(WifiConnectCallback callback = nullptr) {
+        State& s = state();
+        hookEvents();
+        WifiProfileStore* store = WifiProfileStore::getInstance();
+        store->begin();
+        s.callback    = callback;
+        s.start       = millis();
+        s.multi       = true;
+        s.scanned     = false;
+        s.skipProfile = -1;
+        s.phase       = PHASE_IDLE;
+        s.stats.attempts++;
+
+        for (uint8_t i = 0; i < store->size(); i++) {
+            if (cacheValidFor(store->get(i).ssid)) {
+                s.skipProfile = i;
+                beginAttempt(i, store->get(i).ssid, store->get(i).password, 0, nullptr);
+                return;
+            }
+        }
+        if (!nextCandidate()) complete(false);
+    }
+
+    static void update() {
+        State& s = state();
+        pollScan();
+        if (s.phase == PHASE_IDLE || s.phase == PHASE_SCAN) return;
+
+        if (WiFi.status() == WL_CONNECTED && (uint32_t)WiFi.localIP() != 0) {
+            finish(true);
+            return;
+        }
+
+        unsigned long elapsed = millis() - s.phaseStart;
+        if (s.phase == PHASE_FAST && (s.linkFailed || elapsed > WIFI_FAST_TIMEOUT_MS)) {
+            s.stats.fastFallbacks++;
+            DLOG_W(WIFI, WIFI_FAST_FALLBACK, (unsigned)elapsed);
+            wifiRtcCache.magic = 0;
+            startFull();
+        } else if (s.phase == PHASE_FULL && elapsed > CONNECTION_TIMEOUT) {
+            WiFi.disconnect();
+            finish(false);
+        }
+    }
+
+    static bool isConnecting() { return state().phase != PHASE_IDLE; }
+
+    static const WifiConnectStats& getConnectStats() { return state().stats; }
+
+    static void forgetCachedNetwork() { wifiRtcCache.magic = 0; }
+
+    // Profiles
+
+    static bool addNetwork(const char* ssid, const char* password) {
+        state().scanValid = false;  // candidates hold store indexes
+        return WifiProfileStore::getInstance()->add(ssid, password);
+    }
+
+    static bool removeNetwork(const char* ssid) {
+        state().scanValid = false;
+        return WifiProfileStore::getInstance()->remove(ssid);
+    }
+
+    static const WifiProfileStats* getProfileStats(const char* ssid) {
+        WifiProfileStore* store = WifiProfileStore::getInstance();
+        store->begin();
+        int i = store->find(ssid);
+        return i < 0 ? nullptr : &store->stats()[i];
+    }
+
+    // Scan results
+
+    // Background scan, results are kept WIFI_SCAN_CACHE_MS
+    static bool scanAsync() { return startScan(); }
+
+    static bool isScanning() { return state().scanning; }
+
+    static uint32_t getScanAgeMs() { return state().scanValid ? millis() - state().scanAt : UINT32_MAX; }
+
+    // Known networks seen by the last scan, best first
+    static uint8_t getCandidates(const WifiCandidate*& list) {
+        State& s = state();
+        WifiProfileStore* store = WifiProfileStore::getInstance();
+        store->begin();
+        wifiRankCandidates(s.candidates, s.candidateCount, store->stats());
+        list = s.candidates;
+        return s.scanValid ? s.candidateCount : 0;
+    }
+
+    static void printStats() {
+        const WifiConnectStats& st = getConnectStats();
+        Serial.println("=== WiFi ===");
+        Serial.printf("Connects: %u ok fast, %u ok full, %u fallbacks, %u failed / %u\n",
+                      (unsigned)st.fastConnects, (unsigned)st.fullConnects, (unsigned)st.fastFallbacks,
+                      (unsigned)st.failures, (unsigned)st.attempts);
+        Serial.printf("Time to connect: last %u ms, best %u ms, avg %u ms\n", (unsigned)st.lastMs,
+                      (unsigned)st.bestMs, (unsigned)st.averageMs());
+        Serial.printf("Scans: %u, last %u ms\n", (unsigned)st.scans, (unsigned)st.lastScanMs);
+
+        WifiProfileStore* store = WifiProfileStore::getInstance();
+        store->begin();
+        for (uint8_t i = 0; i < store->size(); i++) {
+            const WifiProfileStats& ps = store->stats()[i];
+            Serial.printf("  %-20s %3u tries, %2u.%u%% failed, avg %u ms\n", store->get(i).ssid,
+                          (unsigned)ps.attempts, ps.failurePermille() / 10, ps.failurePermille() % 10,
+                          (unsigned)ps.avgConnectMs);
+        }
+        const WifiCandidate* list;
+        uint8_t n = getCandidates(list);
+        for (uint8_t i = 0; i < n; i++) {
+            Serial.printf("  #%u %-20s %4d dBm ch %2u ~%d ms\n", i + 1, store->get(list[i].profile).ssid,
+                          list[i].rssi, list[i].channel, (int)list[i].score);
+        }
+        Serial.println("============");
+    }
+
+    // Blocking wrapper around connectAsync(), kept for simple sketches
     static bool connect(const char* ssid, const char* password) {
-        WiFi.disconnect(true);
-        WiFi.mode(WIFI_STA);
-        delay(500);
-        
-        Serial.println("Connecting to WiFi...");
-        WiFi.begin(ssid, password);
-        
-        unsigned long startTime = millis();
-        while (WiFi.status() != WL_CONNECTED && 
-               millis() - startTime < CONNECTION_TIMEOUT) {
-            Serial.print(".");
-            delay(500);
+        bool done = false, ok = false;
+        unsigned long start = millis();
+        DLOG_I(WIFI, WIFI_CONNECTING);
+        connectAsync(ssid, password, [&done, &ok](bool connected, uint32_t) {
+            done = true;
+            ok   = connected;
+        });
+        while (!done) {
+            update();
+            delay(10);
         }
-        
-        if (WiFi.status() == WL_CONNECTED) {
-            Serial.println("\n WiFi Connected!");
-            Serial.print("IP: ");
-            Serial.println(WiFi.localIP());
-            return true;
+
+        if (ok) {
+            const WifiConnectStats& st = getConnectStats();
+            IPAddress ip = WiFi.localIP();
+            DLOG_I(WIFI, WIFI_CONNECTED, (unsigned)st.lastMs, st.lastWasFast ? "cached" : "full", ip[0], ip[1],
+                   ip[2], ip[3]);
         } else {
-            Serial.println("\n WiFi Connection Failed");
-            return false;
+            DLOG_E(WIFI, WIFI_FAILED, (unsigned)(millis() - start));
         }
+        return ok;
     }
     
     static void disconnect() {
+        state().phase    = PHASE_IDLE;
+        state().multi    = false;
+        state().callback = nullptr;
         WiFi.disconnect(true);
-        Serial.println("WiFi Disconnected");
+        DLOG_I(WIFI, WIFI_DISCONNECTED);
     }
     
     static bool isConnected() {
         return WiFi.status() == WL_CONNECTED;
     }
     
-    static String getIP() {
-        if (isConnected()) {
-            return WiFi.localIP().toString();
-        }
-        return "Not Connected";
+    // Static buffer, valid until the next call
+    static const char* getIP() {
+        static char text[16];
+        if (!isConnected()) return "Not Connected";
+        IPAddress ip = WiFi.localIP();
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+        return text;
     }
     
     static int getSignalStrength() {
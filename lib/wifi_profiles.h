@@ -0,0 +1,153 @@
+#ifndef WIFI_PROFILES_H
+#define WIFI_PROFILES_H
+
+#include <Preferences.h>
+#include "metrics.h"
+#include <Arduino.h>
+#include <esp_attr.h>
+#include "core/wifi_ranking.h"
+
+#define WIFI_MAX_PROFILES       8
+#define WIFI_STATS_SAVE_EVERY   8   // NVS write of the connect history every N results
+#define WIFI_STATS_RTC_MAGIC    0x57505354
+
+struct WifiProfile {
+    char ssid[33];
+    char password[65];
+};
+
+// Connect history survives deep sleep in RTC memory and is only written to
+// NVS now and then, a wake-connect-sleep cycle should not cost a flash write
+struct WifiStatsRtc {
+    uint32_t         magic;
+    uint8_t          dirty;
+    WifiProfileStats stats[WIFI_MAX_PROFILES];
+};
+
+RTC_DATA_ATTR static WifiStatsRtc wifiStatsRtc;
+
+// Singleton with cache, same as SettingsManager: NVS is read once in begin()
+class WifiProfileStore {
+private:
+    static WifiProfileStore* instance;
+    Preferences prefs;
+    WifiProfile profiles[WIFI_MAX_PROFILES];
+    uint8_t count;
+    bool loaded;
+
+    WifiProfileStore() : count(0), loaded(false) {}
+
+    static void key(char* out, char prefix, uint8_t index) {
+        out[0] = prefix;
+        out[1] = (char)('0' + index);
+        out[2] = '\0';
+    }
+
+    void saveProfiles() {
+        char k[3];
+        prefs.begin("wifi", false);
+        prefs.putUChar("count", count);
+        for (uint8_t i = 0; i < count; i++) {
+            key(k, 's', i); prefs.putString(k, profiles[i].ssid);
+            key(k, 'p', i); prefs.putString(k, profiles[i].password);
+        }
+        for (uint8_t i = count; i < WIFI_MAX_PROFILES; i++) {
+            key(k, 's', i); prefs.remove(k);
+            key(k, 'p', i); prefs.remove(k);
+        }
+        prefs.putBytes("stats", wifiStatsRtc.stats, sizeof(wifiStatsRtc.stats));
+        prefs.end();
+        Metrics::nvsCommits.inc();
+        wifiStatsRtc.dirty = 0;
+    }
+
+public:
+    static WifiProfileStore* getInstance() {
+        if (instance == nullptr) {
+            instance = new WifiProfileStore();
+        }
+        return instance;
+    }
+
+    void begin() {
+        if (loaded) return;
+        loaded = true;
+        char k[3];
+        prefs.begin("wifi", true);
+        count = prefs.getUChar("count", 0);
+        if (count > WIFI_MAX_PROFILES) count = WIFI_MAX_PROFILES;
+        for (uint8_t i = 0; i < count; i++) {
+            key(k, 's', i); prefs.getString(k, profiles[i].ssid, sizeof(profiles[i].ssid));
+            key(k, 'p', i); prefs.getString(k, profiles[i].password, sizeof(profiles[i].password));
+        }
+        // RTC copy is newer than NVS after a deep sleep wake
+        if (wifiStatsRtc.magic != WIFI_STATS_RTC_MAGIC) {
+            memset(&wifiStatsRtc, 0, sizeof(wifiStatsRtc));
+            prefs.getBytes("stats", wifiStatsRtc.stats, sizeof(wifiStatsRtc.stats));
+            wifiStatsRtc.magic = WIFI_STATS_RTC_MAGIC;
+        }
+        prefs.end();
+    }
+
+    uint8_t size() const { return count; }
+    const WifiProfile& get(uint8_t index) const { return profiles[index]; }
+    const WifiProfileStats* stats() const { return wifiStatsRtc.stats; }
+
+    int find(const char* ssid) const {
+        for (uint8_t i = 0; i < count; i++) {
+            if (strcmp(profiles[i].ssid, ssid) == 0) return i;
+        }
+        return -1;
+    }
+
+    // Adds or updates a network, false when the store is full
+    bool add(const char* ssid, const char* password) {
+        begin();
+        int i = find(ssid);
+        if (i < 0) {
+            if (count >= WIFI_MAX_PROFILES) return false;
+            i = count++;
+            memset(&wifiStatsRtc.stats[i], 0, sizeof(WifiProfileStats));
+            strncpy(profiles[i].ssid, ssid, sizeof(profiles[i].ssid) - 1);
+            profiles[i].ssid[sizeof(profiles[i].ssid) - 1] = '\0';
+        }
+        strncpy(profiles[i].password, password ? password : "", sizeof(profiles[i].password) - 1);
+        profiles[i].password[sizeof(profiles[i].password) - 1] = '\0';
+        saveProfiles();
+        return true;
+    }
+
+    bool remove(const char* ssid) {
+        begin();
+        int i = find(ssid);
+        if (i < 0) return false;
+        for (uint8_t j = i; j + 1 < count; j++) {
+            profiles[j] = profiles[j + 1];
+            wifiStatsRtc.stats[j] = wifiStatsRtc.stats[j + 1];
+        }
+        count--;
+        memset(&wifiStatsRtc.stats[count], 0, sizeof(WifiProfileStats));
+        saveProfiles();
+        return true;
+    }
+
+    void record(uint8_t index, bool ok, uint32_t ms) {
+        if (index >= count) return;
+        wifiStatsRtc.stats[index].record(ok, ms);
+        if (++wifiStatsRtc.dirty >= WIFI_STATS_SAVE_EVERY) saveStats();
+    }
+
+    // Also call it before a long sleep or a power off to keep the latest history
+    void saveStats() {
+        if (wifiStatsRtc.dirty == 0) return;
+        prefs.begin("wifi", false);
+        prefs.putBytes("stats", wifiStatsRtc.stats, sizeof(wifiStatsRtc.stats));
+        prefs.end();
+        Metrics::nvsCommits.inc();
+        wifiStatsRtc.dirty = 0;
+    }
+};
+
+WifiProfileStore* WifiProfileStore::instance = nullptr;
+
+#endif
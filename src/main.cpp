@@ -3,21 +3,70 @@
 #include <Preferences.h>
 
 #include "../lib/settings_manager.h"
+#include "../lib/serial_console.h"
+#include "../lib/deferred_log.h"
+#include "../lib/mem_tracker.h"
+#include "../lib/boot_path.h"
+#include "../lib/service_container.h"
 #include "../lib/dependancies/display_handler_deps.h"
 #include "../lib/dependancies/battery_handler_deps.h"
 #include "../lib/dependancies/rtc_utils_deps.h"
 #include "../lib/dependancies/clock_handler_deps.h"
 #include "../lib/dependancies/page_manager_deps.h"
+#include "../lib/dependancies/power_history_deps.h"
+#include "../lib/dependancies/backlight_handler_deps.h"
+#include "../lib/dependancies/energy_profiler_deps.h"
+#include "../lib/dependancies/metrics_deps.h"
+#include "../lib/dependancies/pomodoro_deps.h"
+#include "../lib/dependancies/static_wiring.h"
 #include "../lib/pages/clock_page.h"
+#include "../lib/pages/stopwatch_page.h"
 
-IDisplayHandler* displayHandler = getM5StickDisplayHandler();
-IBatteryHandler* batteryHandler = getM5StickBatteryHandler(displayHandler);
-IRtcUtils*       rtcUtils       = getM5StickRtcUtils();
-IClockHandler*   clockHandler   = getM5StickClockHandler(displayHandler, batteryHandler, rtcUtils);
-IPageManager*    pageManager    = getM5StickPageManager();
+#ifdef STATIC_WIRING
+StaticWiring wiring;
 
-SettingsManager* settings;
-ClockPage*       clockPage = nullptr;
+DisplayHandlerT* displayHandler = &wiring.display;
+BatteryHandlerT* batteryHandler = &wiring.battery;
+RtcUtilsT*       rtcUtils       = &wiring.rtc;
+ClockHandlerT*   clockHandler   = &wiring.clock;
+PageManagerT*    pageManager    = &wiring.pages;
+PowerHistoryT*   powerHistory   = &wiring.powerHistory;
+BacklightHandlerT* backlight    = &wiring.backlight;
+EnergyProfilerT* energyProfiler = &wiring.energy;
+MetricsExporterT* metrics       = &wiring.metrics;
+PomodoroT*       pomodoro       = &wiring.pomodoro;
+#else
+DisplayHandlerT* displayHandler = getM5StickDisplayHandler();
+BatteryHandlerT* batteryHandler = getM5StickBatteryHandler(displayHandler);
+RtcUtilsT*       rtcUtils       = getM5StickRtcUtils();
+ClockHandlerT*   clockHandler   = getM5StickClockHandler(displayHandler, batteryHandler, rtcUtils);
+PageManagerT*    pageManager    = getM5StickPageManager();
+PowerHistoryT*   powerHistory   = getM5StickPowerHistory(batteryHandler, rtcUtils);
+BacklightHandlerT* backlight    = getM5StickBacklightHandler(batteryHandler);
+EnergyProfilerT* energyProfiler = getM5StickEnergyProfiler(batteryHandler, pageManager, backlight, rtcUtils);
+MetricsExporterT* metrics       = getM5StickMetrics();
+PomodoroT*       pomodoro       = getM5StickPomodoro(batteryHandler, rtcUtils);
+#endif
+
+SettingsManager*  settings;
+SerialConsole*    console = nullptr;
+ClockPage*        clockPage = nullptr;
+StopwatchPage*    stopwatchPage = nullptr;
+bool              alarmOnly     = false;   // woken for the alarm only, back to sleep without the UI
+ServiceContainer* services = ServiceContainer::getInstance();
+
+enum AppService : uint8_t {
+  SVC_M5 = 0,
+  SVC_LOG,
+  SVC_SETTINGS,
+  SVC_BATTERY,
+  SVC_BACKLIGHT,
+  SVC_POWER_HISTORY,
+  SVC_ENERGY,
+  SVC_POMODORO,
+  SVC_CONSOLE,
+  SVC_UI
+};
 
 void beepAlarm() {
   M5.Speaker.begin();
@@ -29,36 +78,179 @@ void beepAlarm() {
   M5.Speaker.end();
 }
 
-void setup() {
-  auto cfg = M5.config();
-  M5.begin(cfg);
-  M5.Display.setRotation(3);
-  Serial.begin(115200);
+void registerConsoleCommands() {
+  console->registerCommand("powerlog", "csv | bin | clear | stats", [](const char* args) {
+    if      (strcmp(args, "csv") == 0)   powerHistory->exportCsv();
+    else if (strcmp(args, "bin") == 0)   powerHistory->exportBinary();
+    else if (strcmp(args, "clear") == 0) powerHistory->clear();
+    else Serial.printf("powerlog: %u/%u pages\n",
+                       (unsigned)powerHistory->getStoredPages(),
+                       (unsigned)powerHistory->getCapacityPages());
+  });
+  console->registerCommand("backlight", "backlight energy report", [](const char*) {
+    backlight->printEnergyReport();
+  });
+  console->registerCommand("energy", "energy report | reset", [](const char* args) {
+    if (strcmp(args, "reset") == 0) energyProfiler->reset();
+    else energyProfiler->printReport();
+  });
+  console->registerCommand("metrics", "metrics table | reset", [](const char* args) {
+    if (strcmp(args, "reset") == 0) metrics->reset();
+    else metrics->printTable();
+  });
+  console->registerCommand("pomodoro", "status | start | stop | flush", [](const char* args) {
+    if (strcmp(args, "start") == 0) {
+      pomodoro->start();
+      energyProfiler->beginSpan("pomodoro");
+      energyProfiler->pauseSpan("pomodoro");   // charged from the next sleep on
+    } else if (strcmp(args, "stop") == 0) {
+      pomodoro->stop();
+      energyProfiler->endSpan("pomodoro");
+    }
+    else if (strcmp(args, "flush") == 0) pomodoro->flushStats();
+    pomodoro->printStats();
+  });
+  console->registerCommand("boot", "boot latency per wake cause | reset", [](const char* args) {
+    BootPath::getInstance()->handleConsole(args);
+  });
+  console->registerCommand("tick", "clock tick jitter | reset", [](const char* args) {
+    if (strcmp(args, "reset") == 0) clockHandler->resetTickStats();
+    clockHandler->printTickStats();
+  });
+  console->registerCommand("frames", "frame rate per page | reset", [](const char* args) {
+    if (strcmp(args, "reset") == 0) pageManager->resetFrameStats();
+    pageManager->printFrameStats();
+  });
+  console->registerCommand("services", "boot timeline", [](const char*) {
+    services->printTimeline();
+  });
+  console->registerCommand("mem", "heap, pools and stacks | peaks", [](const char* args) {
+    MemTracker::getInstance()->handleConsole(args);
+  });
+  console->registerCommand("log", "<module|all> <level> | bin | text | stats", [](const char* args) {
+    DeferredLog::getInstance()->handleConsole(args);
+  });
+}
 
-  settings = SettingsManager::getInstance();
-  settings->begin();
-  batteryHandler->begin();
+// Construction above only wires pointers; the begin() calls are here, each
+// with what it needs. Early services come up before the first frame, the
+// background ones one per loop iteration after it, lazy ones when needed.
+void registerServices() {
+  services->add(SVC_M5, "m5", SERVICE_EARLY, 0, [] {
+    auto cfg = M5.config();
+    M5.begin(cfg);
+    M5.Display.setRotation(3);
+    Serial.begin(115200);
+  });
+  services->add(SVC_LOG, "log", SERVICE_EARLY, SERVICE_BIT(SVC_M5), [] {
+    DeferredLog::getInstance()->begin();
+    MemTracker::getInstance()->watchTask("logDrain");
+  });
+  services->add(SVC_SETTINGS, "settings", SERVICE_EARLY, 0, [] {
+    settings = SettingsManager::getInstance();
+    settings->begin();
+  });
+  services->add(SVC_BATTERY, "battery", SERVICE_LAZY, SERVICE_BIT(SVC_M5), [] {
+    batteryHandler->begin();
+  });
+  services->add(SVC_BACKLIGHT, "backlight", SERVICE_EARLY, SERVICE_BIT(SVC_SETTINGS) | SERVICE_BIT(SVC_BATTERY), [] {
+    backlight->begin();
+  });
+  services->add(SVC_POWER_HISTORY, "powerHistory", SERVICE_BACKGROUND, SERVICE_BIT(SVC_BATTERY), [] {
+    powerHistory->begin();
+  });
+  services->add(SVC_ENERGY, "energy", SERVICE_BACKGROUND, SERVICE_BIT(SVC_BATTERY) | SERVICE_BIT(SVC_BACKLIGHT), [] {
+    energyProfiler->begin();  // charges the deep sleep that just ended
+    // Awake with the UI, whatever the wake cause: the pomodoro run goes on
+    // but the time spent in the UI is not charged to it
+    if (!alarmOnly) energyProfiler->pauseSpan("pomodoro");
+  });
+  services->add(SVC_POMODORO, "pomodoro", SERVICE_EARLY, SERVICE_BIT(SVC_M5), [] {
+    pomodoro->begin();
+  });
+  services->add(SVC_CONSOLE, "console", SERVICE_BACKGROUND, SERVICE_BIT(SVC_M5), [] {
+    console = SerialConsole::getInstance();
+    registerConsoleCommands();
+  });
+  services->add(SVC_UI, "ui", SERVICE_EARLY,
+                SERVICE_BIT(SVC_SETTINGS) | SERVICE_BIT(SVC_BATTERY) | SERVICE_BIT(SVC_BACKLIGHT) |
+                SERVICE_BIT(SVC_POMODORO), [] {
+    clockPage = memNew<ClockPage>(MEM_TAG_UI, displayHandler, clockHandler, batteryHandler, rtcUtils);
+    clockPage->setEnergyProfiler(energyProfiler);
+    clockPage->setPomodoro(pomodoro);
+    pageManager->addPage(clockPage);
+    stopwatchPage = memNew<StopwatchPage>(MEM_TAG_UI, displayHandler);
+    pageManager->addPage(stopwatchPage);
+    pageManager->begin();
+  });
+}
 
-  clockPage = new ClockPage(displayHandler, clockHandler, batteryHandler, rtcUtils);
-  pageManager->addPage(clockPage);
+void setup() {
+  BootPath* boot = BootPath::getInstance();
+  boot->begin();
+  registerServices();
 
-  if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER) {
-    clockHandler->clearTarget();
-    beepAlarm();
+  // A pomodoro phase ended: the alarm goes first, from the RTC memory state
+  // alone. Unless button A stops it, the device only starts what re-arming
+  // needs and sleeps until the end of the next phase, the UI stays off.
+  if (boot->isTimerWake() && pomodoro->isActive()) {
+    alarmOnly = !boot->soundAlarm(pomodoro->getCycle().upcoming() == POMO_WORK ? 2500 : 1800);
   }
 
-  pageManager->begin();
+  if (alarmOnly) {
+    // No service started: the time comes from a bare RTC read and the energy
+    // profiler charges the whole sleep, this wake included, on the next UI wake
+    uint32_t now = boot->rtcEpoch();
+    if (now) {
+      powerHistory->recordEventAt(now, POWER_EVENT_WAKE, ESP_SLEEP_WAKEUP_TIMER);
+      powerHistory->recordEventAt(now, POWER_EVENT_SLEEP);
+      pomodoro->sleepUntilPhaseEnd(now);
+    }
+    // The RTC did not answer on the bare bus: through M5.begin() then
+    services->use(SVC_POWER_HISTORY);
+    services->use(SVC_ENERGY);
+    services->use(SVC_POMODORO);
+    energyProfiler->notifySleep();
+    pomodoro->sleepUntilPhaseEnd();
+  }
+
+  services->runStage(SERVICE_EARLY);
+  services->markFirstFrame();
+  boot->mark(BOOT_MARK_UI);
 }
 
 void loop() {
   M5.update();
 
+  // Background start-up, one service per pass; the heap is sealed after it
+  if (services->pending(SERVICE_BACKGROUND)) {
+    services->runNext(SERVICE_BACKGROUND);
+    if (!services->pending(SERVICE_BACKGROUND)) memSealSetup();
+  }
+
   pageManager->handleInput();
   pageManager->update();
 
   batteryHandler->update();
+  if (services->ready(SVC_POWER_HISTORY)) powerHistory->update();
+
+  PageBase* page = pageManager->getCurrentPage();
+  backlight->setPageLevel(page ? page->getBacklightLevel() : 100);
+  backlight->update();
+  if (services->ready(SVC_ENERGY)) energyProfiler->update();
+  if (console) console->update();
+
+  if (pomodoro->update()) beepAlarm();
+
   if (settings->shouldGoToSleep()) {
+    services->use(SVC_POWER_HISTORY);
+    services->use(SVC_ENERGY);
+    powerHistory->recordEvent(POWER_EVENT_SLEEP);
+    if (pomodoro->isActive()) energyProfiler->resumeSpan("pomodoro");
+    energyProfiler->notifySleep();
+    if (pomodoro->isActive()) pomodoro->sleepUntilPhaseEnd();
     batteryHandler->deepSleep();
   }
-  delay(10);
+  // Until the page's next frame, at most an input poll period
+  batteryHandler->idle(pageManager->getIdleUs());
 }
@@ -0,0 +1,30 @@
+#include <new>
+#include "../lib/mem_tracker.h"
+
+// The one translation unit that defines the tracker's static members and
+// replaces the global allocation functions, whatever else includes the header.
+
+MemTracker    MemTracker::instance;
+MemAccounting MemTracker::accounting;
+TaskHandle_t  MemTracker::sealedTask = nullptr;
+#ifdef MEM_STATIC_POOLS
+uint64_t      MemTracker::poolBuffer[(MEM_STATIC_POOL_BYTES + 7) / 8];
+StaticArena   MemTracker::arena((uint8_t*)MemTracker::poolBuffer, sizeof(MemTracker::poolBuffer));
+#endif
+
+#if MEM_TRACK_GLOBAL_NEW
+// Every other C++ allocation (libraries included) lands in "other". Array
+// and nothrow forms end up here through the standard library.
+void* operator new(size_t n) {
+    void* p = MemTracker::heapAlloc(MEM_TAG_OTHER, n, MEM_CALLER());
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(size_t n, const std::nothrow_t&) noexcept {
+    return MemTracker::heapAlloc(MEM_TAG_OTHER, n, MEM_CALLER());
+}
+
+void operator delete(void* p) noexcept { MemTracker::release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { MemTracker::release(p); }
+#endif
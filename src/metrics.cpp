@@ -0,0 +1,31 @@
+#include "../lib/metrics.h"
+
+// The one translation unit that defines the built-in metrics, in export order.
+
+namespace Metrics {
+
+static const uint32_t WIFI_CONNECT_BOUNDS[] = { 250, 500, 1000, 2000, 4000, 8000, 15000 };
+static const uint32_t MENU_DRAW_BOUNDS[]    = { 1000, 2000, 5000, 10000, 20000, 50000 };
+static const uint32_t FRAME_RENDER_BOUNDS[] = { 500, 1000, 2000, 5000, 10000, 20000, 33333 };
+
+MetricCounter   pageSwitches("page_switches");
+MetricCounter   menuDraws("menu_draws");
+MetricHistogram menuDrawUs("menu_draw_us", MENU_DRAW_BOUNDS, 6);
+MetricGauge     frameBudgetUs("frame_budget_us");
+MetricCounter   framesLate("frames_late");
+MetricCounter   framesDropped("frames_dropped");
+MetricHistogram stopwatchRenderUs("stopwatch_render_us", FRAME_RENDER_BOUNDS, 7);
+MetricCounter   nvsCommits("nvs_commits");
+MetricCounter   batterySamples("battery_samples");
+MetricGauge     batteryLevel("battery_pct");
+MetricGauge     batteryMv("battery_mv");
+MetricCounter   mqttPublished("mqtt_published");
+MetricCounter   mqttQueued("mqtt_queued");
+MetricCounter   mqttDropped("mqtt_dropped");
+MetricCounter   mqttEncodeErrors("mqtt_encode_errors");
+MetricHistogram wifiConnectMs("wifi_connect_ms", WIFI_CONNECT_BOUNDS, 7);
+MetricCounter   wifiFailures("wifi_failures");
+MetricGauge     heapFree("heap_free");
+MetricGauge     heapMinFree("heap_min_free");
+
+}
@@ -0,0 +1,73 @@
+#include <unity.h>
+#include "../../lib/core/backoff.h"
+
+// Run with `pio test -e native -f test_backoff`
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_ceiling_doubles_up_to_cap() {
+    ExponentialBackoff b;
+    b.configure(1000, 10000);
+    const uint32_t expected[] = { 1000, 2000, 4000, 8000, 10000, 10000 };
+    for (int i = 0; i < 6; i++) {
+        TEST_ASSERT_EQUAL(expected[i], b.ceilingMs());
+        b.next(0);
+    }
+}
+
+void test_jitter_stays_between_half_and_ceiling() {
+    ExponentialBackoff b;
+    b.configure(500, 60000);
+    uint32_t rng = 1;
+    for (int i = 0; i < 40; i++) {
+        uint32_t ceiling = b.ceilingMs();
+        rng = rng * 1664525UL + 1013904223UL;
+        uint32_t d = b.next(rng);
+        TEST_ASSERT_TRUE(d >= ceiling / 2);
+        TEST_ASSERT_TRUE(d <= ceiling);
+    }
+    TEST_ASSERT_EQUAL(60000, b.ceilingMs());
+}
+
+void test_extremes_of_random() {
+    ExponentialBackoff b;
+    b.configure(1000, 1000);
+    TEST_ASSERT_EQUAL(500, b.next(0));
+    TEST_ASSERT_EQUAL(1000, b.next(500));
+    TEST_ASSERT_TRUE(b.next(0xFFFFFFFF) <= 1000);
+}
+
+void test_reset_and_no_overflow() {
+    ExponentialBackoff b;
+    b.configure(3000, 0xF0000000UL);
+    for (int i = 0; i < 100; i++) b.next(0);
+    TEST_ASSERT_EQUAL(0xF0000000UL, b.ceilingMs());
+    b.reset();
+    TEST_ASSERT_EQUAL(3000, b.ceilingMs());
+}
+
+void test_reconnect_stats() {
+    ReconnectStats s = {};
+    TEST_ASSERT_EQUAL(0, s.averageReconnectMs());
+    s.nextRetryMs = 4000;
+    s.recordReconnect(3000);
+    s.recordReconnect(5000);
+    TEST_ASSERT_EQUAL(2, s.reconnects);
+    TEST_ASSERT_EQUAL(5000, s.lastReconnectMs);
+    TEST_ASSERT_EQUAL(5000, s.maxReconnectMs);
+    TEST_ASSERT_EQUAL(4000, s.averageReconnectMs());
+    TEST_ASSERT_EQUAL(0, s.nextRetryMs);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_ceiling_doubles_up_to_cap);
+    RUN_TEST(test_jitter_stays_between_half_and_ceiling);
+    RUN_TEST(test_extremes_of_random);
+    RUN_TEST(test_reset_and_no_overflow);
+    RUN_TEST(test_reconnect_stats);
+
+    return UNITY_END();
+}
@@ -0,0 +1,233 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <chrono>
+#include <ArduinoJson.h>
+#include "../../lib/core/command_dispatcher.h"
+
+// Host benchmark: run with `pio test -e native -f test_bench_commands -v`
+// Command dispatch through the perfect-hash table and the fixed parse pool,
+// against the previous way: a heap JsonDocument and a strcmp chain.
+
+static int32_t lastUser, lastZone, lastMinutes;
+static int     handled;
+
+static CommandResult onRestart(const CommandArgs&) { handled++; return CommandResult::ok(); }
+static CommandResult onSleep(const CommandArgs&)   { handled++; return CommandResult::ok(); }
+
+static CommandResult onSetConfig(const CommandArgs& a) {
+    handled++;
+    lastUser = a.getInt(0);
+    lastZone = a.getInt(1);
+    return CommandResult::ok();
+}
+
+static CommandResult onSetTime(const CommandArgs& a) {
+    handled++;
+    return a.getInt(0) > 0 ? CommandResult::ok() : CommandResult::fail("epoch");
+}
+
+static CommandResult onPomodoro(const CommandArgs& a) {
+    handled++;
+    lastMinutes = a.getInt(0, 25);
+    return CommandResult::ok();
+}
+
+static const CommandSpec TABLE[] = {
+    { "restart",        onRestart,   {} },
+    { "sleep",          onSleep,     { { "seconds", CMD_ARG_INT, false } } },
+    { "set_config",     onSetConfig, { { "user_id", CMD_ARG_INT, true }, { "zone_id", CMD_ARG_INT, true } } },
+    { "set_time",       onSetTime,   { { "epoch", CMD_ARG_INT, true }, { "tz", CMD_ARG_STRING, false } } },
+    { "start_pomodoro", onPomodoro,  { { "minutes", CMD_ARG_INT, false } } },
+};
+static const size_t TABLE_SIZE = sizeof(TABLE) / sizeof(TABLE[0]);
+
+// 64-bit hosts use a 128 x 24 byte slot pool, larger than the device one
+typedef CommandDispatcher<16, 8, 4096> BenchDispatcher;
+
+static uint32_t fakeNow = 0;
+static uint32_t nowUs() { return fakeNow; }
+
+static char lastReply[160];
+static void captureReply(void*, const CommandJob& job, const CommandSpec* spec, const CommandResult& r) {
+    snprintf(lastReply, sizeof(lastReply), "%s %s %s", job.id, spec ? spec->name : "-", commandStatusName(r.status));
+}
+
+static CommandStatus run(BenchDispatcher& d, const char* json) {
+    CommandStatus s = d.submit((const uint8_t*)json, strlen(json), fakeNow);
+    d.runPending(captureReply, nullptr, nowUs);
+    return s;
+}
+
+// Counts every allocation ArduinoJson makes for the heap baseline
+struct CountingAllocator : ArduinoJson::Allocator {
+    uint32_t count;
+    CountingAllocator() : count(0) {}
+    void* allocate(size_t n) override { count++; return malloc(n); }
+    void  deallocate(void* p) override { free(p); }
+    void* reallocate(void* p, size_t n) override { count++; return realloc(p, n); }
+};
+
+void setUp(void) {
+    handled      = 0;
+    lastReply[0] = '\0';
+}
+void tearDown(void) {}
+
+void test_typed_arguments_reach_the_handler() {
+    BenchDispatcher d;
+    TEST_ASSERT_TRUE(d.begin(TABLE, TABLE_SIZE));
+    TEST_ASSERT_EQUAL(CMD_OK, run(d, "{\"id\":\"r-17\",\"action\":\"set_config\",\"args\":{\"user_id\":3,\"zone_id\":7}}"));
+    TEST_ASSERT_EQUAL(1, handled);
+    TEST_ASSERT_EQUAL(3, lastUser);
+    TEST_ASSERT_EQUAL(7, lastZone);
+    TEST_ASSERT_EQUAL_STRING("r-17 set_config ok", lastReply);
+
+    run(d, "{\"action\":\"start_pomodoro\"}");
+    TEST_ASSERT_EQUAL(25, lastMinutes);
+}
+
+void test_errors_get_a_reply_without_running() {
+    BenchDispatcher d;
+    TEST_ASSERT_TRUE(d.begin(TABLE, TABLE_SIZE));
+    TEST_ASSERT_EQUAL(CMD_ERR_UNKNOWN, run(d, "{\"id\":\"1\",\"action\":\"format_disk\"}"));
+    TEST_ASSERT_EQUAL_STRING("1 - unknown_command", lastReply);
+    TEST_ASSERT_EQUAL(CMD_ERR_ARGS, run(d, "{\"id\":\"2\",\"action\":\"set_config\",\"args\":{\"user_id\":3}}"));
+    TEST_ASSERT_EQUAL_STRING("2 set_config bad_args", lastReply);
+    TEST_ASSERT_EQUAL(CMD_ERR_ARGS, run(d, "{\"id\":\"3\",\"action\":\"set_time\",\"args\":{\"epoch\":\"soon\"}}"));
+    TEST_ASSERT_EQUAL(CMD_ERR_PARSE, run(d, "{\"id\":\"4\",\"action\":"));
+    TEST_ASSERT_EQUAL(0, handled);
+
+    run(d, "{\"id\":\"5\",\"action\":\"set_time\",\"args\":{\"epoch\":0}}");
+    TEST_ASSERT_EQUAL_STRING("5 set_time failed", lastReply);
+
+    const CommandStats& s = d.stats();
+    TEST_ASSERT_EQUAL(1, s.unknown);
+    TEST_ASSERT_EQUAL(2, s.badArgs);
+    TEST_ASSERT_EQUAL(1, s.parseErrors);
+    TEST_ASSERT_EQUAL(1, s.failed);
+}
+
+void test_correlation_id_is_sanitized() {
+    BenchDispatcher d;
+    TEST_ASSERT_TRUE(d.begin(TABLE, TABLE_SIZE));
+    run(d, "{\"id\":\"a\\\"b,c\",\"action\":\"restart\"}");
+    TEST_ASSERT_EQUAL_STRING("abc restart ok", lastReply);
+}
+
+void test_unknown_fields_do_not_use_the_pool() {
+    BenchDispatcher d;
+    TEST_ASSERT_TRUE(d.begin(TABLE, TABLE_SIZE));
+    std::string junk = "{\"id\":\"9\",\"action\":\"sleep\",\"trace\":[";
+    for (int i = 0; i < 200; i++) junk += "{\"k\":\"some long diagnostic value\"},";
+    junk += "0],\"args\":{\"seconds\":60,\"comment\":\"ignored\"}}";
+    TEST_ASSERT_EQUAL(CMD_OK, run(d, junk.c_str()));
+    TEST_ASSERT_EQUAL(0, d.pool().failures());
+    TEST_ASSERT_TRUE(d.pool().highWater() <= d.pool().capacity());
+}
+
+void test_msgpack_commands() {
+    BenchDispatcher d;
+    TEST_ASSERT_TRUE(d.begin(TABLE, TABLE_SIZE));
+    JsonDocument src;
+    src["id"]      = "m1";
+    src["action"]  = "start_pomodoro";
+    src["args"]["minutes"] = 50;
+    uint8_t buf[128];
+    size_t  len = encodePayload(src, PAYLOAD_MSGPACK, buf, sizeof(buf));
+    TEST_ASSERT_TRUE(len > 0);
+    TEST_ASSERT_EQUAL(CMD_OK, d.submit(buf, len, 0));
+    d.runPending(captureReply, nullptr, nowUs);
+    TEST_ASSERT_EQUAL(50, lastMinutes);
+}
+
+void test_full_queue_drops() {
+    BenchDispatcher d;
+    TEST_ASSERT_TRUE(d.begin(TABLE, TABLE_SIZE));
+    const char* cmd = "{\"action\":\"restart\"}";
+    for (int i = 0; i < 10; i++) d.submit((const uint8_t*)cmd, strlen(cmd), 0);
+    TEST_ASSERT_EQUAL(8, d.pending());
+    TEST_ASSERT_EQUAL(2, d.stats().dropped);
+    TEST_ASSERT_EQUAL(4, d.runPending(nullptr, nullptr, nowUs, 4));
+    TEST_ASSERT_EQUAL(4, d.pending());
+}
+
+// The previous handler: whole document on the heap, then a strcmp chain
+static int legacyDispatch(JsonDocument& doc, const char* json) {
+    if (deserializeJson(doc, json)) return -1;
+    const char* action = doc["action"];
+    if (!action) return -1;
+    for (size_t i = 0; i < TABLE_SIZE; i++) {
+        if (strcmp(action, TABLE[i].name) == 0) {
+            CommandArgs args;
+            args.clear();
+            for (uint8_t a = 0; a < CMD_MAX_ARGS && TABLE[i].args[a].name; a++) {
+                JsonVariant v = doc["args"][TABLE[i].args[a].name];
+                if (!v.isNull()) {
+                    args.values[a].i = v.as<int32_t>();
+                    args.present[a]  = true;
+                }
+            }
+            TABLE[i].handler(args);
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+void test_bench_dispatch_latency_and_allocations() {
+    typedef std::chrono::steady_clock Clock;
+    static const char* const MESSAGES[] = {
+        "{\"id\":\"1\",\"action\":\"restart\"}",
+        "{\"id\":\"2\",\"action\":\"sleep\",\"args\":{\"seconds\":300}}",
+        "{\"id\":\"3\",\"action\":\"set_config\",\"args\":{\"user_id\":3,\"zone_id\":7},\"from\":\"dashboard\"}",
+        "{\"id\":\"4\",\"action\":\"set_time\",\"args\":{\"epoch\":1735732800,\"tz\":\"CET\"}}",
+        "{\"id\":\"5\",\"action\":\"start_pomodoro\",\"args\":{\"minutes\":25}}",
+    };
+    const size_t N      = sizeof(MESSAGES) / sizeof(MESSAGES[0]);
+    const int    ROUNDS = 20000;
+
+    CountingAllocator counter;
+    JsonDocument      legacyDoc(&counter);
+    Clock::time_point t0 = Clock::now();
+    for (int i = 0; i < ROUNDS; i++) legacyDispatch(legacyDoc, MESSAGES[i % N]);
+    double legacyNs = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / ROUNDS;
+    double legacyAllocs = (double)counter.count / ROUNDS;
+
+    BenchDispatcher d;
+    TEST_ASSERT_TRUE(d.begin(TABLE, TABLE_SIZE));
+    uint32_t poolBefore = d.pool().allocations();
+    t0 = Clock::now();
+    for (int i = 0; i < ROUNDS; i++) {
+        const char* m = MESSAGES[i % N];
+        d.submit((const uint8_t*)m, strlen(m), 0);
+        d.runPending(nullptr, nullptr, nowUs);
+    }
+    double tableNs = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / ROUNDS;
+    double poolAllocs = (double)(d.pool().allocations() - poolBefore) / ROUNDS;
+
+    printf("%-22s %10s %14s\n", "path", "ns/msg", "heap allocs/msg");
+    printf("%-22s %10.0f %14.2f\n", "heap doc + strcmp", legacyNs, legacyAllocs);
+    printf("%-22s %10.0f %14.2f  (%.2f from the fixed pool, peak %u bytes)\n", "filtered + perfect hash", tableNs,
+           0.0, poolAllocs, (unsigned)d.pool().highWater());
+
+    TEST_ASSERT_EQUAL(0, d.pool().failures());
+    TEST_ASSERT_EQUAL((uint32_t)ROUNDS, d.stats().executed);
+    TEST_ASSERT_TRUE(legacyAllocs > 0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_typed_arguments_reach_the_handler);
+    RUN_TEST(test_errors_get_a_reply_without_running);
+    RUN_TEST(test_correlation_id_is_sanitized);
+    RUN_TEST(test_unknown_fields_do_not_use_the_pool);
+    RUN_TEST(test_msgpack_commands);
+    RUN_TEST(test_full_queue_drops);
+    RUN_TEST(test_bench_dispatch_latency_and_allocations);
+
+    return UNITY_END();
+}
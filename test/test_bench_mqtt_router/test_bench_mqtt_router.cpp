@@ -0,0 +1,229 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include "../../lib/core/mqtt_topic_router.h"
+
+// Host benchmark: run with `pio test -e native -f test_bench_mqtt_router -v`
+// Routes a synthetic topic set against a few hundred filters and checks every
+// result against the reference matcher.
+
+typedef MqttTopicRouter<512, 4096, 32768> BenchRouter;
+
+static BenchRouter router;
+static std::vector<std::string> filters;
+static std::vector<std::string> topics;
+static std::vector<size_t> hits;
+
+static MqttMessageView view(const char* topic) {
+    MqttMessageView v = { topic, "", 0, 0, false, false };
+    return v;
+}
+
+// Deterministic xorshift so the data set is the same on every run
+static uint32_t rng = 2463534242UL;
+static uint32_t nextRandom() {
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    return rng;
+}
+
+static const char* const SITES[]   = { "home", "office", "garage", "lab" };
+static const char* const ROOMS[]   = { "kitchen", "living", "bed1", "bed2", "bath", "hall", "attic", "cellar" };
+static const char* const DEVICES[] = { "temp", "hum", "co2", "lux", "motion", "door", "plug", "lamp", "fan", "valve" };
+static const char* const LEAVES[]  = { "state", "set", "config", "battery" };
+
+#define PICK(a) a[nextRandom() % (sizeof(a) / sizeof(a[0]))]
+
+static void buildDataSet() {
+    if (!filters.empty()) return;
+
+    // Mostly exact filters, with the wildcard shapes real dashboards use
+    for (int i = 0; i < 300; i++) {
+        std::string f;
+        switch (nextRandom() % 6) {
+            case 0:  f = std::string(PICK(SITES)) + "/+/" + PICK(DEVICES) + "/state"; break;
+            case 1:  f = std::string(PICK(SITES)) + "/" + PICK(ROOMS) + "/#"; break;
+            case 2:  f = std::string("+/+/") + PICK(DEVICES) + "/" + PICK(LEAVES); break;
+            default: f = std::string(PICK(SITES)) + "/" + PICK(ROOMS) + "/" + PICK(DEVICES) + "/" + PICK(LEAVES); break;
+        }
+        filters.push_back(f);
+    }
+    filters.push_back("#");
+    filters.push_back("$SYS/#");
+
+    for (int i = 0; i < 20000; i++) {
+        std::string t = std::string(PICK(SITES)) + "/" + PICK(ROOMS) + "/" + PICK(DEVICES) + "/" + PICK(LEAVES);
+        if (i % 97 == 0) t = "$SYS/broker/load";
+        topics.push_back(t);
+    }
+
+    hits.assign(filters.size(), 0);
+    for (size_t i = 0; i < filters.size(); i++) {
+        size_t* counter = &hits[i];
+        router.subscribe(filters[i].c_str(), 0, [counter](const MqttMessageView&) { (*counter)++; });
+    }
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_reference_matcher() {
+    TEST_ASSERT_TRUE(mqttTopicMatches("a/+/c", "a/b/c"));
+    TEST_ASSERT_FALSE(mqttTopicMatches("a/+/c", "a/b/d"));
+    TEST_ASSERT_TRUE(mqttTopicMatches("a/#", "a"));
+    TEST_ASSERT_TRUE(mqttTopicMatches("a/#", "a/b/c"));
+    TEST_ASSERT_TRUE(mqttTopicMatches("+", "a"));
+    TEST_ASSERT_FALSE(mqttTopicMatches("+", "a/b"));
+    TEST_ASSERT_TRUE(mqttTopicMatches("a/+", "a/"));
+    TEST_ASSERT_FALSE(mqttTopicMatches("#", "$SYS/x"));
+    TEST_ASSERT_TRUE(mqttTopicMatches("$SYS/#", "$SYS/x"));
+}
+
+void test_filter_validation() {
+    TEST_ASSERT_TRUE(mqttFilterIsValid("a/+/#"));
+    TEST_ASSERT_FALSE(mqttFilterIsValid("a/#/b"));
+    TEST_ASSERT_FALSE(mqttFilterIsValid("a/b+"));
+    TEST_ASSERT_FALSE(mqttFilterIsValid("a#"));
+    TEST_ASSERT_FALSE(mqttFilterIsValid(""));
+}
+
+void test_router_semantics() {
+    MqttTopicRouter<8, 32, 256> r;
+    int exact = 0, plus = 0, multi = 0, all = 0;
+    r.subscribe("a/b", 0, [&exact](const MqttMessageView&) { exact++; });
+    r.subscribe("a/+", 0, [&plus](const MqttMessageView&) { plus++; });
+    r.subscribe("a/#", 0, [&multi](const MqttMessageView&) { multi++; });
+    r.subscribe("#", 0, [&all](const MqttMessageView&) { all++; });
+
+    TEST_ASSERT_EQUAL(4, r.dispatch(view("a/b")));
+    TEST_ASSERT_EQUAL(2, r.dispatch(view("a")));      // "a/#" and "#"
+    TEST_ASSERT_EQUAL(2, r.dispatch(view("a/b/c")));  // "a/#" and "#"
+    TEST_ASSERT_EQUAL(0, r.dispatch(view("$SYS/a")));
+    TEST_ASSERT_EQUAL(1, exact);
+    TEST_ASSERT_EQUAL(1, plus);
+    TEST_ASSERT_EQUAL(3, multi);
+    TEST_ASSERT_EQUAL(3, all);
+
+    TEST_ASSERT_EQUAL(1, r.unsubscribe("a/#"));
+    TEST_ASSERT_EQUAL(1, r.dispatch(view("a/b/c")));
+}
+
+void test_restore_list_is_deduplicated() {
+    MqttTopicRouter<8, 32, 256> r;
+    r.subscribe("x/+", 0, nullptr);
+    r.subscribe("x/+", 0, nullptr);  // plain subscribe repeated on every connect
+    r.subscribe("x/+", 1, [](const MqttMessageView&) {});
+    r.subscribe("y", 0, [](const MqttMessageView&) {});
+    TEST_ASSERT_EQUAL(3, r.subscriptionCount());
+
+    int count = 0;
+    uint8_t qosX = 0;
+    r.forEachFilter([&](const char* f, uint8_t qos) {
+        count++;
+        if (strcmp(f, "x/+") == 0) qosX = qos;
+    });
+    TEST_ASSERT_EQUAL(2, count);
+    TEST_ASSERT_EQUAL(1, qosX);
+}
+
+void test_capacity_is_bounded() {
+    MqttTopicRouter<2, 4, 64> r;
+    TEST_ASSERT_TRUE(r.subscribe("a/b", 0, nullptr));
+    TEST_ASSERT_FALSE(r.subscribe("c/d/e/f", 0, nullptr));  // out of nodes
+    TEST_ASSERT_TRUE(r.subscribe("a", 0, nullptr));
+    TEST_ASSERT_FALSE(r.subscribe("a/+", 0, nullptr));      // out of subscriptions
+    TEST_ASSERT_FALSE(r.subscribe("a/#/b", 0, nullptr));    // invalid
+}
+
+// Far more cycles than the pool could hold if unsubscribe kept the strings
+void test_subscribe_unsubscribe_cycles_reuse_space() {
+    MqttTopicRouter<4, 16, 64> r;
+    int hits = 0;
+    r.subscribe("keep/+", 0, [&hits](const MqttMessageView&) { hits++; });
+    size_t baseline = r.poolUsed();
+
+    for (int i = 0; i < 500; i++) {
+        const char* f = (i % 2) ? "dev/one/cmd" : "dev/two/#";
+        TEST_ASSERT_TRUE(r.subscribe(f, 0, [](const MqttMessageView&) {}));
+        TEST_ASSERT_TRUE(r.subscribe(f, 1, [](const MqttMessageView&) {}));   // same string shared
+        TEST_ASSERT_EQUAL(2, r.unsubscribe(f));
+    }
+    TEST_ASSERT_EQUAL(baseline + strlen("dev") + strlen("one") + strlen("cmd") + strlen("two") + 4,
+                      r.poolUsed());   // only the trie tokens stay
+    TEST_ASSERT_EQUAL(1, r.subscriptionCount());
+    TEST_ASSERT_EQUAL(1, r.dispatch(view("keep/x")));
+    TEST_ASSERT_EQUAL(1, hits);
+    TEST_ASSERT_TRUE(r.contains("keep/+"));
+}
+
+// A handler removing its own subscription while the message is routed
+void test_unsubscribe_from_a_handler() {
+    MqttTopicRouter<4, 16, 128> r;
+    int once = 0, other = 0;
+    r.subscribe("a/b", 0, [&](const MqttMessageView&) { once++; r.unsubscribe("a/b"); });
+    r.subscribe("a/+", 0, [&other](const MqttMessageView&) { other++; });
+    r.subscribe("z", 0, nullptr);
+
+    TEST_ASSERT_EQUAL(2, r.dispatch(view("a/b")));
+    TEST_ASSERT_EQUAL(1, r.dispatch(view("a/b")));
+    TEST_ASSERT_EQUAL(1, once);
+    TEST_ASSERT_EQUAL(2, other);
+    TEST_ASSERT_EQUAL(2, r.subscriptionCount());
+    TEST_ASSERT_TRUE(r.contains("z"));
+    TEST_ASSERT_TRUE(r.subscribe("a/b", 0, nullptr));
+    TEST_ASSERT_EQUAL(2, r.dispatch(view("a/b")));
+}
+
+void test_bench_matches_reference() {
+    buildDataSet();
+    for (size_t i = 0; i < topics.size(); i += 7) {
+        size_t expected = 0;
+        for (size_t f = 0; f < filters.size(); f++) {
+            if (mqttTopicMatches(filters[f].c_str(), topics[i].c_str())) expected++;
+        }
+        TEST_ASSERT_EQUAL(expected, router.dispatch(view(topics[i].c_str())));
+    }
+}
+
+void test_bench_routing_throughput() {
+    buildDataSet();
+    typedef std::chrono::steady_clock Clock;
+
+    size_t routed = 0;
+    Clock::time_point t0 = Clock::now();
+    for (size_t i = 0; i < topics.size(); i++) routed += router.dispatch(view(topics[i].c_str()));
+    double trieNs = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+
+    size_t linear = 0;
+    t0 = Clock::now();
+    for (size_t i = 0; i < topics.size(); i++) {
+        for (size_t f = 0; f < filters.size(); f++) {
+            if (mqttTopicMatches(filters[f].c_str(), topics[i].c_str())) linear++;
+        }
+    }
+    double linearNs = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+
+    printf("filters=%u topics=%u nodes=%u pool=%u\n", (unsigned)filters.size(), (unsigned)topics.size(),
+           (unsigned)router.nodeCount(), (unsigned)router.poolUsed());
+    printf("trie   %8.1f ns/topic\n", trieNs / topics.size());
+    printf("linear %8.1f ns/topic\n", linearNs / topics.size());
+
+    TEST_ASSERT_EQUAL(linear, routed);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_reference_matcher);
+    RUN_TEST(test_filter_validation);
+    RUN_TEST(test_router_semantics);
+    RUN_TEST(test_restore_list_is_deduplicated);
+    RUN_TEST(test_capacity_is_bounded);
+    RUN_TEST(test_subscribe_unsubscribe_cycles_reuse_space);
+    RUN_TEST(test_unsubscribe_from_a_handler);
+    RUN_TEST(test_bench_matches_reference);
+    RUN_TEST(test_bench_routing_throughput);
+
+    return UNITY_END();
+}
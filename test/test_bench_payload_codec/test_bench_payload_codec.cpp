@@ -0,0 +1,116 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <ArduinoJson.h>
+#include "../../lib/core/payload_codec.h"
+
+// Host benchmark: run with `pio test -e native -f test_bench_payload_codec -v`
+// Payload size and encode/decode time of JSON, MessagePack and CBOR for the
+// documents this firmware actually publishes.
+
+static const char* const BATTERY_DOC =
+    "{\"device_id\":\"24:0A:C4:12:34:56\",\"level\":87,\"voltage\":4012,\"current\":-120,"
+    "\"charging\":false,\"ts\":1735732800}";
+
+static const char* const STATUS_DOC =
+    "{\"device_id\":\"24:0A:C4:12:34:56\",\"uptime\":123456,\"rssi\":-67,\"page\":\"clock\","
+    "\"wifi\":true,\"heap\":{\"free\":123456,\"largest\":65536},\"fw\":\"1.4.2\",\"temp\":23.5}";
+
+static const char* const BATCH_DOC =
+    "{\"t0\":1735732800,\"s\":[[0,0,23.5],[1000,1,40],[2000,0,23.6],[3000,1,41],[4000,0,23.7],"
+    "[5000,1,41],[6000,0,23.8],[7000,1,42]],\"k\":[\"temp\",\"hum\"]}";
+
+static const PayloadEncoding ENCODINGS[] = { PAYLOAD_JSON, PAYLOAD_MSGPACK, PAYLOAD_CBOR };
+
+static uint8_t out[1024];
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void loadDoc(JsonDocument& doc, const char* json) {
+    TEST_ASSERT_FALSE(deserializeJson(doc, json));
+}
+
+// Decoding any encoding gives back the same document
+static void checkRoundTrip(const char* json) {
+    JsonDocument src;
+    loadDoc(src, json);
+    char expected[512];
+    serializeJson(src, expected, sizeof(expected));
+
+    for (size_t e = 0; e < 3; e++) {
+        size_t len = encodePayload(src, ENCODINGS[e], out, sizeof(out));
+        TEST_ASSERT_TRUE(len > 0);
+        TEST_ASSERT_EQUAL(measurePayload(src, ENCODINGS[e]), len);
+        TEST_ASSERT_EQUAL(ENCODINGS[e], detectPayloadEncoding(out, len));
+
+        JsonDocument back;
+        TEST_ASSERT_FALSE(deserializePayload(back, out, len));
+        char actual[512];
+        serializeJson(back, actual, sizeof(actual));
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+    }
+}
+
+void test_round_trip_battery()  { checkRoundTrip(BATTERY_DOC); }
+void test_round_trip_status()   { checkRoundTrip(STATUS_DOC); }
+void test_round_trip_batch()    { checkRoundTrip(BATCH_DOC); }
+
+void test_unmarked_payload_is_json() {
+    JsonDocument doc;
+    const char* legacy = "{\"command\":\"sleep\"}";
+    TEST_ASSERT_FALSE(deserializePayload(doc, (const uint8_t*)legacy, strlen(legacy)));
+    TEST_ASSERT_EQUAL_STRING("sleep", doc["command"].as<const char*>());
+}
+
+void test_encode_refuses_small_buffer() {
+    JsonDocument doc;
+    loadDoc(doc, STATUS_DOC);
+    for (size_t e = 0; e < 3; e++) {
+        TEST_ASSERT_EQUAL(0, encodePayload(doc, ENCODINGS[e], out, 16));
+    }
+}
+
+void test_bench_size_and_speed() {
+    typedef std::chrono::steady_clock Clock;
+    static const char* const DOCS[]  = { BATTERY_DOC, STATUS_DOC, BATCH_DOC };
+    static const char* const NAMES[] = { "battery", "status", "batch" };
+    const int ROUNDS = 20000;
+
+    printf("%-8s %-8s %6s %10s %10s\n", "doc", "encoding", "bytes", "enc ns", "dec ns");
+    for (size_t d = 0; d < 3; d++) {
+        JsonDocument src;
+        loadDoc(src, DOCS[d]);
+        size_t jsonSize = measureJson(src);
+
+        for (size_t e = 0; e < 3; e++) {
+            size_t len = 0;
+            Clock::time_point t0 = Clock::now();
+            for (int i = 0; i < ROUNDS; i++) len = encodePayload(src, ENCODINGS[e], out, sizeof(out));
+            double encNs = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / ROUNDS;
+
+            JsonDocument back;
+            t0 = Clock::now();
+            for (int i = 0; i < ROUNDS; i++) deserializePayload(back, out, len);
+            double decNs = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / ROUNDS;
+
+            printf("%-8s %-8s %6u %10.0f %10.0f  (%3.0f%% of json)\n", NAMES[d], payloadEncodingName(ENCODINGS[e]),
+                   (unsigned)len, encNs, decNs, 100.0 * len / jsonSize);
+            if (ENCODINGS[e] != PAYLOAD_JSON) TEST_ASSERT_TRUE(len < jsonSize);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_round_trip_battery);
+    RUN_TEST(test_round_trip_status);
+    RUN_TEST(test_round_trip_batch);
+    RUN_TEST(test_unmarked_payload_is_json);
+    RUN_TEST(test_encode_refuses_small_buffer);
+    RUN_TEST(test_bench_size_and_speed);
+
+    return UNITY_END();
+}
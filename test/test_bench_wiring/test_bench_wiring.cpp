@@ -0,0 +1,113 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+
+// Host benchmark: run with `pio test -e native -f test_bench_wiring -v`
+// Call overhead of the two wirings on the pattern the adapters use: a
+// consumer holding pointers to its dependencies and calling small getters
+// (battery level, charging flag, RTC epoch) on every sample. Virtual: the
+// pointers are the port interfaces. Static (-DSTATIC_WIRING): they are the
+// final adapter classes, so the calls are direct and get inlined.
+// Flash and RAM of the two firmware builds: tools/wiring_size.sh.
+
+class IBattery {
+public:
+    virtual ~IBattery() = default;
+    virtual int32_t getLevel()   = 0;
+    virtual bool    isCharging() = 0;
+};
+
+class IRtc {
+public:
+    virtual ~IRtc() = default;
+    virtual uint32_t epochNow() = 0;
+};
+
+class BatteryAdapter final : public IBattery {
+public:
+    BatteryAdapter() : _level(87), _charging(false) {}
+    int32_t getLevel() override   { return _level; }
+    bool    isCharging() override { return _charging; }
+
+private:
+    int32_t _level;
+    bool    _charging;
+};
+
+class RtcAdapter final : public IRtc {
+public:
+    RtcAdapter() : _epoch(1735732800) {}
+    uint32_t epochNow() override { return ++_epoch; }
+
+private:
+    uint32_t _epoch;
+};
+
+template <typename Battery, typename Rtc>
+class Sampler {
+public:
+    Sampler(Battery* battery, Rtc* rtc) : _battery(battery), _rtc(rtc) {}
+
+    uint64_t sample() {
+        uint64_t acc = _rtc->epochNow();
+        if (!_battery->isCharging()) acc += (uint32_t)_battery->getLevel();
+        return acc;
+    }
+
+private:
+    Battery* _battery;
+    Rtc*     _rtc;
+};
+
+static const uint32_t CALLS = 20000000;
+
+// Hides the dynamic type from the optimizer, as factories returning
+// interface pointers do
+template <typename T>
+static T* opaque(T* p) {
+    T* volatile v = p;
+    return v;
+}
+
+template <typename S>
+static double nsPerSample(S& sampler, uint64_t& checksum) {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point t0 = Clock::now();
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < CALLS; i++) acc += sampler.sample();
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+    checksum = acc;
+    return ns / CALLS;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_bench_virtual_vs_static_calls() {
+    BatteryAdapter battery1, battery2;
+    RtcAdapter     rtc1, rtc2;
+
+    Sampler<IBattery, IRtc> viaPorts(opaque<IBattery>(&battery1), opaque<IRtc>(&rtc1));
+    Sampler<BatteryAdapter, RtcAdapter> viaAdapters(opaque(&battery2), opaque(&rtc2));
+
+    uint64_t virtualSum = 0, staticSum = 0;
+    double virtualNs = nsPerSample(viaPorts, virtualSum);
+    double staticNs  = nsPerSample(viaAdapters, staticSum);
+
+    printf("samples=%u, 3 calls each\n", (unsigned)CALLS);
+    printf("virtual %6.2f ns/sample\n", virtualNs);
+    printf("static  %6.2f ns/sample\n", staticNs);
+    printf("object sizes: battery %u, rtc %u bytes (vtable pointer included in both builds)\n",
+           (unsigned)sizeof(BatteryAdapter), (unsigned)sizeof(RtcAdapter));
+
+    TEST_ASSERT_TRUE(virtualSum == staticSum);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_bench_virtual_vs_static_calls);
+
+    return UNITY_END();
+}
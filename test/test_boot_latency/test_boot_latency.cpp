@@ -0,0 +1,70 @@
+#include <unity.h>
+#include <string.h>
+#include "../../lib/core/boot_latency.h"
+
+// Run with `pio test -e native -f test_boot_latency`
+
+static BootLatencyTable table;
+
+void setUp(void) {
+    table.clear();
+}
+
+void tearDown(void) {}
+
+void test_stats_per_cause_and_mark() {
+    table.record(BOOT_TIMER, BOOT_MARK_ALARM, 42000);
+    table.record(BOOT_TIMER, BOOT_MARK_ALARM, 38000);
+    table.record(BOOT_TIMER, BOOT_MARK_ALARM, 46000);
+    table.record(BOOT_COLD, BOOT_MARK_UI, 610000);
+
+    const BootLatencyStat& alarm = table.get(BOOT_TIMER, BOOT_MARK_ALARM);
+    TEST_ASSERT_EQUAL_UINT32(3, alarm.count);
+    TEST_ASSERT_EQUAL_UINT32(46000, alarm.lastUs);
+    TEST_ASSERT_EQUAL_UINT32(38000, alarm.minUs);
+    TEST_ASSERT_EQUAL_UINT32(46000, alarm.maxUs);
+    TEST_ASSERT_EQUAL_UINT32(42000, alarm.meanUs());
+
+    TEST_ASSERT_EQUAL_UINT32(1, table.get(BOOT_COLD, BOOT_MARK_UI).count);
+    TEST_ASSERT_EQUAL_UINT32(0, table.get(BOOT_TIMER, BOOT_MARK_UI).count);
+    TEST_ASSERT_EQUAL_UINT32(0, table.get(BOOT_BUTTON, BOOT_MARK_UI).meanUs());
+}
+
+void test_out_of_range_is_ignored() {
+    table.record(BOOT_CAUSE_COUNT, BOOT_MARK_UI, 1);
+    table.record(BOOT_COLD, BOOT_MARK_COUNT, 1);
+    for (uint8_t c = 0; c < BOOT_CAUSE_COUNT; c++) {
+        for (uint8_t m = 0; m < BOOT_MARK_COUNT; m++) TEST_ASSERT_EQUAL_UINT32(0, table.get(c, m).count);
+    }
+}
+
+void test_row_format() {
+    table.record(BOOT_TIMER, BOOT_MARK_ALARM, 41500);
+    char line[96];
+    size_t n = bootFormatLatencyRow(table, BOOT_TIMER, BOOT_MARK_ALARM, line, sizeof(line));
+    TEST_ASSERT_EQUAL(strlen(line), n);
+    TEST_ASSERT_NOT_NULL(strstr(line, "timer"));
+    TEST_ASSERT_NOT_NULL(strstr(line, "alarm"));
+    TEST_ASSERT_NOT_NULL(strstr(line, "41.5"));
+
+    // Every field at its maximum still fits the row
+    table.record(BOOT_BUTTON, BOOT_MARK_UI, 0xFFFFFFFF);
+    char full[BOOT_LATENCY_ROW_MAX];
+    n = bootFormatLatencyRow(table, BOOT_BUTTON, BOOT_MARK_UI, full, sizeof(full));
+    TEST_ASSERT_TRUE(n < sizeof(full) - 1);
+    TEST_ASSERT_NOT_NULL(strstr(full, "4294967.3 ms"));
+
+    char small[8];
+    n = bootFormatLatencyRow(table, BOOT_TIMER, BOOT_MARK_ALARM, small, sizeof(small));
+    TEST_ASSERT_EQUAL(7, n);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_stats_per_cause_and_mark);
+    RUN_TEST(test_out_of_range_is_ignored);
+    RUN_TEST(test_row_format);
+
+    return UNITY_END();
+}
@@ -0,0 +1,116 @@
+#include <unity.h>
+#include <string.h>
+#include <math.h>
+#include "../../lib/core/cbor.h"
+
+// Run with `pio test -e native -f test_cbor`
+// Expected bytes come from RFC 8949 appendix A.
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static uint8_t buf[64];
+
+void test_integer_heads() {
+    CborWriter w(buf, sizeof(buf));
+    w.writeInt(0);
+    w.writeInt(23);
+    w.writeInt(24);
+    w.writeInt(1000);
+    w.writeInt(-1);
+    w.writeInt(-1000);
+    w.writeUInt(1000000);
+    const uint8_t expected[] = { 0x00, 0x17, 0x18, 0x18, 0x19, 0x03, 0xE8, 0x20, 0x39, 0x03, 0xE7,
+                                 0x1A, 0x00, 0x0F, 0x42, 0x40 };
+    TEST_ASSERT_EQUAL(sizeof(expected), w.size());
+    TEST_ASSERT_EQUAL_MEMORY(expected, buf, sizeof(expected));
+}
+
+void test_floats_use_single_precision_when_lossless() {
+    CborWriter w(buf, sizeof(buf));
+    w.writeFloat(100000.0);
+    w.writeFloat(1.1);
+    const uint8_t single[] = { 0xFA, 0x47, 0xC3, 0x50, 0x00 };
+    const uint8_t dbl[]    = { 0xFB, 0x3F, 0xF1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9A };
+    TEST_ASSERT_EQUAL(14, w.size());
+    TEST_ASSERT_EQUAL_MEMORY(single, buf, sizeof(single));
+    TEST_ASSERT_EQUAL_MEMORY(dbl, buf + 5, sizeof(dbl));
+}
+
+void test_document_round_trip() {
+    // {"level":87,"charging":true,"v":[4.1,-2],"name":"stick"}
+    CborWriter w(buf, sizeof(buf));
+    w.writeMap(4);
+    w.writeString("level", 5);    w.writeInt(87);
+    w.writeString("charging", 8); w.writeBool(true);
+    w.writeString("v", 1);        w.writeArray(2); w.writeFloat(4.25); w.writeInt(-2);
+    w.writeString("name", 4);     w.writeString("stick", 5);
+    TEST_ASSERT_FALSE(w.overflowed());
+
+    CborReader r(buf, w.size());
+    CborItem it;
+    TEST_ASSERT_TRUE(r.next(it)); TEST_ASSERT_EQUAL(CBOR_MAP, it.type); TEST_ASSERT_EQUAL(4, it.count);
+    TEST_ASSERT_TRUE(r.next(it)); TEST_ASSERT_EQUAL(CBOR_TEXT, it.type); TEST_ASSERT_EQUAL_MEMORY("level", it.str, 5);
+    TEST_ASSERT_TRUE(r.next(it)); TEST_ASSERT_EQUAL(CBOR_UINT, it.type); TEST_ASSERT_EQUAL(87, it.u);
+    TEST_ASSERT_TRUE(r.next(it)); TEST_ASSERT_EQUAL(CBOR_TEXT, it.type);
+    TEST_ASSERT_TRUE(r.next(it)); TEST_ASSERT_EQUAL(CBOR_BOOL, it.type); TEST_ASSERT_EQUAL(1, it.u);
+    TEST_ASSERT_TRUE(r.next(it)); TEST_ASSERT_EQUAL(CBOR_TEXT, it.type);
+    TEST_ASSERT_TRUE(r.next(it)); TEST_ASSERT_EQUAL(CBOR_ARRAY, it.type); TEST_ASSERT_EQUAL(2, it.count);
+    TEST_ASSERT_TRUE(r.next(it)); TEST_ASSERT_EQUAL(CBOR_FLOAT, it.type); TEST_ASSERT_DOUBLE_WITHIN(1e-9, 4.25, it.f);
+    TEST_ASSERT_TRUE(r.next(it)); TEST_ASSERT_EQUAL(CBOR_NEGINT, it.type); TEST_ASSERT_EQUAL(-2, (int)it.i);
+    TEST_ASSERT_TRUE(r.next(it)); TEST_ASSERT_EQUAL(CBOR_TEXT, it.type);
+    TEST_ASSERT_TRUE(r.next(it)); TEST_ASSERT_EQUAL(CBOR_TEXT, it.type); TEST_ASSERT_EQUAL_MEMORY("stick", it.str, 5);
+    TEST_ASSERT_TRUE(r.atEnd());
+    TEST_ASSERT_FALSE(r.next(it));
+}
+
+void test_reads_half_floats_and_tags() {
+    // 1.5 as half, tag 1 (epoch) + 1363896240, null, undefined
+    const uint8_t data[] = { 0xF9, 0x3E, 0x00, 0xC1, 0x1A, 0x51, 0x4B, 0x67, 0xB0, 0xF6, 0xF7,
+                             0xF9, 0x7C, 0x00 };
+    CborReader r(data, sizeof(data));
+    CborItem it;
+    TEST_ASSERT_TRUE(r.next(it)); TEST_ASSERT_EQUAL(CBOR_FLOAT, it.type); TEST_ASSERT_DOUBLE_WITHIN(1e-9, 1.5, it.f);
+    TEST_ASSERT_TRUE(r.next(it)); TEST_ASSERT_EQUAL(CBOR_UINT, it.type); TEST_ASSERT_EQUAL(1363896240UL, (unsigned long)it.u);
+    TEST_ASSERT_TRUE(r.next(it)); TEST_ASSERT_EQUAL(CBOR_NULL, it.type);
+    TEST_ASSERT_TRUE(r.next(it)); TEST_ASSERT_EQUAL(CBOR_NULL, it.type);
+    TEST_ASSERT_TRUE(r.next(it)); TEST_ASSERT_TRUE(isinf(it.f));
+}
+
+void test_rejects_malformed_input() {
+    CborItem it;
+    const uint8_t truncatedText[] = { 0x65, 'a', 'b' };
+    const uint8_t indefinite[]    = { 0x9F, 0x01, 0xFF };
+    const uint8_t hugeArray[]     = { 0x9B, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00 };
+    const uint8_t truncatedInt[]  = { 0x1A, 0x00, 0x01 };
+
+    CborReader a(truncatedText, sizeof(truncatedText)); TEST_ASSERT_FALSE(a.next(it));
+    CborReader b(indefinite, sizeof(indefinite));       TEST_ASSERT_FALSE(b.next(it));
+    CborReader c(hugeArray, sizeof(hugeArray));         TEST_ASSERT_FALSE(c.next(it));
+    CborReader d(truncatedInt, sizeof(truncatedInt));   TEST_ASSERT_FALSE(d.next(it));
+}
+
+void test_measure_and_overflow() {
+    CborWriter measure(nullptr, 0);
+    measure.writeString("0123456789", 10);
+    TEST_ASSERT_EQUAL(11, measure.size());
+    TEST_ASSERT_FALSE(measure.overflowed());
+
+    uint8_t small[4];
+    CborWriter w(small, sizeof(small));
+    w.writeString("0123456789", 10);
+    TEST_ASSERT_TRUE(w.overflowed());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_integer_heads);
+    RUN_TEST(test_floats_use_single_precision_when_lossless);
+    RUN_TEST(test_document_round_trip);
+    RUN_TEST(test_reads_half_floats_and_tags);
+    RUN_TEST(test_rejects_malformed_input);
+    RUN_TEST(test_measure_and_overflow);
+
+    return UNITY_END();
+}
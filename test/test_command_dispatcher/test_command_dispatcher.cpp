@@ -0,0 +1,160 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <ArduinoJson.h>
+#include "../../lib/core/command_dispatcher.h"
+
+// Run with `pio test -e native -f test_command_dispatcher`
+
+static int32_t lastLevel;
+static float   lastGain;
+static bool    lastMuted;
+static char    lastName[CMD_TEXT_MAX];
+static int     handled;
+
+static CommandResult onSet(const CommandArgs& a) {
+    handled++;
+    lastLevel = a.getInt(0);
+    lastGain  = a.getFloat(1, 1.0f);
+    lastMuted = a.getBool(2);
+    snprintf(lastName, sizeof(lastName), "%s", a.getString(3, "none"));
+    return CommandResult::ok();
+}
+
+static CommandResult onBusy(const CommandArgs&) {
+    handled++;
+    return CommandResult::fail("busy");
+}
+
+static const CommandSpec TABLE[] = {
+    { "set",  onSet,  { { "level", CMD_ARG_INT, true }, { "gain", CMD_ARG_FLOAT, false },
+                        { "muted", CMD_ARG_BOOL, false }, { "name", CMD_ARG_STRING, false } } },
+    { "busy", onBusy, {} },
+};
+static const size_t TABLE_SIZE = sizeof(TABLE) / sizeof(TABLE[0]);
+
+// 64-bit hosts use a larger slot pool than the device
+typedef CommandDispatcher<8, 4, 4096> TestDispatcher;
+
+static TestDispatcher* dispatcher;
+
+static uint32_t fakeNow;
+static uint32_t nowUs() { return fakeNow; }
+
+// Same fields as the reply the adapter publishes
+static char replies[4][96];
+static int  replyCount;
+static void captureReply(void*, const CommandJob& job, const CommandSpec* spec, const CommandResult& r) {
+    if (replyCount >= 4) return;
+    snprintf(replies[replyCount++], sizeof(replies[0]), "%s|%s|%s|%s", job.id, spec ? spec->name : "",
+             commandStatusName(r.status), r.detail ? r.detail : "");
+}
+
+static CommandStatus submit(const char* json) {
+    return dispatcher->submit((const uint8_t*)json, strlen(json), fakeNow);
+}
+
+void setUp(void) {
+    dispatcher = new TestDispatcher();
+    TEST_ASSERT_TRUE(dispatcher->begin(TABLE, TABLE_SIZE));
+    handled     = 0;
+    replyCount  = 0;
+    fakeNow     = 1000;
+    lastName[0] = '\0';
+}
+
+void tearDown(void) {
+    delete dispatcher;
+}
+
+void test_parses_every_argument_type() {
+    TEST_ASSERT_EQUAL(CMD_OK, submit("{\"id\":\"7\",\"action\":\"set\",\"args\":"
+                                     "{\"level\":-3,\"gain\":0.5,\"muted\":true,\"name\":\"desk\"}}"));
+    TEST_ASSERT_EQUAL(0, handled);   // queued, not run on the receiving task
+    TEST_ASSERT_EQUAL(1, dispatcher->pending());
+
+    fakeNow = 1250;
+    TEST_ASSERT_EQUAL(1, dispatcher->runPending(captureReply, nullptr, nowUs));
+    TEST_ASSERT_EQUAL(1, handled);
+    TEST_ASSERT_EQUAL(-3, lastLevel);
+    TEST_ASSERT_EQUAL_FLOAT(0.5f, lastGain);
+    TEST_ASSERT_TRUE(lastMuted);
+    TEST_ASSERT_EQUAL_STRING("desk", lastName);
+    TEST_ASSERT_EQUAL(250, dispatcher->stats().lastLatencyUs);
+}
+
+void test_optional_arguments_take_defaults() {
+    submit("{\"action\":\"set\",\"args\":{\"level\":4}}");
+    dispatcher->runPending(captureReply, nullptr, nowUs);
+    TEST_ASSERT_EQUAL(4, lastLevel);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, lastGain);
+    TEST_ASSERT_FALSE(lastMuted);
+    TEST_ASSERT_EQUAL_STRING("none", lastName);
+    TEST_ASSERT_EQUAL_STRING("|set|ok|", replies[0]);
+}
+
+void test_argument_errors_are_answered_without_running() {
+    TEST_ASSERT_EQUAL(CMD_ERR_ARGS, submit("{\"id\":\"a\",\"action\":\"set\",\"args\":{\"gain\":2}}"));
+    TEST_ASSERT_EQUAL(CMD_ERR_ARGS, submit("{\"id\":\"b\",\"action\":\"set\",\"args\":{\"level\":\"high\"}}"));
+    TEST_ASSERT_EQUAL(CMD_ERR_ARGS, submit("{\"id\":\"c\",\"action\":\"set\",\"args\":{\"level\":1,\"muted\":1}}"));
+    TEST_ASSERT_EQUAL(CMD_ERR_ARGS, submit("{\"id\":\"d\",\"action\":\"set\",\"args\":{\"level\":1,\"name\":"
+                                           "\"0123456789012345678901234567890123456789012345678901234567890123\"}}"));
+
+    TEST_ASSERT_EQUAL(4, dispatcher->runPending(captureReply, nullptr, nowUs));
+    TEST_ASSERT_EQUAL(0, handled);
+    TEST_ASSERT_EQUAL_STRING("a|set|bad_args|", replies[0]);
+    TEST_ASSERT_EQUAL_STRING("d|set|bad_args|", replies[3]);
+    TEST_ASSERT_EQUAL(4, dispatcher->stats().badArgs);
+    TEST_ASSERT_EQUAL(0, dispatcher->stats().executed);
+}
+
+void test_parse_errors_and_unknown_actions() {
+    TEST_ASSERT_EQUAL(CMD_ERR_PARSE, submit("{\"id\":\"1\",\"action\":"));
+    TEST_ASSERT_EQUAL(CMD_ERR_PARSE, submit("{\"id\":\"2\"}"));
+    TEST_ASSERT_EQUAL(CMD_ERR_UNKNOWN, submit("{\"id\":\"3\",\"action\":\"reboot\"}"));
+    TEST_ASSERT_EQUAL(CMD_ERR_PARSE, submit("\xC1" "c\xA1\x66" "action\x63" "set"));   // CBOR, not accepted
+
+    dispatcher->runPending(captureReply, nullptr, nowUs);
+    TEST_ASSERT_EQUAL_STRING("||bad_payload|", replies[0]);   // no id before the document is read
+    TEST_ASSERT_EQUAL_STRING("2||bad_payload|", replies[1]);
+    TEST_ASSERT_EQUAL_STRING("3||unknown_command|", replies[2]);
+    TEST_ASSERT_EQUAL_STRING("||bad_payload|", replies[3]);
+    TEST_ASSERT_EQUAL(3, dispatcher->stats().parseErrors);
+    TEST_ASSERT_EQUAL(1, dispatcher->stats().unknown);
+}
+
+void test_handler_failure_reaches_the_reply() {
+    submit("{\"id\":\"x-1\",\"action\":\"busy\"}");
+    dispatcher->runPending(captureReply, nullptr, nowUs);
+    TEST_ASSERT_EQUAL(1, handled);
+    TEST_ASSERT_EQUAL_STRING("x-1|busy|failed|busy", replies[0]);
+    TEST_ASSERT_EQUAL(1, dispatcher->stats().failed);
+    TEST_ASSERT_EQUAL(1, dispatcher->stats().executed);
+}
+
+void test_replies_keep_the_submit_order() {
+    for (int i = 0; i < 5; i++) {
+        char json[48];
+        snprintf(json, sizeof(json), "{\"id\":\"%d\",\"action\":\"set\",\"args\":{\"level\":%d}}", i, i);
+        submit(json);
+    }
+    TEST_ASSERT_EQUAL(1, dispatcher->stats().dropped);   // depth 4
+    TEST_ASSERT_EQUAL(2, dispatcher->runPending(captureReply, nullptr, nowUs, 2));
+    TEST_ASSERT_EQUAL(2, dispatcher->runPending(captureReply, nullptr, nowUs));
+    TEST_ASSERT_EQUAL_STRING("0|set|ok|", replies[0]);
+    TEST_ASSERT_EQUAL_STRING("3|set|ok|", replies[3]);
+    TEST_ASSERT_EQUAL(3, lastLevel);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_parses_every_argument_type);
+    RUN_TEST(test_optional_arguments_take_defaults);
+    RUN_TEST(test_argument_errors_are_answered_without_running);
+    RUN_TEST(test_parse_errors_and_unknown_actions);
+    RUN_TEST(test_handler_failure_reaches_the_reply);
+    RUN_TEST(test_replies_keep_the_submit_order);
+
+    return UNITY_END();
+}
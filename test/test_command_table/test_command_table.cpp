@@ -0,0 +1,102 @@
+#include <unity.h>
+#include <string.h>
+#include "../../lib/core/command_table.h"
+
+// Run with `pio test -e native -f test_command_table`
+
+static CommandResult noop(const CommandArgs&) { return CommandResult::ok(); }
+
+static const CommandSpec TABLE[] = {
+    { "restart",        noop, {} },
+    { "sleep",          noop, { { "seconds", CMD_ARG_INT, false } } },
+    { "set_config",     noop, { { "user_id", CMD_ARG_INT, true }, { "zone_id", CMD_ARG_INT, true } } },
+    { "set_time",       noop, { { "epoch", CMD_ARG_INT, true }, { "tz", CMD_ARG_STRING, false } } },
+    { "start_pomodoro", noop, { { "minutes", CMD_ARG_INT, false } } },
+    { "set_brightness", noop, { { "level", CMD_ARG_INT, true } } },
+    { "page",           noop, { { "name", CMD_ARG_STRING, true } } },
+    { "beep",           noop, { { "freq", CMD_ARG_INT, false }, { "ms", CMD_ARG_INT, false } } },
+};
+static const size_t TABLE_SIZE = sizeof(TABLE) / sizeof(TABLE[0]);
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_hash_is_a_constant_expression() {
+    static_assert(cmdHash("sleep") != cmdHash("restart"), "distinct names hash apart");
+    switch (cmdHashN("sleep", 5)) {
+        case cmdHash("sleep"): break;
+        default: TEST_FAIL_MESSAGE("runtime and constexpr hashes differ");
+    }
+}
+
+void test_every_name_has_its_own_slot() {
+    CommandIndex<16> index;
+    TEST_ASSERT_TRUE(index.build(TABLE, TABLE_SIZE));
+    for (size_t i = 0; i < TABLE_SIZE; i++) {
+        TEST_ASSERT_EQUAL((int)i, index.find(TABLE[i].name));
+    }
+}
+
+void test_unknown_and_prefix_names_are_rejected() {
+    CommandIndex<16> index;
+    TEST_ASSERT_TRUE(index.build(TABLE, TABLE_SIZE));
+    TEST_ASSERT_EQUAL(-1, index.find("reboot"));
+    TEST_ASSERT_EQUAL(-1, index.find(""));
+    TEST_ASSERT_EQUAL(-1, index.find("slee"));
+    TEST_ASSERT_EQUAL(-1, index.find("sleepy"));
+    TEST_ASSERT_EQUAL(1, index.find("sleep\"}", 5));  // length-delimited, as in a payload
+}
+
+void test_duplicates_and_oversize_tables_fail() {
+    static const CommandSpec DUP[] = { { "a", noop, {} }, { "b", noop, {} }, { "a", noop, {} } };
+    CommandIndex<16> index;
+    TEST_ASSERT_FALSE(index.build(DUP, 3));
+    TEST_ASSERT_EQUAL(-1, index.find("b"));
+
+    CommandIndex<8> small;
+    TEST_ASSERT_FALSE(small.build(TABLE, TABLE_SIZE));
+}
+
+void test_args_keep_strings_in_place() {
+    CommandArgs args;
+    args.clear();
+    TEST_ASSERT_EQUAL(7, args.getInt(0, 7));
+    TEST_ASSERT_TRUE(args.setString(1, "Europe/Paris", 12));
+    TEST_ASSERT_EQUAL_STRING("Europe/Paris", args.getString(1));
+
+    char big[CMD_TEXT_MAX];
+    memset(big, 'x', sizeof(big));
+    TEST_ASSERT_FALSE(args.setString(2, big, sizeof(big)));
+    TEST_ASSERT_FALSE(args.has(2));
+}
+
+void test_queue_is_bounded_and_fifo() {
+    CommandQueue<4> q;
+    for (int i = 0; i < 4; i++) {
+        CommandJob* job = q.reserve();
+        TEST_ASSERT_NOT_NULL(job);
+        job->command = (int16_t)i;
+        q.commit();
+    }
+    TEST_ASSERT_NULL(q.reserve());
+    TEST_ASSERT_EQUAL(4, q.size());
+
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(i, q.front()->command);
+        q.release();
+    }
+    TEST_ASSERT_NULL(q.front());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_hash_is_a_constant_expression);
+    RUN_TEST(test_every_name_has_its_own_slot);
+    RUN_TEST(test_unknown_and_prefix_names_are_rejected);
+    RUN_TEST(test_duplicates_and_oversize_tables_fail);
+    RUN_TEST(test_args_keep_strings_in_place);
+    RUN_TEST(test_queue_is_bounded_and_fifo);
+
+    return UNITY_END();
+}
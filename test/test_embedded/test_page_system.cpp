@@ -21,7 +21,7 @@ public:
         display->clearScreen();
     }
     
-    void loop() override { 
+    void loop(uint32_t) override { 
         loopCalled++; 
     }
     
@@ -0,0 +1,195 @@
+#include <unity.h>
+#include "../../lib/core/energy_accountant.h"
+
+// Host simulator suite: run with `pio test -e native -f test_energy_accountant`
+
+// ---------------------------------------------------------------------------
+// Recorded trace (t_ms,current_ma,page,backlight,speaker,radio)
+// 10s clock page at full brightness, 5s of a beep, 10s dimmed, 5s with Wi-Fi
+// ---------------------------------------------------------------------------
+static const char* const TRACE[] = {
+    "0,60,0,255,0,0",
+    "5000,60,0,255,0,0",
+    "10000,90,0,255,1,0",
+    "15000,30,0,64,0,0",
+    "20000,30,0,64,0,0",
+    "25000,130,0,64,0,1",
+    "30000,130,0,64,0,1",
+};
+
+static EnergyAccountant acc;
+
+static EnergyContext ctx(int page, int backlight, bool speaker, bool radio) {
+    EnergyContext c;
+    c.page = page; c.backlight = backlight; c.speaker = speaker; c.radio = radio;
+    return c;
+}
+
+static void replayTrace() {
+    for (size_t i = 0; i < sizeof(TRACE) / sizeof(TRACE[0]); i++) {
+        EnergyTraceSample s;
+        TEST_ASSERT_TRUE(parseEnergyTraceLine(TRACE[i], s));
+        acc.replay(&s, 1);
+    }
+}
+
+static bool isPage0(const EnergyContext& c)     { return c.page == 0; }
+static bool speakerOn(const EnergyContext& c)   { return c.speaker; }
+static bool radioOn(const EnergyContext& c)     { return c.radio; }
+static bool displayOff(const EnergyContext& c)  { return c.backlight == 0; }
+
+void setUp(void)    { acc.reset(); }
+void tearDown(void) {}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+void test_parse_trace_line() {
+    EnergyTraceSample s;
+    TEST_ASSERT_TRUE(parseEnergyTraceLine("1234,56.5,2,128,1,0", s));
+    TEST_ASSERT_EQUAL_UINT32(1234, s.tMs);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 56.5, s.currentMa);
+    TEST_ASSERT_EQUAL(2, s.context.page);
+    TEST_ASSERT_EQUAL(128, s.context.backlight);
+    TEST_ASSERT_TRUE(s.context.speaker);
+    TEST_ASSERT_FALSE(s.context.radio);
+    TEST_ASSERT_FALSE(parseEnergyTraceLine("garbage", s));
+}
+
+// Every millisecond of the trace ends up in exactly one context
+void test_replay_conserves_time_and_charge() {
+    replayTrace();
+    TEST_ASSERT_EQUAL_UINT32(30000, acc.total.ms);
+    TEST_ASSERT_EQUAL_UINT32(30000, acc.sum(isPage0).ms);
+    // 10s@60 + 5s@90 + 10s@30 + 5s@130 = 2000 mA*s
+    TEST_ASSERT_FLOAT_WITHIN(0.5, 2000000.0, acc.total.maMs);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001, 2000000.0 / 3600000.0, acc.total.mAh());
+    TEST_ASSERT_EQUAL_UINT32(0, acc.droppedMs);
+}
+
+// Average draw per context, e.g. clock page at full brightness
+void test_per_context_average() {
+    replayTrace();
+    const EnergyContextSlot* full = acc.slotFor(ctx(0, 255, false, false));
+    TEST_ASSERT_NOT_NULL(full);
+    TEST_ASSERT_EQUAL_UINT32(10000, full->counter.ms);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 60.0, full->counter.averageMa());
+
+    const EnergyContextSlot* dim = acc.slotFor(ctx(0, 64, false, false));
+    TEST_ASSERT_NOT_NULL(dim);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 30.0, dim->counter.averageMa());
+
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 90.0, acc.sum(speakerOn).averageMa());
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 130.0, acc.sum(radioOn).averageMa());
+    TEST_ASSERT_EQUAL_UINT32(0, acc.sum(displayOff).ms);
+}
+
+// Levels in the same backlight bucket share a context
+void test_backlight_bucketing() {
+    TEST_ASSERT_EQUAL(energyContextKey(ctx(1, 200, false, false)),
+                      energyContextKey(ctx(1, 255, false, false)));
+    TEST_ASSERT_TRUE(energyContextKey(ctx(1, 0, false, false)) !=
+                     energyContextKey(ctx(1, 1, false, false)));
+    TEST_ASSERT_TRUE(energyContextKey(ctx(-1, 0, false, false)) !=
+                     energyContextKey(ctx(0, 0, false, false)));
+}
+
+// A span covers awake time and deep sleep (a pomodoro cycle)
+void test_span_includes_sleep() {
+    acc.resume(0);
+    acc.setContext(0, ctx(0, 255, false, false));
+    acc.addSample(0, 50);
+    acc.beginSpan("pomodoro");
+    acc.addSample(2000, 50);                 // 2s awake inside the span
+    acc.addSleep(25 * 60 * 1000, 0.5f);      // 25 min asleep
+    acc.resume(0);                           // rebooted clock after wake
+    acc.addSample(1000, 50);                 // 1s awake again
+    acc.endSpan("pomodoro");
+    acc.addSample(5000, 50);                 // outside the span
+
+    EnergySpan* span = acc.findSpan("pomodoro");
+    TEST_ASSERT_NOT_NULL(span);
+    TEST_ASSERT_EQUAL_UINT32(1, span->runs);
+    TEST_ASSERT_EQUAL_UINT32(3000 + 25 * 60 * 1000, span->counter.ms);
+    TEST_ASSERT_FLOAT_WITHIN(0.5, 3000.0 * 50 + 1500000.0 * 0.5, span->counter.maMs);
+    TEST_ASSERT_EQUAL_UINT32(25 * 60 * 1000, acc.sleep.ms);
+}
+
+// UI wakes pause the span: one run, only the sleeps charged
+void test_paused_span_keeps_its_run() {
+    acc.resume(0);
+    acc.addSample(0, 50);
+    acc.beginSpan("pomodoro");
+    acc.addSleep(1000, 1.0f);
+    acc.pauseSpan("pomodoro");               // button wake, UI up
+    acc.addSample(4000, 50);
+    acc.resumeSpan("pomodoro");              // back to sleep
+    acc.addSleep(2000, 1.0f);
+    acc.pauseSpan("pomodoro");
+    acc.resumeSpan("pomodoro");
+    acc.addSleep(3000, 1.0f);
+
+    EnergySpan* span = acc.findSpan("pomodoro");
+    TEST_ASSERT_EQUAL_UINT32(1, span->runs);
+    TEST_ASSERT_EQUAL_UINT32(6000, span->counter.ms);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 6000.0, span->counter.maMs);
+
+    acc.endSpan("pomodoro");
+    acc.resumeSpan("pomodoro");              // nothing to resume once stopped
+    acc.addSleep(1000, 1.0f);
+    TEST_ASSERT_EQUAL_UINT32(6000, span->counter.ms);
+    acc.beginSpan("pomodoro");
+    TEST_ASSERT_EQUAL_UINT32(2, span->runs);
+}
+
+// Spans are reopened by name and the table is bounded
+void test_span_table_bounded() {
+    TEST_ASSERT_TRUE(acc.beginSpan("a"));
+    TEST_ASSERT_TRUE(acc.beginSpan("b"));
+    TEST_ASSERT_TRUE(acc.beginSpan("c"));
+    TEST_ASSERT_TRUE(acc.beginSpan("d"));
+    TEST_ASSERT_FALSE(acc.beginSpan("e"));
+    acc.endSpan("a");
+    TEST_ASSERT_TRUE(acc.beginSpan("a"));
+    TEST_ASSERT_EQUAL_UINT32(2, acc.findSpan("a")->runs);
+}
+
+// Charging (positive current) never produces negative consumption
+void test_negative_current_clamped() {
+    acc.resume(0);
+    acc.addSample(0, -200);
+    acc.addSample(1000, 10);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 0.0, acc.total.maMs);
+}
+
+// Context table overflow is counted, not silently lost
+void test_context_overflow_counted() {
+    acc.resume(0);
+    acc.addSample(0, 10);
+    for (int i = 0; i < ENERGY_MAX_CONTEXTS + 2; i++) {
+        acc.setContext(i * 100, ctx(i, 255, false, false));
+    }
+    acc.addSample((ENERGY_MAX_CONTEXTS + 2) * 100, 10);
+    TEST_ASSERT_EQUAL(ENERGY_MAX_CONTEXTS, acc.slotCount);
+    TEST_ASSERT_EQUAL_UINT32(200, acc.droppedMs);
+}
+
+// ---------------------------------------------------------------------------
+// Entry point
+// ---------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_parse_trace_line);
+    RUN_TEST(test_replay_conserves_time_and_charge);
+    RUN_TEST(test_per_context_average);
+    RUN_TEST(test_backlight_bucketing);
+    RUN_TEST(test_span_includes_sleep);
+    RUN_TEST(test_paused_span_keeps_its_run);
+    RUN_TEST(test_span_table_bounded);
+    RUN_TEST(test_negative_current_clamped);
+    RUN_TEST(test_context_overflow_counted);
+
+    return UNITY_END();
+}
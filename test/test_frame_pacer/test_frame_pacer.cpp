@@ -0,0 +1,118 @@
+#include <unity.h>
+#include <string.h>
+#include "../../lib/core/frame_pacer.h"
+
+// Run with `pio test -e native -f test_frame_pacer`
+
+static FramePacer     pacer;
+static PageFrameStats stats;
+
+void setUp(void) {
+    pacer = FramePacer();
+    stats.clear();
+}
+
+void tearDown(void) {}
+
+// Default policy: every pass, like the main loop always did
+void test_every_pass_by_default() {
+    pacer.setRate(0, 1000000);
+    TEST_ASSERT_TRUE(pacer.due(1000000));
+    TEST_ASSERT_EQUAL_UINT32(0, pacer.beginFrame(1000000, stats));
+    TEST_ASSERT_TRUE(pacer.due(1000001));
+    TEST_ASSERT_EQUAL_UINT32(12000, pacer.beginFrame(1012000, stats));
+    TEST_ASSERT_EQUAL_UINT32(10000, pacer.idleUs(1012000, 10000));
+    TEST_ASSERT_EQUAL_UINT32(0, stats.late);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.frames);
+}
+
+void test_rate_uses_a_fixed_timestep() {
+    pacer.setRate(30, 1000000);
+    pacer.beginFrame(1000000, stats);
+    TEST_ASSERT_FALSE(pacer.due(1030000));
+    TEST_ASSERT_EQUAL_UINT32(3333, pacer.idleUs(1030000, 10000));
+    TEST_ASSERT_EQUAL_UINT32(10000, pacer.idleUs(1010000, 10000));
+
+    // Late by a little: same schedule, same delta, not late
+    TEST_ASSERT_EQUAL_UINT32(33333, pacer.beginFrame(1034000, stats));
+    TEST_ASSERT_EQUAL_INT64(1066666, pacer.nextUs());
+    TEST_ASSERT_EQUAL_UINT32(0, stats.late);
+
+    // A 100 ms stall: the frames it covered are dropped, one delta for all
+    TEST_ASSERT_EQUAL_UINT32(4 * 33333, pacer.beginFrame(1166666, stats));
+    TEST_ASSERT_EQUAL_UINT32(3, stats.dropped);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.late);
+    TEST_ASSERT_TRUE(pacer.nextUs() > 1166666);
+}
+
+// A page that knows when it has something to draw (the clock's next tick)
+void test_explicit_deadline() {
+    pacer.setRate(0, 0);
+    pacer.setDeadline(500000);
+    TEST_ASSERT_FALSE(pacer.due(499999));
+    TEST_ASSERT_EQUAL_UINT32(7000, pacer.idleUs(493000, 10000));
+
+    TEST_ASSERT_EQUAL_UINT32(501000, pacer.beginFrame(501000, stats));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.timed);
+    TEST_ASSERT_EQUAL_UINT32(1000, stats.maxLateUs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.late);
+
+    // Not renewed: back to every pass
+    TEST_ASSERT_TRUE(pacer.due(501001));
+
+    pacer.setDeadline(1500000);
+    pacer.beginFrame(1505000, stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.late);
+
+    pacer.setDeadline(0);                 // 0 keeps the policy
+    TEST_ASSERT_TRUE(pacer.due(1505001));
+}
+
+// Back on the clock page after minutes away: its next tick time is long
+// gone, the first frame is due right away and not counted late
+void test_stale_deadline_on_a_page_switch() {
+    pacer.setRate(0, 600000000);
+    pacer.setDeadline(1000000);
+    TEST_ASSERT_TRUE(pacer.due(600000000));
+    pacer.beginFrame(600000500, stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.late);
+    TEST_ASSERT_EQUAL_UINT32(500, stats.maxLateUs);
+
+    // Lateness past 32 bits saturates instead of wrapping
+    pacer.setRate(30, 0);
+    pacer.beginFrame(0x100000000LL + 33333 + 10, stats);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.late);
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, stats.maxLateUs);
+}
+
+void test_switching_policy_and_stats_row() {
+    pacer.setRate(30, 0);
+    pacer.beginFrame(0, stats);
+    pacer.setRate(0, 40000);              // new page: no rate, due right away
+    TEST_ASSERT_TRUE(pacer.due(40000));
+    TEST_ASSERT_EQUAL_UINT32(0, pacer.periodUs());
+
+    stats.clear();
+    for (int i = 0; i < 25; i++) stats.frames++;
+    TEST_ASSERT_EQUAL_UINT32(250, stats.fpsX10(1000000));
+    TEST_ASSERT_EQUAL_UINT32(0, stats.fpsX10(0));
+
+    char line[80];
+    formatFrameStatsRow("Stopwatch", 30, stats, 1000000, line, sizeof(line));
+    TEST_ASSERT_NOT_NULL(strstr(line, "Stopwatch"));
+    TEST_ASSERT_NOT_NULL(strstr(line, "25.0"));
+    formatFrameStatsRow("Clock", 0, stats, 1000000, line, sizeof(line));
+    TEST_ASSERT_NOT_NULL(strstr(line, "pass"));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_every_pass_by_default);
+    RUN_TEST(test_rate_uses_a_fixed_timestep);
+    RUN_TEST(test_explicit_deadline);
+    RUN_TEST(test_stale_deadline_on_a_page_switch);
+    RUN_TEST(test_switching_policy_and_stats_row);
+
+    return UNITY_END();
+}
@@ -0,0 +1,122 @@
+#include <unity.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "../../lib/core/log_ring.h"
+
+// Run with `pio test -e native -f test_log_ring`
+
+static LogRecord make(LogMessageId id) {
+    LogRecord r;
+    r.timeMs      = 12345;
+    r.message     = (uint16_t)id;
+    r.levelModule = (LOG_LEVEL_INFO << 4) | LOG_MODULE_MQTT;
+    r.words       = 0;
+    return r;
+}
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_record_is_fixed_size() {
+    TEST_ASSERT_EQUAL(48, sizeof(LogRecord));
+    TEST_ASSERT_EQUAL_STRING("MQTT", logModuleName(LOG_MODULE_MQTT));
+    TEST_ASSERT_EQUAL_STRING("%u log records dropped", logMessageFormat(LOG_MSG_LOG_DROPPED));
+    TEST_ASSERT_EQUAL_STRING("?", logMessageFormat(LOG_MSG_COUNT));
+}
+
+void test_format_with_numbers_and_strings() {
+    LogRecord r = make(LOG_MSG_MQTT_PAYLOAD_TOO_LARGE);
+    logPack(r, "cbor", "sensors/batch", 2100u, 2048);
+    char out[128];
+    logFormatRecord(r, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("cbor payload for sensors/batch is 2100 bytes (max 2048)", out);
+
+    r = make(LOG_MSG_MQTT_LOST);
+    logPack(r, -3);
+    logFormatLine(r, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("[    12.345] I MQTT   Disconnected from MQTT, reason -3", out);
+}
+
+void test_long_strings_are_truncated_to_the_record() {
+    LogRecord r = make(LOG_MSG_MQTT_PAYLOAD_TOO_LARGE);
+    logPack(r, "json", "a/very/long/topic/name/that/does/not/fit", 1u, 2u);
+    char out[128];
+    logFormatRecord(r, out, sizeof(out));
+    // "json" takes 2 words, the topic the 8 left (31 chars), the numbers are lost
+    TEST_ASSERT_EQUAL_STRING("json payload for a/very/long/topic/name/that/doe is ? bytes (max ?)", out);
+    TEST_ASSERT_EQUAL(LOG_ARG_WORDS, r.words);
+}
+
+void test_output_buffer_is_respected() {
+    LogRecord r = make(LOG_MSG_WIFI_CONNECTED);
+    logPack(r, 850u, "cached", 192, 168, 1, 42);
+    char out[16];
+    size_t n = logFormatRecord(r, out, sizeof(out));
+    TEST_ASSERT_EQUAL(15, n);
+    TEST_ASSERT_EQUAL_STRING("WiFi connected ", out);
+
+    char full[96];
+    logFormatRecord(r, full, sizeof(full));
+    TEST_ASSERT_EQUAL_STRING("WiFi connected in 850 ms (cached), IP 192.168.1.42", full);
+}
+
+void test_full_ring_drops_and_counts() {
+    LogRing<4> ring;
+    LogRecord  r = make(LOG_MSG_MQTT_DISCONNECTED);
+    for (int i = 0; i < 6; i++) ring.push(r);
+    TEST_ASSERT_EQUAL(4, ring.size());
+    TEST_ASSERT_EQUAL(2, ring.dropped());
+
+    LogRecord out;
+    for (int i = 0; i < 4; i++) TEST_ASSERT_TRUE(ring.pop(out));
+    TEST_ASSERT_FALSE(ring.pop(out));
+    TEST_ASSERT_TRUE(ring.push(r));  // space again after the wrap
+}
+
+// Four writers against one reader: every record arrives once, in order per writer
+void test_concurrent_writers() {
+    static LogRing<64> ring;
+    const int WRITERS = 4, PER_WRITER = 20000;
+    std::vector<std::thread> writers;
+    for (int w = 0; w < WRITERS; w++) {
+        writers.push_back(std::thread([w]() {
+            for (int i = 0; i < PER_WRITER; i++) {
+                LogRecord r = make(LOG_MSG_LOG_DROPPED);
+                r.args[0] = (uint32_t)w;
+                r.args[1] = (uint32_t)i;
+                r.words   = 2;
+                while (!ring.push(r)) std::this_thread::yield();
+            }
+        }));
+    }
+
+    int       next[WRITERS] = { 0 };
+    int       received      = 0;
+    bool      ordered       = true;
+    LogRecord r;
+    while (received < WRITERS * PER_WRITER) {
+        if (!ring.pop(r)) continue;
+        if ((int)r.args[1] != next[r.args[0]]) ordered = false;
+        next[r.args[0]] = (int)r.args[1] + 1;
+        received++;
+    }
+    for (size_t w = 0; w < writers.size(); w++) writers[w].join();
+
+    TEST_ASSERT_TRUE(ordered);
+    TEST_ASSERT_EQUAL(WRITERS * PER_WRITER, (int)ring.written());
+    TEST_ASSERT_FALSE(ring.pop(r));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_record_is_fixed_size);
+    RUN_TEST(test_format_with_numbers_and_strings);
+    RUN_TEST(test_long_strings_are_truncated_to_the_record);
+    RUN_TEST(test_output_buffer_is_respected);
+    RUN_TEST(test_full_ring_drops_and_counts);
+    RUN_TEST(test_concurrent_writers);
+
+    return UNITY_END();
+}
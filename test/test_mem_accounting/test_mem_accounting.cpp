@@ -0,0 +1,118 @@
+#include <unity.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "../../lib/core/mem_accounting.h"
+
+// Run with `pio test -e native -f test_mem_accounting`
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_live_and_peak_per_tag() {
+    MemAccounting m;
+    m.onAlloc(MEM_TAG_UI, 100);
+    m.onAlloc(MEM_TAG_UI, 50);
+    m.onAlloc(MEM_TAG_NET, 400);
+    m.onFree(MEM_TAG_UI, 100);
+    TEST_ASSERT_EQUAL(50, m.live(MEM_TAG_UI));
+    TEST_ASSERT_EQUAL(150, m.peak(MEM_TAG_UI));
+    TEST_ASSERT_EQUAL(2, m.allocs(MEM_TAG_UI));
+    TEST_ASSERT_EQUAL(1, m.frees(MEM_TAG_UI));
+    TEST_ASSERT_EQUAL(450, m.totalLive());
+
+    m.resetPeaks();
+    TEST_ASSERT_EQUAL(50, m.peak(MEM_TAG_UI));
+    TEST_ASSERT_EQUAL(400, m.peak(MEM_TAG_NET));
+}
+
+void test_unknown_tag_goes_to_other() {
+    MemAccounting m;
+    m.onAlloc(200, 16);
+    TEST_ASSERT_EQUAL(16, m.live(MEM_TAG_OTHER));
+    TEST_ASSERT_EQUAL_STRING("other", memTagName(MEM_TAG_OTHER));
+    TEST_ASSERT_EQUAL_STRING("telemetry", memTagName(MEM_TAG_TELEMETRY));
+    TEST_ASSERT_EQUAL_STRING("?", memTagName(200));
+}
+
+void test_allocations_after_seal_are_reported() {
+    MemAccounting m;
+    TEST_ASSERT_FALSE(m.onAlloc(MEM_TAG_DISPLAY, 64, 0x400d1234));
+    TEST_ASSERT_EQUAL(0, m.lateAllocs());
+
+    m.seal();
+    TEST_ASSERT_TRUE(m.sealed());
+    TEST_ASSERT_TRUE(m.onAlloc(MEM_TAG_OTHER, 24, 0x400d5678));
+    TEST_ASSERT_TRUE(m.onAlloc(MEM_TAG_OTHER, 24));
+    TEST_ASSERT_EQUAL(2, m.lateAllocs());
+    TEST_ASSERT_EQUAL(0x400d5678, m.lateCaller());  // an unknown caller keeps the last known one
+}
+
+void test_static_arena_aligns_and_refuses_overflow() {
+    static uint64_t buffer[8];
+    StaticArena a((uint8_t*)buffer, sizeof(buffer));
+    uint8_t* p = (uint8_t*)a.allocate(3);
+    uint8_t* q = (uint8_t*)a.allocate(10);
+    TEST_ASSERT_EQUAL_PTR((uint8_t*)buffer, p);
+    TEST_ASSERT_EQUAL_PTR((uint8_t*)buffer + 8, q);
+    TEST_ASSERT_TRUE(a.contains(q + 9));
+    TEST_ASSERT_FALSE(a.contains((uint8_t*)buffer + sizeof(buffer)));
+
+    TEST_ASSERT_NULL(a.allocate(48));  // 24 used, 40 left
+    TEST_ASSERT_EQUAL(1, a.failures());
+    TEST_ASSERT_NOT_NULL(a.allocate(40));
+    TEST_ASSERT_EQUAL(64, a.used());
+    TEST_ASSERT_NULL(a.allocate(1));
+}
+
+void test_static_arena_from_several_threads() {
+    static uint64_t buffer[4096 / 8];
+    StaticArena a((uint8_t*)buffer, sizeof(buffer));
+    const int THREADS = 4, EACH = 32;  // 4 * 32 * 32 bytes = the whole arena
+    std::vector<void*> got[THREADS];
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.push_back(std::thread([&a, &got, t, EACH]() {
+            for (int i = 0; i < EACH; i++) got[t].push_back(a.allocate(32));
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+
+    std::vector<uint8_t> owner(sizeof(buffer) / 32, 0);
+    for (int t = 0; t < THREADS; t++) {
+        for (size_t i = 0; i < got[t].size(); i++) {
+            TEST_ASSERT_NOT_NULL(got[t][i]);
+            size_t slot = ((uint8_t*)got[t][i] - (uint8_t*)buffer) / 32;
+            TEST_ASSERT_EQUAL(0, owner[slot]);  // no block handed out twice
+            owner[slot] = 1;
+        }
+    }
+    TEST_ASSERT_EQUAL(sizeof(buffer), a.used());
+    TEST_ASSERT_EQUAL(0, a.failures());
+}
+
+void test_fragmentation_and_rows() {
+    TEST_ASSERT_EQUAL(0, memFragmentationPct(0, 0));
+    TEST_ASSERT_EQUAL(0, memFragmentationPct(1000, 1000));
+    TEST_ASSERT_EQUAL(75, memFragmentationPct(100000, 25000));
+
+    MemAccounting m;
+    m.onAlloc(MEM_TAG_DISPLAY, 1284);
+    char row[96];
+    memFormatTagRow(m, MEM_TAG_DISPLAY, row, sizeof(row));
+    TEST_ASSERT_EQUAL_STRING("display    live    1284  peak    1284  allocs     1  frees     0", row);
+    TEST_ASSERT_EQUAL(9, memFormatTagRow(m, MEM_TAG_DISPLAY, row, 10));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_live_and_peak_per_tag);
+    RUN_TEST(test_unknown_tag_goes_to_other);
+    RUN_TEST(test_allocations_after_seal_are_reported);
+    RUN_TEST(test_static_arena_aligns_and_refuses_overflow);
+    RUN_TEST(test_static_arena_from_several_threads);
+    RUN_TEST(test_fragmentation_and_rows);
+
+    return UNITY_END();
+}
@@ -0,0 +1,101 @@
+#include <unity.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "../../lib/core/metrics.h"
+
+// Run with `pio test -e native -f test_metrics`
+
+static const uint32_t BOUNDS[] = { 10, 100, 1000 };
+
+static MetricCounter   requests("requests");
+static MetricGauge     level("level");
+static MetricHistogram latency("latency_ms", BOUNDS, 3);
+
+void setUp(void) { metricsReset(); }
+void tearDown(void) {}
+
+void test_registry_keeps_declaration_order() {
+    TEST_ASSERT_EQUAL(3, Metric::count());
+    const Metric* m = Metric::first();
+    TEST_ASSERT_EQUAL_STRING("requests", m->name());
+    TEST_ASSERT_EQUAL_STRING("level", m->next()->name());
+    TEST_ASSERT_EQUAL_STRING("latency_ms", m->next()->next()->name());
+    TEST_ASSERT_EQUAL_PTR(&level, Metric::find("level"));
+    TEST_ASSERT_NULL(Metric::find("nope"));
+}
+
+void test_counter_and_gauge() {
+    requests.inc();
+    requests.add(4);
+    level.set(87);
+    level.add(-2);
+    TEST_ASSERT_EQUAL(5, requests.value());
+    TEST_ASSERT_EQUAL(85, level.value());
+
+    metricsReset();
+    TEST_ASSERT_EQUAL(0, requests.value());
+    TEST_ASSERT_EQUAL(85, level.value());  // gauges keep their value
+}
+
+void test_histogram_buckets_are_inclusive() {
+    static const uint32_t values[] = { 0, 10, 11, 100, 500, 1000, 1001, 5000 };
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) latency.observe(values[i]);
+    TEST_ASSERT_EQUAL(2, latency.bucket(0));   // <= 10
+    TEST_ASSERT_EQUAL(2, latency.bucket(1));   // <= 100
+    TEST_ASSERT_EQUAL(2, latency.bucket(2));   // <= 1000
+    TEST_ASSERT_EQUAL(2, latency.bucket(3));   // overflow
+    TEST_ASSERT_EQUAL(8, latency.count());
+    TEST_ASSERT_EQUAL(7622, latency.sum());
+    TEST_ASSERT_EQUAL(5000, latency.max());
+    TEST_ASSERT_EQUAL(100, latency.percentile(50));
+    TEST_ASSERT_EQUAL(5000, latency.percentile(90));
+}
+
+void test_text_rows() {
+    requests.add(12);
+    level.set(-3);
+    latency.observe(50);
+    char row[160];
+    metricsFormatRow(requests, row, sizeof(row));
+    TEST_ASSERT_EQUAL_STRING("requests               counter           12", row);
+    metricsFormatRow(level, row, sizeof(row));
+    TEST_ASSERT_EQUAL_STRING("level                  gauge             -3", row);
+    metricsFormatRow(latency, row, sizeof(row));
+    TEST_ASSERT_EQUAL_STRING("latency_ms             histogram n=1 avg=50 p90<=100 max=50 | 0 1 0 0", row);
+
+    char small[8];
+    TEST_ASSERT_EQUAL(7, metricsFormatRow(latency, small, sizeof(small)));
+}
+
+void test_updates_from_several_threads() {
+    const int THREADS = 4, EACH = 50000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; t++) {
+        threads.push_back(std::thread([]() {
+            for (int i = 0; i < EACH; i++) {
+                requests.inc();
+                latency.observe((uint32_t)(i % 2000));
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); t++) threads[t].join();
+    TEST_ASSERT_EQUAL(THREADS * EACH, requests.value());
+    TEST_ASSERT_EQUAL(THREADS * EACH, latency.count());
+    TEST_ASSERT_EQUAL(1999, latency.max());
+    uint32_t total = 0;
+    for (uint8_t b = 0; b <= latency.boundCount(); b++) total += latency.bucket(b);
+    TEST_ASSERT_EQUAL(THREADS * EACH, total);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_registry_keeps_declaration_order);
+    RUN_TEST(test_counter_and_gauge);
+    RUN_TEST(test_histogram_buckets_are_inclusive);
+    RUN_TEST(test_text_rows);
+    RUN_TEST(test_updates_from_several_threads);
+
+    return UNITY_END();
+}
@@ -0,0 +1,174 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+#include <string>
+#include "../../lib/core/mqtt_outbox.h"
+
+// Run with `pio test -e native -f test_mqtt_outbox`
+
+static uint8_t    arena[256];
+static MqttOutbox outbox;
+
+static bool pushText(const char* topic, const char* payload, uint32_t now = 0, uint8_t qos = 0, bool retain = false) {
+    return outbox.push(topic, (const uint8_t*)payload, strlen(payload), qos, retain, now);
+}
+
+static void expectNext(const char* topic, const char* payload) {
+    MqttOutboxRecord r;
+    TEST_ASSERT_TRUE(outbox.peek(r));
+    TEST_ASSERT_EQUAL_STRING(topic, r.topic);
+    TEST_ASSERT_EQUAL(strlen(payload), r.length);
+    TEST_ASSERT_EQUAL_MEMORY(payload, r.payload, r.length);
+    outbox.pop();
+}
+
+void setUp(void) {
+    outbox.begin(arena, sizeof(arena), MQTT_OUTBOX_DROP_OLDEST);
+    outbox.setEvictHandler(nullptr);
+    outbox.resetStats();
+}
+
+void tearDown(void) {}
+
+void test_fifo_with_flags() {
+    TEST_ASSERT_TRUE(pushText("a", "1", 10, 1, true));
+    TEST_ASSERT_TRUE(pushText("b", "22", 20));
+    TEST_ASSERT_EQUAL(2, outbox.depth());
+
+    MqttOutboxRecord r;
+    TEST_ASSERT_TRUE(outbox.peek(r));
+    TEST_ASSERT_EQUAL(1, r.qos);
+    TEST_ASSERT_TRUE(r.retain);
+    TEST_ASSERT_EQUAL(10, r.enqueuedMs);
+    TEST_ASSERT_EQUAL(40, outbox.oldestAgeMs(50));
+
+    expectNext("a", "1");
+    expectNext("b", "22");
+    TEST_ASSERT_TRUE(outbox.empty());
+    TEST_ASSERT_FALSE(outbox.peek(r));
+    TEST_ASSERT_EQUAL(0, outbox.bytesUsed());
+}
+
+void test_wraps_around_without_corruption() {
+    char topic[16], payload[32];
+    int next = 0;
+    for (int i = 0; i < 200; i++) {
+        snprintf(topic, sizeof(topic), "t/%d", i);
+        snprintf(payload, sizeof(payload), "payload-%d-%.*s", i, i % 13, "xxxxxxxxxxxxx");
+        TEST_ASSERT_TRUE(pushText(topic, payload));
+        // Drain every third push so the ring keeps wrapping with data in flight
+        if (i % 3 == 2) {
+            while (outbox.depth() > 1) {
+                MqttOutboxRecord r;
+                TEST_ASSERT_TRUE(outbox.peek(r));
+                snprintf(topic, sizeof(topic), "t/%d", next);
+                TEST_ASSERT_EQUAL_STRING(topic, r.topic);
+                outbox.pop();
+                next++;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(0, outbox.stats(0).dropped);
+}
+
+void test_drop_oldest_when_full() {
+    char topic[16];
+    for (int i = 0; i < 20; i++) {
+        snprintf(topic, sizeof(topic), "s/%d", i);
+        TEST_ASSERT_TRUE(pushText(topic, "0123456789abcdef"));
+    }
+    MqttOutboxStats s = outbox.stats(0);
+    TEST_ASSERT_TRUE(s.dropped > 0);
+    TEST_ASSERT_EQUAL(20, s.enqueued);
+    TEST_ASSERT_EQUAL(20 - s.dropped, s.depth);
+    TEST_ASSERT_TRUE(s.bytesUsed <= s.capacity);
+
+    // What is left is the newest records, still in order
+    MqttOutboxRecord r;
+    TEST_ASSERT_TRUE(outbox.peek(r));
+    snprintf(topic, sizeof(topic), "s/%u", (unsigned)s.dropped);
+    TEST_ASSERT_EQUAL_STRING(topic, r.topic);
+}
+
+void test_keep_latest_per_topic() {
+    outbox.setPolicy(MQTT_OUTBOX_KEEP_LATEST_PER_TOPIC);
+    pushText("temp", "20");
+    pushText("hum", "40");
+    pushText("temp", "21");
+    pushText("temp", "22");
+
+    TEST_ASSERT_EQUAL(2, outbox.depth());
+    TEST_ASSERT_EQUAL(2, outbox.stats(0).superseded);
+    expectNext("hum", "40");
+    expectNext("temp", "22");
+    TEST_ASSERT_TRUE(outbox.empty());
+}
+
+void test_evict_handler_spills() {
+    int spilled = 0;
+    outbox.setEvictHandler([&spilled](const MqttOutboxRecord& r) {
+        spilled++;
+        return true;
+    });
+    char topic[16];
+    for (int i = 0; i < 20; i++) {
+        snprintf(topic, sizeof(topic), "s/%d", i);
+        pushText(topic, "0123456789abcdef");
+    }
+    MqttOutboxStats s = outbox.stats(0);
+    TEST_ASSERT_TRUE(spilled > 0);
+    TEST_ASSERT_EQUAL(spilled, s.spilled);
+    TEST_ASSERT_EQUAL(0, s.dropped);
+}
+
+void test_rejects_oversize_and_empty_payload() {
+    static char big[300];
+    memset(big, 'x', sizeof(big) - 1);
+    TEST_ASSERT_FALSE(pushText("big", big));
+    TEST_ASSERT_EQUAL(1, outbox.stats(0).rejected);
+
+    TEST_ASSERT_TRUE(pushText("empty", ""));
+    expectNext("empty", "");
+}
+
+// Random pushes/pops under keep-latest, checked against a plain deque model
+void test_matches_reference_model() {
+    outbox.setPolicy(MQTT_OUTBOX_KEEP_LATEST_PER_TOPIC);
+    std::deque<std::pair<std::string, std::string> > model;
+    uint32_t rng = 12345;
+    char topic[8], payload[48];
+
+    for (int i = 0; i < 5000; i++) {
+        rng = rng * 1103515245UL + 12345UL;
+        if ((rng >> 16) % 3 != 0) {
+            snprintf(topic, sizeof(topic), "k%u", (unsigned)((rng >> 8) % 6));
+            snprintf(payload, sizeof(payload), "%d-%.*s", i, (int)((rng >> 4) % 30), "yyyyyyyyyyyyyyyyyyyyyyyyyyyyyy");
+            for (size_t j = 0; j < model.size(); j++) {
+                if (model[j].first == topic) { model.erase(model.begin() + j); break; }
+            }
+            uint32_t droppedBefore = outbox.stats(0).dropped;
+            TEST_ASSERT_TRUE(pushText(topic, payload));
+            for (uint32_t d = droppedBefore; d < outbox.stats(0).dropped; d++) model.pop_front();
+            model.push_back(std::make_pair(std::string(topic), std::string(payload)));
+        } else if (!model.empty()) {
+            expectNext(model.front().first.c_str(), model.front().second.c_str());
+            model.pop_front();
+        }
+        TEST_ASSERT_EQUAL(model.size(), outbox.depth());
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_fifo_with_flags);
+    RUN_TEST(test_wraps_around_without_corruption);
+    RUN_TEST(test_drop_oldest_when_full);
+    RUN_TEST(test_keep_latest_per_topic);
+    RUN_TEST(test_evict_handler_spills);
+    RUN_TEST(test_rejects_oversize_and_empty_payload);
+    RUN_TEST(test_matches_reference_model);
+
+    return UNITY_END();
+}
@@ -0,0 +1,167 @@
+#include <unity.h>
+#include <string.h>
+#include <string>
+#include "../../lib/core/mqtt_reassembler.h"
+
+// Run with `pio test -e native -f test_mqtt_reassembler`
+
+typedef MqttReassembler<2, 32, 16> Reassembler;
+
+static Reassembler*          rx;
+static MqttMessageProperties props = { 1, false, false };
+
+// Copies what was delivered, the view is only valid during the call
+struct Sink {
+    int         count;
+    std::string topic;
+    std::string payload;
+    uint8_t     qos;
+
+    void operator()(const MqttMessageView& v) {
+        count++;
+        topic   = v.topic;
+        payload = std::string(v.payload, v.length);
+        qos     = v.qos;
+    }
+};
+
+static Sink sink;
+
+// Segment [index, index + len) of msg
+static void part(const char* topic, const char* msg, size_t index, size_t len, uint32_t nowMs = 0) {
+    rx->feed(topic, msg + index, len, index, strlen(msg), props, nowMs, sink);
+}
+
+void setUp(void) {
+    rx   = new Reassembler();
+    sink = Sink();
+}
+
+void tearDown(void) {
+    delete rx;
+}
+
+void test_single_segment_is_passed_through() {
+    const char* msg = "{\"on\":true}";
+    rx->feed("a/b", msg, strlen(msg), 0, strlen(msg), props, 0, sink);
+    TEST_ASSERT_EQUAL(1, sink.count);
+    TEST_ASSERT_EQUAL_STRING("{\"on\":true}", sink.payload.c_str());
+    TEST_ASSERT_EQUAL(1, rx->stats().zeroCopy);
+    TEST_ASSERT_EQUAL(0, rx->busySlots());
+}
+
+void test_in_order_parts_are_joined() {
+    const char* msg = "0123456789abcdefghij";
+    part("t/x", msg, 0, 8);
+    part("t/x", msg, 8, 8);
+    TEST_ASSERT_EQUAL(0, sink.count);
+    TEST_ASSERT_EQUAL(1, rx->busySlots());
+    part("t/x", msg, 16, 4);
+
+    TEST_ASSERT_EQUAL(1, sink.count);
+    TEST_ASSERT_EQUAL_STRING("t/x", sink.topic.c_str());
+    TEST_ASSERT_EQUAL_STRING(msg, sink.payload.c_str());
+    TEST_ASSERT_EQUAL(1, sink.qos);
+    TEST_ASSERT_EQUAL(1, rx->stats().reassembled);
+    TEST_ASSERT_EQUAL(3, rx->stats().fragments);
+    TEST_ASSERT_EQUAL(0, rx->busySlots());
+}
+
+void test_two_topics_interleaved() {
+    const char* a = "aaaaaaaaAAAAAAAA";
+    const char* b = "bbbbbbbbbbBBBBBBBBBB";
+    part("t/a", a, 0, 8);
+    part("t/b", b, 0, 10);
+    part("t/a", a, 8, 8);
+    TEST_ASSERT_EQUAL_STRING(a, sink.payload.c_str());
+    part("t/b", b, 10, 10);
+    TEST_ASSERT_EQUAL_STRING(b, sink.payload.c_str());
+    TEST_ASSERT_EQUAL(2, sink.count);
+}
+
+// Segments are only accepted in order: a gap drops the message and the
+// rest of it counts as orphans
+void test_out_of_order_part_drops_the_message() {
+    const char* msg = "0123456789abcdefghij";
+    part("t/x", msg, 0, 8);
+    part("t/x", msg, 16, 4);
+    TEST_ASSERT_EQUAL(1, rx->stats().outOfOrder);
+    TEST_ASSERT_EQUAL(0, rx->busySlots());
+
+    part("t/x", msg, 8, 8);
+    TEST_ASSERT_EQUAL(1, rx->stats().orphans);
+    TEST_ASSERT_EQUAL(0, sink.count);
+}
+
+void test_duplicate_part_drops_the_message() {
+    const char* msg = "0123456789abcdefghij";
+    part("t/x", msg, 0, 8);
+    part("t/x", msg, 8, 8);
+    part("t/x", msg, 8, 8);   // resent segment
+    TEST_ASSERT_EQUAL(1, rx->stats().outOfOrder);
+    TEST_ASSERT_EQUAL(0, sink.count);
+
+    // A restarted message replaces the stale copy and completes
+    part("t/x", msg, 0, 10);
+    part("t/x", msg, 0, 10);
+    part("t/x", msg, 10, 10);
+    TEST_ASSERT_EQUAL(1, sink.count);
+    TEST_ASSERT_EQUAL_STRING(msg, sink.payload.c_str());
+    TEST_ASSERT_EQUAL(2, rx->stats().outOfOrder);
+}
+
+void test_oversize_and_pool_exhaustion() {
+    const char* big = "0123456789012345678901234567890123456789";   // 40 > 32 byte buffers
+    part("t/big", big, 0, 20);
+    part("t/big", big, 20, 20);
+    TEST_ASSERT_EQUAL(1, rx->stats().oversize);
+    TEST_ASSERT_EQUAL(1, rx->stats().orphans);
+
+    part("a-topic-too-long", "0123456789", 0, 5);
+    TEST_ASSERT_EQUAL(2, rx->stats().oversize);
+
+    part("t/1", "0123456789", 0, 5);
+    part("t/2", "0123456789", 0, 5);
+    part("t/3", "0123456789", 0, 5);
+    TEST_ASSERT_EQUAL(1, rx->stats().poolExhausted);
+    TEST_ASSERT_EQUAL(2, rx->busySlots());
+    TEST_ASSERT_EQUAL(0, sink.count);
+
+    rx->reset();
+    TEST_ASSERT_EQUAL(0, rx->busySlots());
+}
+
+// A message whose last segment never came frees its buffer for the next one
+void test_stalled_message_is_evicted() {
+    const char* msg = "0123456789abcdefghij";
+    part("t/1", msg, 0, 8, 1000);
+    part("t/2", msg, 0, 8, 1000);
+    part("t/2", msg, 8, 8, 1000 + MQTT_RX_PART_TIMEOUT_MS);   // still in time, renews t/2
+    part("t/3", msg, 0, 8, 1000 + MQTT_RX_PART_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL(1, rx->stats().poolExhausted);
+
+    part("t/3", msg, 0, 8, 1001 + MQTT_RX_PART_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL(1, rx->stats().expired);
+    TEST_ASSERT_EQUAL(2, rx->busySlots());
+    part("t/3", msg, 8, 12, 1002 + MQTT_RX_PART_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL(1, sink.count);
+    TEST_ASSERT_EQUAL_STRING("t/3", sink.topic.c_str());
+
+    part("t/1", msg, 8, 12, 1003 + MQTT_RX_PART_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL(1, rx->stats().orphans);
+    TEST_ASSERT_EQUAL(1, sink.count);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_single_segment_is_passed_through);
+    RUN_TEST(test_in_order_parts_are_joined);
+    RUN_TEST(test_two_topics_interleaved);
+    RUN_TEST(test_out_of_order_part_drops_the_message);
+    RUN_TEST(test_duplicate_part_drops_the_message);
+    RUN_TEST(test_oversize_and_pool_exhaustion);
+    RUN_TEST(test_stalled_message_is_evicted);
+
+    return UNITY_END();
+}
@@ -0,0 +1,112 @@
+#include <unity.h>
+#include <M5Unified.h>
+#include "../../lib/wifi_helper.h"
+#include "../../lib/dependancies/mqtt_helper_deps.h"
+
+// Device test against a local broker that goes away and comes back.
+// See "Testing MQTT reconnects" in the readme:
+//   tools/broker_flap.sh            (on the host)
+//   pio test -e m5stick-c -f test_mqtt_reconnect
+
+#ifndef TEST_WIFI_SSID
+#define TEST_WIFI_SSID "ssid"
+#endif
+#ifndef TEST_WIFI_PASS
+#define TEST_WIFI_PASS "password"
+#endif
+#ifndef TEST_MQTT_HOST
+#define TEST_MQTT_HOST "192.168.1.10"
+#endif
+
+#define ECHO_TOPIC      "test/reconnect/echo"
+#define FLAP_TIMEOUT_MS 180000
+
+IMQTTHelper* mqtt = getM5StickMQTTHelper();
+volatile int echoCount  = 0;
+volatile int queuedSeen = 0;
+
+static bool waitFor(bool (*condition)(), uint32_t timeoutMs) {
+    unsigned long start = millis();
+    while (!condition()) {
+        if (millis() - start > timeoutMs) return false;
+        mqtt->update();
+        delay(10);
+    }
+    return true;
+}
+
+static bool connected()    { return mqtt->isConnected(); }
+static bool disconnected() { return !mqtt->isConnected(); }
+static bool echoed()       { return echoCount > 0; }
+static bool queuedEchoed() { return queuedSeen > 0; }
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_initial_connect() {
+    TEST_ASSERT_TRUE(WiFiHelper::connect(TEST_WIFI_SSID, TEST_WIFI_PASS));
+    mqtt->begin(TEST_MQTT_HOST);
+    mqtt->setReconnectBackoff(500, 8000);
+    mqtt->subscribe(ECHO_TOPIC, [](const MqttMessageView& msg) {
+        echoCount++;
+        if (msg.length == 6 && memcmp(msg.payload, "queued", 6) == 0) queuedSeen++;
+    });
+    mqtt->connect();
+    TEST_ASSERT_TRUE(waitFor(connected, 10000));
+}
+
+// The broker is killed and restarted by tools/broker_flap.sh
+void test_reconnects_after_broker_restart() {
+    Serial.println(">>> Stop the broker now (tools/broker_flap.sh does it)");
+    TEST_ASSERT_TRUE(waitFor(disconnected, FLAP_TIMEOUT_MS));
+
+    // Published while offline: must come back through the outbox
+    TEST_ASSERT_EQUAL(0, mqtt->publishText(ECHO_TOPIC, "queued", 1));
+    TEST_ASSERT_EQUAL(1, mqtt->getOutboxStats().depth);
+
+    TEST_ASSERT_TRUE(waitFor(connected, FLAP_TIMEOUT_MS));
+    const ReconnectStats& s = mqtt->getReconnectStats();
+    TEST_ASSERT_EQUAL(1, s.disconnects);
+    TEST_ASSERT_EQUAL(1, s.reconnects);
+    TEST_ASSERT_TRUE(s.attempts >= 1);
+    Serial.printf("Reconnected after %u ms, %u attempts\n", (unsigned)s.lastReconnectMs, (unsigned)s.attempts);
+}
+
+void test_outbox_flushed_after_reconnect() {
+    TEST_ASSERT_TRUE(waitFor(queuedEchoed, 5000));
+    TEST_ASSERT_EQUAL(0, mqtt->getOutboxStats().depth);
+}
+
+void test_subscription_restored() {
+    echoCount = 0;
+    mqtt->publishText(ECHO_TOPIC, "live");
+    TEST_ASSERT_TRUE(waitFor(echoed, 5000));
+}
+
+void test_user_disconnect_does_not_reconnect() {
+    mqtt->disconnect();
+    delay(3000);
+    TEST_ASSERT_FALSE(mqtt->isConnected());
+    TEST_ASSERT_EQUAL(1, mqtt->getReconnectStats().disconnects);
+}
+
+void setup() {
+    delay(2000);  // delay to open the serial monitor
+
+    auto cfg = M5.config();
+    M5.begin(cfg);
+
+    UNITY_BEGIN();
+
+    RUN_TEST(test_initial_connect);
+    RUN_TEST(test_reconnects_after_broker_restart);
+    RUN_TEST(test_outbox_flushed_after_reconnect);
+    RUN_TEST(test_subscription_restored);
+    RUN_TEST(test_user_disconnect_does_not_reconnect);
+
+    UNITY_END();
+}
+
+void loop() {
+    delay(1000);
+}
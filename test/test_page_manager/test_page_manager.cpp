@@ -18,7 +18,7 @@ public:
         : PageBase(disp, name), label(name) {}
 
     void setup()   override { setupCalled++;   }
-    void loop()    override { loopCalled++;    }
+    void loop(uint32_t) override { loopCalled++; }
     void cleanup() override { cleanupCalled++; }
     const char* getName() override { return label; }
 };
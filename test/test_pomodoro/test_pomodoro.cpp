@@ -0,0 +1,146 @@
+#include <unity.h>
+#include "../../lib/core/pomodoro.h"
+
+// Run with `pio test -e native -f test_pomodoro`
+
+static const uint32_t T0 = 1760000000;   // virtual clock origin
+
+static PomodoroCycle cycle;
+
+static PomodoroConfig config(uint16_t work, uint16_t brk, uint16_t longBrk, uint8_t cycles) {
+    PomodoroConfig c = { work, brk, longBrk, cycles };
+    return c;
+}
+
+void setUp(void) {
+    cycle.reset(config(25, 5, 15, 4));
+}
+
+void tearDown(void) {}
+
+void test_phases_follow_the_schedule() {
+    cycle.start(T0);
+    TEST_ASSERT_EQUAL(POMO_WORK, cycle.phase);
+    TEST_ASSERT_EQUAL_UINT32(25 * 60, cycle.remaining(T0));
+    TEST_ASSERT_EQUAL(0, cycle.advance(T0 + 25 * 60 - 1));
+
+    TEST_ASSERT_EQUAL(POMO_SHORT_BREAK, cycle.upcoming());
+
+    TEST_ASSERT_EQUAL(1, cycle.advance(T0 + 25 * 60));
+    TEST_ASSERT_EQUAL(POMO_SHORT_BREAK, cycle.phase);
+    TEST_ASSERT_EQUAL(POMO_WORK, cycle.upcoming());
+    TEST_ASSERT_EQUAL_UINT32(5 * 60, cycle.remaining(T0 + 25 * 60));
+    TEST_ASSERT_EQUAL(1, cycle.session());
+
+    TEST_ASSERT_EQUAL(1, cycle.advance(T0 + 30 * 60));
+    TEST_ASSERT_EQUAL(POMO_WORK, cycle.phase);
+    TEST_ASSERT_EQUAL(2, cycle.session());
+}
+
+// Wakes every phase end, a few seconds late like a real deep sleep, for
+// many sets: the phases keep their planned starts and the long break comes
+// after every 4th work session.
+void test_many_cycles_on_a_virtual_clock() {
+    cycle.start(T0);
+    const uint32_t setLength = (4 * 25 + 3 * 5 + 15) * 60;
+    uint32_t longBreaks = 0;
+    uint32_t now = T0;
+
+    for (int wake = 0; wake < 8 * 50; wake++) {
+        uint8_t before = cycle.phase;
+        uint8_t expected = cycle.upcoming();
+        now = cycle.phaseEnd + 3;
+        TEST_ASSERT_EQUAL(1, cycle.advance(now));
+        TEST_ASSERT_EQUAL(expected, cycle.phase);
+        if (cycle.phase == POMO_LONG_BREAK) {
+            TEST_ASSERT_EQUAL(POMO_WORK, before);
+            longBreaks++;
+            TEST_ASSERT_EQUAL_UINT32(T0 + longBreaks * setLength - 15 * 60, cycle.phaseStart);
+        } else if (before == POMO_WORK) {
+            TEST_ASSERT_EQUAL(POMO_SHORT_BREAK, cycle.phase);
+        } else {
+            TEST_ASSERT_EQUAL(POMO_WORK, cycle.phase);
+        }
+        TEST_ASSERT_EQUAL_UINT32(cycle.phaseEnd - now, cycle.remaining(now));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(50, longBreaks);
+    TEST_ASSERT_EQUAL_UINT32(T0 + 50 * setLength, cycle.phaseStart);
+    TEST_ASSERT_EQUAL_UINT32(200, cycle.pending.workSessions);
+    TEST_ASSERT_EQUAL_UINT32(200 * 25, cycle.pending.workMinutes);
+    TEST_ASSERT_EQUAL_UINT32(50, cycle.pending.longBreaks);
+}
+
+void test_late_wake_catches_up() {
+    cycle.start(T0);
+    // Slept through work, break and most of the second work session
+    uint16_t ended = cycle.advance(T0 + 50 * 60);
+    TEST_ASSERT_EQUAL(2, ended);
+    TEST_ASSERT_EQUAL(POMO_WORK, cycle.phase);
+    TEST_ASSERT_EQUAL_UINT32(5 * 60, cycle.remaining(T0 + 50 * 60));
+
+    // A whole day in one go
+    cycle.advance(T0 + 86400);
+    TEST_ASSERT_TRUE(cycle.active());
+    TEST_ASSERT_TRUE(cycle.phaseEnd > T0 + 86400);
+    TEST_ASSERT_TRUE(cycle.phaseStart <= T0 + 86400);
+}
+
+void test_stop_counts_an_interrupted_session() {
+    cycle.start(T0);
+    cycle.stop(T0 + 10 * 60 + 30);
+    TEST_ASSERT_FALSE(cycle.active());
+    TEST_ASSERT_EQUAL_UINT32(0, cycle.remaining(T0 + 11 * 60));
+    TEST_ASSERT_EQUAL(0, cycle.advance(T0 + 86400));
+    TEST_ASSERT_EQUAL_UINT32(1, cycle.pending.interrupted);
+    TEST_ASSERT_EQUAL_UINT32(10, cycle.pending.workMinutes);
+    TEST_ASSERT_EQUAL_UINT32(0, cycle.pending.workSessions);
+}
+
+void test_stats_are_batched() {
+    cycle.start(T0);
+    uint32_t now = T0;
+    int batches = 0;
+    for (int i = 0; i < 20; i++) {
+        now = cycle.phaseEnd;
+        cycle.advance(now);
+        if (cycle.statsDue()) {
+            batches++;
+            cycle.pending.clear();   // what the adapter does after its NVS write
+        }
+    }
+    // 20 phases = 10 work sessions, one write per 4
+    TEST_ASSERT_EQUAL(2, batches);
+    TEST_ASSERT_EQUAL_UINT32(2, cycle.pending.workSessions);
+}
+
+void test_config_is_sanitized() {
+    cycle.reset(config(0, 500, 15, 0));
+    TEST_ASSERT_EQUAL(1, cycle.config.workMin);
+    TEST_ASSERT_EQUAL(POMODORO_MAX_MINUTES, cycle.config.shortBreakMin);
+    TEST_ASSERT_EQUAL(1, cycle.config.cycles);
+
+    // Every work session is followed by a long break
+    cycle.start(T0);
+    cycle.advance(T0 + 60);
+    TEST_ASSERT_EQUAL(POMO_LONG_BREAK, cycle.phase);
+
+    // A new config applies from the next phase
+    cycle.configure(config(50, 10, 30, 2));
+    TEST_ASSERT_EQUAL_UINT32(T0 + 60 + 15 * 60, cycle.phaseEnd);
+    cycle.advance(cycle.phaseEnd);
+    TEST_ASSERT_EQUAL_UINT32(50 * 60, cycle.phaseEnd - cycle.phaseStart);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_phases_follow_the_schedule);
+    RUN_TEST(test_many_cycles_on_a_virtual_clock);
+    RUN_TEST(test_late_wake_catches_up);
+    RUN_TEST(test_stop_counts_an_interrupted_session);
+    RUN_TEST(test_stats_are_batched);
+    RUN_TEST(test_config_is_sanitized);
+
+    return UNITY_END();
+}
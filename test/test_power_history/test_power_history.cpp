@@ -0,0 +1,250 @@
+#include <unity.h>
+#include "../../lib/core/power_history_codec.h"
+
+// Host-side suite: run with `pio test -e native -f test_power_history`
+
+// ---------------------------------------------------------------------------
+// Synthetic data: a slow discharge with a charger plugged in half way
+// ---------------------------------------------------------------------------
+struct SyntheticSample {
+    uint32_t epoch;
+    int32_t  level;
+    int32_t  voltage;
+    int32_t  current;
+    bool     charging;
+};
+
+static SyntheticSample synthetic(int i) {
+    SyntheticSample s;
+    s.epoch    = 1735689600UL + i * 60;
+    s.charging = i >= 300;
+    s.level    = s.charging ? 40 + (i - 300) / 10 : 100 - i / 5;
+    s.voltage  = s.charging ? 3900 + (i - 300) : 4150 - i;
+    s.current  = s.charging ? 450 - (i % 7) : -(60 + (i % 13));
+    return s;
+}
+
+// Pages persisted by the fake flash, in write order
+static uint8_t  flash[64][POWER_HISTORY_PAGE_SIZE];
+static int      flashPages;
+static PowerHistoryEncoder encoder;
+
+static void persist() {
+    memcpy(flash[flashPages++], encoder.page, POWER_HISTORY_PAGE_SIZE);
+    encoder.startPage(encoder.sequence() + 1);
+}
+
+static void appendSample(const SyntheticSample& s) {
+    if (!encoder.appendSample(s.epoch, s.level, s.voltage, s.current, s.charging)) {
+        persist();
+        TEST_ASSERT_TRUE(encoder.appendSample(s.epoch, s.level, s.voltage, s.current, s.charging));
+    }
+}
+
+void setUp(void) {
+    memset(flash, 0xFF, sizeof(flash));
+    flashPages = 0;
+    memset(&encoder, 0, sizeof(encoder));
+    encoder.startPage(0);
+}
+
+void tearDown(void) {}
+
+// ---------------------------------------------------------------------------
+// Tests
+// ---------------------------------------------------------------------------
+
+// Varints round-trip at every length boundary
+void test_varint_roundtrip() {
+    const uint32_t values[] = { 0, 1, 127, 128, 16383, 16384, 2097151, 2097152, 0xFFFFFFFFUL };
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        uint8_t  buf[5];
+        uint32_t back = 0;
+        size_t n = power_codec::putVarint(buf, sizeof(buf), values[i]);
+        TEST_ASSERT_TRUE(n > 0);
+        TEST_ASSERT_EQUAL(n, power_codec::getVarint(buf, n, &back));
+        TEST_ASSERT_EQUAL_UINT32(values[i], back);
+    }
+}
+
+// Zigzag keeps small negative deltas in a single byte
+void test_zigzag_small_deltas() {
+    TEST_ASSERT_EQUAL_UINT32(0, power_codec::zigzag(0));
+    TEST_ASSERT_EQUAL_UINT32(1, power_codec::zigzag(-1));
+    TEST_ASSERT_EQUAL_UINT32(2, power_codec::zigzag(1));
+    TEST_ASSERT_EQUAL_INT32(-64, power_codec::unzigzag(power_codec::zigzag(-64)));
+    TEST_ASSERT_EQUAL_INT32(-2147483647 - 1, power_codec::unzigzag(power_codec::zigzag(-2147483647 - 1)));
+}
+
+// Truncated varints are rejected instead of read past the end
+void test_varint_truncated() {
+    uint8_t  buf[2] = { 0x80, 0x80 };
+    uint32_t v;
+    TEST_ASSERT_EQUAL(0, power_codec::getVarint(buf, sizeof(buf), &v));
+}
+
+// A full day of synthetic samples decodes back to the exact values
+void test_synthetic_day_roundtrip() {
+    const int count = 600;
+    for (int i = 0; i < count; i++) appendSample(synthetic(i));
+
+    int decoded = 0;
+    for (int p = 0; p <= flashPages; p++) {
+        const uint8_t* page = (p < flashPages) ? flash[p] : encoder.page;
+        PowerHistoryDecoder dec(page, POWER_HISTORY_PAGE_SIZE);
+        TEST_ASSERT_TRUE(dec.isValid());
+        TEST_ASSERT_EQUAL_UINT32(p, dec.sequence());
+
+        PowerHistoryEntry e;
+        bool first = true;
+        while (dec.next(e)) {
+            SyntheticSample s = synthetic(decoded++);
+            TEST_ASSERT_EQUAL(first ? POWER_RECORD_KEYFRAME : POWER_RECORD_SAMPLE, e.type);
+            TEST_ASSERT_EQUAL_UINT32(s.epoch, e.epoch);
+            TEST_ASSERT_EQUAL_INT32(s.level, e.level);
+            TEST_ASSERT_EQUAL_INT32(s.voltage, e.voltage);
+            TEST_ASSERT_EQUAL_INT32(s.current, e.current);
+            TEST_ASSERT_EQUAL(s.charging, e.charging);
+            first = false;
+        }
+    }
+    TEST_ASSERT_EQUAL(count, decoded);
+}
+
+// Delta encoding must beat the naive 14 bytes per sample by a wide margin
+void test_compression_ratio() {
+    const int count = 600;
+    for (int i = 0; i < count; i++) appendSample(synthetic(i));
+    size_t bytes = flashPages * POWER_HISTORY_PAGE_SIZE + POWER_HISTORY_HEADER_SIZE + encoder.used;
+    TEST_ASSERT_LESS_THAN(count * 7, bytes);
+}
+
+// Events are interleaved with samples and inherit the running epoch
+void test_events_interleaved() {
+    SyntheticSample s = synthetic(0);
+    appendSample(s);
+    TEST_ASSERT_TRUE(encoder.appendEvent(s.epoch + 30, POWER_EVENT_SLEEP, 0));
+    TEST_ASSERT_TRUE(encoder.appendEvent(s.epoch + 1500, POWER_EVENT_WAKE, 4));
+    appendSample(synthetic(26));
+
+    PowerHistoryDecoder dec(encoder.page, POWER_HISTORY_PAGE_SIZE);
+    PowerHistoryEntry e;
+    TEST_ASSERT_TRUE(dec.next(e));
+    TEST_ASSERT_TRUE(dec.next(e));
+    TEST_ASSERT_EQUAL(POWER_RECORD_EVENT, e.type);
+    TEST_ASSERT_EQUAL(POWER_EVENT_SLEEP, e.event);
+    TEST_ASSERT_EQUAL_UINT32(s.epoch + 30, e.epoch);
+    TEST_ASSERT_TRUE(dec.next(e));
+    TEST_ASSERT_EQUAL(POWER_EVENT_WAKE, e.event);
+    TEST_ASSERT_EQUAL(4, e.arg);
+    TEST_ASSERT_EQUAL_UINT32(s.epoch + 1500, e.epoch);
+    TEST_ASSERT_TRUE(dec.next(e));
+    TEST_ASSERT_EQUAL(POWER_RECORD_SAMPLE, e.type);
+    TEST_ASSERT_EQUAL_INT32(synthetic(26).level, e.level);
+    TEST_ASSERT_FALSE(dec.next(e));
+}
+
+// An event opening a page carries a keyframe so the page stays decodable
+void test_event_opens_page_with_keyframe() {
+    appendSample(synthetic(0));
+    persist();
+    TEST_ASSERT_TRUE(encoder.appendEvent(synthetic(0).epoch + 10, POWER_EVENT_CHARGE_START, 0));
+
+    PowerHistoryDecoder dec(encoder.page, POWER_HISTORY_PAGE_SIZE);
+    PowerHistoryEntry e;
+    char line[96];
+    TEST_ASSERT_TRUE(dec.next(e));
+    TEST_ASSERT_EQUAL(POWER_RECORD_KEYFRAME, e.type);
+    TEST_ASSERT_TRUE(e.carried);
+    TEST_ASSERT_EQUAL_INT32(synthetic(0).level, e.level);
+    TEST_ASSERT_EQUAL(0, formatPowerHistoryCsv(e, line, sizeof(line)));   // not a reading
+    TEST_ASSERT_EQUAL_STRING("", line);
+    TEST_ASSERT_TRUE(dec.next(e));
+    TEST_ASSERT_EQUAL(POWER_EVENT_CHARGE_START, e.event);
+    TEST_ASSERT_EQUAL_UINT32(synthetic(0).epoch + 10, e.epoch);
+    formatPowerHistoryCsv(e, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("1735689610,event,,,,,charge_start,0", line);
+
+    // The next real sample is a delta on the page, exported as a sample
+    appendSample(synthetic(1));
+    PowerHistoryDecoder again(encoder.page, POWER_HISTORY_PAGE_SIZE);
+    for (int i = 0; i < 3; i++) TEST_ASSERT_TRUE(again.next(e));
+    TEST_ASSERT_FALSE(e.carried);
+    TEST_ASSERT_TRUE(formatPowerHistoryCsv(e, line, sizeof(line)) > 0);
+    TEST_ASSERT_EQUAL_STRING("1735689660,sample,100,4149,-61,0,,", line);
+}
+
+// Cold boot: BOOT is recorded before any sample, no zero reading in the log
+void test_boot_event_first_has_no_fake_sample() {
+    TEST_ASSERT_TRUE(encoder.appendEvent(1735689600UL, POWER_EVENT_BOOT, 0));
+    PowerHistoryDecoder dec(encoder.page, POWER_HISTORY_PAGE_SIZE);
+    PowerHistoryEntry e;
+    char line[96];
+    int  rows = 0;
+    while (dec.next(e)) {
+        if (formatPowerHistoryCsv(e, line, sizeof(line)) > 0) rows++;
+    }
+    TEST_ASSERT_EQUAL(1, rows);
+    TEST_ASSERT_EQUAL_STRING("1735689600,event,,,,,boot,0", line);
+}
+
+// Erased flash (all 0xFF) and garbage headers are not valid pages
+void test_erased_page_invalid() {
+    uint8_t erased[POWER_HISTORY_PAGE_SIZE];
+    memset(erased, 0xFF, sizeof(erased));
+    PowerHistoryDecoder dec(erased, sizeof(erased));
+    TEST_ASSERT_FALSE(dec.isValid());
+
+    PowerHistoryEntry e;
+    TEST_ASSERT_FALSE(dec.next(e));
+}
+
+// A corrupt record stops decoding of the page without reading past it
+void test_corrupt_record_stops() {
+    appendSample(synthetic(0));
+    appendSample(synthetic(1));
+    encoder.page[POWER_HISTORY_HEADER_SIZE + encoder.used - 5] = 0x0E; // bogus type
+
+    PowerHistoryDecoder dec(encoder.page, POWER_HISTORY_PAGE_SIZE);
+    PowerHistoryEntry e;
+    int n = 0;
+    while (dec.next(e)) n++;
+    TEST_ASSERT_EQUAL(1, n);
+}
+
+// CSV formatting of samples and events
+void test_csv_format() {
+    PowerHistoryEntry e;
+    memset(&e, 0, sizeof(e));
+    e.type = POWER_RECORD_SAMPLE; e.epoch = 1000; e.level = 87;
+    e.voltage = 4012; e.current = -73; e.charging = false;
+
+    char line[96];
+    formatPowerHistoryCsv(e, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("1000,sample,87,4012,-73,0,,", line);
+
+    e.type = POWER_RECORD_EVENT; e.event = POWER_EVENT_WAKE; e.arg = 4;
+    formatPowerHistoryCsv(e, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("1000,event,,,,,wake,4", line);
+}
+
+// ---------------------------------------------------------------------------
+// Entry point
+// ---------------------------------------------------------------------------
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_varint_roundtrip);
+    RUN_TEST(test_zigzag_small_deltas);
+    RUN_TEST(test_varint_truncated);
+    RUN_TEST(test_synthetic_day_roundtrip);
+    RUN_TEST(test_compression_ratio);
+    RUN_TEST(test_events_interleaved);
+    RUN_TEST(test_event_opens_page_with_keyframe);
+    RUN_TEST(test_boot_event_first_has_no_fake_sample);
+    RUN_TEST(test_erased_page_invalid);
+    RUN_TEST(test_corrupt_record_stops);
+    RUN_TEST(test_csv_format);
+
+    return UNITY_END();
+}
@@ -0,0 +1,191 @@
+#include <unity.h>
+#include "../../lib/core/second_ticker.h"
+
+// Run with `pio test -e native -f test_second_ticker`
+
+// Simulated RTC: its seconds change every periodUs, first at phaseUs
+struct FakeRtc {
+    int64_t phaseUs;
+    int64_t periodNs;
+
+    int64_t second(int64_t nowUs) const {
+        return nowUs < phaseUs ? -1 : (nowUs - phaseUs) * 1000 / periodNs;
+    }
+    int64_t edge(int64_t k) const { return phaseUs + k * periodNs / 1000; }
+    // First edge after t, found by polling every stepUs
+    int64_t pollEdge(int64_t t, int64_t stepUs) const {
+        int64_t s = second(t);
+        while (second(t) == s) t += stepUs;
+        return t;
+    }
+};
+
+static SecondTicker ticker;
+
+void setUp(void) {
+    ticker.reset();
+}
+
+void tearDown(void) {}
+
+void test_ticks_follow_the_edge() {
+    FakeRtc rtc = { 432100, 1000000000LL };
+    TEST_ASSERT_TRUE(ticker.calibrationDue());
+    TEST_ASSERT_FALSE(ticker.due(10000000));
+
+    ticker.calibrate(rtc.edge(3));
+    TEST_ASSERT_TRUE(ticker.locked());
+    TEST_ASSERT_FALSE(ticker.calibrationDue());
+    TEST_ASSERT_EQUAL_INT64(rtc.edge(4) + SECOND_TICK_GUARD_US, ticker.nextTickUs());
+    TEST_ASSERT_FALSE(ticker.due(ticker.nextTickUs() - 1));
+    TEST_ASSERT_TRUE(ticker.due(ticker.nextTickUs()));
+
+    // Loop polls every 10 ms: the tick lands between guard and guard + 10 ms
+    int64_t now = ticker.nextTickUs() + 7000;
+    TEST_ASSERT_TRUE(ticker.onTick(now, true));
+    TEST_ASSERT_EQUAL_INT32(SECOND_TICK_GUARD_US + 7000, ticker.stats().maxLateUs);
+    TEST_ASSERT_EQUAL_INT64(rtc.edge(5) + SECOND_TICK_GUARD_US, ticker.nextTickUs());   // not now + 1 s
+}
+
+// 30 ppm between the crystals: the guard is used up after ~67 s, the tick
+// then comes before the RTC changed. That slip triggers a calibration
+// which learns the period, after which no tick is early again.
+void test_period_is_learned_from_edges() {
+    FakeRtc rtc = { 250000, 1000030000LL };
+    ticker.calibrate(rtc.pollEdge(0, 500));
+
+    int64_t lastSecond = rtc.second(ticker.nextEdgeUs() - 500000);
+    uint32_t slipsAtHour = 0;
+    for (int i = 0; i < 3600; i++) {
+        if (ticker.calibrationDue()) {
+            int64_t edge = rtc.pollEdge(ticker.nextEdgeUs() - 25000, 500);
+            ticker.calibrate(edge);
+            lastSecond = rtc.second(edge);
+        }
+        int64_t now = ticker.nextTickUs();
+        int64_t s   = rtc.second(now);
+        ticker.onTick(now, s != lastSecond);
+        lastSecond = s;
+        if (i == 600) slipsAtHour = ticker.stats().slips;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(1, slipsAtHour);
+    TEST_ASSERT_EQUAL_UINT32(1, ticker.stats().slips);
+    TEST_ASSERT_INT32_WITHIN(2, 30, ticker.periodPpm());
+    TEST_ASSERT_EQUAL_UINT32(0, ticker.stats().skipped);
+}
+
+void test_missed_seconds_are_skipped() {
+    ticker.calibrate(1000000);
+    int64_t late = ticker.nextTickUs() + 5300000;   // page hidden for 5.3 s
+    ticker.onTick(late, true);
+    TEST_ASSERT_EQUAL_UINT32(5, ticker.stats().skipped);
+    TEST_ASSERT_TRUE(ticker.nextTickUs() > late);
+    TEST_ASSERT_TRUE(ticker.nextTickUs() - late <= 1000000);
+    TEST_ASSERT_FALSE(ticker.due(late));
+}
+
+void test_recalibration_cadence_and_bad_edges() {
+    ticker.calibrate(0);
+    for (int i = 0; i < SECOND_TICK_RECAL_TICKS - 1; i++) ticker.onTick(ticker.nextTickUs(), true);
+    TEST_ASSERT_FALSE(ticker.calibrationDue());
+    ticker.onTick(ticker.nextTickUs(), true);
+    TEST_ASSERT_TRUE(ticker.calibrationDue());
+
+    // An edge half a second off is not taken as drift
+    ticker.calibrate(ticker.nextEdgeUs() + 500000);
+    TEST_ASSERT_EQUAL_INT32(0, ticker.periodPpm());
+    TEST_ASSERT_EQUAL_UINT32(2, ticker.stats().calibrations);
+}
+
+// Simulated polling: each read of the seconds takes stepUs
+struct FakePoll {
+    const FakeRtc* rtc;
+    int64_t        t;
+    int64_t        stepUs;
+
+    uint8_t read()  { t += stepUs; return (uint8_t)(rtc->second(t) % 60); }
+    int64_t now()   { return t; }
+    int64_t observe(int64_t windowUs, uint8_t lastSecond, uint8_t* second) {
+        return observeSecondEdge(windowUs, lastSecond, [this]() { return read(); },
+                                 [this]() { return now(); }, second);
+    }
+};
+
+void test_edge_is_only_taken_when_seen_changing() {
+    FakeRtc rtc = { 250000, 1000000000LL };
+    uint8_t s = 0;
+
+    // Window on time: the edge within a poll step
+    FakePoll on = { &rtc, rtc.edge(10) - SECOND_EDGE_LEAD_US, 200 };
+    int64_t edge = on.observe(on.t, (uint8_t)(rtc.second(on.t) % 60), &s);
+    TEST_ASSERT_INT32_WITHIN(200, 0, (int32_t)(edge - rtc.edge(10)));
+    TEST_ASSERT_EQUAL_UINT8(10, s);
+
+    // Back after 20 min in the fine phase, 450 ms after an edge: the seconds
+    // already differ, no calibration on that time
+    int64_t window = rtc.edge(10) - SECOND_EDGE_LEAD_US;
+    FakePoll late = { &rtc, rtc.edge(1210) + 450000, 200 };
+    TEST_ASSERT_EQUAL_INT64(-1, late.observe(window, 9, &s));
+
+    // Only a little late (a stall shorter than the lead), but the second
+    // already changed: the edge is behind, not seen
+    FakePoll stalled = { &rtc, rtc.edge(10) + 3000, 200 };
+    TEST_ASSERT_EQUAL_INT64(-1, stalled.observe(rtc.edge(10) - 20000, 9, &s));
+
+    // No change before the timeout (RTC set meanwhile)
+    FakePoll none = { &rtc, rtc.edge(10) + 100000, 200 };
+    TEST_ASSERT_EQUAL_INT64(-1, none.observe(none.t, 10, &s));
+    TEST_ASSERT_TRUE(none.t - (rtc.edge(10) + 100000) >= SECOND_EDGE_TIMEOUT_US);
+}
+
+// The RTC set 5 ms off its old phase, which measured across the write
+// would pass for a 250 ppm period: the first edge after it is an anchor
+// only, the learned period is kept and the next ones refine it
+void test_resync_after_an_rtc_write() {
+    FakeRtc rtc = { 100000, 1000030000LL };
+    ticker.calibrate(rtc.edge(0));
+    ticker.calibrate(rtc.edge(20));
+    TEST_ASSERT_INT32_WITHIN(1, 30, ticker.periodPpm());
+
+    ticker.resync();
+    TEST_ASSERT_FALSE(ticker.locked());
+    TEST_ASSERT_TRUE(ticker.calibrationDue());
+    TEST_ASSERT_FALSE(ticker.due(rtc.edge(30)));
+
+    FakeRtc moved = { rtc.edge(40) + 5000, 1000030000LL };
+    ticker.calibrate(moved.edge(0));
+    TEST_ASSERT_INT32_WITHIN(1, 30, ticker.periodPpm());
+    TEST_ASSERT_EQUAL_INT64(moved.edge(1) + SECOND_TICK_GUARD_US, ticker.nextTickUs());
+
+    ticker.calibrate(moved.edge(60));
+    TEST_ASSERT_INT32_WITHIN(1, 30, ticker.periodPpm());
+}
+
+void test_jitter_stats() {
+    SecondTickStats s;
+    s.clear();
+    s.addLateness(2000);
+    s.addLateness(2000);
+    TEST_ASSERT_EQUAL_INT32(0, s.jitterUs());
+    s.addLateness(4000);
+    s.addLateness(4000);
+    TEST_ASSERT_EQUAL_INT32(3000, s.meanLateUs());
+    TEST_ASSERT_EQUAL_INT32(1000, s.jitterUs());
+    TEST_ASSERT_EQUAL_INT32(2000, s.minLateUs);
+    TEST_ASSERT_EQUAL_INT32(4000, s.maxLateUs);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_ticks_follow_the_edge);
+    RUN_TEST(test_period_is_learned_from_edges);
+    RUN_TEST(test_missed_seconds_are_skipped);
+    RUN_TEST(test_recalibration_cadence_and_bad_edges);
+    RUN_TEST(test_edge_is_only_taken_when_seen_changing);
+    RUN_TEST(test_resync_after_an_rtc_write);
+    RUN_TEST(test_jitter_stats);
+
+    return UNITY_END();
+}
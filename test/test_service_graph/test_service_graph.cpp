@@ -0,0 +1,127 @@
+#include <unity.h>
+#include <string.h>
+#include "../../lib/core/service_graph.h"
+
+// Run with `pio test -e native -f test_service_graph`
+
+// Virtual clock: every init takes 1 ms, the order is logged
+static uint32_t nowUs;
+static char     order[32];
+
+static uint32_t fakeClock() { return nowUs; }
+
+static void trace(char c) {
+    size_t n = strlen(order);
+    order[n] = c;
+    order[n + 1] = '\0';
+    nowUs += 1000;
+}
+
+enum { A = 0, B, C, D, E };
+
+static void initA() { trace('a'); }
+static void initB() { trace('b'); }
+static void initC() { trace('c'); }
+static void initD() { trace('d'); }
+static void initE() { trace('e'); }
+
+void setUp(void) {
+    nowUs = 0;
+    order[0] = '\0';
+}
+
+void tearDown(void) {}
+
+void test_dependencies_start_first() {
+    ServiceGraph g(fakeClock);
+    // Registered in the wrong order on purpose
+    g.add(A, "a", SERVICE_EARLY, SERVICE_BIT(C) | SERVICE_BIT(B), initA);
+    g.add(B, "b", SERVICE_LAZY, SERVICE_BIT(C), initB);
+    g.add(C, "c", SERVICE_BACKGROUND, 0, initC);
+
+    TEST_ASSERT_EQUAL(1, g.runStage(SERVICE_EARLY));
+    TEST_ASSERT_EQUAL_STRING("cba", order);
+    TEST_ASSERT_TRUE(g.ready(B));
+    TEST_ASSERT_FALSE(g.pending(SERVICE_BACKGROUND));   // C was pulled in already
+    TEST_ASSERT_FALSE(g.runNext(SERVICE_BACKGROUND));
+}
+
+void test_stages_and_first_use() {
+    ServiceGraph g(fakeClock);
+    g.add(A, "a", SERVICE_EARLY, 0, initA);
+    g.add(B, "b", SERVICE_BACKGROUND, 0, initB);
+    g.add(C, "c", SERVICE_BACKGROUND, SERVICE_BIT(A), initC);
+    g.add(D, "d", SERVICE_LAZY, SERVICE_BIT(B), initD);
+
+    g.runStage(SERVICE_EARLY);
+    g.markFirstFrame();
+    TEST_ASSERT_EQUAL_UINT32(1000, g.firstFrameUs());
+
+    // One per loop pass
+    TEST_ASSERT_TRUE(g.runNext(SERVICE_BACKGROUND));
+    TEST_ASSERT_EQUAL_STRING("ab", order);
+    TEST_ASSERT_TRUE(g.pending(SERVICE_BACKGROUND));
+    TEST_ASSERT_TRUE(g.runNext(SERVICE_BACKGROUND));
+    TEST_ASSERT_FALSE(g.pending(SERVICE_BACKGROUND));
+
+    TEST_ASSERT_FALSE(g.ready(D));
+    TEST_ASSERT_TRUE(g.use(D));
+    TEST_ASSERT_TRUE(g.use(D));        // already up, not run again
+    TEST_ASSERT_EQUAL_STRING("abcd", order);
+
+    g.markFirstFrame();                // only the first one counts
+    TEST_ASSERT_EQUAL_UINT32(1000, g.firstFrameUs());
+}
+
+void test_timeline() {
+    ServiceGraph g(fakeClock);
+    g.add(A, "alpha", SERVICE_EARLY, SERVICE_BIT(B), initA);
+    g.add(B, "beta", SERVICE_LAZY, 0, initB);
+    g.add(C, "gamma", SERVICE_LAZY, 0, initC);
+    g.runStage(SERVICE_EARLY);
+    g.use(C);
+
+    TEST_ASSERT_EQUAL(3, g.timelineCount());
+    TEST_ASSERT_EQUAL(B, g.timeline(0).id);
+    TEST_ASSERT_EQUAL(SERVICE_BY_DEPENDENCY, g.timeline(0).trigger);
+    TEST_ASSERT_EQUAL(A, g.timeline(1).id);
+    TEST_ASSERT_EQUAL(SERVICE_BY_EARLY, g.timeline(1).trigger);
+    TEST_ASSERT_EQUAL_UINT32(1000, g.timeline(1).startUs);
+    TEST_ASSERT_EQUAL_UINT32(1000, g.timeline(1).durationUs);   // its dependency not included
+    TEST_ASSERT_EQUAL(SERVICE_BY_USE, g.timeline(2).trigger);
+
+    char line[64];
+    g.formatTimelineRow(1, line, sizeof(line));
+    TEST_ASSERT_NOT_NULL(strstr(line, "alpha"));
+    TEST_ASSERT_NOT_NULL(strstr(line, "early"));
+}
+
+void test_cycles_and_missing_dependencies_fail() {
+    ServiceGraph g(fakeClock);
+    g.add(A, "a", SERVICE_EARLY, SERVICE_BIT(B), initA);
+    g.add(B, "b", SERVICE_LAZY, SERVICE_BIT(A), initB);
+    g.add(C, "c", SERVICE_EARLY, SERVICE_BIT(E), initC);   // E never registered
+    g.add(D, "d", SERVICE_EARLY, 0, initD);
+
+    g.runStage(SERVICE_EARLY);
+    TEST_ASSERT_EQUAL_STRING("d", order);
+    TEST_ASSERT_EQUAL(SERVICE_FAILED, g.state(A));
+    TEST_ASSERT_EQUAL(SERVICE_FAILED, g.state(B));
+    TEST_ASSERT_EQUAL(SERVICE_FAILED, g.state(C));
+    TEST_ASSERT_FALSE(g.use(A));
+    TEST_ASSERT_FALSE(g.pending(SERVICE_EARLY));
+
+    TEST_ASSERT_FALSE(g.add(D, "again", SERVICE_EARLY, 0, initE));
+    TEST_ASSERT_FALSE(g.add(SERVICE_MAX, "out", SERVICE_EARLY, 0, initE));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_dependencies_start_first);
+    RUN_TEST(test_stages_and_first_use);
+    RUN_TEST(test_timeline);
+    RUN_TEST(test_cycles_and_missing_dependencies_fail);
+
+    return UNITY_END();
+}
@@ -0,0 +1,151 @@
+#include <unity.h>
+#include <stdlib.h>
+#include "../../lib/core/sntp.h"
+#include "../../lib/core/rtc_drift.h"
+
+// Run with `pio test -e native -f test_sntp`
+// The server side below is a minimal NTP stand-in with an injected offset,
+// same idea as tools/ntp_standin.py on the network.
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const int64_t T0 = 1735732800000LL;  // 2025-01-01 12:00:00 UTC
+
+// Answers a request the way a server whose clock is offsetMs ahead would
+static void standinReply(const uint8_t* request, uint8_t* reply, int64_t serverRecvMs, int64_t serverSendMs) {
+    memset(reply, 0, NTP_PACKET_SIZE);
+    reply[0] = (4 << 3) | 4;
+    reply[1] = 2;
+    memcpy(reply + NTP_ORIGINATE_POS, request + NTP_TRANSMIT_POS, 8);
+    ntpWriteMs(reply + NTP_RECEIVE_POS, serverRecvMs);
+    ntpWriteMs(reply + NTP_TRANSMIT_POS, serverSendMs);
+}
+
+void test_timestamp_round_trip() {
+    uint8_t buf[8];
+    const int64_t values[] = { T0, T0 + 1, T0 + 999, 0, 4102444800123LL };
+    for (size_t i = 0; i < 5; i++) {
+        ntpWriteMs(buf, values[i]);
+        TEST_ASSERT_TRUE(ntpReadMs(buf) == values[i]);
+    }
+}
+
+void test_offset_against_standin() {
+    const int64_t injected[] = { 1500, -2750, 37, 0 };
+    for (size_t i = 0; i < 4; i++) {
+        uint8_t req[NTP_PACKET_SIZE], rep[NTP_PACKET_SIZE];
+        int64_t t1 = T0;
+        ntpBuildRequest(req, t1);
+        // 40 ms out, 2 ms in the server, 60 ms back (asymmetric path)
+        int64_t t2 = t1 + 40 + injected[i];
+        int64_t t3 = t2 + 2;
+        int64_t t4 = t1 + 102;
+        standinReply(req, rep, t2, t3);
+
+        NtpReply r;
+        TEST_ASSERT_TRUE(ntpParseReply(rep, sizeof(rep), req, r));
+        NtpSample s = ntpComputeSample(t1, r.receiveMs, r.transmitMs, t4);
+        TEST_ASSERT_TRUE(s.delayMs == 100);
+        // Asymmetry error is half the path difference: 10 ms
+        TEST_ASSERT_INT_WITHIN(10, (int)injected[i], (int)s.offsetMs);
+    }
+}
+
+void test_rejects_bad_replies() {
+    uint8_t req[NTP_PACKET_SIZE], other[NTP_PACKET_SIZE], rep[NTP_PACKET_SIZE];
+    NtpReply r;
+    ntpBuildRequest(req, T0);
+    ntpBuildRequest(other, T0 + 5);
+
+    standinReply(other, rep, T0, T0);                       // answers another request
+    TEST_ASSERT_FALSE(ntpParseReply(rep, sizeof(rep), req, r));
+
+    standinReply(req, rep, T0, T0);
+    TEST_ASSERT_FALSE(ntpParseReply(rep, 40, req, r));      // truncated
+    rep[1] = 0;                                             // kiss-o'-death
+    TEST_ASSERT_FALSE(ntpParseReply(rep, sizeof(rep), req, r));
+    rep[1] = 2;
+    rep[0] = (3 << 6) | (4 << 3) | 4;                       // unsynchronized
+    TEST_ASSERT_FALSE(ntpParseReply(rep, sizeof(rep), req, r));
+    rep[0] = (4 << 3) | 3;                                  // client mode
+    TEST_ASSERT_FALSE(ntpParseReply(rep, sizeof(rep), req, r));
+    rep[0] = (4 << 3) | 4;
+    TEST_ASSERT_TRUE(ntpParseReply(rep, sizeof(rep), req, r));
+}
+
+// RTC running 23 ppm slow, synced every 6 h with +-20 ms measurement noise,
+// stepped between syncs by the estimator
+void test_drift_is_learned_and_compensated() {
+    const float  truePpm = 23.0f;
+    RtcDriftEstimator est;
+    est.reset();
+
+    int64_t now    = T0;
+    double  rtcErr = 0;  // true - RTC, ms
+    int32_t worst  = 0;
+    srand(1);
+    for (int sync = 0; sync < 12; sync++) {
+        int32_t noise = (rand() % 41) - 20;
+        est.onSync(now, (int32_t)rtcErr + noise);
+        rtcErr = 0;
+
+        // 6 h in 1 min steps
+        for (int m = 0; m < 360; m++) {
+            now    += 60000;
+            rtcErr += truePpm * 60000 / 1e6;
+            int32_t step = est.dueStepMs(now);
+            if (step) {
+                rtcErr -= step;
+                est.applied(step);
+            }
+            if (sync >= 2 && abs((int)rtcErr) > worst) worst = abs((int)rtcErr);
+        }
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.5f, truePpm, est.ppm);
+    // Once learned the clock never drifts past one second
+    TEST_ASSERT_TRUE(worst < 1000);
+    TEST_ASSERT_TRUE(est.resyncIntervalS(500) > RTC_RESYNC_DEFAULT_S);
+}
+
+void test_short_spans_and_outliers_are_ignored() {
+    RtcDriftEstimator est;
+    est.reset();
+    TEST_ASSERT_FALSE(est.onSync(T0, 0));
+    TEST_ASSERT_FALSE(est.onSync(T0 + 600000, 300));           // 10 min span
+    TEST_ASSERT_FALSE(est.onSync(T0 + 600000 + 3600000, 59000)); // manual time change
+    TEST_ASSERT_EQUAL(0, est.samples);
+    TEST_ASSERT_EQUAL(0, est.dueStepMs(T0 + 86400000LL));
+    TEST_ASSERT_EQUAL(RTC_RESYNC_DEFAULT_S, est.resyncIntervalS(500));
+
+    TEST_ASSERT_TRUE(est.onSync(T0 + 600000 + 2 * 3600000, -36));  // -10 ppm
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -10.0f, est.ppm);
+}
+
+void test_steps_round_to_whole_seconds() {
+    RtcDriftEstimator est;
+    est.reset();
+    est.anchorMs = T0;
+    est.ppm      = 100.0f;
+    est.samples  = 1;
+    TEST_ASSERT_EQUAL(0, est.dueStepMs(T0 + 4000000LL));      // 400 ms
+    TEST_ASSERT_EQUAL(1000, est.dueStepMs(T0 + 6000000LL));   // 600 ms
+    est.applied(1000);
+    TEST_ASSERT_EQUAL(-400, est.predictedErrorMs(T0 + 6000000LL));
+    est.ppm = -100.0f;
+    est.correctedMs = 0;
+    TEST_ASSERT_EQUAL(-2000, est.dueStepMs(T0 + 16000000LL)); // -1600 ms
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_timestamp_round_trip);
+    RUN_TEST(test_offset_against_standin);
+    RUN_TEST(test_rejects_bad_replies);
+    RUN_TEST(test_drift_is_learned_and_compensated);
+    RUN_TEST(test_short_spans_and_outliers_are_ignored);
+    RUN_TEST(test_steps_round_to_whole_seconds);
+
+    return UNITY_END();
+}
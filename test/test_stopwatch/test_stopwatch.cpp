@@ -0,0 +1,69 @@
+#include <unity.h>
+#include <string.h>
+#include "../../lib/core/stopwatch.h"
+
+// Run with `pio test -e native -f test_stopwatch`
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_runs_and_pauses() {
+    Stopwatch sw;
+    TEST_ASSERT_EQUAL_INT64(0, sw.elapsedUs(5000000));
+
+    sw.start(1000000);
+    TEST_ASSERT_EQUAL_INT64(2500000, sw.elapsedUs(3500000));
+    sw.stop(4000000);
+    TEST_ASSERT_FALSE(sw.running());
+    TEST_ASSERT_EQUAL_INT64(3000000, sw.elapsedUs(9000000));   // frozen while stopped
+
+    sw.start(10000000);
+    TEST_ASSERT_EQUAL_INT64(3000123, sw.elapsedUs(10000123));
+    sw.reset();
+    TEST_ASSERT_EQUAL_INT64(0, sw.elapsedUs(20000000));
+}
+
+void test_laps_ring_keeps_the_newest() {
+    Stopwatch sw;
+    TEST_ASSERT_FALSE(sw.lap(0));                              // not running
+    sw.start(0);
+    for (int i = 1; i <= STOPWATCH_MAX_LAPS + 3; i++) sw.lap((int64_t)i * 1000000 + i * 1000);
+
+    const StopwatchLaps& laps = sw.laps();
+    TEST_ASSERT_EQUAL_UINT32(STOPWATCH_MAX_LAPS + 3, laps.total());
+    TEST_ASSERT_EQUAL_UINT8(STOPWATCH_MAX_LAPS, laps.count());
+    TEST_ASSERT_EQUAL_UINT16(STOPWATCH_MAX_LAPS + 3, laps.get(0).number);
+    TEST_ASSERT_EQUAL_UINT16(4, laps.get(STOPWATCH_MAX_LAPS - 1).number);
+    TEST_ASSERT_EQUAL_INT64(1001000, laps.get(0).splitUs);
+    TEST_ASSERT_EQUAL_INT64(13013000, laps.get(0).totalUs);
+    TEST_ASSERT_EQUAL_INT64(500000, sw.currentLapUs(13513000));
+}
+
+void test_format_truncates_to_the_hundredth() {
+    char text[STOPWATCH_TEXT_LEN + 1];
+    stopwatchFormat(0, text);
+    TEST_ASSERT_EQUAL_STRING("00:00.00", text);
+    stopwatchFormat(61239999, text);
+    TEST_ASSERT_EQUAL_STRING("01:01.23", text);
+    stopwatchFormat(3600000000LL + 5010000, text);                 // hours shown apart
+    TEST_ASSERT_EQUAL_STRING("00:05.01", text);
+    TEST_ASSERT_EQUAL_UINT32(1, stopwatchHours(3600000000LL + 5010000));
+}
+
+void test_only_changed_digits() {
+    TEST_ASSERT_EQUAL_HEX32(0xC0, stopwatchChangedMask("00:12.34", "00:12.67", 8));
+    TEST_ASSERT_EQUAL_HEX32(0xD8, stopwatchChangedMask("00:19.99", "00:20.02", 8));   // not the dot
+    TEST_ASSERT_EQUAL_HEX32(0, stopwatchChangedMask("00:20.02", "00:20.02", 8));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_runs_and_pauses);
+    RUN_TEST(test_laps_ring_keeps_the_newest);
+    RUN_TEST(test_format_truncates_to_the_hundredth);
+    RUN_TEST(test_only_changed_digits);
+
+    return UNITY_END();
+}
@@ -0,0 +1,115 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "../../lib/core/telemetry_batch.h"
+
+// Run with `pio test -e native -f test_telemetry_batch`
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_shared_base_and_delta_offsets() {
+    TelemetryBatch<256> batch;
+    TEST_ASSERT_EQUAL(TELEMETRY_ADDED, batch.add(5000, 1735732800, "temp", 23.5f));
+    TEST_ASSERT_EQUAL(TELEMETRY_ADDED, batch.add(6000, 1735732801, "hum", 40));
+    TEST_ASSERT_EQUAL(TELEMETRY_ADDED, batch.add(7500, 1735732802, "temp", 23.625f));
+
+    size_t len;
+    const char* json = batch.finish(&len);
+    TEST_ASSERT_EQUAL_STRING(
+        "{\"t0\":1735732800,\"s\":[[0,0,23.5],[1000,1,40],[2500,0,23.625]],\"k\":[\"temp\",\"hum\"]}", json);
+    TEST_ASSERT_EQUAL(strlen(json), len);
+}
+
+void test_size_prediction_is_exact() {
+    TelemetryBatch<256> batch;
+    batch.add(0, 1, "a", 1);
+    batch.add(10, 1, "bb", 2.5f);
+    size_t predicted = batch.size();
+    size_t len;
+    batch.finish(&len);
+    TEST_ASSERT_EQUAL(predicted, len);
+}
+
+// Whatever the key mix, the payload never outgrows the buffer and FULL is
+// only returned once nothing else fits
+void test_never_overflows() {
+    static const char* const KEYS[] = { "t", "humidity", "co2", "battery_level", "rssi" };
+    for (int round = 0; round < 50; round++) {
+        TelemetryBatch<128> batch;
+        uint32_t added = 0;
+        for (int i = 0; i < 100; i++) {
+            TelemetryAddResult r = batch.add(i * 997, 1700000000, KEYS[(i * 7 + round) % 5], i * 1.25f - round);
+            if (r == TELEMETRY_FULL) break;
+            TEST_ASSERT_EQUAL(TELEMETRY_ADDED, r);
+            added++;
+        }
+        TEST_ASSERT_TRUE(added > 0);
+        size_t len;
+        const char* json = batch.finish(&len);
+        TEST_ASSERT_TRUE(len < 128);
+        TEST_ASSERT_EQUAL(strlen(json), len);
+        TEST_ASSERT_EQUAL('}', json[len - 1]);
+    }
+}
+
+void test_rejects_bad_keys() {
+    TelemetryBatch<128> batch;
+    TEST_ASSERT_EQUAL(TELEMETRY_REJECTED, batch.add(0, 0, "", 1));
+    TEST_ASSERT_EQUAL(TELEMETRY_REJECTED, batch.add(0, 0, "a\"b", 1));
+    TEST_ASSERT_EQUAL(TELEMETRY_REJECTED, batch.add(0, 0, nullptr, 1));
+    TEST_ASSERT_TRUE(batch.empty());
+    TEST_ASSERT_NULL(batch.finish());
+}
+
+// A failed sensor read must not make the whole batch invalid JSON
+void test_rejects_non_finite_values() {
+    TelemetryBatch<128> batch;
+    TEST_ASSERT_EQUAL(TELEMETRY_REJECTED, batch.add(0, 100, "temp", NAN));
+    TEST_ASSERT_EQUAL(TELEMETRY_REJECTED, batch.add(0, 100, "temp", INFINITY));
+    TEST_ASSERT_TRUE(batch.empty());
+
+    TEST_ASSERT_EQUAL(TELEMETRY_ADDED, batch.add(0, 100, "temp", 23.5f));
+    TEST_ASSERT_EQUAL(TELEMETRY_REJECTED, batch.add(10, 100, "hum", -INFINITY));
+    TEST_ASSERT_EQUAL_STRING("{\"t0\":100,\"s\":[[0,0,23.5]],\"k\":[\"temp\"]}", batch.finish());
+}
+
+void test_key_table_full_asks_for_flush() {
+    TelemetryBatch<1024> batch;
+    char key[8];
+    for (int i = 0; i < TELEMETRY_MAX_KEYS; i++) {
+        snprintf(key, sizeof(key), "k%d", i);
+        TEST_ASSERT_EQUAL(TELEMETRY_ADDED, batch.add(i, 0, key, i));
+    }
+    TEST_ASSERT_EQUAL(TELEMETRY_FULL, batch.add(99, 0, "extra", 1));
+    TEST_ASSERT_EQUAL(TELEMETRY_ADDED, batch.add(99, 0, "k3", 1));  // known keys still fit
+
+    batch.reset();
+    TEST_ASSERT_EQUAL(TELEMETRY_ADDED, batch.add(100, 0, "extra", 1));
+}
+
+void test_stats_helpers() {
+    TelemetryStats s;
+    memset(&s, 0, sizeof(s));
+    TEST_ASSERT_EQUAL(0, s.packetsSaved());
+    s.samples = 60;
+    s.packets = 2;
+    s.bytes   = 900;
+    TEST_ASSERT_EQUAL(58, s.packetsSaved());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 15.0f, s.bytesPerSample());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_shared_base_and_delta_offsets);
+    RUN_TEST(test_size_prediction_is_exact);
+    RUN_TEST(test_never_overflows);
+    RUN_TEST(test_rejects_bad_keys);
+    RUN_TEST(test_rejects_non_finite_values);
+    RUN_TEST(test_key_table_full_asks_for_flush);
+    RUN_TEST(test_stats_helpers);
+
+    return UNITY_END();
+}
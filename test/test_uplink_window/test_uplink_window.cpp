@@ -0,0 +1,116 @@
+#include <unity.h>
+#include "../../lib/core/uplink_window.h"
+
+// Run with `pio test -e native -f test_uplink_window`
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const UplinkPolicy POLICY = { 900, 4096, 8000, 500 };
+
+static UplinkWindow makeWindow() {
+    UplinkWindow w;
+    w.setPolicy(POLICY);
+    return w;
+}
+
+void test_due_on_cadence_and_queue() {
+    TEST_ASSERT_EQUAL(UPLINK_TRIGGER_CADENCE, uplinkWindowDue(POLICY, 1000, 0, 0));
+    TEST_ASSERT_EQUAL(UPLINK_TRIGGER_NONE, uplinkWindowDue(POLICY, 1899, 1000, 0));
+    TEST_ASSERT_EQUAL(UPLINK_TRIGGER_CADENCE, uplinkWindowDue(POLICY, 1900, 1000, 0));
+    TEST_ASSERT_EQUAL(UPLINK_TRIGGER_QUEUE, uplinkWindowDue(POLICY, 1001, 1000, 4096));
+    TEST_ASSERT_EQUAL(UPLINK_TRIGGER_CADENCE, uplinkWindowDue(POLICY, 500, 1000, 0));  // clock went back
+
+    TEST_ASSERT_EQUAL(600, uplinkSecondsUntilDue(POLICY, 1300, 1000));
+    TEST_ASSERT_EQUAL(0, uplinkSecondsUntilDue(POLICY, 2000, 1000));
+}
+
+void test_full_window() {
+    UplinkWindow w = makeWindow();
+    TEST_ASSERT_EQUAL(UPLINK_ACT_CONNECT_WIFI, w.open(UPLINK_TRIGGER_CADENCE, 1000, 50000, 3));
+    TEST_ASSERT_EQUAL(UPLINK_ACT_NONE, w.step(1200, false, false, 3));
+    TEST_ASSERT_EQUAL(UPLINK_ACT_CONNECT_MQTT, w.step(1400, true, false, 3));
+    TEST_ASSERT_EQUAL(UPLINK_ACT_NONE, w.step(1600, true, true, 3));
+    TEST_ASSERT_EQUAL(UPLINK_DRAIN, w.phase());
+    TEST_ASSERT_EQUAL(UPLINK_ACT_NONE, w.step(1700, true, true, 0));
+    TEST_ASSERT_EQUAL(UPLINK_LINGER, w.phase());
+    TEST_ASSERT_EQUAL(UPLINK_ACT_NONE, w.step(2199, true, true, 0));
+    TEST_ASSERT_EQUAL(UPLINK_ACT_CLOSE, w.step(2200, true, true, 0));
+    TEST_ASSERT_FALSE(w.isOpen());
+
+    w.radioOff(2250);
+    const UplinkWindowRecord& r = w.record();
+    TEST_ASSERT_EQUAL(UPLINK_OK, r.outcome);
+    TEST_ASSERT_EQUAL(400, r.wifiMs);
+    TEST_ASSERT_EQUAL(200, r.mqttMs);
+    TEST_ASSERT_EQUAL(1250, r.radioOnMs);
+    TEST_ASSERT_EQUAL(3, r.pendingAtOpen);
+    TEST_ASSERT_EQUAL(0, r.pendingAtClose);
+}
+
+void test_budget_cuts_the_window() {
+    UplinkWindow w = makeWindow();
+    w.open(UPLINK_TRIGGER_QUEUE, 0, 0, 10);
+    w.step(100, true, false, 10);
+    w.step(200, true, true, 10);
+    TEST_ASSERT_EQUAL(UPLINK_ACT_NONE, w.step(7999, true, true, 4));
+    TEST_ASSERT_EQUAL(UPLINK_ACT_CLOSE, w.step(8000, true, true, 4));
+    TEST_ASSERT_EQUAL(UPLINK_BUDGET, w.record().outcome);
+    TEST_ASSERT_EQUAL(4, w.record().pendingAtClose);
+}
+
+void test_budget_outcome_tells_where_it_stalled() {
+    UplinkWindow w = makeWindow();
+    w.open(UPLINK_TRIGGER_CADENCE, 0, 0, 0);
+    TEST_ASSERT_EQUAL(UPLINK_ACT_CLOSE, w.step(9000, false, false, 0));
+    TEST_ASSERT_EQUAL(UPLINK_NO_WIFI, w.record().outcome);
+
+    w.open(UPLINK_TRIGGER_CADENCE, 0, 0, 0);
+    w.step(100, true, false, 0);
+    TEST_ASSERT_EQUAL(UPLINK_ACT_CLOSE, w.step(9000, true, false, 0));
+    TEST_ASSERT_EQUAL(UPLINK_NO_MQTT, w.record().outcome);
+}
+
+void test_empty_queue_goes_straight_to_linger() {
+    UplinkWindow w = makeWindow();
+    w.open(UPLINK_TRIGGER_MANUAL, 0, 0, 0);
+    w.step(100, true, false, 0);
+    TEST_ASSERT_EQUAL(UPLINK_ACT_NONE, w.step(200, true, true, 0));
+    TEST_ASSERT_EQUAL(UPLINK_LINGER, w.phase());
+}
+
+void test_fail_and_stats() {
+    UplinkWindow w = makeWindow();
+    UplinkStats  s = {};
+    w.open(UPLINK_TRIGGER_CADENCE, 0, 0, 2);
+    TEST_ASSERT_EQUAL(UPLINK_ACT_CLOSE, w.fail(300, UPLINK_NO_WIFI, 2));
+    TEST_ASSERT_EQUAL(UPLINK_ACT_NONE, w.fail(400, UPLINK_NO_WIFI, 2));
+    w.radioOff(350);
+    s.record(w.record());
+
+    w.open(UPLINK_TRIGGER_QUEUE, 1000, 0, 0);
+    w.step(1100, true, false, 0);
+    w.step(1200, true, true, 0);
+    w.step(1700, true, true, 0);
+    w.radioOff(1750);
+    s.record(w.record());
+
+    TEST_ASSERT_EQUAL(2, s.windows);
+    TEST_ASSERT_EQUAL(1, s.outcomes[UPLINK_NO_WIFI]);
+    TEST_ASSERT_EQUAL(1, s.outcomes[UPLINK_OK]);
+    TEST_ASSERT_EQUAL(750, s.maxRadioOnMs);
+    TEST_ASSERT_EQUAL(550, s.averageRadioOnMs());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_due_on_cadence_and_queue);
+    RUN_TEST(test_full_window);
+    RUN_TEST(test_budget_cuts_the_window);
+    RUN_TEST(test_budget_outcome_tells_where_it_stalled);
+    RUN_TEST(test_empty_queue_goes_straight_to_linger);
+    RUN_TEST(test_fail_and_stats);
+
+    return UNITY_END();
+}
@@ -0,0 +1,141 @@
+#include <unity.h>
+#include <string.h>
+#include "../../lib/core/value_picker.h"
+
+// Run with `pio test -e native -f test_value_picker`
+
+static constexpr PickerField DATE_TIME[] = {
+    pickYear(), pickMonth(), pickDay(), pickHours(), pickMinutes(), pickSeconds()
+};
+
+static const char* const MODES[] = { "Focus", "Break", "Off" };
+static constexpr PickerField MIXED[] = { pickEnum("Mode", MODES, 3), pickInt("Volume", 0, 100, 10) };
+
+static constexpr PickerField DURATION[] = { pickHours("Hours", 99), pickMinutes(), pickSeconds() };
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_calendar_helpers() {
+    TEST_ASSERT_TRUE(pickerIsLeapYear(2024));
+    TEST_ASSERT_TRUE(pickerIsLeapYear(2000));
+    TEST_ASSERT_FALSE(pickerIsLeapYear(2100));
+    TEST_ASSERT_FALSE(pickerIsLeapYear(2026));
+    TEST_ASSERT_EQUAL(29, pickerDaysInMonth(2024, 2));
+    TEST_ASSERT_EQUAL(28, pickerDaysInMonth(2026, 2));
+    TEST_ASSERT_EQUAL(30, pickerDaysInMonth(2026, 4));
+    TEST_ASSERT_EQUAL(31, pickerDaysInMonth(2026, 12));
+    TEST_ASSERT_EQUAL(4, pickerWeekDay(2026, 1, 1));    // Thursday
+    TEST_ASSERT_EQUAL(0, pickerWeekDay(2026, 10, 18));  // Sunday
+    TEST_ASSERT_EQUAL(4, pickerWeekDay(2024, 2, 29));
+}
+
+void test_initial_values_are_clamped_to_the_calendar() {
+    ValuePickerModel m;
+    const int16_t initial[6] = { 2025, 2, 31, 25, -3, 59 };
+    TEST_ASSERT_TRUE(m.configure(DATE_TIME, 6, initial));
+    TEST_ASSERT_EQUAL(2025, m.value(0));
+    TEST_ASSERT_EQUAL(28, m.value(2));   // no Feb 31st, 2025 is not leap
+    TEST_ASSERT_EQUAL(23, m.value(3));
+    TEST_ASSERT_EQUAL(0, m.value(4));
+    TEST_ASSERT_EQUAL(59, m.value(5));
+    TEST_ASSERT_EQUAL(PICKER_DIRTY_ALL, m.takeDirty());
+    TEST_ASSERT_EQUAL(0, m.takeDirty());
+
+    static constexpr PickerField TOO_MANY[7] = {};
+    TEST_ASSERT_FALSE(m.configure(TOO_MANY, 7));
+}
+
+void test_day_follows_month_and_year() {
+    ValuePickerModel m;
+    const int16_t initial[6] = { 2024, 1, 31, 12, 0, 0 };
+    m.configure(DATE_TIME, 6, initial);
+
+    m.next();                             // month
+    m.step(+1);                           // February
+    TEST_ASSERT_EQUAL(2, m.value(1));
+    TEST_ASSERT_EQUAL(29, m.value(2));    // 2024 is leap
+    m.back();
+    m.step(+1);                           // 2025
+    TEST_ASSERT_EQUAL(28, m.value(2));
+
+    m.next();
+    m.next();                             // day
+    TEST_ASSERT_EQUAL(28, m.maxOf(2));
+    m.step(+1);
+    TEST_ASSERT_EQUAL(1, m.value(2));     // wraps at the end of the month
+    m.step(-1);
+    TEST_ASSERT_EQUAL(28, m.value(2));
+}
+
+void test_wrapping_steps_and_enums() {
+    ValuePickerModel m;
+    m.configure(MIXED, 2);
+    TEST_ASSERT_EQUAL(0, m.value(0));
+    TEST_ASSERT_EQUAL(2, m.neighbour(-1));
+    m.step(-1);
+    TEST_ASSERT_EQUAL(2, m.value(0));
+
+    char text[16];
+    m.format(0, m.value(0), text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("Off", text);
+
+    m.next();
+    m.setValue(1, 47);
+    TEST_ASSERT_EQUAL(40, m.value(1));    // on the step grid
+    for (int i = 0; i < 6; i++) m.step(+1);
+    TEST_ASSERT_EQUAL(100, m.value(1));
+    m.step(+1);
+    m.step(+1);
+    TEST_ASSERT_EQUAL(10, m.value(1));    // wrapped through 0
+    m.format(1, m.value(1), text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("10", text);
+}
+
+void test_dirty_flags_follow_the_edits() {
+    ValuePickerModel m;
+    m.configure(DATE_TIME, 6);
+    m.takeDirty();
+
+    m.step(+1);
+    TEST_ASSERT_EQUAL(PICKER_DIRTY_VALUE, m.takeDirty());
+    m.setValue(5, 30);                    // another field: nothing on screen changes
+    TEST_ASSERT_EQUAL(0, m.takeDirty());
+    m.next();
+    TEST_ASSERT_EQUAL(PICKER_DIRTY_FIELD, m.takeDirty());
+    m.restart();
+    TEST_ASSERT_EQUAL(0, m.current());
+    TEST_ASSERT_EQUAL(PICKER_DIRTY_ALL, m.takeDirty());
+    TEST_ASSERT_EQUAL(30, m.value(5));    // values kept
+}
+
+void test_completion_and_durations() {
+    ValuePickerModel m;
+    const int16_t initial[3] = { 1, 30, 15 };
+    m.configure(DURATION, 3, initial);
+    TEST_ASSERT_EQUAL(5415, m.totalSeconds());
+    TEST_ASSERT_FALSE(m.next());
+    TEST_ASSERT_FALSE(m.next());
+    TEST_ASSERT_FALSE(m.complete());
+    TEST_ASSERT_TRUE(m.next());
+    TEST_ASSERT_TRUE(m.complete());
+
+    char text[16];
+    m.format(0, 7, text, sizeof(text));
+    TEST_ASSERT_EQUAL_STRING("07", text);
+    TEST_ASSERT_EQUAL(-1, m.find(PICK_YEAR));
+    TEST_ASSERT_EQUAL(2, m.find(PICK_SECONDS));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_calendar_helpers);
+    RUN_TEST(test_initial_values_are_clamped_to_the_calendar);
+    RUN_TEST(test_day_follows_month_and_year);
+    RUN_TEST(test_wrapping_steps_and_enums);
+    RUN_TEST(test_dirty_flags_follow_the_edits);
+    RUN_TEST(test_completion_and_durations);
+
+    return UNITY_END();
+}
@@ -0,0 +1,91 @@
+#include <unity.h>
+#include "../../lib/core/wifi_ranking.h"
+
+// Run with `pio test -e native -f test_wifi_ranking`
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const uint8_t BSSID_A[6] = { 1, 2, 3, 4, 5, 6 };
+static const uint8_t BSSID_B[6] = { 6, 5, 4, 3, 2, 1 };
+
+void test_stats_average_and_failures() {
+    WifiProfileStats st = {};
+    st.record(true, 800);
+    TEST_ASSERT_EQUAL(800, st.avgConnectMs);
+    st.record(true, 400);
+    TEST_ASSERT_EQUAL(700, st.avgConnectMs);
+    st.record(false, 10000);
+    TEST_ASSERT_EQUAL(700, st.avgConnectMs);
+    TEST_ASSERT_EQUAL(3, st.attempts);
+    TEST_ASSERT_EQUAL(1, st.failures);
+    TEST_ASSERT_EQUAL(250, st.failurePermille());  // 1000 / (3 + 1)
+    TEST_ASSERT_EQUAL(400, st.lastConnectMs);
+}
+
+void test_stats_counters_halve_instead_of_wrapping() {
+    WifiProfileStats st = {};
+    st.attempts = 0xFFFF;
+    st.failures = 0x8000;
+    st.record(true, 100);
+    TEST_ASSERT_EQUAL(0x8000, st.attempts);
+    TEST_ASSERT_EQUAL(0x4000, st.failures);
+}
+
+void test_strongest_ap_per_profile() {
+    WifiCandidate list[4];
+    size_t n = 0;
+    n = wifiAddCandidate(list, n, 4, 0, -80, 1, BSSID_A);
+    n = wifiAddCandidate(list, n, 4, 1, -60, 6, BSSID_A);
+    n = wifiAddCandidate(list, n, 4, 0, -55, 11, BSSID_B);
+    n = wifiAddCandidate(list, n, 4, 0, -90, 3, BSSID_A);
+    TEST_ASSERT_EQUAL(2, n);
+    TEST_ASSERT_EQUAL(-55, list[0].rssi);
+    TEST_ASSERT_EQUAL(11, list[0].channel);
+    TEST_ASSERT_EQUAL_MEMORY(BSSID_B, list[0].bssid, 6);
+}
+
+void test_capacity_is_respected() {
+    WifiCandidate list[2];
+    size_t n = 0;
+    for (uint8_t p = 0; p < 5; p++) n = wifiAddCandidate(list, n, 2, p, -50, 1, nullptr);
+    TEST_ASSERT_EQUAL(2, n);
+}
+
+void test_fast_history_beats_stronger_signal() {
+    WifiProfileStats stats[3] = {};
+    for (int i = 0; i < 10; i++) stats[0].record(true, 600);    // quick home AP
+    for (int i = 0; i < 10; i++) stats[1].record(i % 2, 2500);  // flaky office AP
+
+    WifiCandidate list[3];
+    size_t n = 0;
+    n = wifiAddCandidate(list, n, 3, 1, -45, 1, BSSID_A);
+    n = wifiAddCandidate(list, n, 3, 2, -50, 6, BSSID_A);  // never used
+    n = wifiAddCandidate(list, n, 3, 0, -70, 11, BSSID_B);
+    wifiRankCandidates(list, n, stats);
+
+    TEST_ASSERT_EQUAL(0, list[0].profile);
+    TEST_ASSERT_EQUAL(2, list[1].profile);
+    TEST_ASSERT_EQUAL(1, list[2].profile);
+    TEST_ASSERT_TRUE(list[0].score <= list[1].score && list[1].score <= list[2].score);
+}
+
+void test_weak_signal_is_penalized() {
+    WifiProfileStats st = {};
+    st.record(true, 500);
+    TEST_ASSERT_TRUE(wifiCandidateScore(-85, st) > wifiCandidateScore(-60, st));
+    TEST_ASSERT_EQUAL(wifiCandidateScore(-60, st), wifiCandidateScore(-50, st));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_stats_average_and_failures);
+    RUN_TEST(test_stats_counters_halve_instead_of_wrapping);
+    RUN_TEST(test_strongest_ap_per_profile);
+    RUN_TEST(test_capacity_is_respected);
+    RUN_TEST(test_fast_history_beats_stronger_signal);
+    RUN_TEST(test_weak_signal_is_penalized);
+
+    return UNITY_END();
+}
@@ -0,0 +1,34 @@
+#!/bin/sh
+# Runs a local mosquitto broker that goes down and comes back, to exercise
+# the MQTT reconnect path (test/test_mqtt_reconnect).
+#
+#   tools/broker_flap.sh [up_seconds] [down_seconds] [cycles]
+#
+# Defaults: 20s up, 15s down, 3 cycles. Needs mosquitto in PATH.
+
+UP=${1:-20}
+DOWN=${2:-15}
+CYCLES=${3:-3}
+PORT=${MQTT_PORT:-1883}
+
+CONF=$(mktemp)
+trap 'kill $PID 2>/dev/null; rm -f "$CONF"' EXIT INT TERM
+printf 'listener %s 0.0.0.0\nallow_anonymous true\n' "$PORT" > "$CONF"
+
+i=1
+while [ "$i" -le "$CYCLES" ]; do
+    echo "[flap] cycle $i/$CYCLES: broker up for ${UP}s"
+    mosquitto -c "$CONF" &
+    PID=$!
+    sleep "$UP"
+    echo "[flap] broker down for ${DOWN}s"
+    kill "$PID"
+    wait "$PID" 2>/dev/null
+    sleep "$DOWN"
+    i=$((i + 1))
+done
+
+echo "[flap] final start, Ctrl-C to stop"
+mosquitto -c "$CONF" &
+PID=$!
+wait "$PID"
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""Decode a binary capture of the deferred log (`log bin` on the device
+console) into text, using the message table in lib/core/log_messages.h.
+
+    tools/log_decode.py capture.bin
+    tools/log_decode.py --port /dev/ttyUSB0 [--baud 115200]   (needs pyserial)
+
+Records are 48 bytes, each preceded by A5 5A. Anything else on the line
+(plain Serial prints) is passed through as text.
+"""
+import argparse
+import os
+import re
+import struct
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+MESSAGES_H = os.path.join(HERE, "..", "lib", "core", "log_messages.h")
+
+SYNC = b"\xa5\x5a"
+RECORD = struct.Struct("<IHBB40s")
+LEVELS = "-EWID"
+CONVERSION = re.compile(r"%([-+ #0]*\d*(?:\.\d+)?)[hlzjt]*([diouxXcsfeEgGaA%])")
+
+
+def load_tables(path):
+    text = open(path).read()
+    messages_block = text[text.index("#define LOG_MESSAGES(X)"):text.index("#define LOG_MODULES(X)")]
+    modules_block = text[text.index("#define LOG_MODULES(X)"):text.index("#define LOG_MSG_ENUM")]
+    formats = [m.group(2).encode().decode("unicode_escape")
+               for m in re.finditer(r'X\((\w+),\s*"((?:[^"\\]|\\.)*)"\)', messages_block)]
+    modules = re.findall(r"X\((\w+)\)", modules_block)
+    return formats, modules
+
+
+def format_record(fmt, words, args):
+    pos = [0]
+
+    def word():
+        if pos[0] >= words:
+            return None
+        value = struct.unpack_from("<I", args, pos[0] * 4)[0]
+        pos[0] += 1
+        return value
+
+    def repl(m):
+        flags, conv = m.group(1), m.group(2)
+        if conv == "%":
+            return "%"
+        if conv == "s":
+            if pos[0] >= words:
+                return "?"
+            raw = args[pos[0] * 4:words * 4]
+            s = raw.split(b"\0", 1)[0]
+            pos[0] += (len(s) + 4) // 4
+            return ("%" + flags + "s") % s.decode(errors="replace")
+        value = word()
+        if value is None:
+            return "?"
+        if conv in "feEgGaA":
+            return ("%" + flags + conv) % struct.unpack("<f", struct.pack("<I", value))[0]
+        if conv in "di":
+            return ("%" + flags + "d") % struct.unpack("<i", struct.pack("<I", value))[0]
+        if conv == "c":
+            return chr(value & 0xFF)
+        return ("%" + flags + conv.replace("u", "d")) % value
+
+    return CONVERSION.sub(repl, fmt)
+
+
+def write_text(text, out):
+    for line in text.split(b"\n"):
+        if line.strip():
+            out.write(line.decode(errors="replace").rstrip("\r") + "\n")
+
+
+def decode(stream, formats, modules, out):
+    buf = b""
+    text = b""
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            write_text(text + buf, out)
+            break
+        buf += chunk
+        while True:
+            i = buf.find(SYNC)
+            if i < 0:
+                text += buf[:-1]
+                buf = buf[-1:]
+                break
+            text += buf[:i]
+            if len(buf) < i + 2 + RECORD.size:
+                buf = buf[i:]
+                break
+            time_ms, message, level_module, words, args = RECORD.unpack_from(buf, i + 2)
+            level, module = level_module >> 4, level_module & 0x0F
+            if message >= len(formats) or words > 10 or level >= len(LEVELS) or module >= len(modules):
+                text += buf[i:i + 1]  # not a record, resync on the next byte
+                buf = buf[i + 1:]
+                continue
+            write_text(text, out)
+            text = b""
+            out.write("[%6u.%03u] %s %-6s %s\n" % (time_ms // 1000, time_ms % 1000, LEVELS[level], modules[module],
+                                                   format_record(formats[message], words, args)))
+            buf = buf[i + 2 + RECORD.size:]
+        out.flush()
+
+
+class LiveSerial:
+    """Blocking reads: an empty read would end decode()"""
+
+    def __init__(self, port):
+        self.port = port
+
+    def read(self, n):
+        while True:
+            data = self.port.read(n)
+            if data:
+                return data
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    p.add_argument("capture", nargs="?", help="binary capture file, stdin if omitted")
+    p.add_argument("--port", help="read live from a serial port")
+    p.add_argument("--baud", type=int, default=115200)
+    p.add_argument("--messages", default=MESSAGES_H, help="path to log_messages.h")
+    args = p.parse_args()
+
+    formats, modules = load_tables(args.messages)
+    if args.port:
+        import serial
+        stream = LiveSerial(serial.Serial(args.port, args.baud, timeout=0.2))
+    elif args.capture:
+        stream = open(args.capture, "rb")
+    else:
+        stream = sys.stdin.buffer
+    try:
+        decode(stream, formats, modules, sys.stdout)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
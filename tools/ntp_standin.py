@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+"""Local NTP stand-in answering SNTP requests with a controlled offset, to
+check the device time sync (time_sync adapter) without a real time server.
+
+    tools/ntp_standin.py [--port 12300] [--offset-ms 1500] [--drift-ppm 0] [--delay-ms 0]
+
+--offset-ms   constant error added to the host clock
+--drift-ppm   extra error growing with time, to watch the drift estimate
+--delay-ms    sleep before answering, adds to the measured round trip
+
+Point the device at it with timeSync->setServer("<host ip>", 12300).
+Port 123 needs root, hence the default.
+"""
+import argparse
+import socket
+import struct
+import time
+
+NTP_UNIX_OFFSET = 2208988800
+
+
+def to_ntp(t):
+    sec = int(t)
+    frac = int((t - sec) * (1 << 32)) & 0xFFFFFFFF
+    return struct.pack("!II", (sec + NTP_UNIX_OFFSET) & 0xFFFFFFFF, frac)
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    p.add_argument("--port", type=int, default=12300)
+    p.add_argument("--offset-ms", type=float, default=0.0)
+    p.add_argument("--drift-ppm", type=float, default=0.0)
+    p.add_argument("--delay-ms", type=float, default=0.0)
+    args = p.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(("0.0.0.0", args.port))
+    start = time.time()
+    print(f"[ntp] listening on udp/{args.port}, offset {args.offset_ms} ms, drift {args.drift_ppm} ppm")
+
+    def now():
+        t = time.time()
+        return t + args.offset_ms / 1000.0 + (t - start) * args.drift_ppm / 1e6
+
+    while True:
+        data, addr = sock.recvfrom(512)
+        t2 = now()
+        if len(data) < 48 or (data[0] & 7) != 3:
+            continue
+        if args.delay_ms:
+            time.sleep(args.delay_ms / 1000.0)
+        # LI 0, VN 4, mode 4 (server), stratum 2, poll 4, precision -20
+        reply = struct.pack("!BBbb", (4 << 3) | 4, 2, 4, -20) + b"\0" * 8 + b"LOCL"
+        reply += to_ntp(t2)             # reference
+        reply += data[40:48]            # originate = client transmit
+        reply += to_ntp(t2)             # receive
+        reply += to_ntp(now())          # transmit
+        sock.sendto(reply, addr)
+        print(f"[ntp] {addr[0]}: answered, server clock off by {(now() - time.time()) * 1000:.1f} ms")
+
+
+if __name__ == "__main__":
+    main()
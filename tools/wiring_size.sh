@@ -0,0 +1,19 @@
+#!/bin/sh
+# Builds the firmware with both wirings and prints flash and RAM use side by
+# side: m5stick-c (factories, virtual calls) and m5stick-c-static
+# (-DSTATIC_WIRING). Call overhead: test/test_bench_wiring on the host.
+#
+#   tools/wiring_size.sh
+#
+# Needs pio in PATH. RAM is static data only (.data + .bss); the virtual
+# build also allocates its adapters on the heap at startup, see `mem` on the
+# device console for that part.
+
+cd "$(dirname "$0")/.." || exit 1
+
+for ENV in m5stick-c m5stick-c-static; do
+    OUT=$(pio run -e "$ENV" 2>&1) || { echo "$OUT" | tail -20; exit 1; }
+    RAM=$(echo "$OUT" | sed -n 's/^RAM:.*used \([0-9]*\) bytes.*/\1/p')
+    FLASH=$(echo "$OUT" | sed -n 's/^Flash:.*used \([0-9]*\) bytes.*/\1/p')
+    printf '%-18s flash %8s  ram %7s\n' "$ENV" "$FLASH" "$RAM"
+done